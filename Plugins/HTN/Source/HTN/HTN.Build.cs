@@ -27,7 +27,8 @@ public class HTN : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
-                "NavigationSystem"
+                "NavigationSystem",
+                "Json"
 			}
         );
 	}
@@ -5,16 +5,25 @@
 #include "HTNPlan.h"
 #include "HTNDecorator.h"
 #include "HTNTask.h"
+#include "Decorators/HTNDecorator_TraceTest.h"
 #include "WorldStateProxy.h"
+#include "Utility/HTNPlanningSnapshot.h"
+#include "Utility/HTNWorkerThreadPlanningValidator.h"
 
 #include "Algo/Accumulate.h"
 #include "Algo/AnyOf.h"
 #include "Algo/MinElement.h"
 #include "Algo/NoneOf.h"
 #include "Algo/Partition.h"
+#include "Async/Async.h"
+#include "Engine/World.h"
 #include "GameplayTasksComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
 #include "Misc/RuntimeErrors.h"
 #include "Misc/ScopeExit.h"
+#include "Tasks/Task.h"
+#include "UObject/GarbageCollection.h"
 #include "VisualLogger/VisualLogger.h"
 #include <atomic>
 
@@ -32,18 +41,48 @@
 
 #endif
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Expanded Plans"), STAT_AI_HTN_NumExpandedPlans, STATGROUP_AI_HTN);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pruned Equivalent Plans"), STAT_AI_HTN_NumPrunedEquivalentPlans, STATGROUP_AI_HTN);
+
 namespace
 {
+	// Orders plans by their cost plus the lower bound of their remaining cost, A*-style.
+	// Among plans with the same estimate, the ones closer to completion come first.
 	struct FCompareHTNPlanCosts
 	{
 		FORCEINLINE bool operator()(const TSharedPtr<FHTNPlan>& A, const TSharedPtr<FHTNPlan>& B) const
 		{
-			return A.IsValid() && B.IsValid() ?
-				A->Cost < B->Cost :
-				B.IsValid();
+			if (!A.IsValid() || !B.IsValid())
+			{
+				return B.IsValid();
+			}
+
+			const int64 EstimateA = StaticCast<int64>(A->Cost) + A->RemainingCostLowerBound;
+			const int64 EstimateB = StaticCast<int64>(B->Cost) + B->RemainingCostLowerBound;
+			return EstimateA != EstimateB ? 
+				EstimateA < EstimateB : 
+				A->RemainingCostLowerBound < B->RemainingCostLowerBound;
 		}
 	};
 
+	// When a step waits for async traces, this many plans from the frontier also get to queue their traces into the same batch.
+	constexpr int32 MaxFrontierPlansToGatherTracesFrom = 8;
+
+	bool GHTNProfilePlanning = false;
+	FAutoConsoleVariableRef CVarHTNProfilePlanning(
+		TEXT("ai.htn.ProfilePlanning"),
+		GHTNProfilePlanning,
+		TEXT("If true, every HTN planning session records where its time goes per node (see FHTNPlanningProfile) and logs the report when it ends."),
+		ECVF_Default);
+
+	FString GHTNPlanningSnapshotDirectory;
+	FAutoConsoleVariableRef CVarHTNPlanningSnapshotDirectory(
+		TEXT("ai.htn.PlanningSnapshotDirectory"),
+		GHTNPlanningSnapshotDirectory,
+		TEXT("If set, every HTN planning session saves the HTN and blackboard values it starts from to a file in this directory,\n")
+		TEXT("so that it can be replayed by the HTNPlanningBenchmark commandlet."),
+		ECVF_Default);
+
 	int32 GetTotalNumSteps(const FHTNPlan& Plan)
 	{
 		const int32 NumSteps = Algo::Accumulate(Plan.Levels, 0, [](int32 Sum, const TSharedPtr<FHTNPlanLevel>& Level) -> int32 { return Sum + Level->Steps.Num(); });
@@ -174,7 +213,14 @@ void FHTNPlanningContext::SubmitCandidatePlan(const TSharedRef<FHTNPlan>& Candid
 		AddedStep.WorldState = AddedStep.WorldStateAfterEnteringDecorators;
 	}
 
-	if (!AddedStep.WorldState.IsValid() || PlanningTask->ExitDecoratorsAndPropagateWorldState(*CandidatePlan, AddedStepID))
+	const uint64 ExitDecoratorsStartCycles = PlanningTask->Profile ? FPlatformTime::Cycles64() : 0;
+	const bool bExitedDecorators = !AddedStep.WorldState.IsValid() || PlanningTask->ExitDecoratorsAndPropagateWorldState(*CandidatePlan, AddedStepID);
+	if (PlanningTask->Profile)
+	{
+		PlanningTask->Profile->FindOrAddNodeStats(*AddingNode).DecoratorCycles += FPlatformTime::Cycles64() - ExitDecoratorsStartCycles;
+	}
+
+	if (bExitedDecorators)
 	{
 		++NumAddedCandidatePlans;
 
@@ -218,8 +264,16 @@ UAITask_MakeHTNPlan::UAITask_MakeHTNPlan(const FObjectInitializer& ObjectInitial
 	NextPriorityMarker(1),
 	CurrentPlanStepID(FHTNPlanStepID::None),
 	NextNodesIndex(0),
+	NumExpandedPlans(0),
+	DoPlanningStartCycles(0),
+	bProfilingRequested(false),
 	bIsWaitingForNodeToMakePlanExpansions(false),
-	bWasCancelled(false)
+	bIsWaitingForAsyncTraces(false),
+	bPruneEquivalentPlans(false),
+	bWasCancelled(false),
+	bIsPlanningOnWorkerThread(false),
+	bWorkerThreadPlanningEnded(false),
+	bCancelWorkerThreadPlanning(false)
 {
 	bIsPausable = false;
 }
@@ -260,6 +314,7 @@ void UAITask_MakeHTNPlan::SetUp(UHTNPlanInstance& PlanInstance, TSharedRef<FHTNP
 
 void UAITask_MakeHTNPlan::ExternalCancel()
 {
+	WaitForWorkerThreadPlanning(/*bCancel=*/true);
 	bWasCancelled = true;
 	Super::ExternalCancel();
 }
@@ -283,6 +338,12 @@ void UAITask_MakeHTNPlan::Clear()
 	PriorityMarkerCounts.Reset();
 	FinishedPlan = nullptr;
 	NextPriorityMarker = 1;
+	TraceCache.Reset();
+	EQSCache.Reset();
+	Heuristic.Reset();
+	ClosedSet.Reset();
+	NumExpandedPlans = 0;
+	Profile.Reset();
 	bWasCancelled = false;
 
 #if HTN_DEBUG_PLANNING
@@ -402,15 +463,44 @@ void UAITask_MakeHTNPlan::Activate()
 
 	const TSharedPtr<FHTNPlan> CachedStartingPlan = StartingPlan;
 	Clear();
+	CachedStartingPlan->RemainingCostLowerBound = Heuristic.GetRemainingCostLowerBound(*CachedStartingPlan);
 	Frontier.HeapPush(CachedStartingPlan, FCompareHTNPlanCosts());
+
+	// Plan adjustment depends on the path a plan took, not only on the state it reached.
+	bPruneEquivalentPlans = OwnerComponent->bPruneEquivalentPlans && PlanningType != EHTNPlanningType::TryToAdjustCurrentPlan;
+
+	if (GHTNProfilePlanning || bProfilingRequested)
+	{
+		Profile.Emplace();
+	}
+	bProfilingRequested = false;
+
+	if (!GHTNPlanningSnapshotDirectory.IsEmpty() && OwnerComponent->GetBlackboardComponent())
+	{
+		const FString FilePath = FPaths::Combine(GHTNPlanningSnapshotDirectory, 
+			FString::Printf(TEXT("%s_%llu.json"), *TopLevelHTN->GetName(), PlanningID.ID));
+		if (!FHTNPlanningSnapshot::Capture(*TopLevelHTN, *OwnerComponent->GetBlackboardComponent()).SaveToFile(FilePath))
+		{
+			UE_VLOG_UELOG(this, LogHTN, Warning, TEXT("%s: could not save planning snapshot to %s"), *GetLogPrefix(), *FilePath);
+		}
+	}
 	
-	DoPlanning();
+	if (ShouldPlanOnWorkerThread())
+	{
+		StartPlanningOnWorkerThread();
+	}
+	else
+	{
+		DoPlanning();
+	}
 }
 
 void UAITask_MakeHTNPlan::OnDestroy(bool bInOwnerFinished)
 {
 	SCOPE_CYCLE_COUNTER(STAT_AI_HTN_Planning);
 
+	WaitForWorkerThreadPlanning(/*bCancel=*/true);
+
 	if (ensureMsgf(IsValid(this), TEXT("OnDestroy called on invalid gameplay task")))
 	{
 		const FString OwnerName = TaskOwner.IsValid() ? TaskOwner.GetObject()->GetName() : TEXT("Invalid GameplayTask Owner");
@@ -446,6 +536,18 @@ void UAITask_MakeHTNPlan::OnDestroy(bool bInOwnerFinished)
 		PlanningType == EHTNPlanningType::TryToAdjustCurrentPlan ? TEXT("(attempt to adjust current plan) ") : TEXT(""),
 		WasCancelled() ? TEXT("was cancelled") : FoundPlan() ? TEXT("succeeded") : TEXT("failed"));
 
+	if (Profile && GHTNProfilePlanning)
+	{
+		UE_VLOG_UELOG(this, LogHTN, Log, TEXT("Planning task %s in HTN %s profile:\n%s"),
+			*GetLogPrefix(), *GetNameSafe(TopLevelHTN), *Profile->ToString());
+	}
+
+	if (bPruneEquivalentPlans)
+	{
+		UE_VLOG_UELOG(this, LogHTN, Verbose, TEXT("Planning task %s in HTN %s expanded %i plans and pruned %i plans equivalent to already expanded ones."),
+			*GetLogPrefix(), *GetNameSafe(TopLevelHTN), NumExpandedPlans, ClosedSet.GetNumPrunedPlans());
+	}
+
 	OnPlanningFinished.Broadcast(*this, FinishedPlan);
 
 	// Instead of calling Super::OnDestroy(bInOwnerFinished); we do what it does but without marking the task as garbage 
@@ -476,16 +578,27 @@ void UAITask_MakeHTNPlan::DoPlanning()
 	SCOPE_CYCLE_COUNTER(STAT_AI_HTN_Planning);
 	
 	check(!FinishedPlan.IsValid());
+	DoPlanningStartCycles = Profile ? FPlatformTime::Cycles64() : 0;
 
-	while (!bIsWaitingForNodeToMakePlanExpansions)
+	while (!bIsWaitingForNodeToMakePlanExpansions && !bIsWaitingForAsyncTraces)
 	{
+		if (bCancelWorkerThreadPlanning && !IsInGameThread())
+		{
+			return;
+		}
+
 		if (!CurrentPlanToExpand.IsValid())
 		{
+			if (Profile)
+			{
+				Profile->FrontierSizes.Add(GetNumCandidatePlans());
+			}
+
 			CurrentPlanToExpand = DequeueCurrentBestPlan();
 			if (!CurrentPlanToExpand.IsValid())
 			{
 				// Planning failed
-				EndTask();
+				FinishPlanning();
 				return;
 			}
 			
@@ -503,13 +616,13 @@ void UAITask_MakeHTNPlan::DoPlanning()
 						*GetLogPrefix());
 
 					CurrentPlanToExpand.Reset();
-					EndTask();
+					FinishPlanning();
 					return;
 				}
 
 				// Planning succeeded
 				FinishedPlan = CurrentPlanToExpand;
-				EndTask();
+				FinishPlanning();
 				return;
 			}
 			
@@ -538,14 +651,30 @@ void UAITask_MakeHTNPlan::DoPlanning()
 						*GetLogPrefix());
 					// Planning failed
 					CurrentPlanToExpand.Reset();
-					EndTask();
+					FinishPlanning();
 					return;
 				}
 			}
+
+			// Plans in the same state have the same remaining cost estimate, so they are dequeued cheapest first.
+			// If an equivalent plan was expanded already, this one can't lead to a cheaper plan than it did.
+			if (bPruneEquivalentPlans && ClosedSet.CheckAndAdd(*CurrentPlanToExpand))
+			{
+				INC_DWORD_STAT(STAT_AI_HTN_NumPrunedEquivalentPlans);
+				UE_VLOG(this, LogHTN, VeryVerbose, TEXT("%s: pruned a plan with cost %i equivalent to an already expanded one"),
+					*GetLogPrefix(), CurrentPlanToExpand->Cost);
+				CurrentPlanToExpand.Reset();
+				continue;
+			}
+
+			++NumExpandedPlans;
+			INC_DWORD_STAT(STAT_AI_HTN_NumExpandedPlans);
 		}
 
 		MakeExpansionsOfCurrentPlan();
 	}
+
+	AddProfiledPlanningTime();
 }
 
 TSharedPtr<FHTNPlan> UAITask_MakeHTNPlan::DequeueCurrentBestPlan()
@@ -617,13 +746,18 @@ void UAITask_MakeHTNPlan::MakeExpansionsOfCurrentPlan()
 		}
 		
 		MakeExpansionsOfCurrentPlan(CurrentWorldState, Node);
-		if (bIsWaitingForNodeToMakePlanExpansions || FinishedPlan.IsValid())
+		if (bIsWaitingForNodeToMakePlanExpansions || bIsWaitingForAsyncTraces || FinishedPlan.IsValid())
 		{
 			break;
 		}
 	}
 
-	if (!bIsWaitingForNodeToMakePlanExpansions)
+	if (bIsWaitingForAsyncTraces)
+	{
+		UE_VLOG(this, LogHTN, VeryVerbose, TEXT("Planning task %s is waiting for %d async traces before planning node '%s'."),
+			*GetLogPrefix(), TraceCache.GetNumTracesInFlight(), *NextNodes[NextNodesIndex]->GetShortDescription());
+	}
+	else if (!bIsWaitingForNodeToMakePlanExpansions)
 	{
 		ClearIntermediateState();
 	}
@@ -645,13 +779,30 @@ void UAITask_MakeHTNPlan::MakeExpansionsOfCurrentPlan(const TSharedPtr<FBlackboa
 	check(OwnerComponent);
 	// Initialize the node with asset if hasn't been initialized with an asset already.
 	// This is to make sure that blackboard key selectors are resolved etc before planning reaches the node.
-	Node->InitializeFromAsset(*TopLevelHTN);
-	// For the same reason, initialize the decorators on the root node if we're just starting the level.
-	if (CurrentPlanStepID.StepIndex == INDEX_NONE)
+	// When planning on a worker thread, FHTNWorkerThreadPlanningValidator has already done this on the game thread.
+	if (IsInGameThread())
+	{
+		Node->InitializeFromAsset(*TopLevelHTN);
+		// For the same reason, initialize the decorators on the root node if we're just starting the level.
+		if (CurrentPlanStepID.StepIndex == INDEX_NONE)
+		{
+			const FHTNPlanLevel& Level = *CurrentPlanToExpand->Levels[CurrentPlanStepID.LevelIndex];
+			Level.InitializeFromAsset(*TopLevelHTN);
+		}
+	}
+
+	if (Profile)
 	{
-		const FHTNPlanLevel& Level = *CurrentPlanToExpand->Levels[CurrentPlanStepID.LevelIndex];
-		Level.InitializeFromAsset(*TopLevelHTN);
+		++Profile->FindOrAddNodeStats(*Node).NumExpansions;
 	}
+	const uint32 NumWorldStatesMadeBefore = FBlackboardWorldState::GetNumMadeOnThisThread();
+	ON_SCOPE_EXIT
+	{
+		if (Profile)
+		{
+			Profile->FindOrAddNodeStats(*Node).NumWorldStateCopies += FBlackboardWorldState::GetNumMadeOnThisThread() - NumWorldStatesMadeBefore;
+		}
+	};
 
 	// Set up the worldstate for the planning step
 	WorldStateAfterEnteredDecorators = WorldState->MakeNext();
@@ -661,18 +812,43 @@ void UAITask_MakeHTNPlan::MakeExpansionsOfCurrentPlan(const TSharedPtr<FBlackboa
 	// Plan-enter the decorators on the node (and the root node decorators if needed).
 	SET_NODE_FAILURE_REASON(TEXT(""));
 	bool bDecoratorsPassed = false;
-	if (!EnterDecorators(bDecoratorsPassed, *CurrentPlanToExpand, CurrentPlanStepID, *Node))
+	const int32 NumQueuedTracesBefore = TraceCache.GetNumQueuedTraces();
+	const uint64 EnterDecoratorsStartCycles = Profile ? FPlatformTime::Cycles64() : 0;
+	const bool bEnteredDecorators = EnterDecorators(bDecoratorsPassed, *CurrentPlanToExpand, CurrentPlanStepID, *Node);
+	if (Profile)
+	{
+		Profile->FindOrAddNodeStats(*Node).DecoratorCycles += FPlatformTime::Cycles64() - EnterDecoratorsStartCycles;
+	}
+
+	if (!bEnteredDecorators)
 	{
 		SAVE_PLANNING_STEP_FAILURE(Node, NodePlanningFailureReason);
 		return;
 	}
 
+	// If some decorators queued async traces instead of tracing right away, 
+	// wait for the results and then plan this node again.
+	if (TraceCache.GetNumQueuedTraces() > NumQueuedTracesBefore)
+	{
+		if (!SubmitQueuedTraces())
+		{
+			SAVE_PLANNING_STEP_FAILURE(Node, TEXT("Failed to submit async traces"));
+		}
+		return;
+	}
+
 	// Let the node itself plan.
 	CurrentPlanningContext = FHTNPlanningContext(this, Node,
 		CurrentPlanToExpand, CurrentPlanStepID,
 		WorldStateAfterEnteredDecorators, bDecoratorsPassed);
 	check(!bIsWaitingForNodeToMakePlanExpansions);
+	const uint64 MakePlanExpansionsStartCycles = Profile ? FPlatformTime::Cycles64() : 0;
 	Node->MakePlanExpansions(CurrentPlanningContext);
+	if (Profile)
+	{
+		Profile->FindOrAddNodeStats(*Node).PlanningCycles += FPlatformTime::Cycles64() - MakePlanExpansionsStartCycles;
+	}
+
 	if (!bIsWaitingForNodeToMakePlanExpansions)
 	{
 		OnNodeFinishedMakingPlanExpansions(Node);
@@ -696,6 +872,109 @@ const FHTNPlanStep* UAITask_MakeHTNPlan::GetExistingPlanStepToAdjust() const
 	return nullptr;
 }
 
+bool UAITask_MakeHTNPlan::SubmitQueuedTraces()
+{
+	UWorld* const World = GetWorld();
+	if (!ensure(World))
+	{
+		TraceCache.Reset();
+		return false;
+	}
+
+	// Before waiting, let the decorators of the remaining nodes of this step and of the best plans in the frontier
+	// queue their traces too, so that they all get submitted as one batch instead of one batch per planning step.
+	GatherQueuedTraces(*CurrentPlanToExpand, CurrentPlanStepID, CurrentWorldState, 
+		TArrayView<UHTNStandaloneNode* const>(NextNodes).Slice(NextNodesIndex + 1, NextNodes.Num() - NextNodesIndex - 1));
+	for (int32 I = 0; I < FMath::Min(Frontier.Num(), MaxFrontierPlansToGatherTracesFrom); ++I)
+	{
+		const TSharedPtr<FHTNPlan>& Plan = Frontier[I];
+		FHTNPlanStepID StepID = FHTNPlanStepID::None;
+		if (!Plan.IsValid() || Plan->IsComplete() || !Plan->FindStepToAddAfter(StepID))
+		{
+			continue;
+		}
+
+		TSharedPtr<FBlackboardWorldState> WorldState;
+		FHTNNextNodesBuffer PlanNextNodes;
+		Plan->GetWorldStateAndNextNodes(StepID, WorldState, PlanNextNodes);
+		GatherQueuedTraces(*Plan, StepID, WorldState, PlanNextNodes);
+	}
+	SET_NODE_FAILURE_REASON(TEXT(""));
+
+	const FTraceDelegate OnTraceDone = FTraceDelegate::CreateUObject(this, &ThisClass::OnAsyncTraceDone, PlanningID);
+	bIsWaitingForAsyncTraces = TraceCache.SubmitQueuedTraces(*World, OnTraceDone);
+	return bIsWaitingForAsyncTraces;
+}
+
+// Enters the trace test decorators of the given nodes only to let them queue the traces they would need, discarding any other results.
+// Other decorators (including Blueprint ones) are never entered here, since entering them may have side effects.
+void UAITask_MakeHTNPlan::GatherQueuedTraces(const FHTNPlan& Plan, const FHTNPlanStepID& StepID, const TSharedPtr<FBlackboardWorldState>& WorldState, 
+	TArrayView<UHTNStandaloneNode* const> Nodes) const
+{
+	if (!WorldState.IsValid())
+	{
+		return;
+	}
+
+	TGuardValue<bool> GatheringGuard(TraceCache.bIsGatheringTraces, true);
+	TGuardValue<const UAITask_MakeHTNPlan*> ActivePlanningTaskGuard(OwnerComponent->GetActivePlanningTaskForCurrentThread(), this);
+
+	TArray<UHTNDecorator*, TInlineAllocator<8>> TraceTestDecorators;
+	const auto AddTraceTestDecorators = [&](TArrayView<UHTNDecorator* const> Decorators)
+	{
+		for (UHTNDecorator* const Decorator : Decorators)
+		{
+			if (Cast<UHTNDecorator_TraceTest>(Decorator))
+			{
+				TraceTestDecorators.Add(Decorator);
+			}
+		}
+	};
+
+	for (UHTNStandaloneNode* const Node : Nodes)
+	{
+		if (IsValid(Node))
+		{
+			TraceTestDecorators.Reset();
+			Node->InitializeFromAsset(*TopLevelHTN);
+			if (StepID.StepIndex == INDEX_NONE)
+			{
+				const FHTNPlanLevel& Level = *Plan.Levels[StepID.LevelIndex];
+				Level.InitializeFromAsset(*TopLevelHTN);
+				AddTraceTestDecorators(Level.GetRootDecoratorTemplates());
+			}
+			AddTraceTestDecorators(Node->Decorators);
+
+			if (TraceTestDecorators.Num())
+			{
+				FGuardWorldStateProxy GuardProxy(*OwnerComponent->GetPlanningWorldStateProxy(), WorldState->MakeNext());
+				bool bDecoratorsPassed = false;
+				EnterDecorators(bDecoratorsPassed, TraceTestDecorators, Plan, StepID, /*bMustPass=*/false);
+			}
+		}
+	}
+}
+
+void UAITask_MakeHTNPlan::OnAsyncTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum, FHTNPlanningID TracePlanningID)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AI_HTN_Planning);
+
+	// Since tasks are pooled, this may be a trace submitted by a previous planning process of this task.
+	if (TracePlanningID != PlanningID || WasCancelled() || !bIsWaitingForAsyncTraces)
+	{
+		return;
+	}
+
+	if (TraceCache.OnAsyncTraceDone(TraceDatum))
+	{
+		UE_VLOG(this, LogHTN, VeryVerbose, TEXT("%s: finished waiting for async traces"), *GetLogPrefix());
+
+		// NextNodesIndex wasn't advanced, so this plans the node that was waiting for the traces again.
+		bIsWaitingForAsyncTraces = false;
+		DoPlanning();
+	}
+}
+
 void UAITask_MakeHTNPlan::OnNodeFinishedMakingPlanExpansions(const UHTNStandaloneNode* Node)
 {
 	if (ensure(Node && Node == CurrentPlanningContext.AddingNode))
@@ -711,6 +990,7 @@ void UAITask_MakeHTNPlan::OnNodeFinishedMakingPlanExpansions(const UHTNStandalon
 
 bool UAITask_MakeHTNPlan::EnterDecorators(bool& bOutDecoratorsPassed, const FHTNPlan& Plan, const FHTNPlanStepID& StepID, const UHTNStandaloneNode& Node) const
 {
+	TGuardValue<const UAITask_MakeHTNPlan*> ActivePlanningTaskGuard(OwnerComponent->GetActivePlanningTaskForCurrentThread(), this);
 	SET_NODE_FAILURE_REASON(TEXT(""));
 
 	// If starting a plan level, enter root decorators of this level.
@@ -767,6 +1047,7 @@ bool UAITask_MakeHTNPlan::ExitDecoratorsAndPropagateWorldState(FHTNPlan& Plan, c
 	const TSharedPtr<FBlackboardWorldState> WorldState = Step.WorldState;
 	check(WorldState.IsValid());
 	FGuardWorldStateProxy GuardProxy(*OwnerComponent->GetPlanningWorldStateProxy(), WorldState);
+	TGuardValue<const UAITask_MakeHTNPlan*> ActivePlanningTaskGuard(OwnerComponent->GetActivePlanningTaskForCurrentThread(), this);
 	
 	SET_NODE_FAILURE_REASON(TEXT(""));
 
@@ -790,7 +1071,7 @@ bool UAITask_MakeHTNPlan::ExitDecoratorsAndPropagateWorldState(FHTNPlan& Plan, c
 			TSharedPtr<FHTNPlanLevel>& ParentLevel = Plan.Levels[Level.ParentStepID.LevelIndex];
 			ParentLevel = MakeShared<FHTNPlanLevel>(*ParentLevel);
 			
-			FHTNPlanStep& ParentStep = ParentLevel->Steps[Level.ParentStepID.StepIndex];
+			FHTNPlanStep& ParentStep = ParentLevel->Steps.GetMutable(Level.ParentStepID.StepIndex);
 			check(!ParentStep.WorldState.IsValid());
 
 			const bool bIsParentStepFinished = ParentStep.Node->OnSubLevelFinishedPlanning(Plan, Level.ParentStepID, StepID.LevelIndex, WorldState);
@@ -861,6 +1142,7 @@ bool UAITask_MakeHTNPlan::ExitDecorators(TArrayView<UHTNDecorator* const> Decora
 void UAITask_MakeHTNPlan::ModifyStepCost(FHTNPlanStep& Step, const TArray<UHTNDecorator*>& Decorators) const
 {
 	FGuardWorldStateProxy GuardProxy(*OwnerComponent->GetPlanningWorldStateProxy(), Step.WorldState);
+	TGuardValue<const UAITask_MakeHTNPlan*> ActivePlanningTaskGuard(OwnerComponent->GetActivePlanningTaskForCurrentThread(), this);
 	for (int32 I = Decorators.Num() - 1; I >= 0; --I)
 	{
 		UHTNDecorator* const Decorator = Decorators[I];
@@ -878,6 +1160,12 @@ void UAITask_MakeHTNPlan::SubmitCandidatePlan(const TSharedRef<FHTNPlan>& NewPla
 		return;
 	}
 
+	NewPlan->RemainingCostLowerBound = Heuristic.GetRemainingCostLowerBound(*NewPlan);
+	if (Profile && AddedNode)
+	{
+		++Profile->FindOrAddNodeStats(*AddedNode).NumSubmittedPlans;
+	}
+
 	AddBlockingPriorityMarkersOf(*NewPlan);
 	if (!IsBlockedByPriorityMarkers(*NewPlan))
 	{
@@ -901,6 +1189,131 @@ void UAITask_MakeHTNPlan::ClearIntermediateState()
 	WorldStateAfterEnteredDecorators = nullptr;
 	CurrentPlanningContext = {};
 	bIsWaitingForNodeToMakePlanExpansions = false;
+	bIsWaitingForAsyncTraces = false;
+}
+
+void UAITask_MakeHTNPlan::AddProfiledPlanningTime()
+{
+	if (Profile)
+	{
+		Profile->TotalCycles += FPlatformTime::Cycles64() - DoPlanningStartCycles;
+		Profile->NumExpandedPlans = NumExpandedPlans;
+		DoPlanningStartCycles = FPlatformTime::Cycles64();
+	}
+}
+
+void UAITask_MakeHTNPlan::FinishPlanning()
+{
+	AddProfiledPlanningTime();
+	if (IsInGameThread())
+	{
+		EndTask();
+	}
+	else
+	{
+		bWorkerThreadPlanningEnded = true;
+	}
+}
+
+bool UAITask_MakeHTNPlan::ShouldPlanOnWorkerThread() const
+{
+	if (!OwnerComponent->bPlanOnWorkerThread || OwnerComponent->bIsPlanningOnWorkerThread || 
+		PlanningType != EHTNPlanningType::Normal || StartingPlan->RootNodeOverride.IsValid() ||
+		!FPlatformProcess::SupportsMultithreading())
+	{
+		return false;
+	}
+
+#if ENABLE_VISUAL_LOG
+	// Recording the planspace traversal for the visual logger isn't thread-safe.
+	if (FVisualLogger::IsRecording())
+	{
+		return false;
+	}
+#endif
+
+	FHTNWorkerThreadPlanningValidator Validator(TopLevelHTN);
+	if (!Validator.CanPlanOnWorkerThread(*TopLevelHTN))
+	{
+		UE_LOG(LogHTN, VeryVerbose, TEXT("%s: planning on the game thread because %s"), *GetLogPrefix(), *Validator.GetFailureReason());
+		return false;
+	}
+
+	return true;
+}
+
+void UAITask_MakeHTNPlan::StartPlanningOnWorkerThread()
+{
+	check(IsInGameThread());
+	check(!bIsPlanningOnWorkerThread);
+
+	bIsPlanningOnWorkerThread = true;
+	bWorkerThreadPlanningEnded = false;
+	bCancelWorkerThreadPlanning = false;
+	OwnerComponent->bIsPlanningOnWorkerThread = true;
+
+	const TWeakObjectPtr<UAITask_MakeHTNPlan> WeakThis = this;
+	const FHTNPlanningID WorkerThreadPlanningID = PlanningID;
+	WorkerThreadPlanningTask = UE::Tasks::Launch(TEXT("HTN Planning"), [this, WeakThis, WorkerThreadPlanningID]()
+	{
+		{
+			// The nodes and worldstates are only referenced through this task and the component, 
+			// so garbage collection must not run until the planning is done.
+			FGCScopeGuard GCGuard;
+			DoPlanning();
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, WorkerThreadPlanningID]()
+		{
+			if (UAITask_MakeHTNPlan* const Task = WeakThis.Get())
+			{
+				Task->OnWorkerThreadPlanningFinished(WorkerThreadPlanningID);
+			}
+		});
+	});
+}
+
+void UAITask_MakeHTNPlan::OnWorkerThreadPlanningFinished(FHTNPlanningID WorkerThreadPlanningID)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AI_HTN_Planning);
+
+	// The task may have been cancelled and reused for another planning by now.
+	if (WorkerThreadPlanningID != PlanningID || !bIsPlanningOnWorkerThread)
+	{
+		return;
+	}
+
+	WaitForWorkerThreadPlanning(/*bCancel=*/false);
+	if (bWorkerThreadPlanningEnded)
+	{
+		EndTask();
+	}
+	else
+	{
+		// Some node is making its plan expansions latently. FinishLatentMakePlanExpansions will continue planning on the game thread.
+		UE_VLOG(this, LogHTN, Log, TEXT("%s: worker thread planning is waiting for a node, continuing on the game thread."), *GetLogPrefix());
+	}
+}
+
+void UAITask_MakeHTNPlan::WaitForWorkerThreadPlanning(bool bCancel)
+{
+	if (!bIsPlanningOnWorkerThread)
+	{
+		return;
+	}
+
+	if (bCancel)
+	{
+		bCancelWorkerThreadPlanning = true;
+	}
+
+	WorkerThreadPlanningTask.Wait();
+	WorkerThreadPlanningTask = {};
+	bIsPlanningOnWorkerThread = false;
+	if (IsValid(OwnerComponent))
+	{
+		OwnerComponent->bIsPlanningOnWorkerThread = false;
+	}
 }
 
 void UAITask_MakeHTNPlan::AddBlockingPriorityMarkersOf(const FHTNPlan& Plan)
@@ -46,6 +46,11 @@ namespace
 			return StaticCast<const UBlackboardKeyTypeHelper*>(&KeyInstance)->TestArithmeticOperation(OwnerComp, MemoryBlock, Type, IntValue, FloatValue);
 		}
 		
+		FORCEINLINE static bool AreValuesEqualHelper(const UBlackboardKeyType& KeyInstance, const UBlackboardComponent& OwnerComp, const uint8* MemoryBlock, const UBlackboardKeyType& OtherKeyInstance, const uint8* OtherMemoryBlock)
+		{
+			return StaticCast<const UBlackboardKeyTypeHelper*>(&KeyInstance)->CompareValues(OwnerComp, MemoryBlock, &OtherKeyInstance, OtherMemoryBlock) == EBlackboardCompare::Equal;
+		}
+
 		FORCEINLINE static bool TestTextOperationHelper(const UBlackboardKeyType& KeyInstance, const UBlackboardComponent& OwnerComp, const uint8* MemoryBlock, ETextKeyOperation::Type Type, const FString& StringValue)
 		{
 			return StaticCast<const UBlackboardKeyTypeHelper*>(&KeyInstance)->TestTextOperation(OwnerComp, MemoryBlock, Type, StringValue);
@@ -130,23 +135,174 @@ namespace
 	};
 }
 
+
+namespace
+{
+	// When a worldstate is made from one with this many layers, the layers are flattened into a single base layer
+	// so that reading values that were not changed recently doesn't need to go through a long chain of layers.
+	constexpr int32 MaxWorldStateLayerDepth = 16;
+
+	FORCEINLINE uint64 GetKeyMaskBit(FBlackboard::FKey KeyID)
+	{
+		return StaticCast<uint64>(1) << (StaticCast<uint32>(KeyID) & 63);
+	}
+
+	// The memory of layers is aligned to this, and so is the memory of each key in non-base layers.
+	constexpr uint32 MaxKeyMemoryAlignment = 16;
+
+	// Key types don't report the alignment of their values, so assume the natural alignment of their size.
+	FORCEINLINE uint32 GetKeyMemoryAlignment(uint16 RawDataSize)
+	{
+		return FMath::Min(FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(RawDataSize, 1)), MaxKeyMemoryAlignment);
+	}
+}
+
+// A set of blackboard values in a copy-on-write chain of worldstates.
+// A base layer stores all keys, laid out the same way as the ValueMemory of the BlackboardComponent.
+// Other layers only store the keys that were written to on top of their Parent layer.
+struct FBlackboardWorldStateLayer : public FNoncopyable
+{
+	TSharedPtr<FBlackboardWorldStateLayer> Parent;
+
+	TWeakObjectPtr<UBlackboardComponent> BlackboardComponent;
+	TWeakObjectPtr<UBlackboardData> BlackboardAsset;
+
+	TArray<uint8, TAlignedHeapAllocator<MaxKeyMemoryAlignment>> ValueMemory;
+
+	// In a base layer, this is indexed by KeyID. In other layers, this is parallel to the Keys array.
+	// The key instances are kept alive by the worldstates referencing this layer.
+	TArray<UBlackboardKeyType*, TInlineAllocator<4>> KeyInstances;
+
+	// In a base layer, the offsets of the memory of each key in ValueMemory.
+	// Copied from the BlackboardComponent, since it may reinitialize with a different BlackboardData while this layer is alive.
+	TArray<uint16> BaseKeyOffsets;
+
+	// The keys stored in a non-base layer and the offsets of their memory in ValueMemory.
+	TArray<FBlackboard::FKey, TInlineAllocator<4>> Keys;
+	TArray<uint16, TInlineAllocator<4>> KeyOffsets;
+
+	// One bit per (KeyID % 64) of the keys stored in this layer. Used to skip layers without searching through the Keys.
+	uint64 KeyMask;
+
+	// The number of layers below this one.
+	int32 Depth;
+
+	bool bIsBaseLayer;
+
+	FBlackboardWorldStateLayer(const TWeakObjectPtr<UBlackboardComponent>& BlackboardComponent, 
+		const TWeakObjectPtr<UBlackboardData>& BlackboardAsset, 
+		const TSharedPtr<FBlackboardWorldStateLayer>& Parent = nullptr) :
+		Parent(Parent),
+		BlackboardComponent(BlackboardComponent),
+		BlackboardAsset(BlackboardAsset),
+		KeyMask(0),
+		Depth(Parent.IsValid() ? Parent->Depth + 1 : 0),
+		bIsBaseLayer(false)
+	{}
+
+	~FBlackboardWorldStateLayer()
+	{
+		if (!ensureMsgf(BlackboardComponent.IsValid() || !BlackboardAsset.IsValid(), TEXT("Could not destroy key values in a worldstate because the original blackboard component is no longer valid.")))
+		{
+			return;
+		}
+
+		if (!BlackboardAsset.IsValid())
+		{
+			return;
+		}
+
+		if (bIsBaseLayer)
+		{
+			for (UBlackboardData* It = BlackboardAsset.Get(); It; It = It->Parent)
+			{
+				for (int32 KeyIndex = 0; KeyIndex < It->Keys.Num(); ++KeyIndex)
+				{
+					FreeKeyValue(KeyIndex + StaticCast<int32>(It->GetFirstKeyID()));
+				}
+			}
+		}
+		else
+		{
+			for (const FBlackboard::FKey KeyID : Keys)
+			{
+				FreeKeyValue(KeyID);
+			}
+		}
+	}
+
+	FORCEINLINE int32 FindLocalKeyIndex(FBlackboard::FKey KeyID) const
+	{
+		return KeyMask & GetKeyMaskBit(KeyID) ? Keys.Find(KeyID) : INDEX_NONE;
+	}
+
+	// Returns the memory of the key if it's stored in this layer.
+	uint8* FindKeyRawData(FBlackboard::FKey KeyID, UBlackboardKeyType*& OutKeyInstance)
+	{
+		if (bIsBaseLayer)
+		{
+			if (ValueMemory.Num() && ensure(BaseKeyOffsets.Num()) && BaseKeyOffsets.IsValidIndex(KeyID))
+			{
+				check(ValueMemory.IsValidIndex(BaseKeyOffsets[KeyID]));
+				OutKeyInstance = KeyInstances.IsValidIndex(KeyID) ? KeyInstances[KeyID] : nullptr;
+				return ValueMemory.GetData() + BaseKeyOffsets[KeyID];
+			}
+		}
+		else
+		{
+			const int32 LocalKeyIndex = FindLocalKeyIndex(KeyID);
+			if (LocalKeyIndex != INDEX_NONE)
+			{
+				OutKeyInstance = KeyInstances[LocalKeyIndex];
+				return ValueMemory.GetData() + KeyOffsets[LocalKeyIndex];
+			}
+		}
+
+		return nullptr;
+	}
+
+private:
+	void FreeKeyValue(FBlackboard::FKey KeyID)
+	{
+		const FBlackboardEntry* const Entry = BlackboardAsset->GetKey(KeyID);
+		if (UBlackboardKeyType* const KeyType = Entry ? UNWRAP_TOBJECT_PTR(Entry->KeyType) : nullptr)
+		{
+			UBlackboardKeyType* KeyInstance = nullptr;
+			uint8* const KeyValueRawMemory = FindKeyRawData(KeyID, KeyInstance);
+			if (ensure(KeyValueRawMemory))
+			{
+				uint8* const KeyValueMemory = KeyType->HasInstance() ?
+					KeyValueRawMemory + sizeof(FBlackboardInstancedKeyMemory) :
+					KeyValueRawMemory;
+
+				UBlackboardKeyType* const Key = KeyType->HasInstance() ? KeyInstance : KeyType;
+				if (ensure(Key))
+				{
+					UBlackboardKeyTypeHelper::FreeMemoryHelper(Key, *BlackboardComponent, KeyValueMemory);
+				}
+			}
+		}
+	}
+};
+
 class FBlackboardWorldStateImpl
 {
 public:
-	
+
+	// Makes a layer containing all keys, with values copied from the Source.
 	template<typename SourceType>
-	static void InitializeKeys(FBlackboardWorldState& WorldState, const SourceType& Source)
+	static TSharedRef<FBlackboardWorldStateLayer> MakeBaseLayer(const FBlackboardWorldState& WorldState, const SourceType& Source)
 	{
 		check(WorldState.BlackboardComponent.IsValid());
 		check(WorldState.BlackboardAsset.IsValid());
-		check(!WorldState.bIsInitialized);
-		
-		const auto& SourceMemory = GetValueMemory(Source);
-		const TArray<UBlackboardKeyType*>& SourceKeyInstances = GetKeyInstances(Source);
+
 		UBlackboardComponent& BlackboardComponent = *WorldState.BlackboardComponent;
 
-		WorldState.ValueMemory.AddZeroed(SourceMemory.Num());
-		WorldState.KeyInstances.AddZeroed(SourceKeyInstances.Num());
+		const TSharedRef<FBlackboardWorldStateLayer> Layer = MakeShared<FBlackboardWorldStateLayer>(WorldState.BlackboardComponent, WorldState.BlackboardAsset);
+		Layer->bIsBaseLayer = true;
+		Layer->BaseKeyOffsets = UBlackboardComponentHelper::GetValueMemoryOffsets(BlackboardComponent);
+		Layer->ValueMemory.AddZeroed(GetValueMemory(BlackboardComponent).Num());
+		Layer->KeyInstances.AddZeroed(GetKeyInstances(BlackboardComponent).Num());
 		for (UBlackboardData* It = WorldState.BlackboardAsset.Get(); It; It = It->Parent)
 		{
 			for (int32 KeyIndex = 0; KeyIndex < It->Keys.Num(); ++KeyIndex)
@@ -154,22 +310,31 @@ public:
 				if (UBlackboardKeyType* const KeyType = It->Keys[KeyIndex].KeyType)
 				{
 					KeyType->PreInitialize(BlackboardComponent);
-					
+
 					const bool bKeyHasInstance = KeyType->HasInstance();
 					const uint16 MemoryOffset = bKeyHasInstance ? sizeof(FBlackboardInstancedKeyMemory) : 0;
 					const FBlackboard::FKey KeyID = KeyIndex + StaticCast<int32>(It->GetFirstKeyID());
 
-					const uint8* const SourceValueMemory = GetKeyRawDataConst(SourceMemory, BlackboardComponent, KeyID) + MemoryOffset;
-					UBlackboardKeyType* const SourceKey = bKeyHasInstance ? SourceKeyInstances[KeyID] : KeyType;
-					
-					uint8* const DestinationRawMemory = GetKeyRawData(WorldState.ValueMemory, BlackboardComponent, KeyID);
+					UBlackboardKeyType* SourceKeyInstance = nullptr;
+					const uint8* const SourceRawMemory = GetSourceKeyRawData(Source, BlackboardComponent, KeyID, SourceKeyInstance);
+					if (!ensure(SourceRawMemory))
+					{
+						continue;
+					}
+
+					const uint8* const SourceValueMemory = SourceRawMemory + MemoryOffset;
+					UBlackboardKeyType* const SourceKey = bKeyHasInstance ? SourceKeyInstance : KeyType;
+
+					UBlackboardKeyType* DestinationKeyInstance = nullptr;
+					uint8* const DestinationRawMemory = Layer->FindKeyRawData(KeyID, DestinationKeyInstance);
+					check(DestinationRawMemory);
 					uint8* const DestinationValueMemory = DestinationRawMemory + MemoryOffset;
 					UBlackboardKeyType* DestinationKey = KeyType;
 					if (bKeyHasInstance)
 					{
 						DestinationKey = UBlackboardKeyTypeHelper::MakeInstance(SourceKey, BlackboardComponent);
 						reinterpret_cast<FBlackboardInstancedKeyMemory*>(DestinationRawMemory)->KeyIdx = KeyID;
-						WorldState.KeyInstances[KeyID] = DestinationKey;
+						Layer->KeyInstances[KeyID] = DestinationKey;
 					}
 					UBlackboardKeyTypeHelper::InitializeMemoryHelper(DestinationKey, BlackboardComponent, DestinationValueMemory);
 
@@ -178,7 +343,62 @@ public:
 			}
 		}
 
-		WorldState.bIsInitialized = true;
+		return Layer;
+	}
+
+	// Makes an empty layer on top of the given one.
+	static TSharedRef<FBlackboardWorldStateLayer> MakeLayer(const FBlackboardWorldState& WorldState, const TSharedPtr<FBlackboardWorldStateLayer>& Parent)
+	{
+		check(Parent.IsValid());
+		return MakeShared<FBlackboardWorldStateLayer>(WorldState.BlackboardComponent, WorldState.BlackboardAsset, Parent);
+	}
+
+	// Adds the key to a non-base layer, copying its value from the layers below. Returns the memory of the key in the layer.
+	static uint8* AddKeyToLayer(FBlackboardWorldStateLayer& Layer, const FBlackboardWorldStateKeyHandle& Key, UBlackboardKeyType*& OutKeyInstance)
+	{
+		check(!Layer.bIsBaseLayer);
+		check(Key.IsValid());
+		check(Layer.FindLocalKeyIndex(Key.KeyID) == INDEX_NONE);
+
+		UBlackboardComponent& BlackboardComponent = *Layer.BlackboardComponent;
+
+		UBlackboardKeyType* SourceKeyInstance = nullptr;
+		const uint8* SourceRawMemory = nullptr;
+		for (FBlackboardWorldStateLayer* It = Layer.Parent.Get(); It && !SourceRawMemory; It = It->Parent.Get())
+		{
+			SourceRawMemory = It->FindKeyRawData(Key.KeyID, SourceKeyInstance);
+		}
+
+		if (!ensure(SourceRawMemory))
+		{
+			return nullptr;
+		}
+
+		// The source memory is in a different layer, so growing the memory of this one doesn't invalidate it.
+		const int32 DestinationOffset = Align(Layer.ValueMemory.Num(), GetKeyMemoryAlignment(Key.RawDataSize));
+		check(DestinationOffset <= MAX_uint16);
+		Layer.ValueMemory.AddZeroed(DestinationOffset + Key.RawDataSize - Layer.ValueMemory.Num());
+		uint8* const DestinationRawMemory = Layer.ValueMemory.GetData() + DestinationOffset;
+		uint8* const DestinationValueMemory = DestinationRawMemory + Key.DataOffset;
+
+		UBlackboardKeyType* const SourceKey = Key.bHasInstance ? SourceKeyInstance : Key.KeyType;
+		UBlackboardKeyType* DestinationKey = Key.KeyType;
+		if (Key.bHasInstance)
+		{
+			DestinationKey = UBlackboardKeyTypeHelper::MakeInstance(SourceKey, BlackboardComponent);
+			reinterpret_cast<FBlackboardInstancedKeyMemory*>(DestinationRawMemory)->KeyIdx = Key.KeyID;
+		}
+
+		Layer.Keys.Add(Key.KeyID);
+		Layer.KeyOffsets.Add(StaticCast<uint16>(DestinationOffset));
+		Layer.KeyInstances.Add(Key.bHasInstance ? DestinationKey : nullptr);
+		Layer.KeyMask |= GetKeyMaskBit(Key.KeyID);
+
+		UBlackboardKeyTypeHelper::InitializeMemoryHelper(DestinationKey, BlackboardComponent, DestinationValueMemory);
+		UBlackboardKeyTypeHelper::CopyValuesHelper(DestinationKey, BlackboardComponent, DestinationValueMemory, SourceKey, SourceRawMemory + Key.DataOffset);
+
+		OutKeyInstance = Key.bHasInstance ? DestinationKey : nullptr;
+		return DestinationRawMemory;
 	}
 
 	template<typename DestinationType>
@@ -187,31 +407,12 @@ public:
 		check(WorldState.BlackboardComponent.IsValid());
 		check(WorldState.BlackboardAsset.IsValid());
 
-		auto& DestinationMemory = GetValueMemory(Destination);
-		const TArray<UBlackboardKeyType*>& DestinationKeyInstances = GetKeyInstances(Destination);
-		UBlackboardComponent& BlackboardComponent = *WorldState.BlackboardComponent;
-		
 		for (int32 KeyIndex = 0; KeyIndex < WorldState.ChangedFlags.Num(); ++KeyIndex)
 		{
 			const FBlackboard::FKey KeyID(KeyIndex);
 			if (WorldState.ChangedFlags[KeyID])
 			{
-				if (const FBlackboardEntry* const Entry = WorldState.BlackboardAsset->GetKey(KeyID))
-				{
-					if (UBlackboardKeyType* const KeyType = Entry->KeyType)
-					{
-						const bool bKeyHasInstance = KeyType->HasInstance();
-						const uint16 MemoryOffset = bKeyHasInstance ? sizeof(FBlackboardInstancedKeyMemory) : 0;
-
-						const uint8* const SourceValueMemory = GetKeyRawDataConst(WorldState.ValueMemory, BlackboardComponent, KeyID) + MemoryOffset;
-						uint8* const DestinationValueMemory = GetKeyRawData(DestinationMemory, BlackboardComponent, KeyID) + MemoryOffset;
-
-						UBlackboardKeyType* const SourceKey = bKeyHasInstance ? WorldState.KeyInstances[KeyID] : KeyType;
-						UBlackboardKeyType* const DestinationKey = bKeyHasInstance ? DestinationKeyInstances[KeyID] : KeyType;
-						UBlackboardKeyTypeHelper::CopyValuesHelper(DestinationKey, BlackboardComponent, DestinationValueMemory, SourceKey, SourceValueMemory);
-						NotifyValueChanged(Destination, KeyID, *Entry, DestinationKey, MemoryOffset, DestinationValueMemory);
-					}
-				}
+				CopyKeyValue(WorldState, Destination, KeyID);
 			}
 		}
 	}
@@ -222,8 +423,17 @@ public:
 		check(WorldState.BlackboardComponent.IsValid());
 		check(WorldState.BlackboardAsset.IsValid());
 
-		auto& DestinationMemory = GetValueMemory(Destination);
-		const TArray<UBlackboardKeyType*>& DestinationKeyInstances = GetKeyInstances(Destination);
+		if (CopyKeyValue(WorldState, Destination, KeyID))
+		{
+			SetKeyChanged(Destination, KeyID);
+		}
+	}
+	
+private:
+
+	template<typename DestinationType>
+	static bool CopyKeyValue(const FBlackboardWorldState& WorldState, DestinationType& Destination, FBlackboard::FKey KeyID)
+	{
 		UBlackboardComponent& BlackboardComponent = *WorldState.BlackboardComponent;
 
 		if (const FBlackboardEntry* const Entry = WorldState.BlackboardAsset->GetKey(KeyID))
@@ -233,19 +443,29 @@ public:
 				const bool bKeyHasInstance = KeyType->HasInstance();
 				const uint16 MemoryOffset = bKeyHasInstance ? sizeof(FBlackboardInstancedKeyMemory) : 0;
 
-				const uint8* const SourceValueMemory = GetKeyRawDataConst(WorldState.ValueMemory, BlackboardComponent, KeyID) + MemoryOffset;
-				uint8* const DestinationValueMemory = GetKeyRawData(DestinationMemory, BlackboardComponent, KeyID) + MemoryOffset;
+				// Get the destination first, since making room for it in a worldstate may add a new layer to it.
+				UBlackboardKeyType* DestinationKeyInstance = nullptr;
+				uint8* const DestinationRawMemory = GetDestinationKeyRawData(Destination, BlackboardComponent, KeyID, DestinationKeyInstance);
+
+				UBlackboardKeyType* SourceKeyInstance = nullptr;
+				const uint8* const SourceRawMemory = WorldState.GetKeyRawData(KeyID, SourceKeyInstance);
 
-				UBlackboardKeyType* const SourceKey = bKeyHasInstance ? WorldState.KeyInstances[KeyID] : KeyType;
-				UBlackboardKeyType* const DestinationKey = bKeyHasInstance ? DestinationKeyInstances[KeyID] : KeyType;
-				UBlackboardKeyTypeHelper::CopyValuesHelper(DestinationKey, BlackboardComponent, DestinationValueMemory, SourceKey, SourceValueMemory);
-				NotifyValueChanged(Destination, KeyID, *Entry, DestinationKey, MemoryOffset, DestinationValueMemory);
-				SetKeyChanged(Destination, KeyID);
+				if (ensure(DestinationRawMemory && SourceRawMemory))
+				{
+					uint8* const DestinationValueMemory = DestinationRawMemory + MemoryOffset;
+					const uint8* const SourceValueMemory = SourceRawMemory + MemoryOffset;
+
+					UBlackboardKeyType* const SourceKey = bKeyHasInstance ? SourceKeyInstance : KeyType;
+					UBlackboardKeyType* const DestinationKey = bKeyHasInstance ? DestinationKeyInstance : KeyType;
+					UBlackboardKeyTypeHelper::CopyValuesHelper(DestinationKey, BlackboardComponent, DestinationValueMemory, SourceKey, SourceValueMemory);
+					NotifyValueChanged(Destination, KeyID, *Entry, DestinationKey, MemoryOffset, DestinationValueMemory);
+					return true;
+				}
 			}
 		}
+
+		return false;
 	}
-	
-private:
 
 	template<typename ValueMemoryArrayType>
 	static const uint8* GetKeyRawDataConst(const ValueMemoryArrayType& ValueMemory, const UBlackboardComponent& Blackboard, FBlackboard::FKey KeyID)
@@ -281,44 +501,48 @@ private:
 		return nullptr;
 	}
 
-	FORCEINLINE static const TArray<uint8>& GetValueMemory(const UBlackboardComponent& BlackboardComponent)
+	FORCEINLINE static const uint8* GetSourceKeyRawData(const UBlackboardComponent& Source, const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID, UBlackboardKeyType*& OutKeyInstance)
 	{
-		return UBlackboardComponentHelper::GetValueMemory(BlackboardComponent);
+		const TArray<UBlackboardKeyType*>& SourceKeyInstances = GetKeyInstances(Source);
+		OutKeyInstance = SourceKeyInstances.IsValidIndex(KeyID) ? SourceKeyInstances[KeyID] : nullptr;
+		return GetKeyRawDataConst(GetValueMemory(Source), BlackboardComponent, KeyID);
 	}
 
-	FORCEINLINE static TArray<uint8>& GetValueMemory(UBlackboardComponent& BlackboardComponent)
+	FORCEINLINE static const uint8* GetSourceKeyRawData(const FBlackboardWorldState& Source, const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID, UBlackboardKeyType*& OutKeyInstance)
 	{
-		return UBlackboardComponentHelper::GetValueMemory(BlackboardComponent);
+		return Source.GetKeyRawData(KeyID, OutKeyInstance);
 	}
 
-	FORCEINLINE static const auto& GetValueMemory(const FBlackboardWorldState& WorldState)
+	FORCEINLINE static uint8* GetDestinationKeyRawData(UBlackboardComponent& Destination, const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID, UBlackboardKeyType*& OutKeyInstance)
 	{
-		return WorldState.ValueMemory;
+		const TArray<UBlackboardKeyType*>& DestinationKeyInstances = GetKeyInstances(Destination);
+		OutKeyInstance = DestinationKeyInstances.IsValidIndex(KeyID) ? DestinationKeyInstances[KeyID] : nullptr;
+		return GetKeyRawData(GetValueMemory(Destination), BlackboardComponent, KeyID);
 	}
 
-	FORCEINLINE static auto& GetValueMemory(FBlackboardWorldState& WorldState)
+	FORCEINLINE static uint8* GetDestinationKeyRawData(FBlackboardWorldState& Destination, const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID, UBlackboardKeyType*& OutKeyInstance)
 	{
-		return WorldState.ValueMemory;
+		return Destination.GetKeyRawDataForWrite(KeyID, OutKeyInstance);
 	}
 
-	FORCEINLINE static const TArray<UBlackboardKeyType*>& GetKeyInstances(const UBlackboardComponent& BlackboardComponent)
+	FORCEINLINE static const TArray<uint8>& GetValueMemory(const UBlackboardComponent& BlackboardComponent)
 	{
-		return UBlackboardComponentHelper::GetKeyInstances(BlackboardComponent);
+		return UBlackboardComponentHelper::GetValueMemory(BlackboardComponent);
 	}
 
-	FORCEINLINE static TArray<UBlackboardKeyType*>& GetKeyInstances(UBlackboardComponent& BlackboardComponent)
+	FORCEINLINE static TArray<uint8>& GetValueMemory(UBlackboardComponent& BlackboardComponent)
 	{
-		return UBlackboardComponentHelper::GetKeyInstances(BlackboardComponent);
+		return UBlackboardComponentHelper::GetValueMemory(BlackboardComponent);
 	}
 
-	FORCEINLINE static const TArray<UBlackboardKeyType*>& GetKeyInstances(const FBlackboardWorldState& WorldState)
+	FORCEINLINE static const TArray<UBlackboardKeyType*>& GetKeyInstances(const UBlackboardComponent& BlackboardComponent)
 	{
-		return WorldState.KeyInstances;
+		return UBlackboardComponentHelper::GetKeyInstances(BlackboardComponent);
 	}
 
-	FORCEINLINE static TArray<UBlackboardKeyType*>& GetKeyInstances(FBlackboardWorldState& WorldState)
+	FORCEINLINE static TArray<UBlackboardKeyType*>& GetKeyInstances(UBlackboardComponent& BlackboardComponent)
 	{
-		return WorldState.KeyInstances;
+		return UBlackboardComponentHelper::GetKeyInstances(BlackboardComponent);
 	}
 
 	FORCEINLINE static void NotifyValueChanged(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID, const FBlackboardEntry& Entry, UBlackboardKeyType* DestinationKey, uint16 MemoryOffset, const uint8* SourceValueMemory)
@@ -342,19 +566,68 @@ private:
 	}
 };
 
+FBlackboardWorldStateKeyHandle::FBlackboardWorldStateKeyHandle() :
+	KeyID(FBlackboard::InvalidKey),
+	KeyType(nullptr),
+	KeyClass(nullptr),
+	DataOffset(0),
+	RawDataSize(0),
+	bHasInstance(false)
+{}
+
+FBlackboardWorldStateKeyHandle::FBlackboardWorldStateKeyHandle(const UBlackboardData& BlackboardAsset, FBlackboard::FKey KeyID) : 
+	FBlackboardWorldStateKeyHandle()
+{
+	Resolve(BlackboardAsset, KeyID);
+}
+
+bool FBlackboardWorldStateKeyHandle::Resolve(const UBlackboardData& BlackboardAsset, FBlackboard::FKey InKeyID)
+{
+	const FBlackboardEntry* const Entry = InKeyID != FBlackboard::InvalidKey ? BlackboardAsset.GetKey(InKeyID) : nullptr;
+	UBlackboardKeyType* const EntryKeyType = Entry ? UNWRAP_TOBJECT_PTR(Entry->KeyType) : nullptr;
+	if (!EntryKeyType)
+	{
+		Invalidate();
+		return false;
+	}
+
+	KeyID = InKeyID;
+	KeyType = EntryKeyType;
+	KeyClass = EntryKeyType->GetClass();
+	bHasInstance = EntryKeyType->HasInstance();
+	DataOffset = bHasInstance ? sizeof(FBlackboardInstancedKeyMemory) : 0;
+	RawDataSize = EntryKeyType->GetValueSize() + DataOffset;
+	return true;
+}
+
+bool FBlackboardWorldStateKeyHandle::Resolve(const UBlackboardData& BlackboardAsset, const FBlackboardKeySelector& KeySelector)
+{
+	return Resolve(BlackboardAsset, KeySelector.GetSelectedKeyID());
+}
+
+void FBlackboardWorldStateKeyHandle::Invalidate()
+{
+	*this = FBlackboardWorldStateKeyHandle();
+}
+
 FBlackboardWorldState::FBlackboardWorldState() :
-	bIsInitialized(false)
+	ReadKeysRecorder(nullptr),
+	bIsInitialized(false),
+	bIsTopLayerShared(false)
 {}
 
 FBlackboardWorldState::FBlackboardWorldState(UBlackboardComponent& Blackboard) :
 	BlackboardComponent(&Blackboard),
 	BlackboardAsset(Blackboard.GetBlackboardAsset()),
-	bIsInitialized(false)
+	ReadKeysRecorder(nullptr),
+	bIsInitialized(false),
+	bIsTopLayerShared(false)
 {
 	check(BlackboardComponent.IsValid());
 	check(BlackboardAsset.IsValid());
 	
-	FBlackboardWorldStateImpl::InitializeKeys(*this, Blackboard);
+	TopLayer = FBlackboardWorldStateImpl::MakeBaseLayer(*this, Blackboard);
+	bIsInitialized = true;
 }
 
 FBlackboardWorldState::~FBlackboardWorldState()
@@ -366,7 +639,17 @@ void FBlackboardWorldState::AddReferencedObjects(FReferenceCollector& Collector)
 {
 	if (bIsInitialized)
 	{
-		Collector.AddReferencedObjects(KeyInstances);
+		// Layers shared with other worldstates are reported by each of them, which is harmless.
+		for (FBlackboardWorldStateLayer* Layer = TopLayer.Get(); Layer; Layer = Layer->Parent.Get())
+		{
+			for (UBlackboardKeyType*& KeyInstance : Layer->KeyInstances)
+			{
+				if (KeyInstance)
+				{
+					Collector.AddReferencedObject(KeyInstance);
+				}
+			}
+		}
 	}
 }
 
@@ -375,21 +658,42 @@ FString FBlackboardWorldState::GetReferencerName() const
 	return TEXT("FBlackboardWorldState");
 }
 
+static thread_local uint32 GNumWorldStatesMadeOnThisThread = 0;
+
 TSharedRef<FBlackboardWorldState> FBlackboardWorldState::MakeNext() const
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FBlackboardWorldState::MakeNext"), STAT_AI_HTN_WorldStateMakeNext, STATGROUP_AI_HTN);
+	++GNumWorldStatesMadeOnThisThread;
 	
 	check(BlackboardComponent.IsValid());
 	check(BlackboardAsset.IsValid());
+	check(TopLayer.IsValid());
 	
 	const TSharedRef<FBlackboardWorldState> NextWorldstate = MakeShared<FBlackboardWorldState>();
 	NextWorldstate->BlackboardComponent = BlackboardComponent;
 	NextWorldstate->BlackboardAsset = BlackboardAsset;
-	FBlackboardWorldStateImpl::InitializeKeys(*NextWorldstate, *this);
+	if (TopLayer->Depth < MaxWorldStateLayerDepth)
+	{
+		// Share the values instead of copying them. 
+		// Whichever of the two worldstates is written to first will put a new layer on top of the shared one.
+		NextWorldstate->TopLayer = TopLayer;
+		NextWorldstate->bIsTopLayerShared = true;
+		bIsTopLayerShared = true;
+	}
+	else
+	{
+		NextWorldstate->TopLayer = FBlackboardWorldStateImpl::MakeBaseLayer(*NextWorldstate, *this);
+	}
+	NextWorldstate->bIsInitialized = true;
 	
 	return NextWorldstate;
 }
 
+uint32 FBlackboardWorldState::GetNumMadeOnThisThread()
+{
+	return GNumWorldStatesMadeOnThisThread;
+}
+
 void FBlackboardWorldState::ApplyChangedValues(UBlackboardComponent& Blackboard) const
 {
 	FBlackboardWorldStateImpl::ApplyChangedValues(*this, Blackboard);
@@ -502,39 +806,115 @@ bool FBlackboardWorldState::IsCompatible(const FBlackboardWorldState& Other) con
 		BlackboardAsset.IsValid();
 }
 
-void FBlackboardWorldState::DestroyValues()
+bool FBlackboardWorldState::HasEqualValues(const FBlackboardWorldState& Other, const TBitArray<>& KeyIDs) const
 {
-	if (!ensureMsgf(BlackboardComponent.IsValid() || !BlackboardAsset.IsValid(), TEXT("Could not destroy key values in a worldstate because the original blackboard component is no longer valid.")))
+	if (!IsCompatible(Other))
 	{
-		return;
+		return false;
 	}
 
-	for (UBlackboardData* It = BlackboardAsset.Get(); It; It = It->Parent)
+	for (TConstSetBitIterator<> It(KeyIDs); It; ++It)
 	{
-		for (int32 KeyIndex = 0; KeyIndex < It->Keys.Num(); KeyIndex++)
+		if (!HasEqualValue(Other, StaticCast<FBlackboard::FKey>(It.GetIndex())))
 		{
-			if (UBlackboardKeyType* const KeyType = It->Keys[KeyIndex].KeyType)
-			{
-				const FBlackboard::FKey KeyID = KeyIndex + StaticCast<int32>(It->GetFirstKeyID());
-				uint8* const KeyValueRawMemory = GetKeyRawData(KeyID);
-				if (ensure(KeyValueRawMemory))
-				{
-					uint8* const KeyValueMemory = KeyType->HasInstance() ? 
-						KeyValueRawMemory + sizeof(FBlackboardInstancedKeyMemory) :
-						KeyValueRawMemory;
-					
-					UBlackboardKeyType* const Key = KeyType->HasInstance() ? KeyInstances[KeyID] : KeyType;
-					if (ensure(Key))
-					{
-						UBlackboardKeyTypeHelper::FreeMemoryHelper(Key, *BlackboardComponent, KeyValueMemory);
-					}
-				}
-			}
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FBlackboardWorldState::HasEqualValues(const FBlackboardWorldState& Other) const
+{
+	if (!IsCompatible(Other))
+	{
+		return false;
+	}
+
+	if (TopLayer == Other.TopLayer)
+	{
+		return true;
+	}
+
+	for (int32 KeyIndex = 0; KeyIndex < BlackboardAsset->GetNumKeys(); ++KeyIndex)
+	{
+		if (!HasEqualValue(Other, StaticCast<FBlackboard::FKey>(KeyIndex)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32 FBlackboardWorldState::GetValuesHash() const
+{
+	uint32 Hash = 0;
+	if (!BlackboardAsset.IsValid() || !BlackboardComponent.IsValid())
+	{
+		return Hash;
+	}
+
+	for (int32 KeyIndex = 0; KeyIndex < BlackboardAsset->GetNumKeys(); ++KeyIndex)
+	{
+		const FBlackboard::FKey KeyID = StaticCast<FBlackboard::FKey>(KeyIndex);
+		const FBlackboardEntry* const Entry = BlackboardAsset->GetKey(KeyID);
+
+		// Instanced keys and strings don't store their values inline, so hashing their memory would make equal values hash differently.
+		// They are left out of the hash and only compared by HasEqualValues.
+		if (!Entry || !Entry->KeyType || Entry->KeyType->HasInstance() || Entry->KeyType->IsA<UBlackboardKeyType_String>())
+		{
+			continue;
+		}
+
+		UBlackboardKeyType* KeyInstance = nullptr;
+		if (const uint8* const RawMemory = GetKeyRawData(KeyID, KeyInstance))
+		{
+			Hash = FCrc::MemCrc32(RawMemory, Entry->KeyType->GetValueSize(), Hash);
 		}
 	}
 
-	ValueMemory.Reset();
-	KeyInstances.Reset();
+	return Hash;
+}
+
+bool FBlackboardWorldState::HasEqualValue(const FBlackboardWorldState& Other, FBlackboard::FKey KeyID) const
+{
+	const FBlackboardEntry* const Entry = BlackboardAsset->GetKey(KeyID);
+	if (!Entry || !Entry->KeyType)
+	{
+		return true;
+	}
+
+	UBlackboardKeyType* KeyInstance = nullptr;
+	UBlackboardKeyType* OtherKeyInstance = nullptr;
+	const uint8* const RawMemory = GetKeyRawData(KeyID, KeyInstance);
+	const uint8* const OtherRawMemory = Other.GetKeyRawData(KeyID, OtherKeyInstance);
+	if (RawMemory == OtherRawMemory)
+	{
+		// Both worldstates read the value from the same shared layer.
+		return true;
+	}
+
+	if (!RawMemory || !OtherRawMemory)
+	{
+		return false;
+	}
+
+	if (Entry->KeyType->HasInstance())
+	{
+		return KeyInstance && OtherKeyInstance && UBlackboardKeyTypeHelper::AreValuesEqualHelper(
+			*KeyInstance, *BlackboardComponent, RawMemory + sizeof(FBlackboardInstancedKeyMemory),
+			*OtherKeyInstance, OtherRawMemory + sizeof(FBlackboardInstancedKeyMemory));
+	}
+
+	return UBlackboardKeyTypeHelper::AreValuesEqualHelper(*Entry->KeyType, *BlackboardComponent, RawMemory, *Entry->KeyType, OtherRawMemory);
+}
+
+void FBlackboardWorldState::DestroyValues()
+{
+	// The values are freed by the layers themselves once no worldstate references them anymore.
+	TopLayer.Reset();
+	bIsTopLayerShared = false;
 }
 
 void FBlackboardWorldState::ClearValue(FBlackboard::FKey KeyID)
@@ -546,7 +926,8 @@ void FBlackboardWorldState::ClearValue(FBlackboard::FKey KeyID)
 	{
 		if (const UBlackboardKeyType* const KeyType = EntryInfo->KeyType)
 		{
-			if (uint8* const RawData = GetKeyRawData(KeyID))
+			UBlackboardKeyType* KeyInstance = nullptr;
+			if (uint8* const RawData = GetKeyRawDataForWrite(KeyID, KeyInstance))
 			{
 				KeyType->WrappedClear(*BlackboardComponent, RawData);
 				SetKeyChanged(KeyID);
@@ -563,7 +944,7 @@ bool FBlackboardWorldState::CopyKeyValue(FBlackboard::FKey SourceKeyID, FBlackbo
 	}
 
 	// Copy only when values are initialized
-	if (ValueMemory.Num() == 0)
+	if (!TopLayer.IsValid())
 	{
 		return false;
 	}
@@ -591,15 +972,27 @@ bool FBlackboardWorldState::CopyKeyValue(FBlackboard::FKey SourceKeyID, FBlackbo
 	const bool bKeyHasInstance = SourceValueEntryInfo->KeyType->HasInstance();
 	const uint16 MemDataOffset = bKeyHasInstance ? sizeof(FBlackboardInstancedKeyMemory) : 0;
 
+	// Get the target first: making room for it in the top layer may move the memory of that layer.
+	UBlackboardKeyType* TargetKeyInstance = nullptr;
+	uint8* const TargetRawData = GetKeyRawDataForWrite(TargetKeyID, TargetKeyInstance);
+
+	UBlackboardKeyType* SourceKeyInstance = nullptr;
+	const uint8* const SourceRawData = GetKeyRawData(SourceKeyID, SourceKeyInstance);
+
+	if (!ensure(TargetRawData && SourceRawData))
+	{
+		return false;
+	}
+
 	const UBlackboardKeyType* const SourceKeyOb = bKeyHasInstance ? 
-		KeyInstances[SourceKeyID] : 
+		SourceKeyInstance : 
 		UNWRAP_TOBJECT_PTR(SourceValueEntryInfo->KeyType);
-	const uint8* SourceValueData = GetKeyRawData(SourceKeyID) + MemDataOffset;
+	const uint8* const SourceValueData = SourceRawData + MemDataOffset;
 
 	UBlackboardKeyType* const TargetKeyOb = bKeyHasInstance ? 
-		KeyInstances[TargetKeyID] : 
+		TargetKeyInstance : 
 		UNWRAP_TOBJECT_PTR(TargetValueEntryInfo->KeyType);
-	uint8* const TargetValueData = GetKeyRawData(TargetKeyID) + MemDataOffset;
+	uint8* const TargetValueData = TargetRawData + MemDataOffset;
 
 	UBlackboardKeyTypeHelper::CopyValuesHelper(TargetKeyOb, *BlackboardComponent, TargetValueData, SourceKeyOb, SourceValueData);
 	SetKeyChanged(TargetKeyID);
@@ -611,12 +1004,12 @@ bool FBlackboardWorldState::TestBasicOperation(const UBlackboardKeyType& Key, FB
 {
 	check(BlackboardComponent.IsValid());
 	
-	const uint8* const RawMemory = GetKeyRawData(KeyID);
+	UBlackboardKeyType* KeyInstance = nullptr;
+	const uint8* const RawMemory = GetKeyRawData(KeyID, KeyInstance);
 	if (ensure(RawMemory))
 	{
 		if (Key.HasInstance())
 		{
-			const UBlackboardKeyType* const KeyInstance = KeyInstances.IsValidIndex(KeyID) ? KeyInstances[KeyID] : nullptr;
 			if (ensure(KeyInstance))
 			{
 				const uint8* KeyValueMemory = RawMemory + sizeof(FBlackboardInstancedKeyMemory);
@@ -637,12 +1030,12 @@ bool FBlackboardWorldState::TestArithmeticOperation(const UBlackboardKeyType& Ke
 {
 	check(BlackboardComponent.IsValid());
 
-	const uint8* const RawMemory = GetKeyRawData(KeyID);
+	UBlackboardKeyType* KeyInstance = nullptr;
+	const uint8* const RawMemory = GetKeyRawData(KeyID, KeyInstance);
 	if (ensure(RawMemory))
 	{
 		if (Key.HasInstance())
 		{
-			const UBlackboardKeyType* const KeyInstance = KeyInstances.IsValidIndex(KeyID) ? KeyInstances[KeyID] : nullptr;
 			if (ensure(KeyInstance))
 			{
 				const uint8* KeyValueMemory = RawMemory + sizeof(FBlackboardInstancedKeyMemory);
@@ -663,12 +1056,12 @@ bool FBlackboardWorldState::TestTextOperation(const UBlackboardKeyType& Key, FBl
 {
 	check(BlackboardComponent.IsValid());
 
-	const uint8* const RawMemory = GetKeyRawData(KeyID);
+	UBlackboardKeyType* KeyInstance = nullptr;
+	const uint8* const RawMemory = GetKeyRawData(KeyID, KeyInstance);
 	if (ensure(RawMemory))
 	{
 		if (Key.HasInstance())
 		{
-			const UBlackboardKeyType* const KeyInstance = KeyInstances.IsValidIndex(KeyID) ? KeyInstances[KeyID] : nullptr;
 			if (ensure(KeyInstance))
 			{
 				const uint8* KeyValueMemory = RawMemory + sizeof(FBlackboardInstancedKeyMemory);
@@ -684,6 +1077,21 @@ bool FBlackboardWorldState::TestTextOperation(const UBlackboardKeyType& Key, FBl
 	return false;
 }
 
+bool FBlackboardWorldState::TestBasicOperation(const FBlackboardWorldStateKeyHandle& Key, EBasicKeyOperation::Type Type) const
+{
+	return Key.IsValid() && TestBasicOperation(*Key.KeyType, Key.KeyID, Type);
+}
+
+bool FBlackboardWorldState::TestArithmeticOperation(const FBlackboardWorldStateKeyHandle& Key, EArithmeticKeyOperation::Type Type, int32 IntValue, float FloatValue) const
+{
+	return Key.IsValid() && TestArithmeticOperation(*Key.KeyType, Key.KeyID, Type, IntValue, FloatValue);
+}
+
+bool FBlackboardWorldState::TestTextOperation(const FBlackboardWorldStateKeyHandle& Key, ETextKeyOperation::Type Type, const FString& StringValue) const
+{
+	return Key.IsValid() && TestTextOperation(*Key.KeyType, Key.KeyID, Type, StringValue);
+}
+
 bool FBlackboardWorldState::IsVectorValueSet(FBlackboard::FKey KeyID) const
 {
 	const FVector VectorValue = GetValue<UBlackboardKeyType_Vector>(KeyID);
@@ -694,13 +1102,12 @@ bool FBlackboardWorldState::GetLocationFromEntry(FBlackboard::FKey KeyID, FVecto
 {
 	if (BlackboardComponent.IsValid() && BlackboardAsset.IsValid())
 	{
-		const TArray<uint16>& MemoryOffsets = UBlackboardComponentHelper::GetValueMemoryOffsets(*BlackboardComponent);
-		if (MemoryOffsets.IsValidIndex(KeyID))
+		const FBlackboardEntry* const EntryInfo = BlackboardAsset->GetKey(KeyID);
+		if (EntryInfo && EntryInfo->KeyType)
 		{
-			const FBlackboardEntry* const EntryInfo = BlackboardAsset->GetKey(KeyID);
-			if (EntryInfo && EntryInfo->KeyType)
+			UBlackboardKeyType* KeyInstance = nullptr;
+			if (const uint8* const ValueData = GetKeyRawData(KeyID, KeyInstance))
 			{
-				const uint8* const ValueData = ValueMemory.GetData() + MemoryOffsets[KeyID];
 				return EntryInfo->KeyType->WrappedGetLocation(*BlackboardComponent, ValueData, ResultLocation);
 			}
 		}
@@ -713,13 +1120,12 @@ bool FBlackboardWorldState::GetRotationFromEntry(FBlackboard::FKey KeyID, FRotat
 {
 	if (BlackboardComponent.IsValid() && BlackboardAsset.IsValid())
 	{
-		const TArray<uint16>& MemoryOffsets = UBlackboardComponentHelper::GetValueMemoryOffsets(*BlackboardComponent);
-		if (MemoryOffsets.IsValidIndex(KeyID))
+		const FBlackboardEntry* const EntryInfo = BlackboardAsset->GetKey(KeyID);
+		if (EntryInfo && EntryInfo->KeyType)
 		{
-			const FBlackboardEntry* const EntryInfo = BlackboardAsset->GetKey(KeyID);
-			if (EntryInfo && EntryInfo->KeyType)
+			UBlackboardKeyType* KeyInstance = nullptr;
+			if (const uint8* const ValueData = GetKeyRawData(KeyID, KeyInstance))
 			{
-				const uint8* const ValueData = ValueMemory.GetData() + MemoryOffsets[KeyID];
 				return EntryInfo->KeyType->WrappedGetRotation(*BlackboardComponent, ValueData, ResultRotation);
 			}
 		}
@@ -730,22 +1136,61 @@ bool FBlackboardWorldState::GetRotationFromEntry(FBlackboard::FKey KeyID, FRotat
 
 uint8* FBlackboardWorldState::GetKeyRawData(FBlackboard::FKey KeyID)
 {
-	if (ValueMemory.Num())
+	UBlackboardKeyType* KeyInstance = nullptr;
+	return GetKeyRawDataForWrite(KeyID, KeyInstance);
+}
+
+const uint8* FBlackboardWorldState::GetKeyRawData(FBlackboard::FKey KeyID) const
+{
+	UBlackboardKeyType* KeyInstance = nullptr;
+	return GetKeyRawData(KeyID, KeyInstance);
+}
+
+const uint8* FBlackboardWorldState::GetKeyRawData(FBlackboard::FKey KeyID, UBlackboardKeyType*& OutKeyInstance) const
+{
+	OutKeyInstance = nullptr;
+	if (!BlackboardComponent.IsValid())
 	{
-		const TArray<uint16>& MemoryOffsets = UBlackboardComponentHelper::GetValueMemoryOffsets(*BlackboardComponent);
-		if (ensure(MemoryOffsets.Num()) && MemoryOffsets.IsValidIndex(KeyID))
+		return nullptr;
+	}
+
+	if (ReadKeysRecorder && ReadKeysRecorder->IsValidIndex(KeyID))
+	{
+		(*ReadKeysRecorder)[KeyID] = true;
+	}
+
+	for (FBlackboardWorldStateLayer* Layer = TopLayer.Get(); Layer; Layer = Layer->Parent.Get())
+	{
+		if (const uint8* const RawData = Layer->FindKeyRawData(KeyID, OutKeyInstance))
 		{
-			check(ValueMemory.IsValidIndex(MemoryOffsets[KeyID]));
-			return ValueMemory.GetData() + MemoryOffsets[KeyID];
+			return RawData;
 		}
 	}
 
 	return nullptr;
 }
 
-const uint8* FBlackboardWorldState::GetKeyRawData(FBlackboard::FKey KeyID) const
+uint8* FBlackboardWorldState::GetKeyRawDataForWrite(const FBlackboardWorldStateKeyHandle& Key, UBlackboardKeyType*& OutKeyInstance)
 {
-	return const_cast<FBlackboardWorldState*>(this)->GetKeyRawData(KeyID);
+	OutKeyInstance = nullptr;
+	if (!TopLayer.IsValid() || !Key.IsValid() || !BlackboardComponent.IsValid())
+	{
+		return nullptr;
+	}
+
+	// The top layer is also referenced by other worldstates, so writing to it would change their values too.
+	if (bIsTopLayerShared)
+	{
+		TopLayer = FBlackboardWorldStateImpl::MakeLayer(*this, TopLayer);
+		bIsTopLayerShared = false;
+	}
+
+	if (uint8* const RawData = TopLayer->FindKeyRawData(Key.KeyID, OutKeyInstance))
+	{
+		return RawData;
+	}
+
+	return FBlackboardWorldStateImpl::AddKeyToLayer(*TopLayer, Key, OutKeyInstance);
 }
 
 FVector FBlackboardWorldState::GetLocation(const FBlackboardKeySelector& KeySelector, AActor** OutActor) const
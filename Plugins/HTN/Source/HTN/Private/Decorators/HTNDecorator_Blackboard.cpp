@@ -11,6 +11,8 @@ UHTNDecorator_Blackboard::UHTNDecorator_Blackboard(const FObjectInitializer& Ini
 {
 	// If bCheckConditionOnTick is enabled, then we only want to actually check on the first tick, and then rely on blackboard events to handle condition changes.
 	bCheckConditionOnTickOnlyOnce = true;
+	bConditionOnlyDependsOnWorldState = true;
+	bCanPlanOnWorkerThread = true;
 }
 
 FString UHTNDecorator_Blackboard::GetNodeName() const
@@ -173,30 +175,25 @@ EBlackboardNotificationResult UHTNDecorator_Blackboard::OnBlackboardKeyValueChan
 bool UHTNDecorator_Blackboard::EvaluateConditionOnWorldState(const UWorldStateProxy& WorldStateProxy) const
 {
 	bool bResult = false;
-	if (BlackboardKey.SelectedKeyType)
+	if (BlackboardKeyHandle.IsValid())
 	{
-		const UBlackboardKeyType* const KeyCDO = BlackboardKey.SelectedKeyType->GetDefaultObject<UBlackboardKeyType>();
-		const FBlackboard::FKey KeyID = BlackboardKey.GetSelectedKeyID();
-		if (ensure(KeyCDO))
+		const EBlackboardKeyOperation::Type Op = BlackboardKeyHandle.KeyType->GetTestOperation();
+		switch (Op)
 		{
-			const EBlackboardKeyOperation::Type Op = KeyCDO->GetTestOperation();
-			switch (Op)
-			{
-			case EBlackboardKeyOperation::Basic:
-				bResult = WorldStateProxy.TestBasicOperation(*KeyCDO, KeyID, StaticCast<EBasicKeyOperation::Type>(OperationType));
-				break;
+		case EBlackboardKeyOperation::Basic:
+			bResult = WorldStateProxy.TestBasicOperation(BlackboardKeyHandle, StaticCast<EBasicKeyOperation::Type>(OperationType));
+			break;
 
-			case EBlackboardKeyOperation::Arithmetic:
-				bResult = WorldStateProxy.TestArithmeticOperation(*KeyCDO, KeyID, StaticCast<EArithmeticKeyOperation::Type>(OperationType), IntValue, FloatValue);
-				break;
+		case EBlackboardKeyOperation::Arithmetic:
+			bResult = WorldStateProxy.TestArithmeticOperation(BlackboardKeyHandle, StaticCast<EArithmeticKeyOperation::Type>(OperationType), IntValue, FloatValue);
+			break;
 
-			case EBlackboardKeyOperation::Text:
-				bResult = WorldStateProxy.TestTextOperation(*KeyCDO, KeyID, StaticCast<ETextKeyOperation::Type>(OperationType), StringValue);
-				break;
+		case EBlackboardKeyOperation::Text:
+			bResult = WorldStateProxy.TestTextOperation(BlackboardKeyHandle, StaticCast<ETextKeyOperation::Type>(OperationType), StringValue);
+			break;
 
-			default:
-				break;
-			}
+		default:
+			break;
 		}
 	}
 
@@ -17,11 +17,13 @@ void UHTNDecorator_BlackboardBase::InitializeFromAsset(UHTN& Asset)
 	if (const UBlackboardData* const BBAsset = GetBlackboardAsset())
 	{
 		BlackboardKey.ResolveSelectedKey(*BBAsset);
+		BlackboardKeyHandle.Resolve(*BBAsset, BlackboardKey);
 	}
 	else
 	{
 		UE_LOG(LogHTN, Warning, TEXT("Can't initialize %s due to missing blackboard data."), *GetShortDescription());
 		BlackboardKey.InvalidateResolvedKey();
+		BlackboardKeyHandle.Invalidate();
 	}
 }
 
@@ -26,6 +26,7 @@ UHTNDecorator_FocusScope::UHTNDecorator_FocusScope(const FObjectInitializer& Ini
 	FocusTarget.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, FocusTarget), AActor::StaticClass());
 	FocusTarget.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, FocusTarget));
 	FocusTarget.AddRotatorFilter(this, GET_MEMBER_NAME_CHECKED(ThisClass, FocusTarget));
+	bCanPlanOnWorkerThread = true;
 }
 
 FString UHTNDecorator_FocusScope::GetNodeName() const
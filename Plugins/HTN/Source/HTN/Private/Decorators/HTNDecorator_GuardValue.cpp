@@ -24,6 +24,7 @@ UHTNDecorator_GuardValue::UHTNDecorator_GuardValue(const FObjectInitializer& Ini
 	bNotifyExecutionFinish = true;
 
 	bNotifyOnBlackboardKeyValueChange = false;
+	bCanPlanOnWorkerThread = true;
 }
 
 uint16 UHTNDecorator_GuardValue::GetInstanceMemorySize() const
@@ -42,7 +43,7 @@ void UHTNDecorator_GuardValue::OnEnterPlan(UHTNComponent& OwnerComp, const FHTNP
 
 	if (bSetValueOnEnterPlan)
 	{
-		if (!Value.SetValue(*OwnerComp.GetPlanningWorldStateProxy()->GetWorldState(), BlackboardKey))
+		if (!Value.SetValue(*OwnerComp.GetPlanningWorldStateProxy()->GetWorldState(), BlackboardKeyHandle))
 		{
 			UE_VLOG_UELOG(&OwnerComp, LogHTN, Error, TEXT("%s could not set worldstate key %s to (%s)"),
 				*GetShortDescription(),
@@ -13,6 +13,7 @@ UHTNDecorator_ModifyCost::UHTNDecorator_ModifyCost(const FObjectInitializer& Ini
 	bCheckConditionOnPlanExit = false;
 	bCheckConditionOnPlanRecheck = false;
 	bCheckConditionOnTick = false;
+	bCanPlanOnWorkerThread = true;
 }
 
 FString UHTNDecorator_ModifyCost::GetStaticDescription() const
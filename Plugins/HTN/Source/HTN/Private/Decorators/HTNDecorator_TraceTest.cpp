@@ -1,6 +1,7 @@
 // Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
 
 #include "Decorators/HTNDecorator_TraceTest.h"
+#include "AITask_MakeHTNPlan.h"
 
 #include "AIController.h"
 #include "Engine/World.h"
@@ -18,6 +19,8 @@ UHTNDecorator_TraceTest::UHTNDecorator_TraceTest(const FObjectInitializer& Initi
 	TraceExtentX(0.0f),
 	TraceExtentY(0.0f),
 	TraceExtentZ(0.0f),
+	PlanningTraceCacheTolerance(1.0f),
+	bUseAsyncTracesDuringPlanning(false),
 	DrawDebugType(EDrawDebugTrace::None),
 	DebugColor(FLinearColor::Red),
 	DebugHitColor(FLinearColor::Green),
@@ -82,11 +85,60 @@ bool UHTNDecorator_TraceTest::CalculateRawConditionValue(UHTNComponent& OwnerCom
 
 	const FVector StartLocation = TraceFromRawPosition + FVector(0.0f, 0.0f, TraceFromZOffset);
 	const FVector EndLocation = TraceToRawPosition + FVector(0.0f, 0.0f, TraceToZOffset);
-	const ETraceTypeQuery TraceTypeQuery = UEngineTypes::ConvertToTraceType(CollisionChannel);
-	const FVector Extent(TraceExtentX, TraceExtentY, TraceExtentZ);
 	FillActorsToIgnoreBuffer(OwnerComp, TraceFromActor, TraceToActor);
 	ON_SCOPE_EXIT { ActorsToIgnoreBuffer.Reset(); };
 
+	// During planning, reuse the results of identical traces made in other branches of the same planning session.
+	const UAITask_MakeHTNPlan* const PlanningTask = CheckType != EHTNDecoratorConditionCheckType::Execution && PlanningTraceCacheTolerance > 0.0f ?
+		OwnerComp.GetActivePlanningTask() : nullptr;
+	if (!PlanningTask)
+	{
+		return Trace(OwnerComp, StartLocation, EndLocation);
+	}
+
+	FHTNPlanningTraceCache& TraceCache = PlanningTask->GetTraceCache();
+	const FCollisionShape CollisionShape = MakeCollisionShape();
+	const FHTNTraceCacheKey Key = FHTNPlanningTraceCache::MakeKey(StartLocation, EndLocation, CollisionShape, 
+		CollisionChannel, bUseComplexCollision, ActorsToIgnoreBuffer, PlanningTraceCacheTolerance);
+	if (const bool* const CachedHit = TraceCache.FindResult(Key))
+	{
+		return *CachedHit;
+	}
+
+	if (bUseAsyncTracesDuringPlanning && CheckType == EHTNDecoratorConditionCheckType::PlanEnter)
+	{
+		FHTNQueuedTrace QueuedTrace;
+		QueuedTrace.Key = Key;
+		QueuedTrace.Start = StartLocation;
+		QueuedTrace.End = EndLocation;
+		QueuedTrace.Rotation = TraceShape == EEnvTraceShape::Box ? (EndLocation - StartLocation).Rotation().Quaternion() : FQuat::Identity;
+		QueuedTrace.Shape = CollisionShape;
+		QueuedTrace.Channel = CollisionChannel;
+		QueuedTrace.Params = FCollisionQueryParams(SCENE_QUERY_STAT(HTNDecorator_TraceTest), bUseComplexCollision);
+		QueuedTrace.Params.AddIgnoredActors(ActorsToIgnoreBuffer);
+		TraceCache.QueueTrace(MoveTemp(QueuedTrace));
+
+		// The planner will plan this node again once the result is in the cache.
+		// Until then, pass so that the decorators after this one get to queue their traces too.
+		return !IsInversed();
+	}
+
+	// Only queued traces are wanted while gathering, so don't block on a synchronous trace here.
+	if (TraceCache.bIsGatheringTraces)
+	{
+		return !IsInversed();
+	}
+
+	const bool bHit = Trace(OwnerComp, StartLocation, EndLocation);
+	TraceCache.AddResult(Key, bHit);
+	return bHit;
+}
+
+bool UHTNDecorator_TraceTest::Trace(UHTNComponent& OwnerComp, const FVector& StartLocation, const FVector& EndLocation) const
+{
+	const ETraceTypeQuery TraceTypeQuery = UEngineTypes::ConvertToTraceType(CollisionChannel);
+	const FVector Extent(TraceExtentX, TraceExtentY, TraceExtentZ);
+
 	FHitResult Hit;
 	bool bHit = false;
 	switch (TraceShape)
@@ -137,6 +189,24 @@ bool UHTNDecorator_TraceTest::CalculateRawConditionValue(UHTNComponent& OwnerCom
 	return bHit;
 }
 
+FCollisionShape UHTNDecorator_TraceTest::MakeCollisionShape() const
+{
+	switch (TraceShape)
+	{
+	case EEnvTraceShape::Box:
+		return FCollisionShape::MakeBox(FVector(TraceExtentX, TraceExtentY, TraceExtentZ));
+
+	case EEnvTraceShape::Sphere:
+		return FCollisionShape::MakeSphere(TraceExtentX);
+
+	case EEnvTraceShape::Capsule:
+		return FCollisionShape::MakeCapsule(TraceExtentX, TraceExtentZ);
+
+	default:
+		return FCollisionShape();
+	}
+}
+
 void UHTNDecorator_TraceTest::FillActorsToIgnoreBuffer(UHTNComponent& OwnerComp, AActor* TraceFromActor, AActor* TraceToActor) const
 {
 	ActorsToIgnoreBuffer.Reset();
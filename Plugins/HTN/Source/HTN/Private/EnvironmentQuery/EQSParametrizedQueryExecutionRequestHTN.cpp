@@ -60,6 +60,27 @@ TSharedPtr<FEnvQueryResult> FEQSParametrizedQueryExecutionRequestHTN::ExecuteIns
 	return nullptr;
 }
 
+UEnvQuery* FEQSParametrizedQueryExecutionRequestHTN::GetQueryTemplate(AActor& QueryOwner, const FBlackboardWorldState& WorldState) const
+{
+	return bUseBBKeyForQueryTemplate ? GetQueryTemplateFromWorldState(QueryOwner, WorldState) : QueryTemplate;
+}
+
+uint32 FEQSParametrizedQueryExecutionRequestHTN::GetStaticParamsHash() const
+{
+	uint32 Hash = GetTypeHash(StaticCast<uint8>(RunMode));
+	for (const FAIDynamicParam& RuntimeParam : QueryConfig)
+	{
+		if (!RuntimeParam.BBKey.IsSet())
+		{
+			Hash = HashCombine(Hash, GetTypeHash(RuntimeParam.ParamName));
+			Hash = HashCombine(Hash, GetTypeHash(StaticCast<uint8>(RuntimeParam.ParamType)));
+			Hash = HashCombine(Hash, GetTypeHash(RuntimeParam.Value));
+		}
+	}
+
+	return Hash;
+}
+
 UEnvQuery* FEQSParametrizedQueryExecutionRequestHTN::GetQueryTemplateFromWorldState(AActor& QueryOwner, const FBlackboardWorldState& WorldState) const
 {
 	UObject* const QueryTemplateObject = WorldState.GetValue<UBlackboardKeyType_Object>(EQSQueryBlackboardKey.GetSelectedKeyID());
@@ -12,6 +12,7 @@
 #include "HTNDecorator.h"
 #include "HTNDelegates.h"
 #include "HTNService.h"
+#include "HTNSubsystem.h"
 #include "Nodes/HTNNode_Parallel.h"
 #include "Nodes/HTNNode_SubNetworkDynamic.h"
 #include "WorldStateProxy.h"
@@ -91,6 +92,10 @@ int32 FHTNDebugSteps::GetLastIndex() const
 UHTNComponent::UHTNComponent(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer),
 	MaxPlanLength(100),
 	MaxNestedSubPlanDepth(100),
+	bPruneEquivalentPlans(false),
+	bPlanOnWorkerThread(false),
+	bTickFromSubsystem(false),
+	TickSignificance(1.0f),
 	bIsPaused(false),
 	bDeferredCleanup(false),
 	bStoppingHTN(false),
@@ -98,7 +103,11 @@ UHTNComponent::UHTNComponent(const FObjectInitializer& ObjectInitializer) : Supe
 	PendingHTNAsset(nullptr),
 	RootPlanInstance(CreateDefaultSubobject<UHTNPlanInstance>(TEXT("RootPlanInstance"))),
 	PlanningWorldStateProxy(CreateDefaultSubobject<UWorldStateProxy>(TEXT("WorldStateProxy"))),
-	BlackboardProxy(CreateDefaultSubobject<UWorldStateProxy>(TEXT("BlackboardProxy")))
+	WorkerThreadPlanningWorldStateProxy(CreateDefaultSubobject<UWorldStateProxy>(TEXT("WorkerThreadWorldStateProxy"))),
+	BlackboardProxy(CreateDefaultSubobject<UWorldStateProxy>(TEXT("BlackboardProxy"))),
+	ActivePlanningTask(nullptr),
+	WorkerThreadActivePlanningTask(nullptr),
+	bIsPlanningOnWorkerThread(false)
 {
 	bAutoActivate = true;
 	bWantsInitializeComponent = true;
@@ -117,6 +126,11 @@ void UHTNComponent::PostInitProperties()
 void UHTNComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	TickHTN(DeltaTime);
+}
+
+void UHTNComponent::TickHTN(float DeltaTime)
+{
 	SCOPE_CYCLE_COUNTER(STAT_AI_Overall);
 	SCOPE_CYCLE_COUNTER(STAT_AI_HTN_Tick);
 	CSV_SCOPED_TIMING_STAT_EXCLUSIVE(HTNTick);
@@ -158,6 +172,15 @@ void UHTNComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (bTickFromSubsystem)
+	{
+		if (UHTNSubsystem* const Subsystem = UWorld::GetSubsystem<UHTNSubsystem>(GetWorld()))
+		{
+			SetComponentTickEnabled(false);
+			Subsystem->RegisterComponent(*this);
+		}
+	}
+
 #if USE_HTN_DEBUGGER
 	PlayingComponents.AddUnique(this);
 #endif
@@ -168,6 +191,11 @@ void UHTNComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	// Cleanup and remove worldstates before the blackboard component they reference gets uninitialized
 	Cleanup();
 
+	if (UHTNSubsystem* const Subsystem = UWorld::GetSubsystem<UHTNSubsystem>(GetWorld()))
+	{
+		Subsystem->UnregisterComponent(*this);
+	}
+
 #if USE_HTN_DEBUGGER
 	PlayingComponents.Remove(this);
 #endif
@@ -175,6 +203,18 @@ void UHTNComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	Super::EndPlay(EndPlayReason);
 }
 
+void UHTNComponent::SetTickSignificance(float NewSignificance)
+{
+	TickSignificance = FMath::Clamp(NewSignificance, 0.0f, 1.0f);
+	if (bTickFromSubsystem)
+	{
+		if (UHTNSubsystem* const Subsystem = UWorld::GetSubsystem<UHTNSubsystem>(GetWorld()))
+		{
+			Subsystem->SetTickPeriod(*this, UHTNSubsystem::GetTickPeriodForSignificance(TickSignificance));
+		}
+	}
+}
+
 void UHTNComponent::RestartLogic()
 {
 	UE_VLOG(this, LogHTN, Log, TEXT("UHTNComponent::RestartLogic"));
@@ -469,9 +509,9 @@ void UHTNComponent::Replan(const FHTNReplanParameters& Params)
 
 void UHTNComponent::SetPlanningWorldState(TSharedPtr<FBlackboardWorldState> WorldState, bool bIsEditable)
 {
-	check(PlanningWorldStateProxy);
-	PlanningWorldStateProxy->WorldState = WorldState;
-	PlanningWorldStateProxy->bIsEditable = bIsEditable;
+	UWorldStateProxy* const Proxy = GetPlanningWorldStateProxy();
+	Proxy->WorldState = WorldState;
+	Proxy->bIsEditable = bIsEditable;
 }
 
 UHTNExtension* UHTNComponent::FindExtensionByClass(TSubclassOf<UHTNExtension> ExtensionClass) const
@@ -581,6 +621,47 @@ void UHTNComponent::ReturnPlanningTaskToPool(UAITask_MakeHTNPlan& Task)
 	PlanningTasksPool.Push(&Task);
 }
 
+void UHTNComponent::TakeNodeMemoryFromPool(TArray<uint8>& Memory, int32 NumBytes)
+{
+	if (Memory.Max() >= NumBytes)
+	{
+		return;
+	}
+
+	int32 BestIndex = INDEX_NONE;
+	for (int32 Index = 0; Index < NodeMemoryPool.Num(); ++Index)
+	{
+		const int32 Capacity = NodeMemoryPool[Index].Max();
+		if (Capacity >= NumBytes && (BestIndex == INDEX_NONE || Capacity < NodeMemoryPool[BestIndex].Max()))
+		{
+			BestIndex = Index;
+		}
+	}
+
+	if (BestIndex != INDEX_NONE)
+	{
+		check(Memory.Num() == 0);
+		Swap(Memory, NodeMemoryPool[BestIndex]);
+		if (NodeMemoryPool[BestIndex].Max() == 0)
+		{
+			NodeMemoryPool.RemoveAtSwap(BestIndex, 1, /*bAllowShrinking=*/false);
+		}
+	}
+}
+
+void UHTNComponent::ReturnNodeMemoryToPool(TArray<uint8>&& Memory)
+{
+	// The number of blocks is limited by the number of plan instances alive at the same time, 
+	// which is small unless SubPlan nodes are nested very deeply.
+	static constexpr int32 MaxNumPooledBlocks = 16;
+
+	Memory.Reset();
+	if (Memory.Max() > 0 && NodeMemoryPool.Num() < MaxNumPooledBlocks)
+	{
+		NodeMemoryPool.Add(MoveTemp(Memory));
+	}
+}
+
 #if ENABLE_VISUAL_LOG
 
 void UHTNComponent::DescribeSelfToVisLog(FVisualLogEntry* Snapshot) const
@@ -16,6 +16,7 @@ UHTNDecorator::UHTNDecorator(const FObjectInitializer& Initializer) : Super(Init
 	bNotifyExecutionStart(false),
 	bNotifyTick(false),
 	bNotifyExecutionFinish(false),
+	bConditionOnlyDependsOnWorldState(false),
 	bInverseCondition(false),
 	bCheckConditionOnPlanEnter(true),
 	bCheckConditionOnPlanExit(false),
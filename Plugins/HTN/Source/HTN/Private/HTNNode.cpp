@@ -15,6 +15,7 @@ UHTNNode::UHTNNode(const FObjectInitializer& ObjectInitializer) : Super(ObjectIn
 	bOwnsGameplayTasks(false),
 	bNotifyOnPlanExecutionStarted(false),
 	bNotifyOnPlanExecutionFinished(false),
+	bCanPlanOnWorkerThread(false),
 	bForceUsingPlanningWorldState(false),
 	HTNAsset(nullptr),
 	OwnerComponent(nullptr)
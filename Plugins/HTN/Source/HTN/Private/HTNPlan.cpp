@@ -17,6 +17,7 @@ const FHTNPlanStepID FHTNPlanStepID::None = { INDEX_NONE, INDEX_NONE };
 
 FHTNPlan::FHTNPlan() :
 	Cost(0),
+	RemainingCostLowerBound(0),
 	NumPotentialDivergencePointsDuringPlanAdjustment(0),
 	NumRemainingPotentialDivergencePointsDuringPlanAdjustment(0),
 	bDivergesFromCurrentPlanDuringPlanAdjustment(false)
@@ -25,6 +26,7 @@ FHTNPlan::FHTNPlan() :
 FHTNPlan::FHTNPlan(UHTN* HTNAsset, TSharedRef<FBlackboardWorldState> WorldStateAtPlanStart, UHTNStandaloneNode* RootNodeOverride) :
 	Levels { MakeShared<FHTNPlanLevel>(HTNAsset, WorldStateAtPlanStart) },
 	Cost(0),
+	RemainingCostLowerBound(0),
 	RootNodeOverride(RootNodeOverride),
 	NumPotentialDivergencePointsDuringPlanAdjustment(0),
 	NumRemainingPotentialDivergencePointsDuringPlanAdjustment(0),
@@ -292,7 +294,7 @@ void FHTNPlan::VerifySubNodesAreInactive(const UObject* VisLogOwner) const
 
 	for (int32 LevelIndex = 0; LevelIndex < Levels.Num(); ++LevelIndex)
 	{
-		FHTNPlanLevel& Level = *Levels[LevelIndex];
+		const FHTNPlanLevel& Level = *Levels[LevelIndex];
 
 		UE_CVLOG_UELOG(Level.RootSubNodesInfo.bSubNodesExecuting,
 			VisLogOwner, LogHTN, Error,
@@ -310,7 +312,7 @@ void FHTNPlan::VerifySubNodesAreInactive(const UObject* VisLogOwner) const
 		for (int32 StepIndex = 0; StepIndex < Level.Steps.Num(); ++StepIndex)
 		{
 			const FHTNPlanStepID StepID { LevelIndex, StepIndex };
-			FHTNPlanStep& Step = Level.Steps[StepIndex];
+			const FHTNPlanStep& Step = Level.Steps[StepIndex];
 
 			UE_CVLOG_UELOG(Step.SubNodesInfo.bSubNodesExecuting,
 				VisLogOwner, LogHTN, Error,
@@ -331,7 +333,11 @@ void FHTNPlan::VerifySubNodesAreInactive(const UObject* VisLogOwner) const
 
 const FHTNPlanStep& FHTNPlan::GetStep(const FHTNPlanStepID& PlanStepID) const
 {
-	return const_cast<FHTNPlan*>(this)->GetStep(PlanStepID);
+	// Not implemented via the non-const version since that would duplicate steps shared with other plans.
+	check(HasLevel(PlanStepID.LevelIndex));
+	const FHTNPlanLevel& Level = *Levels[PlanStepID.LevelIndex];
+	check(Level.Steps.IsValidIndex(PlanStepID.StepIndex));
+	return Level.Steps[PlanStepID.StepIndex];
 }
 
 FHTNPlanStep& FHTNPlan::GetStep(const FHTNPlanStepID& PlanStepID)
@@ -339,12 +345,21 @@ FHTNPlanStep& FHTNPlan::GetStep(const FHTNPlanStepID& PlanStepID)
 	check(HasLevel(PlanStepID.LevelIndex));
 	FHTNPlanLevel& Level = *Levels[PlanStepID.LevelIndex];
 	check(Level.Steps.IsValidIndex(PlanStepID.StepIndex));
-	return Level.Steps[PlanStepID.StepIndex];
+	return Level.Steps.GetMutable(PlanStepID.StepIndex);
 }
 
 const FHTNPlanStep* FHTNPlan::FindStep(const FHTNPlanStepID& PlanStepID) const
 {
-	return const_cast<FHTNPlan*>(this)->FindStep(PlanStepID);
+	if (HasLevel(PlanStepID.LevelIndex))
+	{
+		const FHTNPlanLevel& Level = *Levels[PlanStepID.LevelIndex];
+		if (Level.Steps.IsValidIndex(PlanStepID.StepIndex))
+		{
+			return &Level.Steps[PlanStepID.StepIndex];
+		}
+	}
+	
+	return nullptr;
 }
 
 FHTNPlanStep* FHTNPlan::FindStep(const FHTNPlanStepID& PlanStepID)
@@ -354,7 +369,7 @@ FHTNPlanStep* FHTNPlan::FindStep(const FHTNPlanStepID& PlanStepID)
 		FHTNPlanLevel& Level = *Levels[PlanStepID.LevelIndex];
 		if (Level.Steps.IsValidIndex(PlanStepID.StepIndex))
 		{
-			return &Level.Steps[PlanStepID.StepIndex];
+			return &Level.Steps.GetMutable(PlanStepID.StepIndex);
 		}
 	}
 	
@@ -420,8 +435,8 @@ void FHTNPlan::GetSubNodesAtPlanStep(const FHTNPlanStepID& StepID, FHTNSubNodeGr
 	FHTNPlanStepID CurrentStepID = StepID;
 	while (true)
 	{
-		FHTNPlanLevel& Level = *Levels[CurrentStepID.LevelIndex];
-		FHTNPlanStep& Step = Level.Steps[CurrentStepID.StepIndex];
+		const FHTNPlanLevel& Level = *Levels[CurrentStepID.LevelIndex];
+		const FHTNPlanStep& Step = Level.Steps[CurrentStepID.StepIndex];
 		OutSubNodeGroups.Add(FHTNSubNodeGroup(Step.SubNodesInfo, CurrentStepID,
 			Step.bIsIfNodeFalseBranch, Step.bCanConditionsInterruptTrueBranch, Step.bCanConditionsInterruptFalseBranch));
 
@@ -541,7 +556,8 @@ bool FHTNPlan::HasTasksInLevel(int32 LevelIndex) const
 {
 	if (HasLevel(LevelIndex))
 	{
-		return Algo::AnyOf(Levels[LevelIndex]->Steps, [&](const FHTNPlanStep& Step)
+		const FHTNPlanLevel& Level = *Levels[LevelIndex];
+		return Algo::AnyOf(Level.Steps, [&](const FHTNPlanStep& Step)
 		{
 			return Cast<UHTNTask>(Step.Node) || HasTasksInLevel(Step.SubLevelIndex) || HasTasksInLevel(Step.SecondarySubLevelIndex);
 		});
@@ -125,7 +125,7 @@ namespace
 
 			for (int32 StepIndex = 0; StepIndex < NewLevel->Steps.Num(); ++StepIndex)
 			{
-				FHTNPlanStep& Step = NewLevel->Steps[StepIndex];
+				FHTNPlanStep& Step = NewLevel->Steps.GetMutable(StepIndex);
 				const FHTNPlanStepID NewStepID = { NewLevelIndex, StepIndex };
 				Step.SubLevelIndex = ExtractAndFixUpLevelIndices(SubPlan, Step.SubLevelIndex, NewStepID);
 				Step.SecondarySubLevelIndex = ExtractAndFixUpLevelIndices(SubPlan, Step.SecondarySubLevelIndex, NewStepID);
@@ -169,10 +169,90 @@ namespace
 
 		return false;
 	}
+
+	bool AnyBitsInCommon(const TBitArray<>& A, const TBitArray<>& B)
+	{
+		for (TConstSetBitIterator<> It(A); It; ++It)
+		{
+			if (B.IsValidIndex(It.GetIndex()) && B[It.GetIndex()])
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
 }
 
 const FHTNPlanInstanceConfig FHTNPlanInstanceConfig::Default = {};
 
+void FHTNPlanRecheckDependencies::SetActiveSteps(TConstArrayView<FHTNPlanStepID> InActiveStepIDs)
+{
+	const bool bSameActiveSteps = InActiveStepIDs.Num() == ActiveStepIDs.Num() && 
+		Algo::AllOf(InActiveStepIDs, [&](const FHTNPlanStepID& StepID) { return ActiveStepIDs.Contains(StepID); });
+	if (!bSameActiveSteps)
+	{
+		Reset();
+	}
+}
+
+bool FHTNPlanRecheckDependencies::CanRecheckBeSkipped() const
+{
+	return bHasDependencies && !bDependsOnNonWorldState && !AnyBitsInCommon(ReadKeys, ChangedKeys);
+}
+
+bool FHTNPlanRecheckDependencies::CanStepRecheckBeSkipped(const FHTNPlanStepID& StepID) const
+{
+	if (!bHasDependencies)
+	{
+		return false;
+	}
+
+	const FStepDependencies* const Dependencies = StepDependencies.Find(StepID);
+	return Dependencies && Dependencies->bOnlyDependsOnWorldState && !AnyBitsInCommon(Dependencies->ReadKeys, ChangedKeys);
+}
+
+FHTNPlanRecheckDependencies::FStepDependencies& FHTNPlanRecheckDependencies::RecordStep(const FHTNPlanStepID& StepID, int32 NumKeys)
+{
+	FStepDependencies& Dependencies = StepDependencies.FindOrAdd(StepID);
+	Dependencies.ReadKeys.Init(false, NumKeys);
+	Dependencies.bOnlyDependsOnWorldState = false;
+	return Dependencies;
+}
+
+void FHTNPlanRecheckDependencies::FinishRecording(TConstArrayView<FHTNPlanStepID> InActiveStepIDs, int32 NumKeys)
+{
+	ReadKeys.Init(false, NumKeys);
+	bDependsOnNonWorldState = false;
+	for (const TPair<FHTNPlanStepID, FStepDependencies>& Pair : StepDependencies)
+	{
+		ReadKeys.CombineWithBitwiseOR(Pair.Value.ReadKeys, EBitwiseOperatorFlags::MaintainSize);
+		bDependsOnNonWorldState |= !Pair.Value.bOnlyDependsOnWorldState;
+	}
+	ChangedKeys.Init(false, NumKeys);
+	ActiveStepIDs.Reset();
+	ActiveStepIDs.Append(InActiveStepIDs.GetData(), InActiveStepIDs.Num());
+	bHasDependencies = true;
+}
+
+void FHTNPlanRecheckDependencies::NotifyKeyChanged(FBlackboard::FKey KeyID)
+{
+	if (ChangedKeys.IsValidIndex(KeyID))
+	{
+		ChangedKeys[KeyID] = true;
+	}
+}
+
+void FHTNPlanRecheckDependencies::Reset()
+{
+	StepDependencies.Reset();
+	ReadKeys.Reset();
+	ChangedKeys.Reset();
+	ActiveStepIDs.Reset();
+	bHasDependencies = false;
+	bDependsOnNonWorldState = false;
+}
+
 FHTNPlanInstanceConfig::FHTNPlanInstanceConfig() :
 	SucceededReaction(EHTNPlanInstanceFinishReaction::Loop),
 	FailedReaction(EHTNPlanInstanceFinishReaction::Loop),
@@ -229,11 +309,17 @@ void UHTNPlanInstance::Initialize(UHTNComponent& InOwnerComponent, FHTNPlanInsta
 void UHTNPlanInstance::OnPreDestroy()
 {
 	DeleteAllWorldStates();
+
+	if (IsValid(OwnerComponent))
+	{
+		OwnerComponent->ReturnNodeMemoryToPool(MoveTemp(PlanMemory));
+	}
 }
 
 void UHTNPlanInstance::DeleteAllWorldStates()
 {
 	Reset();
+	StopObservingBlackboardForRecheck();
 
 	// We need to do this to get rid of any worldstates in the plan, 
 	// so that the worldstates are guaranteed to be destroyed before the blackboard component they depend on.
@@ -341,188 +427,17 @@ bool UHTNPlanInstance::OwnsNodeMemory(const uint8* NodeMemory) const
 
 FHTNNodeInPlanInfo UHTNPlanInstance::FindActiveTaskInfo(const UHTNTask* Task, const uint8* NodeMemory) const
 {
-	if (NodeMemory && !OwnsNodeMemory(NodeMemory))
-	{
-		return {};
-	}
-
-	if (!HasActivePlan())
-	{
-		return {};
-	}
-	
-	const UHTNTask* const TaskTemplate = Task ? StaticCast<const UHTNTask*>(Task->GetTemplateNode()) : nullptr;
-	if (!IsValid(TaskTemplate))
-	{
-		return {};
-	}
-
-	FHTNNodeInPlanInfo Result;
-	Result.PlanInstance = const_cast<UHTNPlanInstance*>(this);
-
-	const auto FindIn = [&](const TArray<FHTNPlanStepID>& StepIDs) -> bool
-	{
-		for (const FHTNPlanStepID& StepID : StepIDs)
-		{
-			uint8* TaskMemory = nullptr;
-			if (TaskTemplate == &GetTaskInCurrentPlan(StepID, TaskMemory))
-			{
-				if (!NodeMemory || NodeMemory == TaskMemory)
-				{
-					Result.NodeMemory = TaskMemory;
-					Result.PlanStepID = StepID;
-					return true;
-				}
-			}
-		}
-
-		return false;
-	};
-
-	if (FindIn(CurrentlyExecutingStepIDs))
-	{
-		Result.Status = EHTNTaskStatus::Active;
-	} 
-	else if (FindIn(CurrentlyAbortingStepIDs))
-	{
-		Result.Status = EHTNTaskStatus::Aborting;
-	}
-	else
-	{
-		Result = {};
-	}
-
-	return Result;
+	return FindInActiveNodeIndex(Task ? Task->GetTemplateNode() : nullptr, NodeMemory);
 }
 
 FHTNNodeInPlanInfo UHTNPlanInstance::FindActiveDecoratorInfo(const UHTNDecorator* Decorator, const uint8* NodeMemory) const
 {
-	if (NodeMemory && !OwnsNodeMemory(NodeMemory))
-	{
-		return {};
-	}
-
-	if (!HasActivePlan())
-	{
-		return {};
-	}
-
-	const UHTNNode* const NodeTemplate = Decorator ? Decorator->GetTemplateNode() : nullptr;
-	if (!IsValid(NodeTemplate))
-	{
-		return {};
-	}
-
-	FHTNNodeInPlanInfo Result;
-	Result.PlanInstance = const_cast<UHTNPlanInstance*>(this);
-
-	FHTNSubNodeGroups SubNodeGroups;
-	const auto FindIn = [&](const TArray<FHTNPlanStepID>& StepIDs) -> bool
-	{
-		for (const FHTNPlanStepID& StepID : StepIDs)
-		{
-			SubNodeGroups.Reset();
-			CurrentPlan->GetSubNodesAtPlanStep(StepID, SubNodeGroups);
-			for (const FHTNSubNodeGroup& Group : SubNodeGroups)
-			{
-				for (const THTNNodeInfo<UHTNDecorator>& DecoratorInfo : Group.SubNodesInfo->DecoratorInfos)
-				{
-					if (NodeTemplate == DecoratorInfo.TemplateNode)
-					{
-						uint8* const FoundMemory = GetNodeMemory(DecoratorInfo.NodeMemoryOffset);
-						if (!NodeMemory || NodeMemory == FoundMemory)
-						{
-							Result.NodeMemory = FoundMemory;
-							Result.PlanStepID = StepID;
-							return true;
-						}
-					}
-				}
-			}
-		}
-
-		return false;
-	};
-
-	if (FindIn(CurrentlyExecutingStepIDs))
-	{
-		Result.Status = EHTNTaskStatus::Active;
-	}
-	else if (FindIn(CurrentlyAbortingStepIDs))
-	{
-		Result.Status = EHTNTaskStatus::Aborting;
-	}
-	else
-	{
-		Result = {};
-	}
-
-	return Result;
+	return FindInActiveNodeIndex(Decorator ? Decorator->GetTemplateNode() : nullptr, NodeMemory);
 }
 
 FHTNNodeInPlanInfo UHTNPlanInstance::FindActiveServiceInfo(const UHTNService* Service, const uint8* NodeMemory) const
 {
-	if (NodeMemory && !OwnsNodeMemory(NodeMemory))
-	{
-		return {};
-	}
-
-	if (!HasActivePlan())
-	{
-		return {};
-	}
-
-	const UHTNNode* const NodeTemplate = Service ? Service->GetTemplateNode() : nullptr;
-	if (!IsValid(NodeTemplate))
-	{
-		return {};
-	}
-
-	FHTNNodeInPlanInfo Result;
-	Result.PlanInstance = const_cast<UHTNPlanInstance*>(this);
-
-	FHTNSubNodeGroups SubNodeGroups;
-	const auto FindIn = [&](const TArray<FHTNPlanStepID>& StepIDs) -> bool
-	{
-		for (const FHTNPlanStepID& StepID : StepIDs)
-		{
-			SubNodeGroups.Reset();
-			CurrentPlan->GetSubNodesAtPlanStep(StepID, SubNodeGroups);
-			for (const FHTNSubNodeGroup& Group : SubNodeGroups)
-			{
-				for (const THTNNodeInfo<UHTNService>& ServiceInfo : Group.SubNodesInfo->ServiceInfos)
-				{
-					if (NodeTemplate == ServiceInfo.TemplateNode)
-					{
-						uint8* const FoundMemory = GetNodeMemory(ServiceInfo.NodeMemoryOffset);
-						if (!NodeMemory || NodeMemory == FoundMemory)
-						{
-							Result.NodeMemory = FoundMemory;
-							Result.PlanStepID = StepID;
-							return true;
-						}
-					}
-				}
-			}
-		}
-
-		return false;
-	};
-
-	if (FindIn(CurrentlyExecutingStepIDs))
-	{
-		Result.Status = EHTNTaskStatus::Active;
-	}
-	else if (FindIn(CurrentlyAbortingStepIDs))
-	{
-		Result.Status = EHTNTaskStatus::Aborting;
-	}
-	else
-	{
-		Result = {};
-	}
-
-	return Result;
+	return FindInActiveNodeIndex(Service ? Service->GetTemplateNode() : nullptr, NodeMemory);
 }
 
 bool UHTNPlanInstance::IsRootInstance() const
@@ -1058,6 +973,7 @@ void UHTNPlanInstance::OnTaskFinished(const UHTNTask* Task, uint8* TaskMemory, c
 		check(HasPlan());
 	}
 	CurrentlyExecutingStepIDs.RemoveSingle(FinishedStepID);
+	RemoveStepFromActiveNodeIndex(FinishedStepID);
 
 	check(OwnerComponent->GetBlackboardComponent());
 	check(HasPlan());
@@ -1087,6 +1003,7 @@ void UHTNPlanInstance::OnTaskFinished(const UHTNTask* Task, uint8* TaskMemory, c
 			*Task->GetShortDescription());
 
 		CurrentlyAbortingStepIDs.RemoveSingle(FinishedStepID);
+		RemoveStepFromActiveNodeIndex(FinishedStepID);
 		if (!bReentrantCallToOnTaskFinished && !HasActiveTasks())
 		{
 			if (IsAbortingPlan())
@@ -1262,7 +1179,7 @@ void UHTNPlanInstance::GetSubNodesInCurrentPlanToStart(FHTNSubNodeGroups& OutSub
 	while (true)
 	{
 		FHTNPlanLevel& Level = *CurrentPlan->Levels[CurrentStepID.LevelIndex];
-		FHTNPlanStep& Step = Level.Steps[CurrentStepID.StepIndex];
+		FHTNPlanStep& Step = Level.Steps.GetMutable(CurrentStepID.StepIndex);
 		if (!Step.SubNodesInfo.bSubNodesExecuting)
 		{
 			// Subnodes at the CurrentStep itself
@@ -1302,7 +1219,7 @@ void UHTNPlanInstance::GetSubNodesInCurrentPlanToTick(FHTNSubNodeGroups& OutSubN
 	while (true)
 	{
 		FHTNPlanLevel& Level = *CurrentPlan->Levels[CurrentStepID.LevelIndex];
-		FHTNPlanStep& Step = Level.Steps[CurrentStepID.StepIndex];
+		FHTNPlanStep& Step = Level.Steps.GetMutable(CurrentStepID.StepIndex);
 		if (Step.SubNodesInfo.LastFrameSubNodesTicked != GFrameCounter)
 		{
 			// Subnodes at the CurrentStep itself
@@ -1344,7 +1261,7 @@ void UHTNPlanInstance::GetSubNodesInCurrentPlanToFinish(FHTNSubNodeGroups& OutSu
 	while (true)
 	{
 		FHTNPlanLevel& Level = *CurrentPlan->Levels[CurrentStepID.LevelIndex];
-		FHTNPlanStep& Step = Level.Steps[CurrentStepID.StepIndex];
+		FHTNPlanStep& Step = Level.Steps.GetMutable(CurrentStepID.StepIndex);
 		if (Step.SubNodesInfo.bSubNodesExecuting)
 		{
 			// Subnodes at the CurrentStep itself
@@ -1400,7 +1317,7 @@ void UHTNPlanInstance::GetSubNodesInCurrentPlanToAbort(FHTNSubNodeGroups& OutSub
 	while (true)
 	{
 		FHTNPlanLevel& Level = *CurrentPlan->Levels[CurrentStepID.LevelIndex];
-		FHTNPlanStep& Step = Level.Steps[CurrentStepID.StepIndex];
+		FHTNPlanStep& Step = Level.Steps.GetMutable(CurrentStepID.StepIndex);
 		if (Step.SubNodesInfo.bSubNodesExecuting)
 		{
 			// Subnodes at the CurrentStep itself
@@ -1440,7 +1357,7 @@ void UHTNPlanInstance::GetSubNodesInCurrentPlanAll(FHTNSubNodeGroups& OutSubNode
 	while (true)
 	{
 		FHTNPlanLevel& Level = *CurrentPlan->Levels[CurrentStepID.LevelIndex];
-		FHTNPlanStep& Step = Level.Steps[CurrentStepID.StepIndex];
+		FHTNPlanStep& Step = Level.Steps.GetMutable(CurrentStepID.StepIndex);
 
 		// Subnodes at the CurrentStep itself
 		OutSubNodeGroups.Add(FHTNSubNodeGroup(Step.SubNodesInfo, CurrentStepID,
@@ -1878,7 +1795,7 @@ void UHTNPlanInstance::InitializeCurrentPlan(TSharedRef<FHTNPlan> NewPlan)
 		for (int32 StepIndex = 0; StepIndex < Level.Steps.Num(); ++StepIndex)
 		{
 			const FHTNPlanStepID StepID { LevelIndex, StepIndex };
-			FHTNPlanStep& Step = Level.Steps[StepIndex];
+			FHTNPlanStep& Step = Level.Steps.GetMutable(StepIndex);
 
 			if (Step.Node.IsValid())
 			{
@@ -1907,6 +1824,8 @@ void UHTNPlanInstance::InitializeCurrentPlan(TSharedRef<FHTNPlan> NewPlan)
 		TotalNumBytesNeeded);
 
 	// Actually initialize the memory and create node instances where needed.
+	// The memory keeps its allocation between plans, and a fresh plan instance takes it from the pool of its component.
+	OwnerComponent->TakeNodeMemoryFromPool(PlanMemory, TotalNumBytesNeeded);
 	PlanMemory.SetNumZeroed(TotalNumBytesNeeded);
 	for (const FNodeInitInfo& NodeInitInfo : InitList)
 	{
@@ -1960,19 +1879,19 @@ void UHTNPlanInstance::ClearCurrentPlan()
 			}
 
 			// Do steps
-			for (FHTNPlanStep& Step : Level.Steps)
+			for (const FHTNPlanStep& Step : Level.Steps)
 			{
 				if (Step.Node.IsValid())
 				{
 					CleanupNode(Step.Node.Get(), Step.NodeMemoryOffset);
 				}
 
-				for (THTNNodeInfo<UHTNDecorator>& DecoratorInfo : Step.SubNodesInfo.DecoratorInfos)
+				for (const THTNNodeInfo<UHTNDecorator>& DecoratorInfo : Step.SubNodesInfo.DecoratorInfos)
 				{
 					CleanupNode(DecoratorInfo.TemplateNode, DecoratorInfo.NodeMemoryOffset);
 				}
 
-				for (THTNNodeInfo<UHTNService>& ServiceInfo : Step.SubNodesInfo.ServiceInfos)
+				for (const THTNNodeInfo<UHTNService>& ServiceInfo : Step.SubNodesInfo.ServiceInfos)
 				{
 					CleanupNode(ServiceInfo.TemplateNode, ServiceInfo.NodeMemoryOffset);
 				}
@@ -1987,6 +1906,8 @@ void UHTNPlanInstance::ClearCurrentPlan()
 	CurrentlyExecutingStepIDs.Reset();
 	PendingExecutionStepIDs.Reset();
 	CurrentlyAbortingStepIDs.Reset();
+	ActiveNodeIndex.Reset();
+	RecheckDependencies.Reset();
 	bCurrentPlanStartedExecution = false;
 
 #if USE_HTN_DEBUGGER
@@ -2003,18 +1924,7 @@ bool UHTNPlanInstance::RecheckCurrentPlan(const FBlackboardWorldState* WorldStat
 		return true;
 	}
 
-	// Ensure that the worldstate proxy is restored to its current state at the end of this.
-	FGuardWorldStateProxy GuardProxy(*OwnerComponent->GetPlanningWorldStateProxy());
-
-	struct FRecheckContext
-	{
-		TSharedRef<FBlackboardWorldState> WorldState;
-		FHTNPlanStepID StepID;
-	};
-
-	TArray<FRecheckContext> RecheckStack;
-
-	// Set up the RecheckStack.
+	// The steps the recheck starts from.
 	TArray<FHTNPlanStepID, TInlineAllocator<8>> ActiveStepIDs;
 	if (bCurrentPlanStartedExecution)
 	{
@@ -2029,12 +1939,47 @@ bool UHTNPlanInstance::RecheckCurrentPlan(const FBlackboardWorldState* WorldStat
 		GetNextPrimitiveStepsInCurrentPlan(Buffer, { 0, INDEX_NONE }, /*bExecutingPlan=*/false);
 		ActiveStepIDs = Buffer;
 	}
+
+	// Dependencies are only tracked when rechecking against the blackboard, since that's what the observers watch.
+	const bool bTrackDependencies = !WorldStateOverride && ObserveBlackboardForRecheck();
+	if (bTrackDependencies)
+	{
+		RecheckDependencies.SetActiveSteps(ActiveStepIDs);
+		if (RecheckDependencies.CanRecheckBeSkipped())
+		{
+			// Nothing the remaining steps read has changed since they passed the last recheck.
+			return true;
+		}
+	}
+
+	// Ensure that the worldstate proxy is restored to its current state at the end of this.
+	FGuardWorldStateProxy GuardProxy(*OwnerComponent->GetPlanningWorldStateProxy());
+
+	bool bSucceeded = false;
+	ON_SCOPE_EXIT
+	{
+		if (bTrackDependencies && !bSucceeded)
+		{
+			RecheckDependencies.Reset();
+		}
+	};
+
+	struct FRecheckContext
+	{
+		TSharedRef<FBlackboardWorldState> WorldState;
+		FHTNPlanStepID StepID;
+	};
+
+	// Set up the RecheckStack.
+	TArray<FRecheckContext> RecheckStack;
+
+	// All active steps start from the same worldstate, so they can share its values.
+	const TSharedRef<FBlackboardWorldState> StartWorldState = WorldStateOverride ? 
+		WorldStateOverride->MakeNext() : 
+		MakeShared<FBlackboardWorldState>(*OwnerComponent->GetBlackboardComponent());
 	Algo::Transform(ActiveStepIDs, RecheckStack, [&](const FHTNPlanStepID& StepID) -> FRecheckContext
 	{
-		const TSharedRef<FBlackboardWorldState> WorldState = WorldStateOverride ? 
-			WorldStateOverride->MakeNext() : 
-			MakeShared<FBlackboardWorldState>(*OwnerComponent->GetBlackboardComponent());
-		return { WorldState, StepID };
+		return { StartWorldState->MakeNext(), StepID };
 	});
 
 	// Make sure that the step on the most primary branch is first, i.e. on the bottom of the stack.
@@ -2043,6 +1988,7 @@ bool UHTNPlanInstance::RecheckCurrentPlan(const FBlackboardWorldState* WorldStat
 		return CurrentPlan->IsSecondaryParallelStep(RecheckContext.StepID) ? 1 : 0;
 	});
 
+	const int32 NumKeys = OwnerComponent->GetBlackboardComponent()->GetNumKeys();
 	TArray<FHTNPlanStepID> NextStepsBuffer;
 	while (RecheckStack.Num())
 	{
@@ -2066,8 +2012,34 @@ bool UHTNPlanInstance::RecheckCurrentPlan(const FBlackboardWorldState* WorldStat
 
 		const bool bExecuting = CurrentlyExecutingStepIDs.Contains(CurrentContext.StepID);
 
+		// Steps that passed the last recheck and don't read anything that changed since then would pass again, 
+		// but the worldstate still needs to be carried through them for the steps after.
+		const bool bSkipChecks = bExecuting || (bTrackDependencies && RecheckDependencies.CanStepRecheckBeSkipped(CurrentContext.StepID));
+		if (bTrackDependencies && !bSkipChecks)
+		{
+			FHTNPlanRecheckDependencies::FStepDependencies& Dependencies = RecheckDependencies.RecordStep(CurrentContext.StepID, NumKeys);
+			Dependencies.bOnlyDependsOnWorldState = Task->DoesRecheckPlanOnlyDependOnWorldState();
+			if (Dependencies.bOnlyDependsOnWorldState)
+			{
+				FHTNSubNodeGroups SubNodeGroups;
+				GetSubNodesInCurrentPlanToTick(SubNodeGroups, CurrentContext.StepID);
+				Dependencies.bOnlyDependsOnWorldState = Algo::AllOf(SubNodeGroups, [](const FHTNSubNodeGroup& Group)
+				{
+					return Algo::AllOf(Group.SubNodesInfo->DecoratorInfos, [](const THTNNodeInfo<UHTNDecorator>& DecoratorInfo)
+					{
+						return !DecoratorInfo.TemplateNode || DecoratorInfo.TemplateNode->DoesRecheckOnlyDependOnWorldState();
+					});
+				});
+			}
+			CurrentContext.WorldState->SetReadKeysRecorder(&Dependencies.ReadKeys);
+		}
+		ON_SCOPE_EXIT
+		{
+			CurrentContext.WorldState->SetReadKeysRecorder(nullptr);
+		};
+
 		// Recheck the task itself
-		if (!bExecuting && !Task->WrappedRecheckPlan(*OwnerComponent, GetNodeMemory(CurrentStep.NodeMemoryOffset), *CurrentContext.WorldState, CurrentStep))
+		if (!bSkipChecks && !Task->WrappedRecheckPlan(*OwnerComponent, GetNodeMemory(CurrentStep.NodeMemoryOffset), *CurrentContext.WorldState, CurrentStep))
 		{
 			UE_VLOG(this, LogHTN, Log,
 				TEXT("%s plan recheck failed on task %s"),
@@ -2080,7 +2052,7 @@ bool UHTNPlanInstance::RecheckCurrentPlan(const FBlackboardWorldState* WorldStat
 		CurrentStep.WorldState->ApplyChangedValues(*CurrentContext.WorldState);
 
 		// Recheck decorators
-		if (!bExecuting && !UpdateSubNodes(CurrentContext.StepID, EHTNUpdateSubNodesFlags::CheckConditionsRecheck))
+		if (!bSkipChecks && !UpdateSubNodes(CurrentContext.StepID, EHTNUpdateSubNodesFlags::CheckConditionsRecheck))
 		{
 			UE_VLOG(this, LogHTN, Log,
 				TEXT("%s plan recheck failed because of subnodes active at task %s"),
@@ -2101,9 +2073,101 @@ bool UHTNPlanInstance::RecheckCurrentPlan(const FBlackboardWorldState* WorldStat
 		}
 	}
 
+	bSucceeded = true;
+	if (bTrackDependencies)
+	{
+		RecheckDependencies.FinishRecording(ActiveStepIDs, NumKeys);
+		if (!ObserveKeysReadByRecheck())
+		{
+			RecheckDependencies.Reset();
+		}
+	}
+
+	return true;
+}
+
+bool UHTNPlanInstance::ObserveBlackboardForRecheck()
+{
+	UBlackboardComponent* const Blackboard = OwnerComponent ? OwnerComponent->GetBlackboardComponent() : nullptr;
+	if (!IsValid(Blackboard) || !Blackboard->HasValidAsset())
+	{
+		return false;
+	}
+
+	if (ObservedBlackboard == Blackboard)
+	{
+		return true;
+	}
+
+	// Changing observers from inside UBlackboardComponent::NotifyObservers is not safe (see HTN_ALLOW_START_PLAN_DURING_BLACKBOARD_NOTIFY_OBSERVERS).
+	// Rechecks will be done in full until we can observe.
+	if (IsInsideBlackboardNotifyObservers(Blackboard))
+	{
+		return false;
+	}
+
+	StopObservingBlackboardForRecheck();
+
+	// Observers are added in ObserveKeysReadByRecheck, only for the keys that rechecks actually read.
+	ObservedBlackboard = Blackboard;
+	ObservedKeys.Init(false, Blackboard->GetNumKeys());
+
+	return true;
+}
+
+bool UHTNPlanInstance::ObserveKeysReadByRecheck()
+{
+	UBlackboardComponent* const Blackboard = ObservedBlackboard.Get();
+	if (!Blackboard)
+	{
+		return false;
+	}
+
+	for (TConstSetBitIterator<> It(RecheckDependencies.GetReadKeys()); It; ++It)
+	{
+		const int32 KeyIndex = It.GetIndex();
+		if (!ObservedKeys.IsValidIndex(KeyIndex))
+		{
+			return false;
+		}
+
+		if (!ObservedKeys[KeyIndex])
+		{
+			// Adding observers from inside UBlackboardComponent::NotifyObservers is not safe (see HTN_ALLOW_START_PLAN_DURING_BLACKBOARD_NOTIFY_OBSERVERS).
+			// Rechecks will be done in full until we can observe.
+			if (IsInsideBlackboardNotifyObservers(Blackboard))
+			{
+				return false;
+			}
+
+			Blackboard->RegisterObserver(FBlackboard::FKey(KeyIndex), this,
+				FOnBlackboardChangeNotification::CreateUObject(this, &UHTNPlanInstance::OnBlackboardKeyValueChange));
+			ObservedKeys[KeyIndex] = true;
+		}
+	}
+
 	return true;
 }
 
+void UHTNPlanInstance::StopObservingBlackboardForRecheck()
+{
+	if (UBlackboardComponent* const Blackboard = ObservedBlackboard.Get())
+	{
+		Blackboard->UnregisterObserversFrom(this);
+	}
+
+	ObservedBlackboard.Reset();
+	ObservedKeys.Reset();
+	RecheckDependencies.Reset();
+}
+
+EBlackboardNotificationResult UHTNPlanInstance::OnBlackboardKeyValueChange(const UBlackboardComponent& Blackboard, FBlackboard::FKey ChangedKeyID)
+{
+	RecheckDependencies.NotifyKeyChanged(ChangedKeyID);
+
+	return EBlackboardNotificationResult::ContinueObserving;
+}
+
 void UHTNPlanInstance::TickCurrentPlan(float DeltaTime)
 {
 	check(HasActivePlan());
@@ -2267,6 +2331,7 @@ EHTNNodeResult UHTNPlanInstance::StartExecuteTask(const FHTNPlanStepID& PlanStep
 
 	check(!CurrentlyExecutingStepIDs.Contains(PlanStepID));
 	CurrentlyExecutingStepIDs.Add(PlanStepID);
+	AddStepToActiveNodeIndex(PlanStepID, EHTNTaskStatus::Active);
 #if USE_HTN_DEBUGGER
 	OwnerComponent->StoreDebugStep();
 #endif
@@ -2554,6 +2619,84 @@ UHTNTask& UHTNPlanInstance::GetTaskInCurrentPlan(const FHTNPlanStepID& Executing
 	return *ExecutingTask;
 }
 
+void UHTNPlanInstance::AddStepToActiveNodeIndex(const FHTNPlanStepID& StepID, EHTNTaskStatus Status)
+{
+	check(HasActivePlan());
+
+	const FHTNPlanStep& Step = CurrentPlan->GetStep(StepID);
+	ActiveNodeIndex.FindOrAdd(Step.Node.Get()).Add({ StepID, Step.NodeMemoryOffset, Status });
+
+	// Subnodes that span several steps get an entry for each of them, same as the steps would be found by going through their subnodes.
+	FHTNSubNodeGroups SubNodeGroups;
+	CurrentPlan->GetSubNodesAtPlanStep(StepID, SubNodeGroups);
+	for (const FHTNSubNodeGroup& Group : SubNodeGroups)
+	{
+		for (const THTNNodeInfo<UHTNDecorator>& DecoratorInfo : Group.SubNodesInfo->DecoratorInfos)
+		{
+			ActiveNodeIndex.FindOrAdd(DecoratorInfo.TemplateNode).Add({ StepID, DecoratorInfo.NodeMemoryOffset, Status });
+		}
+
+		for (const THTNNodeInfo<UHTNService>& ServiceInfo : Group.SubNodesInfo->ServiceInfos)
+		{
+			ActiveNodeIndex.FindOrAdd(ServiceInfo.TemplateNode).Add({ StepID, ServiceInfo.NodeMemoryOffset, Status });
+		}
+	}
+}
+
+void UHTNPlanInstance::RemoveStepFromActiveNodeIndex(const FHTNPlanStepID& StepID)
+{
+	for (auto It = ActiveNodeIndex.CreateIterator(); It; ++It)
+	{
+		It.Value().RemoveAll([&](const FHTNActiveNodeIndexEntry& Entry) { return Entry.StepID == StepID; });
+		if (!It.Value().Num())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+FHTNNodeInPlanInfo UHTNPlanInstance::FindInActiveNodeIndex(const UHTNNode* NodeTemplate, const uint8* NodeMemory) const
+{
+	if (NodeMemory && !OwnsNodeMemory(NodeMemory))
+	{
+		return {};
+	}
+
+	if (!HasActivePlan() || !IsValid(NodeTemplate))
+	{
+		return {};
+	}
+
+	const TArray<FHTNActiveNodeIndexEntry, TInlineAllocator<1>>* const Entries = ActiveNodeIndex.Find(NodeTemplate);
+	if (!Entries)
+	{
+		return {};
+	}
+
+	// Executing steps take precedence over aborting ones.
+	for (const EHTNTaskStatus Status : { EHTNTaskStatus::Active, EHTNTaskStatus::Aborting })
+	{
+		for (const FHTNActiveNodeIndexEntry& Entry : *Entries)
+		{
+			if (Entry.Status == Status)
+			{
+				uint8* const FoundMemory = GetNodeMemory(Entry.NodeMemoryOffset);
+				if (!NodeMemory || NodeMemory == FoundMemory)
+				{
+					FHTNNodeInPlanInfo Result;
+					Result.PlanInstance = const_cast<UHTNPlanInstance*>(this);
+					Result.NodeMemory = FoundMemory;
+					Result.Status = Status;
+					Result.PlanStepID = Entry.StepID;
+					return Result;
+				}
+			}
+		}
+	}
+
+	return {};
+}
+
 void UHTNPlanInstance::RemovePendingExecutionPlanSteps()
 {
 	for (int32 I = PendingExecutionStepIDs.Num() - 1; I >= 0; --I)
@@ -2592,6 +2735,8 @@ void UHTNPlanInstance::AbortExecutingPlanStep(FHTNPlanStepID PlanStepID)
 
 	CurrentlyExecutingStepIDs.RemoveSingle(PlanStepID);
 	CurrentlyAbortingStepIDs.Add(PlanStepID);
+	RemoveStepFromActiveNodeIndex(PlanStepID);
+	AddStepToActiveNodeIndex(PlanStepID, EHTNTaskStatus::Aborting);
 
 	const EHTNNodeResult Result = Task.WrappedAbortTask(*OwnerComponent, TaskMemory);
 	UE_CVLOG_UELOG(Result != EHTNNodeResult::Aborted && Result != EHTNNodeResult::InProgress, 
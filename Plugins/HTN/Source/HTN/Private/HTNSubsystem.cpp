@@ -0,0 +1,139 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#include "HTNSubsystem.h"
+#include "HTNComponent.h"
+#include "HTNTypes.h"
+
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_CYCLE_STAT(TEXT("Subsystem Tick"), STAT_AI_HTN_SubsystemTick, STATGROUP_AI_HTN);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Subsystem Registered Components"), STAT_AI_HTN_SubsystemRegisteredComponents, STATGROUP_AI_HTN);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Subsystem Ticked Components"), STAT_AI_HTN_SubsystemTickedComponents, STATGROUP_AI_HTN);
+
+namespace
+{
+	int32 GHTNMaxTickPeriod = 8;
+	FAutoConsoleVariableRef CVarHTNMaxTickPeriod(
+		TEXT("ai.htn.MaxTickPeriod"),
+		GHTNMaxTickPeriod,
+		TEXT("The number of frames between ticks of HTNComponents with a tick significance of 0, when ticked by the HTN subsystem.\n")
+		TEXT("Components with higher significance tick more often, down to every frame at a significance of 1."),
+		ECVF_Default);
+}
+
+void UHTNSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_AI_HTN_SubsystemRegisteredComponents, ComponentToEntryIndex.Num());
+
+	Entries.Reset();
+	FreeEntryIndices.Reset();
+	ComponentToEntryIndex.Reset();
+	for (TArray<FWheelItem>& Slot : Wheel)
+	{
+		Slot.Reset();
+	}
+
+	Super::Deinitialize();
+}
+
+void UHTNSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AI_HTN_SubsystemTick);
+
+	CurrentTime += DeltaTime;
+
+	// Components ticked in this frame get scheduled into other slots (or this one again after a full turn of the wheel),
+	// so take the items out of the slot first.
+	TArray<FWheelItem> ItemsToTick = MoveTemp(Wheel[CurrentSlot]);
+	Wheel[CurrentSlot].Reset();
+
+	for (const FWheelItem& Item : ItemsToTick)
+	{
+		// Entries can be removed or reused by components unregistering during the ticks of other components.
+		if (!Entries.IsValidIndex(Item.EntryIndex) || Entries[Item.EntryIndex].Serial != Item.Serial)
+		{
+			continue;
+		}
+
+		FEntry& Entry = Entries[Item.EntryIndex];
+		UHTNComponent* const Component = Entry.Component.Get();
+		if (!IsValid(Component))
+		{
+			continue;
+		}
+
+		const float ComponentDeltaTime = StaticCast<float>(CurrentTime - Entry.LastTickTime);
+		Entry.LastTickTime = CurrentTime;
+		ScheduleTick(Item.EntryIndex, Entry.TickPeriod);
+
+		INC_DWORD_STAT(STAT_AI_HTN_SubsystemTickedComponents);
+		Component->TickHTN(ComponentDeltaTime);
+	}
+
+	CurrentSlot = (CurrentSlot + 1) % NumWheelSlots;
+}
+
+TStatId UHTNSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHTNSubsystem, STATGROUP_Tickables);
+}
+
+void UHTNSubsystem::RegisterComponent(UHTNComponent& Component)
+{
+	if (ComponentToEntryIndex.Contains(&Component))
+	{
+		return;
+	}
+
+	const int32 EntryIndex = FreeEntryIndices.Num() ? FreeEntryIndices.Pop(/*bAllowShrinking=*/false) : Entries.AddDefaulted();
+	FEntry& Entry = Entries[EntryIndex];
+	Entry.Component = &Component;
+	Entry.LastTickTime = CurrentTime;
+	Entry.TickPeriod = GetTickPeriodForSignificance(Component.GetTickSignificance());
+	ComponentToEntryIndex.Add(&Component, EntryIndex);
+	INC_DWORD_STAT(STAT_AI_HTN_SubsystemRegisteredComponents);
+
+	// Spread components with the same tick period across different frames.
+	ScheduleTick(EntryIndex, 1 + EntryIndex % Entry.TickPeriod);
+}
+
+void UHTNSubsystem::UnregisterComponent(UHTNComponent& Component)
+{
+	int32 EntryIndex = INDEX_NONE;
+	if (ComponentToEntryIndex.RemoveAndCopyValue(&Component, EntryIndex))
+	{
+		FEntry& Entry = Entries[EntryIndex];
+		Entry.Component = nullptr;
+		++Entry.Serial;
+		FreeEntryIndices.Add(EntryIndex);
+		DEC_DWORD_STAT(STAT_AI_HTN_SubsystemRegisteredComponents);
+	}
+}
+
+void UHTNSubsystem::SetTickPeriod(const UHTNComponent& Component, int32 TickPeriod)
+{
+	if (const int32* const EntryIndex = ComponentToEntryIndex.Find(&Component))
+	{
+		Entries[*EntryIndex].TickPeriod = FMath::Clamp(TickPeriod, 1, NumWheelSlots);
+	}
+}
+
+int32 UHTNSubsystem::GetTickPeriodForSignificance(float Significance)
+{
+	const int32 MaxTickPeriod = FMath::Clamp(GHTNMaxTickPeriod, 1, NumWheelSlots);
+	const float Alpha = 1.0f - FMath::Clamp(Significance, 0.0f, 1.0f);
+	return FMath::Clamp(FMath::RoundToInt(FMath::Lerp(1.0f, StaticCast<float>(MaxTickPeriod), Alpha)), 1, MaxTickPeriod);
+}
+
+bool UHTNSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHTNSubsystem::ScheduleTick(int32 EntryIndex, int32 FramesFromNow)
+{
+	check(FramesFromNow >= 1 && FramesFromNow <= NumWheelSlots);
+	const int32 Slot = (CurrentSlot + FramesFromNow) % NumWheelSlots;
+	Wheel[Slot].Add({ EntryIndex, Entries[EntryIndex].Serial });
+}
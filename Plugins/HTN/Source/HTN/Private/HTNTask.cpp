@@ -26,7 +26,8 @@ UHTNTask::UHTNTask(const FObjectInitializer& ObjectInitializer) : Super(ObjectIn
 	bShowTaskNameOnCurrentPlanVisualization(true),
 	bProcessSubmittedPlanStepsInOrder(false),
 	bNotifyTick(false),
-	bNotifyTaskFinished(false)
+	bNotifyTaskFinished(false),
+	bRecheckPlanOnlyDependsOnWorldState(false)
 {}
 
 void UHTNTask::MakePlanExpansions(FHTNPlanningContext& Context)
@@ -38,6 +39,17 @@ void UHTNTask::MakePlanExpansions(FHTNPlanningContext& Context)
 	}
 }
 
+bool UHTNTask::IsClosestNativeClass(const UClass* NativeClass) const
+{
+	const UClass* Class = GetClass();
+	while (Class && !Class->HasAnyClassFlags(CLASS_Native))
+	{
+		Class = Class->GetSuperClass();
+	}
+
+	return Class == NativeClass;
+}
+
 uint16 UHTNTask::GetSpecialMemorySize() const { return sizeof(FHTNTaskSpecialMemory); }
 
 void UHTNTask::InitializeSpecialMemory(UHTNComponent& OwnerComp, uint8* NodeMemory, const FHTNPlan& Plan, const FHTNPlanStepID& StepID) const
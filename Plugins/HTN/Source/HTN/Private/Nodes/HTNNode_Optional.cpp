@@ -6,6 +6,7 @@
 UHTNNode_Optional::UHTNNode_Optional(const FObjectInitializer& Initializer) : Super(Initializer)
 {
 	bPlanNextNodesAfterThis = false;
+	bCanPlanOnWorkerThread = true;
 }
 
 void UHTNNode_Optional::MakePlanExpansions(FHTNPlanningContext& Context)
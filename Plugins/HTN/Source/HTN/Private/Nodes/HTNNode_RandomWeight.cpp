@@ -8,6 +8,7 @@ UHTNNode_RandomWeight::UHTNNode_RandomWeight(const FObjectInitializer& Initializ
 	RandomWeight(1.0f)
 {
 	bPlanNextNodesAfterThis = false;
+	bCanPlanOnWorkerThread = true;
 }
 
 FString UHTNNode_RandomWeight::GetNodeName() const
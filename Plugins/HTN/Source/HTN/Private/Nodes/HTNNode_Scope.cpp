@@ -8,6 +8,7 @@
 UHTNNode_Scope::UHTNNode_Scope(const FObjectInitializer& Initializer) : Super(Initializer)
 {
 	bPlanNextNodesAfterThis = false;
+	bCanPlanOnWorkerThread = true;
 }
 
 FString UHTNNode_Scope::GetNodeName() const
@@ -2,6 +2,13 @@
 
 #include "Nodes/HTNNode_SubNetwork.h"
 #include "AITask_MakeHTNPlan.h"
+#include "Utility/HTNPlanningHeuristic.h"
+#include "Utility/HTNWorkerThreadPlanningValidator.h"
+
+UHTNNode_SubNetwork::UHTNNode_SubNetwork(const FObjectInitializer& Initializer) : Super(Initializer)
+{
+	bCanPlanOnWorkerThread = true;
+}
 
 FString UHTNNode_SubNetwork::GetStaticDescription() const
 {
@@ -42,6 +49,17 @@ void UHTNNode_SubNetwork::GetNextPrimitiveSteps(FHTNGetNextStepsContext& Context
 	Context.AddFirstPrimitiveStepsInLevel(Step.SubLevelIndex);
 }
 
+int32 UHTNNode_SubNetwork::GetPlanningCostLowerBound(FHTNPlanningHeuristic& Heuristic) const
+{
+	// If the subnetwork is invalid, the node is planned without a sublevel.
+	return HTN ? Heuristic.GetCostLowerBound(*HTN) : 0;
+}
+
+bool UHTNNode_SubNetwork::CanPlanContentsOnWorkerThread(FHTNWorkerThreadPlanningValidator& Validator) const
+{
+	return !HTN || Validator.CanPlanOnWorkerThread(*HTN);
+}
+
 FString UHTNNode_SubNetwork::GetNodeName() const
 {
 	if (!HTN || NodeName.Len())
@@ -7,6 +7,7 @@ UHTNNode_TwoBranches::UHTNNode_TwoBranches(const FObjectInitializer& ObjectIniti
 	NumPrimaryNodes(INDEX_NONE)
 {
 	bPlanNextNodesAfterThis = false;
+	bCanPlanOnWorkerThread = true;
 }
 
 void UHTNNode_TwoBranches::GetNextNodes(FHTNNextNodesBuffer& OutNextNodes, const FHTNPlan& Plan, const FHTNPlanStepID& ThisStepID, int32 SubLevelIndex)
@@ -9,9 +9,11 @@ void UHTNTask_BlackboardBase::InitializeFromAsset(UHTN& Asset)
 	if (const UBlackboardData* const BBAsset = GetBlackboardAsset())
 	{
 		BlackboardKey.ResolveSelectedKey(*BBAsset);
+		BlackboardKeyHandle.Resolve(*BBAsset, BlackboardKey);
 	}
 	else
 	{
 		UE_LOG(LogHTN, Warning, TEXT("Can't initialize task: %s, make sure that the HTN specifies a Blackboard asset!"), *GetShortDescription());
+		BlackboardKeyHandle.Invalidate();
 	}
 }
@@ -31,6 +31,8 @@ UHTNTask_BlueprintBase::UHTNTask_BlueprintBase(const FObjectInitializer& Initial
 #undef IS_IMPLEMENTED
 
 	bNotifyTick = bImplementsTick;
+	// Blueprints can look at anything when rechecking.
+	bRecheckPlanOnlyDependsOnWorldState = !bImplementsRecheckPlan;
 	// We need OnExecutionFinish to be called even if ReceiveExecutionFinish is not implemented in Blueprints,
 	// so that we can abort latent actions (e.g. Delay nodes) and timers.
 	bNotifyTaskFinished = true;
@@ -7,6 +7,8 @@ UHTNTask_ClearValue::UHTNTask_ClearValue(const FObjectInitializer& ObjectInitial
 {
 	NodeName = TEXT("Clear Value");
 	bShowTaskNameOnCurrentPlanVisualization = false;
+	bCanPlanOnWorkerThread = true;
+	bRecheckPlanOnlyDependsOnWorldState = IsClosestNativeClass(StaticClass());
 }
 
 void UHTNTask_ClearValue::CreatePlanSteps(UHTNComponent& OwnerComp, UAITask_MakeHTNPlan& PlanningTask, const TSharedRef<const FBlackboardWorldState>& WorldState) const
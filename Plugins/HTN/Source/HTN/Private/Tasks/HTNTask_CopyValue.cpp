@@ -7,6 +7,8 @@
 UHTNTask_CopyValue::UHTNTask_CopyValue(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	bShowTaskNameOnCurrentPlanVisualization = false;
+	bCanPlanOnWorkerThread = true;
+	bRecheckPlanOnlyDependsOnWorldState = IsClosestNativeClass(StaticClass());
 }
 
 void UHTNTask_CopyValue::InitializeFromAsset(UHTN& Asset)
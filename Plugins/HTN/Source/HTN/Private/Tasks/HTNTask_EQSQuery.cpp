@@ -19,6 +19,7 @@ UHTNTask_EQSQuery::UHTNTask_EQSQuery(const FObjectInitializer& Initializer) : Su
 	Cost(0)
 {
 	bShowTaskNameOnCurrentPlanVisualization = false;
+	bRecheckPlanOnlyDependsOnWorldState = IsClosestNativeClass(StaticClass());
 }
 
 void UHTNTask_EQSQuery::Serialize(FArchive& Ar)
@@ -69,12 +70,31 @@ void UHTNTask_EQSQuery::CreatePlanSteps(UHTNComponent& OwnerComp, UAITask_MakeHT
 		return;
 	}
 
+	// Other branches of this planning session may have already run the same query 
+	// from a worldstate with the same values in all the keys that query read.
+	FHTNPlanningEQSCache& EQSCache = PlanningTask.GetEQSCache();
+	FHTNEQSCacheKey CacheKey;
+	CacheKey.QueryTemplate = EQSRequest.GetQueryTemplate(*QueryOwner, *WorldState);
+	CacheKey.Querier = QueryOwner;
+	CacheKey.StaticParamsHash = EQSRequest.GetStaticParamsHash();
+	if (const TSharedPtr<FEnvQueryResult> CachedResult = EQSCache.Find(CacheKey, *WorldState))
+	{
+		SubmitPlanStepsFromQueryResult(PlanningTask, *WorldState, *CachedResult);
+		return;
+	}
+
+	// Record which keys the query reads (through its template, params and contexts) until it finishes.
+	const UBlackboardComponent* const BlackboardComponent = OwnerComp.GetBlackboardComponent();
+	const int32 RecordingID = BlackboardComponent ? EQSCache.StartRecording(WorldState, BlackboardComponent->GetNumKeys()) : 0;
+
 	const int32 RequestID = EQSRequest.Execute(*QueryOwner, *WorldState, FQueryFinishedSignature::CreateWeakLambda(const_cast<UHTNTask_EQSQuery*>(this), 
 	[
 		this, 
 		WorldStatePtr = TWeakPtr<const FBlackboardWorldState>(WorldState), 
 		PlanningTaskPtr = TWeakObjectPtr<UAITask_MakeHTNPlan>(&PlanningTask),
-		PlanningID = PlanningTask.GetPlanningID()
+		PlanningID = PlanningTask.GetPlanningID(),
+		RecordingID,
+		CacheKey
 	]
 	(TSharedPtr<FEnvQueryResult> Result)
 	{
@@ -90,56 +110,72 @@ void UHTNTask_EQSQuery::CreatePlanSteps(UHTNComponent& OwnerComp, UAITask_MakeHT
 		{
 			return;
 		}
-		
-#if ENGINE_MAJOR_VERSION >= 5
-		const bool bSuccess = Result.IsValid() && Result->IsSuccessful() && Result->Items.Num() > 0;
-#else
-		const bool bSuccess = Result.IsValid() && Result->IsSuccsessful() && Result->Items.Num() > 0;
-#endif
-		if (!bSuccess)
+
+		const bool bCanShareResult = Result.IsValid() && Result->IsFinished() && !Result->IsAborted();
+		PlanningTaskPtr->GetEQSCache().FinishRecording(RecordingID, CacheKey, bCanShareResult ? Result : nullptr);
+
+		if (!Result.IsValid())
 		{
 			PlanningTaskPtr->SetNodePlanningFailureReason(TEXT("EQS query failed"));
 			return;
 		}
 
-		const TSharedPtr<const FBlackboardWorldState> OldWorldState = WorldStatePtr.Pin();
-		if (!OldWorldState.IsValid())
+		if (const TSharedPtr<const FBlackboardWorldState> OldWorldState = WorldStatePtr.Pin())
 		{
-			return;
+			SubmitPlanStepsFromQueryResult(*PlanningTaskPtr, *OldWorldState, *Result);
 		}
+	}));
 
-		UEnvQueryItemType* const ItemTypeCDO = Result->ItemType->GetDefaultObject<UEnvQueryItemType>();
-		if (!ensure(ItemTypeCDO))
-		{
-			return;
-		}
+	if (RequestID != INDEX_NONE)
+	{
+		PlanningTask.WaitForLatentCreatePlanSteps(this);
+	}
+	else
+	{
+		EQSCache.FinishRecording(RecordingID, CacheKey, nullptr);
+	}
+}
 
-		const int32 MaxNumSteps = EQSRequest.RunMode == EEnvQueryRunMode::AllMatching ? FMath::Max(MaxNumCandidatePlans, 0) : 1;
-		const int32 NumSteps = MaxNumSteps > 0 ? FMath::Min(Result->Items.Num(), MaxNumSteps) : Result->Items.Num();
-		for (int32 ItemIndex = 0; ItemIndex < NumSteps; ++ItemIndex)
+void UHTNTask_EQSQuery::SubmitPlanStepsFromQueryResult(UAITask_MakeHTNPlan& PlanningTask, const FBlackboardWorldState& WorldState, const FEnvQueryResult& Result) const
+{
+#if ENGINE_MAJOR_VERSION >= 5
+	const bool bSuccess = Result.IsSuccessful() && Result.Items.Num() > 0;
+#else
+	const bool bSuccess = Result.IsSuccsessful() && Result.Items.Num() > 0;
+#endif
+	if (!bSuccess)
+	{
+		PlanningTask.SetNodePlanningFailureReason(TEXT("EQS query failed"));
+		return;
+	}
+
+	UEnvQueryItemType* const ItemTypeCDO = Result.ItemType->GetDefaultObject<UEnvQueryItemType>();
+	if (!ensure(ItemTypeCDO))
+	{
+		return;
+	}
+
+	// The items are read straight from the (possibly shared) raw data of the result, without copying it per candidate.
+	const int32 MaxNumSteps = EQSRequest.RunMode == EEnvQueryRunMode::AllMatching ? FMath::Max(MaxNumCandidatePlans, 0) : 1;
+	const int32 NumSteps = MaxNumSteps > 0 ? FMath::Min(Result.Items.Num(), MaxNumSteps) : Result.Items.Num();
+	for (int32 ItemIndex = 0; ItemIndex < NumSteps; ++ItemIndex)
+	{
+		const TSharedRef<FBlackboardWorldState> NewWorldState = WorldState.MakeNext();
+		const uint8* const RawItemData = Result.RawData.GetData() + Result.Items[ItemIndex].DataOffset;
+		if (StoreInWorldState(ItemTypeCDO, BlackboardKey, *NewWorldState, RawItemData))
 		{
-			const TSharedRef<FBlackboardWorldState> NewWorldState = OldWorldState->MakeNext();
-			const uint8* const RawItemData = Result->RawData.GetData() + Result->Items[ItemIndex].DataOffset;
-			if (StoreInWorldState(ItemTypeCDO, BlackboardKey, *NewWorldState, RawItemData))
-			{
 #if HTN_DEBUG_PLANNING && ENABLE_VISUAL_LOG
-				const FString Description = FVisualLogger::IsRecording() ? ItemTypeCDO->GetDescription(RawItemData) : TEXT("");
+			const FString Description = FVisualLogger::IsRecording() ? ItemTypeCDO->GetDescription(RawItemData) : TEXT("");
 #else
-				const FString Description = TEXT("");
+			const FString Description = TEXT("");
 #endif
-				PlanningTaskPtr->SubmitPlanStep(this, NewWorldState, FMath::Max(0, Cost), Description);
-			}
-			else
-			{
-				UE_LOG(LogHTN, Error, TEXT("%s: Failed to store result %i (%s) into world state at key %s"),
-					*GetShortDescription(), ItemIndex, *ItemTypeCDO->GetDescription(RawItemData), *BlackboardKey.SelectedKeyName.ToString());
-			}
+			PlanningTask.SubmitPlanStep(this, NewWorldState, FMath::Max(0, Cost), Description);
+		}
+		else
+		{
+			UE_LOG(LogHTN, Error, TEXT("%s: Failed to store result %i (%s) into world state at key %s"),
+				*GetShortDescription(), ItemIndex, *ItemTypeCDO->GetDescription(RawItemData), *BlackboardKey.SelectedKeyName.ToString());
 		}
-	}));
-
-	if (RequestID != INDEX_NONE)
-	{
-		PlanningTask.WaitForLatentCreatePlanSteps(this);
 	}
 }
 
@@ -6,7 +6,10 @@
 
 UHTNTask_Fail::UHTNTask_Fail(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer),
 	bFailDuringExecution(false)
-{}
+{
+	bCanPlanOnWorkerThread = true;
+	bRecheckPlanOnlyDependsOnWorldState = IsClosestNativeClass(StaticClass());
+}
 
 void UHTNTask_Fail::CreatePlanSteps(UHTNComponent& OwnerComp, UAITask_MakeHTNPlan& PlanningTask, const TSharedRef<const FBlackboardWorldState>& WorldState) const 
 {
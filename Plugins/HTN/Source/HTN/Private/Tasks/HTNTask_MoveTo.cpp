@@ -21,6 +21,7 @@ UHTNTask_MoveTo::UHTNTask_MoveTo(const FObjectInitializer& ObjectInitializer) :
 {
 	NodeName = TEXT("Move To");
 	bNotifyTaskFinished = true;
+	bRecheckPlanOnlyDependsOnWorldState = IsClosestNativeClass(StaticClass());
 	
 	AcceptableRadius = GET_AI_CONFIG_VAR(AcceptanceRadius);
 	bReachTestIncludesGoalRadius = bReachTestIncludesAgentRadius = GET_AI_CONFIG_VAR(bFinishMoveOnGoalOverlap);
@@ -8,6 +8,8 @@ UHTNTask_Replan::UHTNTask_Replan(const FObjectInitializer& ObjectInitializer) :
 {
 	// Because the most common expected use case of this task is to force-replan the subplan we're in regardless of its settings.
 	Parameters.bForceReplan = true;
+	bCanPlanOnWorkerThread = true;
+	bRecheckPlanOnlyDependsOnWorldState = IsClosestNativeClass(StaticClass());
 }
 
 void UHTNTask_Replan::CreatePlanSteps(UHTNComponent& OwnerComp, UAITask_MakeHTNPlan& PlanningTask, const TSharedRef<const FBlackboardWorldState>& WorldState) const
@@ -8,7 +8,10 @@
 UHTNTask_ResetCooldown::UHTNTask_ResetCooldown(const FObjectInitializer& Initializer) : Super(Initializer),
 	AffectedCooldowns(EHTNResetCooldownAffectedCooldowns::CooldownsWithGameplayTag),
 	GameplayTag(FGameplayTag::EmptyTag)
-{}
+{
+	bCanPlanOnWorkerThread = true;
+	bRecheckPlanOnlyDependsOnWorldState = IsClosestNativeClass(StaticClass());
+}
 
 FString UHTNTask_ResetCooldown::GetNodeName() const
 {
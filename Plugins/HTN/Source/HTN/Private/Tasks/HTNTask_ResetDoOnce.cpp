@@ -8,7 +8,10 @@
 UHTNTask_ResetDoOnce::UHTNTask_ResetDoOnce(const FObjectInitializer& Initializer) : Super(Initializer),
 	AffectedDecorators(EHTNResetDoOnceAffectedDecorators::DoOnceDecoratorsWithGameplayTag),
 	GameplayTag(FGameplayTag::EmptyTag)
-{}
+{
+	bCanPlanOnWorkerThread = true;
+	bRecheckPlanOnlyDependsOnWorldState = IsClosestNativeClass(StaticClass());
+}
 
 FString UHTNTask_ResetDoOnce::GetNodeName() const
 {
@@ -7,6 +7,8 @@ UHTNTask_SetValue::UHTNTask_SetValue(const FObjectInitializer& ObjectInitializer
 {
 	NodeName = TEXT("Set Value");
 	bShowTaskNameOnCurrentPlanVisualization = false;
+	bCanPlanOnWorkerThread = true;
+	bRecheckPlanOnlyDependsOnWorldState = IsClosestNativeClass(StaticClass());
 }
 
 void UHTNTask_SetValue::CreatePlanSteps(UHTNComponent& OwnerComp, UAITask_MakeHTNPlan& PlanningTask, const TSharedRef<const FBlackboardWorldState>& WorldState) const
@@ -19,7 +21,7 @@ void UHTNTask_SetValue::CreatePlanSteps(UHTNComponent& OwnerComp, UAITask_MakeHT
 	}
 
 	const TSharedRef<FBlackboardWorldState> WorldStateAfterTask = WorldState->MakeNext();
-	if (Value.SetValue(*WorldStateAfterTask, BlackboardKey))
+	if (Value.SetValue(*WorldStateAfterTask, BlackboardKeyHandle))
 	{
 		PlanningTask.SubmitPlanStep(this, WorldStateAfterTask, 0);
 	}
@@ -19,6 +19,9 @@ UHTNTask_SubPlan::UHTNTask_SubPlan(const FObjectInitializer& ObjectInitializer)
 
 	bNotifyTick = true;
 	bNotifyTaskFinished = true;
+
+	// Rechecking depends on the state of the subplan instance.
+	bRecheckPlanOnlyDependsOnWorldState = false;
 }
 
 FString UHTNTask_SubPlan::GetStaticDescription() const
@@ -7,6 +7,8 @@ UHTNTask_Success::UHTNTask_Success(const FObjectInitializer& ObjectInitializer)
 	Cost(0)
 {
 	bShowTaskNameOnCurrentPlanVisualization = false;
+	bCanPlanOnWorkerThread = true;
+	bRecheckPlanOnlyDependsOnWorldState = IsClosestNativeClass(StaticClass());
 }
 
 void UHTNTask_Success::Serialize(FArchive& Ar)
@@ -11,6 +11,8 @@ UHTNTask_Wait::UHTNTask_Wait(const FObjectInitializer& ObjectInitializer) : Supe
 	Cost(0)
 {
 	bNotifyTick = true;
+	bCanPlanOnWorkerThread = true;
+	bRecheckPlanOnlyDependsOnWorldState = IsClosestNativeClass(StaticClass());
 }
 
 void UHTNTask_Wait::Serialize(FArchive& Ar)
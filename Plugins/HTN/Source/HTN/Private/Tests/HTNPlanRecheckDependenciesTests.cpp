@@ -0,0 +1,74 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Misc/AutomationTest.h"
+#include "HTNPlanInstance.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HTNPlanRecheckDependenciesTests
+{
+	constexpr int32 NumKeys = 4;
+	constexpr FBlackboard::FKey ReadKey = 1;
+	constexpr FBlackboard::FKey OtherKey = 2;
+
+	// Records a recheck that started at ActiveStep and rechecked NextStep, which read only ReadKey.
+	void RecordRecheck(FHTNPlanRecheckDependencies& Dependencies, const FHTNPlanStepID& ActiveStep, const FHTNPlanStepID& NextStep)
+	{
+		const FHTNPlanStepID ActiveStepIDs[] = { ActiveStep };
+		Dependencies.SetActiveSteps(ActiveStepIDs);
+
+		FHTNPlanRecheckDependencies::FStepDependencies& StepDependencies = Dependencies.RecordStep(NextStep, NumKeys);
+		StepDependencies.bOnlyDependsOnWorldState = true;
+		StepDependencies.ReadKeys[ReadKey] = true;
+
+		Dependencies.FinishRecording(ActiveStepIDs, NumKeys);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHTNPlanRecheckDependenciesTest, "HTN.PlanInstance.RecheckDependencies", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FHTNPlanRecheckDependenciesTest::RunTest(const FString& Parameters)
+{
+	using namespace HTNPlanRecheckDependenciesTests;
+
+	const FHTNPlanStepID ExecutingStep = { 0, 0 };
+	const FHTNPlanStepID NextStep = { 0, 1 };
+
+	FHTNPlanRecheckDependencies Dependencies;
+	TestFalse(TEXT("Nothing can be skipped before anything is recorded"), Dependencies.CanRecheckBeSkipped());
+	TestFalse(TEXT("No step can be skipped before anything is recorded"), Dependencies.CanStepRecheckBeSkipped(NextStep));
+
+	RecordRecheck(Dependencies, ExecutingStep, NextStep);
+	TestTrue(TEXT("Recheck is skipped while nothing changed"), Dependencies.CanRecheckBeSkipped());
+
+	Dependencies.NotifyKeyChanged(OtherKey);
+	TestTrue(TEXT("Recheck is skipped when only unread keys changed"), Dependencies.CanRecheckBeSkipped());
+	TestTrue(TEXT("Step is skipped when only unread keys changed"), Dependencies.CanStepRecheckBeSkipped(NextStep));
+
+	Dependencies.NotifyKeyChanged(ReadKey);
+	TestFalse(TEXT("Recheck is not skipped when a read key changed"), Dependencies.CanRecheckBeSkipped());
+	TestFalse(TEXT("Step is not skipped when a read key changed"), Dependencies.CanStepRecheckBeSkipped(NextStep));
+
+	// The executing step finishes without writing its planned effect to the blackboard, so no key changes,
+	// but the next step now starts from the blackboard instead of the planned worldstate of the finished step.
+	RecordRecheck(Dependencies, ExecutingStep, NextStep);
+	const FHTNPlanStepID ActiveStepsAfterFinish[] = { NextStep };
+	Dependencies.SetActiveSteps(ActiveStepsAfterFinish);
+	TestFalse(TEXT("Recheck is not skipped after an active step finished"), Dependencies.CanRecheckBeSkipped());
+	TestFalse(TEXT("Step is not skipped after an active step finished"), Dependencies.CanStepRecheckBeSkipped(NextStep));
+
+	// A step that may depend on more than the worldstate is never skipped.
+	{
+		const FHTNPlanStepID ActiveStepIDs[] = { ExecutingStep };
+		Dependencies.SetActiveSteps(ActiveStepIDs);
+		Dependencies.RecordStep(NextStep, NumKeys).bOnlyDependsOnWorldState = false;
+		Dependencies.FinishRecording(ActiveStepIDs, NumKeys);
+		TestFalse(TEXT("Recheck is not skipped if a step depends on more than the worldstate"), Dependencies.CanRecheckBeSkipped());
+		TestFalse(TEXT("Step is not skipped if it depends on more than the worldstate"), Dependencies.CanStepRecheckBeSkipped(NextStep));
+	}
+
+	return true;
+}
+
+#endif
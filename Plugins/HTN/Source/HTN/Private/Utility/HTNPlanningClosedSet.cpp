@@ -0,0 +1,204 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#include "Utility/HTNPlanningClosedSet.h"
+#include "BlackboardWorldstate.h"
+#include "HTNPlan.h"
+
+namespace
+{
+	enum class ESubLevelStatus : uint32
+	{
+		None,
+		WaitingForWorldState,
+		Incomplete,
+		Complete
+	};
+
+	ESubLevelStatus GetSubLevelStatus(const FHTNPlan& Plan, int32 SubLevelIndex)
+	{
+		if (!Plan.HasLevel(SubLevelIndex))
+		{
+			return ESubLevelStatus::None;
+		}
+
+		if (Plan.IsLevelComplete(SubLevelIndex))
+		{
+			return ESubLevelStatus::Complete;
+		}
+
+		return Plan.Levels[SubLevelIndex]->WorldStateAtLevelStart.IsValid() ?
+			ESubLevelStatus::Incomplete :
+			ESubLevelStatus::WaitingForWorldState;
+	}
+
+	// The node-specific data of a step only matters while the step still has sublevels to plan.
+	void GetStepStateData(const FHTNPlan& Plan, const FHTNPlanStep& Step, uint64& OutData, uint32& OutFlags)
+	{
+		const ESubLevelStatus PrimaryStatus = GetSubLevelStatus(Plan, Step.SubLevelIndex);
+		const ESubLevelStatus SecondaryStatus = GetSubLevelStatus(Plan, Step.SecondarySubLevelIndex);
+		const bool bHasSubLevelsToPlan =
+			(PrimaryStatus != ESubLevelStatus::None && PrimaryStatus != ESubLevelStatus::Complete) ||
+			(SecondaryStatus != ESubLevelStatus::None && SecondaryStatus != ESubLevelStatus::Complete);
+		if (!bHasSubLevelsToPlan)
+		{
+			OutData = 0;
+			OutFlags = 0;
+			return;
+		}
+
+		OutData = Step.CustomData;
+		OutFlags = StaticCast<uint32>(PrimaryStatus) | (StaticCast<uint32>(SecondaryStatus) << 2) |
+			(Step.bAnyOrderInversed << 4) | (Step.bIsIfNodeFalseBranch << 5) |
+			(Step.bCanConditionsInterruptTrueBranch << 6) | (Step.bCanConditionsInterruptFalseBranch << 7);
+	}
+
+	TSharedPtr<const FBlackboardWorldState> GetWorldStateBeforeStep(const FHTNPlanLevel& Level, int32 StepIndex)
+	{
+		return Level.Steps.IsValidIndex(StepIndex - 1) ? Level.Steps[StepIndex - 1].WorldState : Level.WorldStateAtLevelStart;
+	}
+}
+
+bool FHTNPlanningClosedSet::CheckAndAdd(const FHTNPlan& Plan)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FHTNPlanningClosedSet::CheckAndAdd"), STAT_AI_HTN_ClosedSetCheckAndAdd, STATGROUP_AI_HTN);
+
+	ScratchElements.Reset();
+	MakeStateElements(Plan, ScratchElements);
+	const uint32 Hash = GetStateHash(ScratchElements);
+
+	for (auto It = States.CreateKeyIterator(Hash); It; ++It)
+	{
+		FState& State = It.Value();
+		if (AreStatesEqual(State.Elements, ScratchElements))
+		{
+			if (State.Cost <= Plan.Cost)
+			{
+				++NumPrunedPlans;
+				return true;
+			}
+
+			// Can happen when a cheaper plan was blocked by priority markers until now.
+			State.Cost = Plan.Cost;
+			return false;
+		}
+	}
+
+	States.Add(Hash, { ScratchElements, Plan.Cost });
+	return false;
+}
+
+void FHTNPlanningClosedSet::Reset()
+{
+	States.Reset();
+	ScratchElements.Reset();
+	NumPrunedPlans = 0;
+}
+
+void FHTNPlanningClosedSet::MakeStateElements(const FHTNPlan& Plan, TArray<FElement>& OutElements)
+{
+	OutElements.Add({ Plan.RootNodeOverride.Get() });
+	for (const FHTNPriorityMarker PriorityMarker : Plan.PriorityMarkers)
+	{
+		OutElements.Add({ nullptr, StaticCast<uint64>(PriorityMarker) });
+	}
+
+	if (Plan.RecursionCounts.IsValid())
+	{
+		for (const TPair<TWeakObjectPtr<UHTNNode>, int32>& Pair : *Plan.RecursionCounts)
+		{
+			OutElements.Add({ Pair.Key.Get(), StaticCast<uint64>(Pair.Value) });
+		}
+	}
+
+	for (int32 LevelIndex = 0; LevelIndex < Plan.Levels.Num(); ++LevelIndex)
+	{
+		if (!Plan.HasLevel(LevelIndex) || Plan.Levels[LevelIndex]->IsDummyLevel() || Plan.IsLevelComplete(LevelIndex))
+		{
+			continue;
+		}
+
+		// The step this level continues after.
+		const FHTNPlanLevel& Level = *Plan.Levels[LevelIndex];
+		if (Level.Steps.Num())
+		{
+			const FHTNPlanStep& LastStep = Level.Steps.Last();
+			FElement& Element = OutElements.Add_GetRef({ LastStep.Node.Get() });
+			GetStepStateData(Plan, LastStep, Element.Data, Element.Flags);
+			Element.WorldState = LastStep.WorldState;
+		}
+
+		// The level itself and the steps containing it, up to the top level.
+		// The worldstates before the containing steps are included because their decorators may restore values from them on exit.
+		int32 ChildLevelIndex = LevelIndex;
+		while (true)
+		{
+			const FHTNPlanLevel& ChildLevel = *Plan.Levels[ChildLevelIndex];
+			FElement& LevelElement = OutElements.Add_GetRef({ ChildLevel.HTNAsset.Get() });
+			LevelElement.Flags = ChildLevel.IsInlineLevel();
+			LevelElement.WorldState = ChildLevel.WorldStateAtLevelStart;
+
+			const FHTNPlanStepID& ParentStepID = ChildLevel.ParentStepID;
+			const FHTNPlanStep* const ParentStep = ParentStepID != FHTNPlanStepID::None ? Plan.FindStep(ParentStepID) : nullptr;
+			if (!ParentStep)
+			{
+				break;
+			}
+
+			FElement& ParentElement = OutElements.Add_GetRef({ ParentStep->Node.Get() });
+			GetStepStateData(Plan, *ParentStep, ParentElement.Data, ParentElement.Flags);
+			ParentElement.Flags |= (ParentStep->SecondarySubLevelIndex == ChildLevelIndex) << 8;
+			ParentElement.WorldState = GetWorldStateBeforeStep(*Plan.Levels[ParentStepID.LevelIndex], ParentStepID.StepIndex);
+
+			ChildLevelIndex = ParentStepID.LevelIndex;
+		}
+
+		// Separates the levels so that different splits of the same elements don't compare equal.
+		OutElements.Add({ nullptr, MAX_uint64 });
+	}
+}
+
+uint32 FHTNPlanningClosedSet::GetStateHash(TArrayView<const FElement> Elements)
+{
+	uint32 Hash = 0;
+	for (const FElement& Element : Elements)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(Element.Object));
+		Hash = HashCombine(Hash, GetTypeHash(Element.Data));
+		Hash = HashCombine(Hash, Element.Flags);
+		if (Element.WorldState.IsValid())
+		{
+			Hash = HashCombine(Hash, Element.WorldState->GetValuesHash());
+		}
+	}
+
+	return Hash;
+}
+
+bool FHTNPlanningClosedSet::AreStatesEqual(TArrayView<const FElement> A, TArrayView<const FElement> B)
+{
+	if (A.Num() != B.Num())
+	{
+		return false;
+	}
+
+	for (int32 I = 0; I < A.Num(); ++I)
+	{
+		const FElement& ElementA = A[I];
+		const FElement& ElementB = B[I];
+		if (ElementA.Object != ElementB.Object || ElementA.Data != ElementB.Data || ElementA.Flags != ElementB.Flags)
+		{
+			return false;
+		}
+
+		if (ElementA.WorldState != ElementB.WorldState)
+		{
+			if (!ElementA.WorldState.IsValid() || !ElementB.WorldState.IsValid() ||
+				!ElementA.WorldState->HasEqualValues(*ElementB.WorldState))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,72 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#include "Utility/HTNPlanningEQSCache.h"
+#include "BlackboardWorldstate.h"
+
+FHTNPlanningEQSCache::~FHTNPlanningEQSCache()
+{
+	StopRecording();
+}
+
+TSharedPtr<FEnvQueryResult> FHTNPlanningEQSCache::Find(const FHTNEQSCacheKey& Key, const FBlackboardWorldState& WorldState) const
+{
+	for (auto It = Entries.CreateConstKeyIterator(Key); It; ++It)
+	{
+		const FEntry& Entry = It.Value();
+		if (Entry.WorldState.IsValid() && WorldState.HasEqualValues(*Entry.WorldState, Entry.ReadKeys))
+		{
+			return Entry.Result;
+		}
+	}
+
+	return nullptr;
+}
+
+int32 FHTNPlanningEQSCache::StartRecording(const TSharedRef<const FBlackboardWorldState>& WorldState, int32 NumKeys)
+{
+	StopRecording();
+
+	RecordedWorldState = WorldState;
+	RecordedReadKeys.Init(false, NumKeys);
+	WorldState->SetReadKeysRecorder(&RecordedReadKeys);
+
+	RecordingID = NextRecordingID++;
+	return RecordingID;
+}
+
+void FHTNPlanningEQSCache::FinishRecording(int32 InRecordingID, const FHTNEQSCacheKey& Key, const TSharedPtr<FEnvQueryResult>& Result)
+{
+	if (InRecordingID != RecordingID || RecordingID == 0)
+	{
+		return;
+	}
+
+	const TSharedPtr<const FBlackboardWorldState> WorldState = RecordedWorldState.Pin();
+	StopRecording();
+
+	if (WorldState.IsValid() && Result.IsValid())
+	{
+		FEntry& Entry = Entries.Add(Key);
+		// The snapshot shares the values of the worldstate but is guaranteed to never be modified.
+		Entry.WorldState = WorldState->MakeNext();
+		Entry.ReadKeys = RecordedReadKeys;
+		Entry.Result = Result;
+	}
+}
+
+void FHTNPlanningEQSCache::Reset()
+{
+	StopRecording();
+	Entries.Reset();
+}
+
+void FHTNPlanningEQSCache::StopRecording()
+{
+	if (const TSharedPtr<const FBlackboardWorldState> WorldState = RecordedWorldState.Pin())
+	{
+		WorldState->SetReadKeysRecorder(nullptr);
+	}
+
+	RecordedWorldState.Reset();
+	RecordingID = 0;
+}
@@ -0,0 +1,127 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#include "Utility/HTNPlanningHeuristic.h"
+#include "HTN.h"
+#include "HTNDecorator.h"
+#include "HTNPlan.h"
+
+#include "Algo/AnyOf.h"
+
+namespace
+{
+	FORCEINLINE int32 AddCosts(int32 A, int32 B)
+	{
+		return StaticCast<int32>(FMath::Min<int64>(StaticCast<int64>(A) + B, MAX_int32));
+	}
+}
+
+int32 FHTNPlanningHeuristic::GetRemainingCostLowerBound(const FHTNPlan& Plan)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FHTNPlanningHeuristic::GetRemainingCostLowerBound"), STAT_AI_HTN_GetRemainingCostLowerBound, STATGROUP_AI_HTN);
+
+	// Every level needs to be complete for the plan to be complete, and each step is in only one level,
+	// so the bounds of the incomplete levels can be added up.
+	int32 Bound = 0;
+	for (int32 LevelIndex = 0; LevelIndex < Plan.Levels.Num(); ++LevelIndex)
+	{
+		if (Plan.HasLevel(LevelIndex) && !Plan.Levels[LevelIndex]->IsDummyLevel() && !Plan.IsLevelComplete(LevelIndex))
+		{
+			Bound = AddCosts(Bound, GetLevelRemainingCostLowerBound(Plan, LevelIndex));
+		}
+	}
+
+	return Bound;
+}
+
+int32 FHTNPlanningHeuristic::GetCostLowerBound(const UHTN& HTN)
+{
+	if (const int32* const CachedBound = CachedBounds.Find(&HTN))
+	{
+		return FMath::Max(*CachedBound, 0);
+	}
+
+	CachedBounds.Add(&HTN, INDEX_NONE);
+	const int32 Bound = GetCostLowerBound(HTN.StartNodes);
+	CachedBounds.Add(&HTN, Bound);
+	return Bound;
+}
+
+int32 FHTNPlanningHeuristic::GetCostLowerBound(TArrayView<UHTNStandaloneNode* const> Nodes)
+{
+	int32 MinBound = MAX_int32;
+	for (const UHTNStandaloneNode* const Node : Nodes)
+	{
+		if (Node)
+		{
+			MinBound = FMath::Min(MinBound, GetCostLowerBound(*Node));
+		}
+	}
+
+	return MinBound != MAX_int32 ? MinBound : 0;
+}
+
+int32 FHTNPlanningHeuristic::GetCostLowerBound(const UHTNStandaloneNode& Node)
+{
+	if (const int32* const CachedBound = CachedBounds.Find(&Node))
+	{
+		return FMath::Max(*CachedBound, 0);
+	}
+
+	CachedBounds.Add(&Node, INDEX_NONE);
+
+	// Decorators are allowed to lower the cost of primitive tasks, so the bound of the node itself can't be relied on then.
+	const bool bCostCanBeLowered = Algo::AnyOf(Node.Decorators, [](const UHTNDecorator* Decorator)
+	{
+		return Decorator && Decorator->CanModifyStepCost();
+	});
+	int32 Bound = bCostCanBeLowered ? 0 : FMath::Max(Node.GetPlanningCostLowerBound(*this), 0);
+	if (Node.bPlanNextNodesAfterThis)
+	{
+		Bound = AddCosts(Bound, GetCostLowerBound(Node.NextNodes));
+	}
+
+	CachedBounds.Add(&Node, Bound);
+	return Bound;
+}
+
+void FHTNPlanningHeuristic::Reset()
+{
+	CachedBounds.Reset();
+}
+
+int32 FHTNPlanningHeuristic::GetLevelRemainingCostLowerBound(const FHTNPlan& Plan, int32 LevelIndex)
+{
+	const FHTNPlanLevel& Level = *Plan.Levels[LevelIndex];
+
+	// The level continues with one of the next nodes of its last step, unless the step puts those in its sublevels.
+	if (Level.Steps.Num())
+	{
+		const UHTNStandaloneNode* const LastNode = Level.Steps.Last().Node.Get();
+		return LastNode && LastNode->bPlanNextNodesAfterThis ? GetCostLowerBound(LastNode->NextNodes) : 0;
+	}
+
+	// The level starts with one of the nodes GetWorldStateAndNextNodes would give for it.
+	if (Level.ParentStepID == FHTNPlanStepID::None && Plan.RootNodeOverride.IsValid())
+	{
+		FHTNNextNodesBuffer NextNodes;
+		Plan.RootNodeOverride->GetNextNodes(NextNodes, Plan);
+		return GetCostLowerBound(NextNodes);
+	}
+
+	if (!Level.IsInlineLevel())
+	{
+		return Level.HTNAsset.IsValid() ? GetCostLowerBound(*Level.HTNAsset) : 0;
+	}
+
+	if (const FHTNPlanStep* const ParentStep = Plan.FindStep(Level.ParentStepID))
+	{
+		if (ParentStep->Node.IsValid())
+		{
+			FHTNNextNodesBuffer NextNodes;
+			ParentStep->Node->GetNextNodes(NextNodes, Plan, Level.ParentStepID, LevelIndex);
+			return GetCostLowerBound(NextNodes);
+		}
+	}
+
+	return 0;
+}
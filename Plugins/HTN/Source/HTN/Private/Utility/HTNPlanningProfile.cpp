@@ -0,0 +1,73 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#include "Utility/HTNPlanningProfile.h"
+#include "HTNStandaloneNode.h"
+
+namespace
+{
+	FORCEINLINE double CyclesToMilliseconds(uint64 Cycles)
+	{
+		return FPlatformTime::ToMilliseconds64(Cycles);
+	}
+}
+
+void FHTNPlanningProfile::Reset()
+{
+	NodeStats.Reset();
+	FrontierSizes.Reset();
+	NumExpandedPlans = 0;
+	TotalCycles = 0;
+}
+
+FString FHTNPlanningProfile::ToString() const
+{
+	TStringBuilder<2048> Builder;
+	Builder.Appendf(TEXT("Planning took %.3f ms, expanded %d plans.\n"), CyclesToMilliseconds(TotalCycles), NumExpandedPlans);
+
+	if (FrontierSizes.Num())
+	{
+		int64 SumFrontierSizes = 0;
+		int32 MaxFrontierSize = 0;
+		for (const int32 FrontierSize : FrontierSizes)
+		{
+			SumFrontierSizes += FrontierSize;
+			MaxFrontierSize = FMath::Max(MaxFrontierSize, FrontierSize);
+		}
+		Builder.Appendf(TEXT("Frontier size: max %d, average %.1f, over time:"),
+			MaxFrontierSize, StaticCast<double>(SumFrontierSizes) / FrontierSizes.Num());
+
+		// Show at most this many samples evenly spread across the planning session.
+		static constexpr int32 MaxNumShownSamples = 20;
+		const int32 NumShownSamples = FMath::Min(FrontierSizes.Num(), MaxNumShownSamples);
+		for (int32 I = 0; I < NumShownSamples; ++I)
+		{
+			const int32 SampleIndex = NumShownSamples > 1 ? I * (FrontierSizes.Num() - 1) / (NumShownSamples - 1) : 0;
+			Builder.Appendf(TEXT(" %d"), FrontierSizes[SampleIndex]);
+		}
+		Builder.Append(TEXT("\n"));
+	}
+
+	TArray<TPair<const UHTNStandaloneNode*, const FNodeStats*>> SortedNodeStats;
+	SortedNodeStats.Reserve(NodeStats.Num());
+	for (const TPair<TWeakObjectPtr<const UHTNStandaloneNode>, FNodeStats>& Pair : NodeStats)
+	{
+		SortedNodeStats.Emplace(Pair.Key.Get(), &Pair.Value);
+	}
+	SortedNodeStats.Sort([](const auto& A, const auto& B)
+	{
+		return A.Value->PlanningCycles + A.Value->DecoratorCycles > B.Value->PlanningCycles + B.Value->DecoratorCycles;
+	});
+
+	Builder.Append(TEXT("Node | expansions | submitted plans | decorators ms | planning ms | worldstate copies\n"));
+	for (const TPair<const UHTNStandaloneNode*, const FNodeStats*>& Pair : SortedNodeStats)
+	{
+		const FNodeStats& Stats = *Pair.Value;
+		Builder.Appendf(TEXT("%s | %d | %d | %.3f | %.3f | %u\n"),
+			Pair.Key ? *Pair.Key->GetShortDescription() : TEXT("[missing node]"),
+			Stats.NumExpansions, Stats.NumSubmittedPlans,
+			CyclesToMilliseconds(Stats.DecoratorCycles), CyclesToMilliseconds(Stats.PlanningCycles),
+			Stats.NumWorldStateCopies);
+	}
+
+	return FString(Builder.ToString());
+}
@@ -0,0 +1,224 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#include "Utility/HTNPlanningSnapshot.h"
+#include "HTN.h"
+#include "HTNTypes.h"
+
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_NativeEnum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Rotator.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_String.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+	// Floats are written with enough digits to be read back exactly, so that replays plan from the same values.
+	FString FloatToString(double Value)
+	{
+		return FString::Printf(TEXT("%.17g"), Value);
+	}
+}
+
+FHTNPlanningSnapshot FHTNPlanningSnapshot::Capture(const UHTN& HTN, const UBlackboardComponent& Blackboard)
+{
+	FHTNPlanningSnapshot Snapshot;
+	Snapshot.HTN = &HTN;
+	Snapshot.BlackboardAsset = Blackboard.GetBlackboardAsset();
+
+	for (int32 KeyIndex = 0; KeyIndex < Blackboard.GetNumKeys(); ++KeyIndex)
+	{
+		const FBlackboard::FKey KeyID = StaticCast<FBlackboard::FKey>(KeyIndex);
+		const TSubclassOf<UBlackboardKeyType> KeyType = Blackboard.GetKeyType(KeyID);
+		const FName KeyName = Blackboard.GetKeyName(KeyID);
+
+		FString Value;
+		if (KeyType == UBlackboardKeyType_Bool::StaticClass())
+		{
+			Value = LexToString(Blackboard.GetValue<UBlackboardKeyType_Bool>(KeyID));
+		}
+		else if (KeyType == UBlackboardKeyType_Int::StaticClass())
+		{
+			Value = LexToString(Blackboard.GetValue<UBlackboardKeyType_Int>(KeyID));
+		}
+		else if (KeyType == UBlackboardKeyType_Float::StaticClass())
+		{
+			Value = FloatToString(Blackboard.GetValue<UBlackboardKeyType_Float>(KeyID));
+		}
+		else if (KeyType == UBlackboardKeyType_Enum::StaticClass())
+		{
+			Value = LexToString(Blackboard.GetValue<UBlackboardKeyType_Enum>(KeyID));
+		}
+		else if (KeyType == UBlackboardKeyType_NativeEnum::StaticClass())
+		{
+			Value = LexToString(Blackboard.GetValue<UBlackboardKeyType_NativeEnum>(KeyID));
+		}
+		else if (KeyType == UBlackboardKeyType_Name::StaticClass())
+		{
+			Value = Blackboard.GetValue<UBlackboardKeyType_Name>(KeyID).ToString();
+		}
+		else if (KeyType == UBlackboardKeyType_String::StaticClass())
+		{
+			Value = Blackboard.GetValue<UBlackboardKeyType_String>(KeyID);
+		}
+		else if (KeyType == UBlackboardKeyType_Vector::StaticClass())
+		{
+			if (!Blackboard.IsVectorValueSet(KeyID))
+			{
+				continue;
+			}
+
+			const FVector Vector = Blackboard.GetValue<UBlackboardKeyType_Vector>(KeyID);
+			Value = FString::Printf(TEXT("X=%s Y=%s Z=%s"), *FloatToString(Vector.X), *FloatToString(Vector.Y), *FloatToString(Vector.Z));
+		}
+		else if (KeyType == UBlackboardKeyType_Rotator::StaticClass())
+		{
+			const FRotator Rotator = Blackboard.GetValue<UBlackboardKeyType_Rotator>(KeyID);
+			Value = FString::Printf(TEXT("P=%s Y=%s R=%s"), *FloatToString(Rotator.Pitch), *FloatToString(Rotator.Yaw), *FloatToString(Rotator.Roll));
+		}
+		else
+		{
+			continue;
+		}
+
+		Snapshot.Values.Add(KeyName, MoveTemp(Value));
+	}
+
+	return Snapshot;
+}
+
+void FHTNPlanningSnapshot::ApplyTo(UBlackboardComponent& Blackboard) const
+{
+	for (int32 KeyIndex = 0; KeyIndex < Blackboard.GetNumKeys(); ++KeyIndex)
+	{
+		const FBlackboard::FKey KeyID = StaticCast<FBlackboard::FKey>(KeyIndex);
+		const FString* const Value = Values.Find(Blackboard.GetKeyName(KeyID));
+		if (!Value)
+		{
+			Blackboard.ClearValue(KeyID);
+			continue;
+		}
+
+		const TSubclassOf<UBlackboardKeyType> KeyType = Blackboard.GetKeyType(KeyID);
+		if (KeyType == UBlackboardKeyType_Bool::StaticClass())
+		{
+			bool bBool = false;
+			LexFromString(bBool, **Value);
+			Blackboard.SetValue<UBlackboardKeyType_Bool>(KeyID, bBool);
+		}
+		else if (KeyType == UBlackboardKeyType_Int::StaticClass())
+		{
+			int32 Int = 0;
+			LexFromString(Int, **Value);
+			Blackboard.SetValue<UBlackboardKeyType_Int>(KeyID, Int);
+		}
+		else if (KeyType == UBlackboardKeyType_Float::StaticClass())
+		{
+			double Float = 0.0;
+			LexFromString(Float, **Value);
+			Blackboard.SetValue<UBlackboardKeyType_Float>(KeyID, Float);
+		}
+		else if (KeyType == UBlackboardKeyType_Enum::StaticClass() || KeyType == UBlackboardKeyType_NativeEnum::StaticClass())
+		{
+			uint8 Enum = 0;
+			LexFromString(Enum, **Value);
+			if (KeyType == UBlackboardKeyType_Enum::StaticClass())
+			{
+				Blackboard.SetValue<UBlackboardKeyType_Enum>(KeyID, Enum);
+			}
+			else
+			{
+				Blackboard.SetValue<UBlackboardKeyType_NativeEnum>(KeyID, Enum);
+			}
+		}
+		else if (KeyType == UBlackboardKeyType_Name::StaticClass())
+		{
+			Blackboard.SetValue<UBlackboardKeyType_Name>(KeyID, FName(**Value));
+		}
+		else if (KeyType == UBlackboardKeyType_String::StaticClass())
+		{
+			Blackboard.SetValue<UBlackboardKeyType_String>(KeyID, *Value);
+		}
+		else if (KeyType == UBlackboardKeyType_Vector::StaticClass())
+		{
+			FVector Vector;
+			if (Vector.InitFromString(*Value))
+			{
+				Blackboard.SetValue<UBlackboardKeyType_Vector>(KeyID, Vector);
+			}
+		}
+		else if (KeyType == UBlackboardKeyType_Rotator::StaticClass())
+		{
+			FRotator Rotator;
+			if (Rotator.InitFromString(*Value))
+			{
+				Blackboard.SetValue<UBlackboardKeyType_Rotator>(KeyID, Rotator);
+			}
+		}
+	}
+}
+
+bool FHTNPlanningSnapshot::SaveToFile(const FString& FilePath) const
+{
+	const TSharedRef<FJsonObject> ValuesObject = MakeShared<FJsonObject>();
+	for (const TPair<FName, FString>& Pair : Values)
+	{
+		ValuesObject->SetStringField(Pair.Key.ToString(), Pair.Value);
+	}
+
+	const TSharedRef<FJsonObject> RootObject = MakeShared<FJsonObject>();
+	RootObject->SetStringField(TEXT("HTN"), HTN.ToString());
+	RootObject->SetStringField(TEXT("Blackboard"), BlackboardAsset.ToString());
+	RootObject->SetObjectField(TEXT("Values"), ValuesObject);
+
+	FString Text;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+	if (!FJsonSerializer::Serialize(RootObject, Writer))
+	{
+		return false;
+	}
+
+	return FFileHelper::SaveStringToFile(Text, *FilePath);
+}
+
+bool FHTNPlanningSnapshot::LoadFromFile(const FString& FilePath)
+{
+	FString Text;
+	if (!FFileHelper::LoadFileToString(Text, *FilePath))
+	{
+		UE_LOG(LogHTN, Error, TEXT("Could not read planning snapshot %s"), *FilePath);
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> RootObject;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), RootObject) || !RootObject.IsValid())
+	{
+		UE_LOG(LogHTN, Error, TEXT("Could not parse planning snapshot %s"), *FilePath);
+		return false;
+	}
+
+	HTN = FSoftObjectPath(RootObject->GetStringField(TEXT("HTN")));
+	BlackboardAsset = FSoftObjectPath(RootObject->GetStringField(TEXT("Blackboard")));
+	Values.Reset();
+
+	const TSharedPtr<FJsonObject>* ValuesObject = nullptr;
+	if (RootObject->TryGetObjectField(TEXT("Values"), ValuesObject))
+	{
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : (*ValuesObject)->Values)
+		{
+			Values.Add(FName(*Pair.Key), Pair.Value->AsString());
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,108 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#include "Utility/HTNPlanningTraceCache.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+namespace
+{
+	FIntVector Quantize(const FVector& Vector, float QuantizationStep)
+	{
+		return FIntVector(
+			FMath::RoundToInt(Vector.X / QuantizationStep),
+			FMath::RoundToInt(Vector.Y / QuantizationStep),
+			FMath::RoundToInt(Vector.Z / QuantizationStep));
+	}
+}
+
+FHTNTraceCacheKey FHTNPlanningTraceCache::MakeKey(const FVector& Start, const FVector& End, const FCollisionShape& Shape,
+	ECollisionChannel Channel, bool bTraceComplex, TArrayView<AActor* const> IgnoredActors, float QuantizationStep)
+{
+	check(QuantizationStep > 0.0f);
+
+	FHTNTraceCacheKey Key;
+	Key.Start = Quantize(Start, QuantizationStep);
+	Key.End = Quantize(End, QuantizationStep);
+	Key.Extent = Shape.IsLine() ? FIntVector::ZeroValue : Quantize(Shape.GetExtent(), QuantizationStep);
+	Key.IgnoredActors.Reserve(IgnoredActors.Num());
+	for (const AActor* const Actor : IgnoredActors)
+	{
+		Key.IgnoredActors.Add(Actor);
+		Key.IgnoredActorsHash = HashCombine(Key.IgnoredActorsHash, GetTypeHash(Actor));
+	}
+	Key.ShapeType = static_cast<uint8>(Shape.ShapeType);
+	Key.Channel = static_cast<uint8>(Channel);
+	Key.bTraceComplex = bTraceComplex;
+	return Key;
+}
+
+void FHTNPlanningTraceCache::QueueTrace(FHTNQueuedTrace&& Trace)
+{
+	bool bIsAlreadyPending = false;
+	PendingKeys.Add(Trace.Key, &bIsAlreadyPending);
+	if (!bIsAlreadyPending)
+	{
+		QueuedTraces.Add(MoveTemp(Trace));
+	}
+}
+
+bool FHTNPlanningTraceCache::SubmitQueuedTraces(UWorld& World, const FTraceDelegate& OnTraceDone)
+{
+	if (QueuedTraces.Num() == 0)
+	{
+		return false;
+	}
+
+	FTraceDelegate Delegate = OnTraceDone;
+	for (const FHTNQueuedTrace& Trace : QueuedTraces)
+	{
+		const uint32 UserData = TracesInFlight.Add(Trace.Key);
+		if (Trace.Shape.IsLine())
+		{
+			World.AsyncLineTraceByChannel(EAsyncTraceType::Single, Trace.Start, Trace.End, Trace.Channel,
+				Trace.Params, FCollisionResponseParams::DefaultResponseParam, &Delegate, UserData);
+		}
+		else
+		{
+			World.AsyncSweepByChannel(EAsyncTraceType::Single, Trace.Start, Trace.End, Trace.Rotation, Trace.Channel, Trace.Shape,
+				Trace.Params, FCollisionResponseParams::DefaultResponseParam, &Delegate, UserData);
+		}
+	}
+
+	NumTracesInFlight += QueuedTraces.Num();
+	QueuedTraces.Reset();
+	return true;
+}
+
+bool FHTNPlanningTraceCache::OnAsyncTraceDone(const FTraceDatum& TraceDatum)
+{
+	if (!ensure(TracesInFlight.IsValidIndex(TraceDatum.UserData) && NumTracesInFlight > 0))
+	{
+		return false;
+	}
+
+	const FHTNTraceCacheKey& Key = TracesInFlight[TraceDatum.UserData];
+	const bool bHit = TraceDatum.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	Results.Add(Key, bHit);
+	PendingKeys.Remove(Key);
+
+	NumTracesInFlight -= 1;
+	if (NumTracesInFlight == 0)
+	{
+		TracesInFlight.Reset();
+		return true;
+	}
+
+	return false;
+}
+
+void FHTNPlanningTraceCache::Reset()
+{
+	Results.Reset();
+	QueuedTraces.Reset();
+	PendingKeys.Reset();
+	TracesInFlight.Reset();
+	NumTracesInFlight = 0;
+	bIsGatheringTraces = false;
+}
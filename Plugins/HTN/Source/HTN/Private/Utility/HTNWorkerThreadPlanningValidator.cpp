@@ -0,0 +1,123 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#include "Utility/HTNWorkerThreadPlanningValidator.h"
+#include "HTN.h"
+#include "HTNDecorator.h"
+#include "HTNService.h"
+#include "HTNStandaloneNode.h"
+
+#include "BehaviorTree/BlackboardData.h"
+
+FHTNWorkerThreadPlanningValidator::FHTNWorkerThreadPlanningValidator(UHTN* TopLevelHTN) :
+	TopLevelHTN(TopLevelHTN)
+{}
+
+bool FHTNWorkerThreadPlanningValidator::CanPlanOnWorkerThread(const UHTN& HTN)
+{
+	bool bAlreadyVisited = false;
+	VisitedObjects.Add(&HTN, &bAlreadyVisited);
+	if (bAlreadyVisited)
+	{
+		return true;
+	}
+
+	for (const UBlackboardData* BlackboardAsset = HTN.BlackboardAsset; BlackboardAsset; BlackboardAsset = BlackboardAsset->Parent)
+	{
+		for (const FBlackboardEntry& Entry : BlackboardAsset->Keys)
+		{
+			if (Entry.KeyType && Entry.KeyType->HasInstance())
+			{
+				FailureReason = FString::Printf(TEXT("key %s of blackboard %s is instanced"), 
+					*Entry.EntryName.ToString(), *BlackboardAsset->GetName());
+				return false;
+			}
+		}
+	}
+
+	if (TopLevelHTN)
+	{
+		for (UHTNService* const RootService : HTN.RootServices)
+		{
+			if (RootService)
+			{
+				RootService->InitializeFromAsset(*TopLevelHTN);
+			}
+		}
+	}
+
+	if (!CanPlanOnWorkerThread(HTN.RootDecorators))
+	{
+		return false;
+	}
+
+	for (UHTNStandaloneNode* const Node : HTN.StartNodes)
+	{
+		if (Node && !CanPlanOnWorkerThread(*Node))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FHTNWorkerThreadPlanningValidator::CanPlanOnWorkerThread(UHTNStandaloneNode& Node)
+{
+	bool bAlreadyVisited = false;
+	VisitedObjects.Add(&Node, &bAlreadyVisited);
+	if (bAlreadyVisited)
+	{
+		return true;
+	}
+
+	// Also initializes the decorators and services of the node.
+	if (TopLevelHTN)
+	{
+		Node.InitializeFromAsset(*TopLevelHTN);
+	}
+
+	if (!Node.CanPlanOnWorkerThread())
+	{
+		FailureReason = FString::Printf(TEXT("node %s can't plan on a worker thread"), *Node.GetShortDescription());
+		return false;
+	}
+
+	if (!CanPlanOnWorkerThread(Node.Decorators) || !Node.CanPlanContentsOnWorkerThread(*this))
+	{
+		return false;
+	}
+
+	for (UHTNStandaloneNode* const NextNode : Node.NextNodes)
+	{
+		if (NextNode && !CanPlanOnWorkerThread(*NextNode))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FHTNWorkerThreadPlanningValidator::CanPlanOnWorkerThread(TArrayView<UHTNDecorator* const> Decorators)
+{
+	for (UHTNDecorator* const Decorator : Decorators)
+	{
+		if (!Decorator)
+		{
+			continue;
+		}
+
+		if (TopLevelHTN)
+		{
+			Decorator->InitializeFromAsset(*TopLevelHTN);
+		}
+
+		if (!Decorator->CanPlanOnWorkerThread())
+		{
+			FailureReason = FString::Printf(TEXT("decorator %s can't plan on a worker thread"), *Decorator->GetShortDescription());
+			return false;
+		}
+	}
+
+	return true;
+}
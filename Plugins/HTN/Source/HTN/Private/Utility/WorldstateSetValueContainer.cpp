@@ -2,6 +2,11 @@
 #include "BehaviorTree/Blackboard/BlackboardKeyAllTypes.h"
 
 bool FWorldstateSetValueContainer::SetValue(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const
+{
+	return SetValue(WorldState, WorldState.ResolveKey(KeySelector.GetSelectedKeyID()));
+}
+
+bool FWorldstateSetValueContainer::SetValue(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const
 {
 	using HandlerType = decltype(&FWorldstateSetValueContainer::SetValueBool);
 
@@ -22,9 +27,9 @@ bool FWorldstateSetValueContainer::SetValue(FBlackboardWorldState& WorldState, c
 	};
 #undef SET_VALUE_HANDLER
 
-	if (const HandlerType* const Handler = KeyClassToHandlerMap.Find(KeySelector.SelectedKeyType))
+	if (const HandlerType* const Handler = KeyClassToHandlerMap.Find(Key.KeyClass))
 	{
-		return (this->**Handler)(WorldState, KeySelector);
+		return (this->**Handler)(WorldState, Key);
 	}
 
 	return false;
@@ -102,9 +107,9 @@ FString FWorldstateSetValueContainer::GetValueDescription(const UBlackboardKeyTy
 }
 
 #define SET_VALUE_IMPLEMENTATION(TYPE) \
-bool FWorldstateSetValueContainer::SetValue##TYPE(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const \
+bool FWorldstateSetValueContainer::SetValue##TYPE(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const \
 { \
-	return WorldState.SetValue<UBlackboardKeyType_##TYPE>(KeySelector.GetSelectedKeyID(), TYPE##Value); \
+	return WorldState.SetValue<UBlackboardKeyType_##TYPE>(Key, TYPE##Value); \
 };
 
 SET_VALUE_IMPLEMENTATION(Int)
@@ -115,34 +120,34 @@ SET_VALUE_IMPLEMENTATION(Vector)
 SET_VALUE_IMPLEMENTATION(Rotator)
 SET_VALUE_IMPLEMENTATION(Object)
 
-bool FWorldstateSetValueContainer::SetValueBool(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const
+bool FWorldstateSetValueContainer::SetValueBool(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const
 {
 	return WorldState.SetValue<UBlackboardKeyType_Bool>(
-		KeySelector.GetSelectedKeyID(),
+		Key,
 		StaticCast<UBlackboardKeyType_Bool::FDataType>(IntValue)
 	);
 };
 
-bool FWorldstateSetValueContainer::SetValueEnum(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const
+bool FWorldstateSetValueContainer::SetValueEnum(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const
 {
 	return WorldState.SetValue<UBlackboardKeyType_Enum>(
-		KeySelector.GetSelectedKeyID(),
+		Key,
 		StaticCast<UBlackboardKeyType_Enum::FDataType>(IntValue)
 	);
 };
 
-bool FWorldstateSetValueContainer::SetValueNativeEnum(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const
+bool FWorldstateSetValueContainer::SetValueNativeEnum(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const
 {
 	return WorldState.SetValue<UBlackboardKeyType_NativeEnum>(
-		KeySelector.GetSelectedKeyID(),
+		Key,
 		StaticCast<UBlackboardKeyType_NativeEnum::FDataType>(IntValue)
 	);
 };
 
-bool FWorldstateSetValueContainer::SetValueClass(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const
+bool FWorldstateSetValueContainer::SetValueClass(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const
 {
 	return WorldState.SetValue<UBlackboardKeyType_Class>(
-		KeySelector.GetSelectedKeyID(),
+		Key,
 		Cast<UClass>(ObjectValue)
 	);
 };
@@ -105,6 +105,36 @@ bool UWorldStateProxy::TestTextOperation(const UBlackboardKeyType& Key, FBlackbo
 	return false;
 }
 
+bool UWorldStateProxy::TestBasicOperation(const FBlackboardWorldStateKeyHandle& Key, EBasicKeyOperation::Type Type) const
+{
+	if (WorldState.IsValid())
+	{
+		return WorldState->TestBasicOperation(Key, Type);
+	}
+
+	return Key.IsValid() && TestBasicOperation(*Key.KeyType, Key.KeyID, Type);
+}
+
+bool UWorldStateProxy::TestArithmeticOperation(const FBlackboardWorldStateKeyHandle& Key, EArithmeticKeyOperation::Type Type, int32 IntValue, float FloatValue) const
+{
+	if (WorldState.IsValid())
+	{
+		return WorldState->TestArithmeticOperation(Key, Type, IntValue, FloatValue);
+	}
+
+	return Key.IsValid() && TestArithmeticOperation(*Key.KeyType, Key.KeyID, Type, IntValue, FloatValue);
+}
+
+bool UWorldStateProxy::TestTextOperation(const FBlackboardWorldStateKeyHandle& Key, ETextKeyOperation::Type Type, const FString& StringValue) const
+{
+	if (WorldState.IsValid())
+	{
+		return WorldState->TestTextOperation(Key, Type, StringValue);
+	}
+
+	return Key.IsValid() && TestTextOperation(*Key.KeyType, Key.KeyID, Type, StringValue);
+}
+
 bool UWorldStateProxy::GetLocation(const FBlackboardKeySelector& KeySelector, FVector& OutLocation, AActor*& OutActor) const
 {
 	if (KeySelector.SelectedKeyType == UBlackboardKeyType_Vector::StaticClass())
@@ -9,8 +9,16 @@
 #include "HTNPlan.h"
 #include "HTNPlanningDebugInfo.h"
 #include "HTNStandaloneNode.h"
+#include "Tasks/Task.h"
+#include "Utility/HTNPlanningClosedSet.h"
+#include "Utility/HTNPlanningEQSCache.h"
+#include "Utility/HTNPlanningHeuristic.h"
+#include "Utility/HTNPlanningProfile.h"
+#include "Utility/HTNPlanningTraceCache.h"
 #include "AITask_MakeHTNPlan.generated.h"
 
+#include <atomic>
+
 class UHTNComponent;
 class UHTNPlanInstance;
 
@@ -119,6 +127,18 @@ public:
 	FHTNPriorityMarker MakePriorityMarker();
 	void SetNodePlanningFailureReason(const FString& FailureReason);
 
+	// Trace results shared by all branches of this planning session. See UHTNDecorator_TraceTest.
+	FHTNPlanningTraceCache& GetTraceCache() const;
+
+	// EQS query results shared by all branches of this planning session. See UHTNTask_EQSQuery.
+	FHTNPlanningEQSCache& GetEQSCache();
+
+	// Makes the next planning session record an FHTNPlanningProfile even if ai.htn.ProfilePlanning is disabled.
+	void RequestProfiling();
+
+	// The profile of this planning session, if it's being profiled. Still available while OnPlanningFinished is broadcast.
+	const FHTNPlanningProfile* GetProfile() const;
+
 	DECLARE_EVENT_TwoParams(UAITask_MakeHTNPlan, FHTNPlanningFinishedSignature, UAITask_MakeHTNPlan&, TSharedPtr<FHTNPlan>);
 	FHTNPlanningFinishedSignature OnPlanningFinished;
 
@@ -140,6 +160,11 @@ private:
 
 	void OnNodeFinishedMakingPlanExpansions(const UHTNStandaloneNode* Node);
 
+	bool SubmitQueuedTraces();
+	void GatherQueuedTraces(const FHTNPlan& Plan, const FHTNPlanStepID& StepID, const TSharedPtr<class FBlackboardWorldState>& WorldState, 
+		TArrayView<UHTNStandaloneNode* const> Nodes) const;
+	void OnAsyncTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum, FHTNPlanningID TracePlanningID);
+
 	bool EnterDecorators(bool& bOutDecoratorsPassed, const FHTNPlan& Plan, const FHTNPlanStepID& StepID, const UHTNStandaloneNode& Node) const;
 	bool EnterDecorators(bool& bOutDecoratorsPassed, TArrayView<UHTNDecorator* const> Decorators, const FHTNPlan& Plan, const FHTNPlanStepID& StepID, bool bMustPass = true) const;
 
@@ -149,6 +174,18 @@ private:
 
 	void ClearIntermediateState();
 
+	// Ends the task, unless planning on a worker thread. In that case the game thread ends it once the worker thread is done.
+	void FinishPlanning();
+
+	// Adds the time since the last call of DoPlanning to the profile, if profiling.
+	void AddProfiledPlanningTime();
+
+	// See UHTNComponent::bPlanOnWorkerThread.
+	bool ShouldPlanOnWorkerThread() const;
+	void StartPlanningOnWorkerThread();
+	void OnWorkerThreadPlanningFinished(FHTNPlanningID WorkerThreadPlanningID);
+	void WaitForWorkerThreadPlanning(bool bCancel);
+
 	int32 GetNumCandidatePlans() const;
 	void AddBlockingPriorityMarkersOf(const FHTNPlan& Plan);
 	void RemoveBlockingPriorityMarkersOf(const FHTNPlan& Plan);
@@ -195,11 +232,39 @@ private:
 	
 	TSharedPtr<FHTNPlan> FinishedPlan;
 
+	// Mutable because decorators fill it in while being evaluated from const functions like EnterDecorators.
+	mutable FHTNPlanningTraceCache TraceCache;
+
+	FHTNPlanningEQSCache EQSCache;
+
+	// Orders the Frontier by cost plus a lower bound of the cost still to come.
+	FHTNPlanningHeuristic Heuristic;
+
+	// The states of the plans expanded so far, if pruning equivalent plans is enabled. See UHTNComponent::bPruneEquivalentPlans.
+	FHTNPlanningClosedSet ClosedSet;
+	int32 NumExpandedPlans;
+
+	// Set if this planning session is being profiled.
+	TOptional<FHTNPlanningProfile> Profile;
+	uint64 DoPlanningStartCycles;
+	bool bProfilingRequested;
+
 	UPROPERTY(Transient)
 	uint8 bIsWaitingForNodeToMakePlanExpansions : 1;
 
+	// True while the current step is waiting for a batch of async traces requested by its decorators.
+	uint8 bIsWaitingForAsyncTraces : 1;
+
+	uint8 bPruneEquivalentPlans : 1;
 	uint8 bWasCancelled : 1;
 
+	// Kept out of the bitfields above, which are written to by the worker thread while it is planning.
+	bool bIsPlanningOnWorkerThread;
+	bool bWorkerThreadPlanningEnded;
+	std::atomic<bool> bCancelWorkerThreadPlanning;
+
+	UE::Tasks::FTask WorkerThreadPlanningTask;
+
 #if HTN_DEBUG_PLANNING
 	FHTNPlanningDebugInfo DebugInfo;
 	mutable FString NodePlanningFailureReason;
@@ -223,6 +288,10 @@ FORCEINLINE bool UAITask_MakeHTNPlan::FoundPlan() const { return FinishedPlan.Is
 FORCEINLINE TSharedPtr<struct FHTNPlan> UAITask_MakeHTNPlan::GetFinishedPlan() const { return FinishedPlan; }
 
 FORCEINLINE FHTNPriorityMarker UAITask_MakeHTNPlan::MakePriorityMarker() { return NextPriorityMarker++; }
+FORCEINLINE FHTNPlanningTraceCache& UAITask_MakeHTNPlan::GetTraceCache() const { return TraceCache; }
+FORCEINLINE FHTNPlanningEQSCache& UAITask_MakeHTNPlan::GetEQSCache() { return EQSCache; }
+FORCEINLINE void UAITask_MakeHTNPlan::RequestProfiling() { bProfilingRequested = true; }
+FORCEINLINE const FHTNPlanningProfile* UAITask_MakeHTNPlan::GetProfile() const { return Profile.GetPtrOrNull(); }
 
 #if HTN_DEBUG_PLANNING
 FORCEINLINE void UAITask_MakeHTNPlan::SetNodePlanningFailureReason(const FString& FailureReason) { NodePlanningFailureReason = FailureReason; }
@@ -10,9 +10,46 @@
 #include "HTNTypes.h"
 
 class FBlackboardWorldStateImpl;
+struct FBlackboardWorldStateLayer;
+
+// A blackboard key with everything needed to access its value resolved up front, 
+// so that reading and writing it in a worldstate doesn't need to look up the key in the BlackboardData.
+// Nodes should resolve these once in InitializeFromAsset and use them during planning.
+struct HTN_API FBlackboardWorldStateKeyHandle
+{
+	FBlackboardWorldStateKeyHandle();
+	FBlackboardWorldStateKeyHandle(const UBlackboardData& BlackboardAsset, FBlackboard::FKey KeyID);
+
+	// Returns true if the key was found in the BlackboardAsset.
+	bool Resolve(const UBlackboardData& BlackboardAsset, FBlackboard::FKey KeyID);
+	bool Resolve(const UBlackboardData& BlackboardAsset, const FBlackboardKeySelector& KeySelector);
+	void Invalidate();
+
+	FORCEINLINE bool IsValid() const { return KeyType != nullptr; }
+
+	template<class TDataClass>
+	FORCEINLINE bool IsA() const { return KeyClass == TDataClass::StaticClass(); }
+
+	FBlackboard::FKey KeyID;
+
+	// The key type from the BlackboardData. Kept alive by the BlackboardData. 
+	// For instanced keys, the values need to be accessed through the key instance of the worldstate instead.
+	UBlackboardKeyType* KeyType;
+	UClass* KeyClass;
+
+	// Where the value starts in the memory of the key. Instanced keys have a FBlackboardInstancedKeyMemory in front of the value.
+	uint16 DataOffset;
+
+	// The size of the memory of the key, including the DataOffset.
+	uint16 RawDataSize;
+
+	bool bHasInstance;
+};
 
 // Stores Blackboard values the same way as a BlackboardComponent, but is cheap to copy since it's not a UObject.
 // Used to model future states during planning. Also keeps track of which keys were changed since the object's creation.
+// Values are stored copy-on-write: a worldstate made via MakeNext shares the layers of values of the worldstate 
+// it was made from and only stores the keys that were written to since then. Reads fall through to the shared layers.
 // Note: to work, it requires the original BlackboardComponent to be alive, 
 // so make sure all worldstates are deallocated before their BlackboardCompoent is.
 class HTN_API FBlackboardWorldState final : public FGCObject
@@ -30,6 +67,10 @@ public:
 	// End FGCObject implementation
 	
 	TSharedRef<FBlackboardWorldState> MakeNext() const;
+
+	// The number of worldstates made with MakeNext on the calling thread so far. Used by FHTNPlanningProfile.
+	static uint32 GetNumMadeOnThisThread();
+
 	void ApplyChangedValues(UBlackboardComponent& BlackboardComponent) const;
 	void ApplyChangedValues(FBlackboardWorldState& OtherWorldstate) const;
 	void CopyValue(UBlackboardComponent& TargetBlackboard, FBlackboard::FKey KeyID) const;
@@ -50,6 +91,13 @@ public:
 	template<class TDataClass>
 	bool SetValue(FBlackboard::FKey KeyID, typename TDataClass::FDataType Value);
 
+	// Faster versions of GetValue and SetValue for keys that were resolved in advance.
+	template<class TDataClass>
+	typename TDataClass::FDataType GetValue(const FBlackboardWorldStateKeyHandle& Key) const;
+
+	template<class TDataClass>
+	bool SetValue(const FBlackboardWorldStateKeyHandle& Key, typename TDataClass::FDataType Value);
+
 	FORCEINLINE void ClearValue(const FName& KeyName) { ClearValue(GetKeyID(KeyName)); }
 	void ClearValue(FBlackboard::FKey KeyID);
 
@@ -60,6 +108,10 @@ public:
 	bool TestArithmeticOperation(const UBlackboardKeyType& Key, FBlackboard::FKey KeyID, EArithmeticKeyOperation::Type Type, int32 IntValue, float FloatValue) const;
 	bool TestTextOperation(const UBlackboardKeyType& Key, FBlackboard::FKey KeyID, ETextKeyOperation::Type Type, const FString& StringValue) const;
 
+	bool TestBasicOperation(const FBlackboardWorldStateKeyHandle& Key, EBasicKeyOperation::Type Type) const;
+	bool TestArithmeticOperation(const FBlackboardWorldStateKeyHandle& Key, EArithmeticKeyOperation::Type Type, int32 IntValue, float FloatValue) const;
+	bool TestTextOperation(const FBlackboardWorldStateKeyHandle& Key, ETextKeyOperation::Type Type, const FString& StringValue) const;
+
 	bool IsVectorValueSet(const FName& Name) const;
 	bool IsVectorValueSet(FBlackboard::FKey KeyID) const;
 
@@ -76,6 +128,7 @@ public:
 	const uint8* GetKeyRawData(FBlackboard::FKey KeyID) const;
 
 	FORCEINLINE bool IsValidKey(FBlackboard::FKey KeyID) const { check(BlackboardAsset.IsValid()); return KeyID != FBlackboard::InvalidKey && BlackboardAsset->Keys.IsValidIndex(KeyID); }
+	FORCEINLINE FBlackboardWorldStateKeyHandle ResolveKey(FBlackboard::FKey KeyID) const { return BlackboardAsset.IsValid() ? FBlackboardWorldStateKeyHandle(*BlackboardAsset, KeyID) : FBlackboardWorldStateKeyHandle(); }
 	FORCEINLINE	FName GetKeyName(FBlackboard::FKey KeyID) const { return BlackboardAsset.IsValid() ? BlackboardAsset->GetKeyName(KeyID) : NAME_None; }
 	FORCEINLINE FBlackboard::FKey GetKeyID(const FName& KeyName) const { return BlackboardAsset.IsValid() ? BlackboardAsset->GetKeyID(KeyName) : FBlackboard::InvalidKey; }
 
@@ -84,27 +137,57 @@ public:
 	
 	bool WasKeyChanged(FBlackboard::FKey KeyID) const;
 	bool HasAnyKeyChanged() const;
+
+	// While a recorder is set, reading the value of a key marks its KeyID in the recorder.
+	// Used by plan rechecking to find out which keys a plan step depends on. Not passed on to worldstates made with MakeNext.
+	FORCEINLINE void SetReadKeysRecorder(TBitArray<>* Recorder) const { ReadKeysRecorder = Recorder; }
 	
 	bool IsCompatible(const FBlackboardWorldState& Other) const;
 
+	// Returns true if the keys set in KeyIDs have the same values in this and the Other worldstate.
+	bool HasEqualValues(const FBlackboardWorldState& Other, const TBitArray<>& KeyIDs) const;
+
+	// Returns true if all keys have the same values in this and the Other worldstate.
+	bool HasEqualValues(const FBlackboardWorldState& Other) const;
+
+	// A hash of the values of all keys, to quickly tell apart worldstates with different values.
+	// Only exactly equal values are guaranteed to hash the same, so use HasEqualValues to confirm a match.
+	uint32 GetValuesHash() const;
+
 private:
 	friend FBlackboardWorldStateImpl;
 	
 	void SetKeyChanged(FBlackboard::FKey KeyID, bool bWasChanged = true);
 	void DestroyValues();
+	bool HasEqualValue(const FBlackboardWorldState& Other, FBlackboard::FKey KeyID) const;
+
+	// Finds the memory of a key in the newest layer that has it. 
+	// OutKeyInstance is set to the instance of the key if the key is instanced.
+	const uint8* GetKeyRawData(FBlackboard::FKey KeyID, UBlackboardKeyType*& OutKeyInstance) const;
+
+	// Makes sure the key is stored in a layer owned only by this worldstate and returns its memory there.
+	uint8* GetKeyRawDataForWrite(const FBlackboardWorldStateKeyHandle& Key, UBlackboardKeyType*& OutKeyInstance);
+	FORCEINLINE uint8* GetKeyRawDataForWrite(FBlackboard::FKey KeyID, UBlackboardKeyType*& OutKeyInstance) { return GetKeyRawDataForWrite(ResolveKey(KeyID), OutKeyInstance); }
 
 	TWeakObjectPtr<class UBlackboardComponent> BlackboardComponent;
 	TWeakObjectPtr<class UBlackboardData> BlackboardAsset;
 
-	TArray<uint8, TInlineAllocator<128>> ValueMemory;
-
-	// The key instances are gc-owned by the UBlackboardComponent
-	TArray<UBlackboardKeyType*> KeyInstances;
+	// The newest layer of values. Older layers are reachable through its Parent pointer. 
+	// The oldest layer of the chain stores all keys, the newer layers only store the keys that were written to.
+	// Once the layer is shared with another worldstate (by MakeNext) it becomes immutable 
+	// and further writes go into a new layer on top of it.
+	TSharedPtr<FBlackboardWorldStateLayer> TopLayer;
 
 	// Whether or not a given key was changed on this worldstate.
 	TBitArray<> ChangedFlags;
 
+	// See SetReadKeysRecorder
+	mutable TBitArray<>* ReadKeysRecorder;
+
 	bool bIsInitialized : 1;
+
+	// If true, TopLayer is referenced by other worldstates and must not be modified.
+	mutable bool bIsTopLayerShared : 1;
 };
 
 template <class TDataClass>
@@ -115,19 +198,28 @@ typename TDataClass::FDataType FBlackboardWorldState::GetValue(const FName& KeyN
 }
 
 template <class TDataClass>
-typename TDataClass::FDataType FBlackboardWorldState::GetValue(FBlackboard::FKey KeyID) const
+FORCEINLINE typename TDataClass::FDataType FBlackboardWorldState::GetValue(FBlackboard::FKey KeyID) const
+{
+	return GetValue<TDataClass>(ResolveKey(KeyID));
+}
+
+template <class TDataClass>
+typename TDataClass::FDataType FBlackboardWorldState::GetValue(const FBlackboardWorldStateKeyHandle& Key) const
 {
-	const FBlackboardEntry* const EntryInfo = BlackboardAsset.IsValid() ? BlackboardAsset->GetKey(KeyID) : nullptr;
-	if (!EntryInfo || !EntryInfo->KeyType || EntryInfo->KeyType->GetClass() != TDataClass::StaticClass())
+	if (!Key.IsA<TDataClass>())
 	{
 		return TDataClass::InvalidValue;
 	}
 
-	UBlackboardKeyType* const KeyOb = EntryInfo->KeyType->HasInstance() ? KeyInstances[KeyID] : UNWRAP_TOBJECT_PTR(EntryInfo->KeyType);
-	const uint16 DataOffset = EntryInfo->KeyType->HasInstance() ? sizeof(FBlackboardInstancedKeyMemory) : 0;
+	UBlackboardKeyType* KeyInstance = nullptr;
+	const uint8* const RawData = GetKeyRawData(Key.KeyID, KeyInstance);
+	if (!RawData)
+	{
+		return TDataClass::InvalidValue;
+	}
 
-	const uint8* const RawData = GetKeyRawData(KeyID) + DataOffset;
-	return RawData ? TDataClass::GetValue(StaticCast<TDataClass*>(KeyOb), RawData) : TDataClass::InvalidValue;
+	UBlackboardKeyType* const KeyOb = Key.bHasInstance ? KeyInstance : Key.KeyType;
+	return TDataClass::GetValue(StaticCast<TDataClass*>(KeyOb), RawData + Key.DataOffset);
 }
 
 template <class TDataClass>
@@ -138,25 +230,29 @@ bool FBlackboardWorldState::SetValue(const FName& KeyName, typename TDataClass::
 }
 
 template <class TDataClass>
-bool FBlackboardWorldState::SetValue(FBlackboard::FKey KeyID, typename TDataClass::FDataType Value)
+FORCEINLINE bool FBlackboardWorldState::SetValue(FBlackboard::FKey KeyID, typename TDataClass::FDataType Value)
 {
-	const FBlackboardEntry* EntryInfo = BlackboardAsset.IsValid() ? BlackboardAsset->GetKey(KeyID) : nullptr;
-	if (!EntryInfo || !EntryInfo->KeyType || EntryInfo->KeyType->GetClass() != TDataClass::StaticClass())
+	return SetValue<TDataClass>(ResolveKey(KeyID), Value);
+}
+
+template <class TDataClass>
+bool FBlackboardWorldState::SetValue(const FBlackboardWorldStateKeyHandle& Key, typename TDataClass::FDataType Value)
+{
+	if (!Key.IsA<TDataClass>())
 	{
 		return false;
 	}
 
-	const uint16 DataOffset = EntryInfo->KeyType->HasInstance() ? sizeof(FBlackboardInstancedKeyMemory) : 0;
-	if (uint8* const RawData = GetKeyRawData(KeyID) + DataOffset)
+	UBlackboardKeyType* KeyInstance = nullptr;
+	if (uint8* const RawData = GetKeyRawDataForWrite(Key, KeyInstance))
 	{
-		UBlackboardKeyType* const KeyOb = EntryInfo->KeyType->HasInstance() ? KeyInstances[KeyID] : UNWRAP_TOBJECT_PTR(EntryInfo->KeyType);
-		TDataClass::SetValue(StaticCast<TDataClass*>(KeyOb), RawData, Value);
+		UBlackboardKeyType* const KeyOb = Key.bHasInstance ? KeyInstance : Key.KeyType;
+		TDataClass::SetValue(StaticCast<TDataClass*>(KeyOb), RawData + Key.DataOffset, Value);
 		// Intentionally marking the key as changed even though it might have been set to the same value it had before.
-		SetKeyChanged(KeyID);
+		SetKeyChanged(Key.KeyID);
 		
 		return true;
 	}
-	
 
 	return false;
 }
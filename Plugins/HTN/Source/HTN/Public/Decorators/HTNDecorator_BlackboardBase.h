@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "BlackboardWorldstate.h"
 #include "UObject/ObjectMacros.h"
 #include "HTNDecorator.h"
 #include "HTNDecorator_BlackboardBase.generated.h"
@@ -38,6 +39,9 @@ protected:
 	UPROPERTY(EditAnywhere, Category = Blackboard)
 	FBlackboardKeySelector BlackboardKey;
 
+	// The BlackboardKey resolved for fast access to its value in worldstates. Set in InitializeFromAsset.
+	FBlackboardWorldStateKeyHandle BlackboardKeyHandle;
+
 	// If set (true by default), OnExecutionStart will subscribe the OnBlackboardKeyValueChange function to changes of the BlackboardKey.
 	// OnExecutionFinish will unsubscribe.
 	UPROPERTY(EditDefaultsOnly, Category = Blackboard)
@@ -57,6 +57,18 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Trace|Shape", meta = (UIMin = 0, ClampMin = 0, EditCondition = "TraceShape == EEnvTraceShape::Box || TraceShape == EEnvTraceShape::Capsule"))
 	float TraceExtentZ;
 
+	// During planning, traces with endpoints and extents that round to the same multiples of this value
+	// share a single result for the whole planning session instead of tracing again in every planning branch.
+	// Values less than or equal to zero disable the cache.
+	UPROPERTY(EditAnywhere, Category = "Trace|Planning", meta = (UIMin = 0, ClampMin = 0, ForceUnits = cm))
+	float PlanningTraceCacheTolerance;
+
+	// If true, traces made when entering the plan are submitted as async traces instead of blocking the planner.
+	// Planning waits until the whole batch of queued traces (including those of other nodes in the frontier) is done, 
+	// then plans the node again using the results. Debug drawing is not done for async traces.
+	UPROPERTY(EditAnywhere, Category = "Trace|Planning", meta = (EditCondition = "PlanningTraceCacheTolerance > 0"))
+	uint8 bUseAsyncTracesDuringPlanning : 1;
+
 	UPROPERTY(EditAnywhere, Category = "Trace|Debug")
 	TEnumAsByte<EDrawDebugTrace::Type> DrawDebugType;
 
@@ -75,6 +87,8 @@ public:
 protected:
 	virtual bool CalculateRawConditionValue(UHTNComponent& OwnerComp, uint8* NodeMemory, EHTNDecoratorConditionCheckType CheckType) const override;
 	void FillActorsToIgnoreBuffer(UHTNComponent& OwnerComp, AActor* TraceFromActor, AActor* TraceToActor) const;
+	bool Trace(UHTNComponent& OwnerComp, const FVector& StartLocation, const FVector& EndLocation) const;
+	FCollisionShape MakeCollisionShape() const;
 
 	UPROPERTY(Transient)
 	mutable TArray<AActor*> ActorsToIgnoreBuffer;
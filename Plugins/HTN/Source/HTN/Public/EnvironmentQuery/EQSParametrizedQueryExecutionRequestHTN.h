@@ -15,6 +15,12 @@ struct HTN_API FEQSParametrizedQueryExecutionRequestHTN : public FEQSParametrize
 	int32 Execute(AActor& QueryOwner, const class FBlackboardWorldState& WorldState, const FQueryFinishedSignature& QueryFinishedDelegate) const;
 	TSharedPtr<FEnvQueryResult> ExecuteInstant(AActor& QueryOwner, const class FBlackboardWorldState& WorldState) const;
 
+	// Returns the query template that Execute would run from the given worldstate.
+	UEnvQuery* GetQueryTemplate(AActor& QueryOwner, const class FBlackboardWorldState& WorldState) const;
+
+	// A hash of the run mode and the query params that don't come from blackboard keys.
+	uint32 GetStaticParamsHash() const;
+
 private:
 
 	UEnvQuery* GetQueryTemplateFromWorldState(AActor& QueryOwner, const class FBlackboardWorldState& WorldState) const;
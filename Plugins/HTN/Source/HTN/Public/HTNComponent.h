@@ -61,6 +61,18 @@ public:
 	virtual void DescribeSelfToVisLog(struct FVisualLogEntry* Snapshot) const override;
 #endif
 
+	// Does everything TickComponent does for the HTN. Called by TickComponent, or by the UHTNSubsystem if bTickFromSubsystem is enabled.
+	void TickHTN(float DeltaTime);
+
+	// How important it is to tick this component often, from 0 to 1. 
+	// Only used if bTickFromSubsystem is enabled, in which case the component is ticked once every few frames
+	// if the significance is below 1 (see the ai.htn.MaxTickPeriod console variable).
+	UFUNCTION(BlueprintCallable, Category = "AI|HTN")
+	void SetTickSignificance(float NewSignificance);
+
+	UFUNCTION(BlueprintPure, Category = "AI|HTN")
+	FORCEINLINE float GetTickSignificance() const { return TickSignificance; }
+
 	UFUNCTION(BlueprintCallable, Category = "AI|HTN")
 	void StartHTN(class UHTN* Asset);
 
@@ -141,7 +153,13 @@ public:
 	FHTNNodeInPlanInfo FindActiveDecoratorInfo(const class UHTNDecorator* Decorator, const uint8* NodeMemory = nullptr) const;
 	FHTNNodeInPlanInfo FindActiveServiceInfo(const class UHTNService* Service, const uint8* NodeMemory = nullptr) const;
 
-	FORCEINLINE class UWorldStateProxy* GetPlanningWorldStateProxy() const { check(PlanningWorldStateProxy); return PlanningWorldStateProxy; }
+	// When called from a worker thread, returns the proxy used by the planning task running there (see bPlanOnWorkerThread).
+	FORCEINLINE class UWorldStateProxy* GetPlanningWorldStateProxy() const
+	{
+		class UWorldStateProxy* const Proxy = IsInGameThread() ? PlanningWorldStateProxy : WorkerThreadPlanningWorldStateProxy;
+		check(Proxy);
+		return Proxy;
+	}
 
 	UFUNCTION(BlueprintPure, Category = "AI|HTN")
 	FORCEINLINE class UWorldStateProxy* GetBlackboardProxy() const { check(BlackboardProxy); return BlackboardProxy; }
@@ -153,6 +171,10 @@ public:
 	// When calling GetPlanningWorldStateProxy, they will get a proxy to the given worldstate. If null, the proxy will be pointing to the blackboard.
 	void SetPlanningWorldState(TSharedPtr<class FBlackboardWorldState> WorldState, bool bIsEditable = true);
 
+	// The planning task that is currently evaluating decorators on this component, if any.
+	// Lets decorators use state that lives for the duration of a planning session (e.g. the trace cache of UHTNDecorator_TraceTest).
+	FORCEINLINE const class UAITask_MakeHTNPlan* GetActivePlanningTask() const { return IsInGameThread() ? ActivePlanningTask : WorkerThreadActivePlanningTask; }
+
 	class UHTNExtension* FindExtensionByClass(TSubclassOf<UHTNExtension> ExtensionClass) const;
 
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "AI|HTN", DisplayName = "Find Extension By Class", Meta = (DynamicOutputParam = "ReturnValue", DeterminesOutputType = "ExtensionClass", ReturnDisplayName = "Extension", ExpandEnumAsExecs = "OutResult"))
@@ -203,6 +225,12 @@ public:
 	// Makes this UAITask_MakeHTNPlan available for future planning again.
 	void ReturnPlanningTaskToPool(class UAITask_MakeHTNPlan& Task);
 
+	// If Memory can't hold NumBytes without reallocating, swaps it with the smallest pooled node memory block that can.
+	void TakeNodeMemoryFromPool(TArray<uint8>& Memory, int32 NumBytes);
+
+	// Makes the node memory of a plan instance that is being destroyed available to other plan instances.
+	void ReturnNodeMemoryToPool(TArray<uint8>&& Memory);
+
 	// The maximum number of steps in a plan. Each standalone node (not a decorator or service) is one step.
 	// This limit is used to prevent infinite recursion during planning. If it is exceeded during planning,
 	// planning is aborted with an error that gets logged in the visual logger and the output log.
@@ -215,9 +243,32 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|HTN")
 	int32 MaxNestedSubPlanDepth;
 
+	// If true, planning discards plans that reach a state that was already expanded at an equal or lower cost:
+	// the same nodes left to plan in the same HTN levels, with the same worldstate values.
+	// This avoids planning the same continuation many times (e.g. after both orders of an AnyOrder node), 
+	// but assumes that nodes don't depend on how that state was reached, only on the worldstate.
+	// Not used when trying to adjust the current plan.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|HTN")
+	bool bPruneEquivalentPlans;
+
+	// If true, planning runs on a worker thread when every node that can be reached from the HTN allows it
+	// (see UHTNNode::bCanPlanOnWorkerThread), so that the game thread doesn't wait for large plans.
+	// Falls back to planning on the game thread otherwise, e.g. when the blackboard has instanced keys or when the visual logger is recording.
+	// Only one plan per component is made on a worker thread at a time.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|HTN")
+	bool bPlanOnWorkerThread;
+
+	// If true, this component doesn't use its own tick function. Instead, the UHTNSubsystem ticks it together with all other such components,
+	// which is cheaper with many AI agents and allows reducing the tick rate of less significant agents (see SetTickSignificance).
+	// Only takes effect when the component begins play.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "AI|HTN")
+	bool bTickFromSubsystem;
+
 protected:
 	EHTNLockFlags GetLockFlags() const;
 
+	float TickSignificance;
+
 	uint8 bIsPaused : 1;
 	uint8 bDeferredCleanup : 1;
 	uint8 bStoppingHTN : 1;
@@ -269,6 +320,10 @@ private:
 	UPROPERTY()
 	class UWorldStateProxy* PlanningWorldStateProxy;
 
+	// Same as PlanningWorldStateProxy, but used by the planning task running on a worker thread, if any.
+	UPROPERTY()
+	class UWorldStateProxy* WorkerThreadPlanningWorldStateProxy;
+
 	// The proxy to the BlackboardComponent of the AIController.
 	// UHTNBlueprintLibrary functions(e.g.Get/SetWorldStateValueAsVector) use this proxy during plan execution.
 	UPROPERTY()
@@ -282,11 +337,28 @@ private:
 	// that would need to get Garbage Collected later every time we need to make a plan..
 	UPROPERTY()
 	TArray<class UAITask_MakeHTNPlan*> PlanningTasksPool;
+
+	// Node memory blocks of destroyed plan instances (see UHTNPlanInstance::PlanMemory).
+	// Sub plan instances are created and destroyed often, so they take their memory from here instead of allocating it from scratch.
+	TArray<TArray<uint8>> NodeMemoryPool;
+
+	// Set by UAITask_MakeHTNPlan for the duration of decorator evaluation.
+	const class UAITask_MakeHTNPlan* ActivePlanningTask;
+	const class UAITask_MakeHTNPlan* WorkerThreadActivePlanningTask;
+
+	// True while a UAITask_MakeHTNPlan of this component is planning on a worker thread.
+	bool bIsPlanningOnWorkerThread;
+
+	FORCEINLINE const class UAITask_MakeHTNPlan*& GetActivePlanningTaskForCurrentThread()
+	{
+		return IsInGameThread() ? ActivePlanningTask : WorkerThreadActivePlanningTask;
+	}
 	
 	friend class UHTNNode;
 	friend class FHTNDebugger;
 	friend struct FHTNComponentScopedLock;
 	friend class UHTNPlanInstance;
+	friend class UAITask_MakeHTNPlan;
 
 #if USE_HTN_DEBUGGER
 	mutable FHTNDebugSteps DebuggerSteps;
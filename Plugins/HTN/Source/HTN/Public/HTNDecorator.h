@@ -35,6 +35,11 @@ public:
 	EHTNDecoratorTestResult GetLastEffectiveConditionValue(const uint8* NodeMemory) const;
 	virtual bool ShouldCheckCondition(UHTNComponent& OwnerComp, uint8* NodeMemory, EHTNDecoratorConditionCheckType CheckType) const;
 
+	FORCEINLINE bool CanModifyStepCost() const { return bModifyStepCost; }
+
+	// True if plan rechecking can skip this decorator while none of the blackboard keys it read have changed.
+	FORCEINLINE bool DoesRecheckOnlyDependOnWorldState() const { return !bCheckConditionOnPlanRecheck || bConditionOnlyDependsOnWorldState; }
+
 	UFUNCTION(BlueprintPure, Category = AI)
 	FORCEINLINE bool IsInversed() const { return bInverseCondition; }
 
@@ -91,6 +96,10 @@ protected:
 	uint8 bNotifyExecutionStart : 1;
 	uint8 bNotifyTick : 1;
 	uint8 bNotifyExecutionFinish : 1;
+
+	// If true, the condition during planning and plan recheck only depends on the values in the worldstate.
+	// This lets plan rechecking skip the decorator while none of the blackboard keys it read have changed.
+	uint8 bConditionOnlyDependsOnWorldState : 1;
 	
 	// If set, condition check result will be inversed
 	UPROPERTY(Category = Condition, EditAnywhere)
@@ -54,6 +54,9 @@ protected:
 public:
 	FORCEINLINE bool HasInstance() const { return bCreateNodeInstance; }
 	FORCEINLINE bool IsInstance() const { return TemplateNode != nullptr; }
+
+	// True if the planning logic of this node can run on a worker thread. See bCanPlanOnWorkerThread.
+	FORCEINLINE bool CanPlanOnWorkerThread() const { return bCanPlanOnWorkerThread; }
 	
 	void InitializeInPlan(UHTNComponent& OwnerComp, uint8* NodeMemory, const struct FHTNPlan& Plan, const FHTNPlanStepID& StepID, TArray<UHTNNode*>& OutNodeInstances) const;
 	void CleanupInPlan(UHTNComponent& OwnerComp, uint8* NodeMemory) const;
@@ -158,6 +161,12 @@ protected:
 	uint8 bNotifyOnPlanExecutionStarted : 1;
 	uint8 bNotifyOnPlanExecutionFinished : 1;
 
+	// If true, the planning logic of this node only reads and writes the worldstate it is given (or the planning WorldStateProxy)
+	// and doesn't touch actors, the world, blueprints or other game-thread state, so an HTN made only of such nodes can plan on a worker thread.
+	// For standalone nodes this covers MakePlanExpansions/CreatePlanSteps. For decorators: plan-time condition checks, OnEnterPlan, OnExitPlan and ModifyStepCost.
+	// See UHTNComponent::bPlanOnWorkerThread.
+	uint8 bCanPlanOnWorkerThread : 1;
+
 	// If set, UHTNNodeLibrary::GetOwnersWorldState(UHTNNode*) will always return a 
 	// proxy to the planning worldstate instead of the blackboard.
 	mutable uint8 bForceUsingPlanningWorldState : 1;
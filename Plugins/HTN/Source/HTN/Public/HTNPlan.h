@@ -8,11 +8,15 @@ struct HTN_API FHTNPlan
 {
 	// Each plan level corresponds to a compound task.
 	// If you have an plan with a single compound task which only has primitive tasks, there will be two levels.
-	TArray<TSharedPtr<struct FHTNPlanLevel>> Levels;
+	// Stored inline since most plans have only a few levels, so that copying a plan during planning doesn't need to allocate the array.
+	TArray<TSharedPtr<struct FHTNPlanLevel>, TInlineAllocator<8>> Levels;
 
 	// The sum of the costs of the Levels.
 	int32 Cost;
 
+	// Set during planning. The least cost that can still be added to this plan before it is complete. See FHTNPlanningHeuristic.
+	int32 RemainingCostLowerBound;
+
 	// For tasks with a recursion limit, stores how many times each task is present in this plan.
 	// Since most plan expansions don't change this, the map is shared between most plans and only copied when a node with a recursion limit is added.
 	TSharedPtr<TMap<TWeakObjectPtr<UHTNNode>, int32>> RecursionCounts;
@@ -105,7 +109,7 @@ struct HTN_API FHTNPlanLevel
 	TWeakObjectPtr<UHTN> HTNAsset;
 	TSharedPtr<class FBlackboardWorldState> WorldStateAtLevelStart;
 
-	TArray<FHTNPlanStep> Steps;
+	FHTNPlanStepArray Steps;
 
 	// Step ID of the step containing this level
 	FHTNPlanStepID ParentStepID;
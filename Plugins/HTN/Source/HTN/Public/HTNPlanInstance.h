@@ -3,6 +3,7 @@
 #pragma once
 
 #include "HTNTypes.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
 #include "HTNPlanInstance.generated.h"
 
 class UHTN;
@@ -72,6 +73,61 @@ struct HTN_API FHTNPlanInstanceConfig
 	FCanHTNPlanInstanceLoop CanPlanInstanceLoopDelegate;
 };
 
+// What the last successful recheck of a plan depended on, so that rechecks whose inputs didn't change can be skipped.
+// See UHTNPlanInstance::RecheckCurrentPlan.
+struct HTN_API FHTNPlanRecheckDependencies
+{
+	// What the last recheck of a plan step depended on.
+	struct FStepDependencies
+	{
+		// The blackboard keys read while rechecking the step.
+		TBitArray<> ReadKeys;
+
+		// If false, the step has nodes that depend on more than the worldstate, so it always needs to be rechecked.
+		bool bOnlyDependsOnWorldState = false;
+	};
+
+	// Forgets the recorded dependencies if they were recorded with different active steps.
+	// When an active step finishes, the steps after it start from the blackboard instead of the worldstate the finished step was planned to produce,
+	// so they need to be rechecked even if no blackboard key changed (e.g., if the step didn't apply its planned effects).
+	void SetActiveSteps(TConstArrayView<FHTNPlanStepID> InActiveStepIDs);
+
+	// True if nothing read by the recorded steps has changed since they passed the last recheck.
+	bool CanRecheckBeSkipped() const;
+	bool CanStepRecheckBeSkipped(const FHTNPlanStepID& StepID) const;
+
+	// Starts recording what the recheck of the given step depends on.
+	FStepDependencies& RecordStep(const FHTNPlanStepID& StepID, int32 NumKeys);
+
+	// Called after a successful recheck starting from the given active steps.
+	void FinishRecording(TConstArrayView<FHTNPlanStepID> InActiveStepIDs, int32 NumKeys);
+
+	void NotifyKeyChanged(FBlackboard::FKey KeyID);
+	void Reset();
+
+	FORCEINLINE bool HasDependencies() const { return bHasDependencies; }
+
+	// The union of the ReadKeys of all recorded steps.
+	FORCEINLINE const TBitArray<>& GetReadKeys() const { return ReadKeys; }
+
+private:
+	TMap<FHTNPlanStepID, FStepDependencies> StepDependencies;
+
+	TBitArray<> ReadKeys;
+
+	// Blackboard keys whose values changed since the last recheck.
+	TBitArray<> ChangedKeys;
+
+	// The active steps of the plan when the dependencies were recorded.
+	TArray<FHTNPlanStepID, TInlineAllocator<8>> ActiveStepIDs;
+
+	// True if the StepDependencies are up to date with the plan.
+	bool bHasDependencies = false;
+
+	// True if any of the StepDependencies always needs to be rechecked.
+	bool bDependsOnNonWorldState = false;
+};
+
 // A wrapper around an HTNPlan that contains and manages the runtime data for it, such as the plan memory and the node instances.
 // It can have subplans which may be replanned during execution.
 // 
@@ -137,6 +193,8 @@ public:
 	// Verifies that the remaining part of the current plan is still valid.
 	// For all steps in the plan yet to be executed, checks if the conditions of the task and its decorators still pass, given the estimated worldstate at that point in the plan.
 	// Future worldstates ar estimated by applying planned changes to the current worldstate (one made from the blackboard at this moment, but a custom worldstate can be provided).
+	// When rechecking against the blackboard, steps are only rechecked if a blackboard key they read during their last recheck has changed since then,
+	// unless they have tasks or decorators that depend on more than the worldstate.
 	bool RecheckCurrentPlan(const class FBlackboardWorldState* WorldStateOverride = nullptr);
 
 	void Replan(const FHTNReplanParameters& Params = FHTNReplanParameters::Default);
@@ -181,6 +239,11 @@ private:
 	void TickCurrentPlan(float DeltaTime);
 	void StartTasksPendingExecution();
 
+	bool ObserveBlackboardForRecheck();
+	void StopObservingBlackboardForRecheck();
+	EBlackboardNotificationResult OnBlackboardKeyValueChange(const UBlackboardComponent& Blackboard, FBlackboard::FKey ChangedKeyID);
+	bool ObserveKeysReadByRecheck();
+
 	EHTNNodeResult StartExecuteTask(const FHTNPlanStepID& PlanStepID);
 	bool UpdateSubNodes(const FHTNPlanStepID& PlanStepID, uint8 UpdateFlags, float DeltaTime = 0.0f);
 	bool CheckConditionsOfDecoratorsInGroup(const struct FHTNSubNodeGroup& Group, EHTNDecoratorConditionCheckType CheckType, const FHTNPlanStepID& CheckedPlanStepID);
@@ -204,6 +267,10 @@ private:
 	UHTNTask& GetTaskInCurrentPlan(const FHTNPlanStepID& ExecutingStepID) const;
 	UHTNTask& GetTaskInCurrentPlan(const FHTNPlanStepID& ExecutingStepID, uint8*& OutTaskMemory) const;
 
+	void AddStepToActiveNodeIndex(const FHTNPlanStepID& StepID, EHTNTaskStatus Status);
+	void RemoveStepFromActiveNodeIndex(const FHTNPlanStepID& StepID);
+	FHTNNodeInPlanInfo FindInActiveNodeIndex(const UHTNNode* NodeTemplate, const uint8* NodeMemory) const;
+
 	void AbortExecutingPlanStep(FHTNPlanStepID PlanStepID);
 
 	void OnPlanAbortFinished();
@@ -249,6 +316,19 @@ private:
 	TArray<FHTNPlanStepID> PendingExecutionStepIDs;
 	TArray<FHTNPlanStepID> CurrentlyAbortingStepIDs;
 
+	// Where a node is active in the current plan.
+	struct FHTNActiveNodeIndexEntry
+	{
+		FHTNPlanStepID StepID;
+		uint16 NodeMemoryOffset = 0;
+		EHTNTaskStatus Status = EHTNTaskStatus::Inactive;
+	};
+
+	// The tasks, decorators and services of the CurrentlyExecutingStepIDs and CurrentlyAbortingStepIDs by template node,
+	// so that FindActiveTaskInfo etc. don't need to go through the subnodes of every active step.
+	// The entries of each node are in the order their steps were added to CurrentlyExecutingStepIDs or CurrentlyAbortingStepIDs.
+	TMap<const UHTNNode*, TArray<FHTNActiveNodeIndexEntry, TInlineAllocator<1>>> ActiveNodeIndex;
+
 	// Memory of nodes in the current plan.
 	// 
 	// It is important that this is heap-allocated, because that way a pointer 
@@ -270,6 +350,14 @@ private:
 	// How many times has this instance executed a plan (or tried to execute one).
 	int32 PlanExecutionCount;
 
+	// What the last successful RecheckCurrentPlan depended on.
+	FHTNPlanRecheckDependencies RecheckDependencies;
+
+	TWeakObjectPtr<UBlackboardComponent> ObservedBlackboard;
+
+	// Blackboard keys of the ObservedBlackboard that have observers registered. Only keys read during a recheck are observed.
+	TBitArray<> ObservedKeys;
+
 	// It is possible that the CurrentPlan is set but hasn't started execution 
 	// (e.g., initializing a SubPlan long before actually starting it)
 	uint8 bCurrentPlanStartedExecution : 1;
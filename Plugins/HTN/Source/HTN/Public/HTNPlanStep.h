@@ -85,4 +85,57 @@ struct HTN_API FHTNPlanStep
 		bIsPotentialDivergencePointDuringPlanAdjustment(false),
 		NodeMemoryOffset(0)
 	{}
-};
\ No newline at end of file
+};
+
+// The steps of a plan level. 
+// Each step is stored by reference and shared between all copies of the level, 
+// so copying a level during planning doesn't copy the steps themselves. 
+// Reading a step never copies it, even through a non-const array.
+// A shared step is only duplicated when it's explicitly accessed for modification via GetMutable/LastMutable (copy-on-write).
+class HTN_API FHTNPlanStepArray
+{
+public:
+	class FConstIterator
+	{
+	public:
+		FORCEINLINE explicit FConstIterator(const TSharedPtr<FHTNPlanStep>* InPtr) : Ptr(InPtr) {}
+		FORCEINLINE const FHTNPlanStep& operator*() const { return **Ptr; }
+		FORCEINLINE FConstIterator& operator++() { ++Ptr; return *this; }
+		FORCEINLINE bool operator!=(const FConstIterator& Other) const { return Ptr != Other.Ptr; }
+
+	private:
+		const TSharedPtr<FHTNPlanStep>* Ptr;
+	};
+
+	FORCEINLINE int32 Num() const { return Steps.Num(); }
+	FORCEINLINE bool IsValidIndex(int32 Index) const { return Steps.IsValidIndex(Index); }
+
+	FORCEINLINE const FHTNPlanStep& operator[](int32 Index) const { return *Steps[Index]; }
+	FORCEINLINE const FHTNPlanStep& Last() const { return *Steps.Last(); }
+
+	// Duplicates the step first if it's shared with other copies of the level.
+	FORCEINLINE FHTNPlanStep& GetMutable(int32 Index) { return MakeUnique(Steps[Index]); }
+	FORCEINLINE FHTNPlanStep& LastMutable() { return MakeUnique(Steps.Last()); }
+
+	template<typename... ArgsType>
+	FORCEINLINE FHTNPlanStep& Emplace_GetRef(ArgsType&&... Args)
+	{
+		return *Steps.Add_GetRef(MakeShared<FHTNPlanStep>(Forward<ArgsType>(Args)...));
+	}
+
+	FORCEINLINE FConstIterator begin() const { return FConstIterator(Steps.GetData()); }
+	FORCEINLINE FConstIterator end() const { return FConstIterator(Steps.GetData() + Steps.Num()); }
+
+private:
+	FORCEINLINE static FHTNPlanStep& MakeUnique(TSharedPtr<FHTNPlanStep>& Step)
+	{
+		if (!Step.IsUnique())
+		{
+			Step = MakeShared<FHTNPlanStep>(*Step);
+		}
+
+		return *Step;
+	}
+
+	TArray<TSharedPtr<FHTNPlanStep>, TInlineAllocator<8>> Steps;
+};
@@ -5,6 +5,9 @@
 #include "HTNNode.h"
 #include "HTNStandaloneNode.generated.h"
 
+struct FHTNPlanningHeuristic;
+struct FHTNWorkerThreadPlanningValidator;
+
 // The base class for standalone nodes (as opposed to subnodes, like decorators or services).
 UCLASS(Abstract)
 class HTN_API UHTNStandaloneNode : public UHTNNode
@@ -38,6 +41,13 @@ public:
 	virtual bool OnSubLevelFinished(UHTNPlanInstance& PlanInstance, const FHTNPlanStepID& ThisStepID, int32 FinishedSubLevelIndex);
 	// Called during execution to decide what to execute next when execution finishes in one of the sublevels of this node.
 	virtual void GetNextPrimitiveSteps(struct FHTNGetNextStepsContext& Context, const FHTNPlanStepID& ThisStepID, int32 FinishedSubLevelIndex);
+	// Returns a lower bound of the cost this node adds to a plan, including the steps in any sublevels it makes.
+	// The planner uses it to consider plans that are bound to get expensive later (see FHTNPlanningHeuristic).
+	// Must never be higher than the actual cost, otherwise the planner might not find the cheapest plan. Zero is always safe.
+	virtual int32 GetPlanningCostLowerBound(FHTNPlanningHeuristic& Heuristic) const { return 0; }
+	// Called when checking if an HTN containing this node can plan on a worker thread, after checking bCanPlanOnWorkerThread of this node and its decorators.
+	// Nodes that plan other HTNs as part of themselves (e.g., SubNetwork) should check those with the Validator too.
+	virtual bool CanPlanContentsOnWorkerThread(FHTNWorkerThreadPlanningValidator& Validator) const { return true; }
 
 	// The maximum number of times this node can be present in a single plan. 0 means no limit.
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Planning, Meta = (ClampMin = "0"))
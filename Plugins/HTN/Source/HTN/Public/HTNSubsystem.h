@@ -0,0 +1,75 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HTNSubsystem.generated.h"
+
+class UHTNComponent;
+
+// Ticks the HTNComponents that have bTickFromSubsystem enabled in one batched loop instead of each one using its own tick function.
+// The components are kept in a timing wheel: each is ticked once every few frames depending on its tick significance
+// (see UHTNComponent::SetTickSignificance) and receives the time since its last tick as DeltaTime.
+// Components with a significance of 1 (the default) are ticked every frame.
+// Scheduling is per component only: there are no separate interval buckets for services or decorators.
+// Those are still ticked from within UHTNComponent::TickHTN, so they run at the tick period of their component.
+// Anything that is only processed during the component's tick (service and decorator ticks, pending replans,
+// task ticks) can therefore be delayed by up to TickPeriod frames compared to ticking every frame.
+UCLASS()
+class HTN_API UHTNSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterComponent(UHTNComponent& Component);
+	void UnregisterComponent(UHTNComponent& Component);
+
+	// Makes the component tick once every TickPeriod frames, starting from its next tick.
+	void SetTickPeriod(const UHTNComponent& Component, int32 TickPeriod);
+
+	FORCEINLINE int32 GetNumRegisteredComponents() const { return ComponentToEntryIndex.Num(); }
+
+	// Converts a significance in the [0, 1] range to the number of frames between ticks.
+	static int32 GetTickPeriodForSignificance(float Significance);
+
+	// The number of slots in the timing wheel, which is also the longest possible tick period.
+	static constexpr int32 NumWheelSlots = 64;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<UHTNComponent> Component;
+		double LastTickTime = 0.0;
+		int32 TickPeriod = 1;
+
+		// Incremented whenever the entry is reused for another component, so that stale references to it in the wheel can be told apart.
+		uint32 Serial = 0;
+	};
+
+	struct FWheelItem
+	{
+		int32 EntryIndex = INDEX_NONE;
+		uint32 Serial = 0;
+	};
+
+	void ScheduleTick(int32 EntryIndex, int32 FramesFromNow);
+
+	TArray<FEntry> Entries;
+	TArray<int32> FreeEntryIndices;
+	TMap<const UHTNComponent*, int32> ComponentToEntryIndex;
+
+	// Each slot contains the components to tick in the frame when CurrentSlot reaches it.
+	TArray<FWheelItem> Wheel[NumWheelSlots];
+	int32 CurrentSlot = 0;
+
+	// The sum of all DeltaTimes this subsystem was ticked with.
+	double CurrentTime = 0.0;
+};
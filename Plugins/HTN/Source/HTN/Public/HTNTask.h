@@ -48,6 +48,8 @@ public:
 	// (e.g., if there is recursion or a loop of tasks together with Parallel or SubPlan nodes).
 	void FinishLatentTask(UHTNComponent& OwnerComp, EHTNNodeResult TaskResult, const uint8* NodeMemory = nullptr) const;
 
+	FORCEINLINE bool DoesRecheckPlanOnlyDependOnWorldState() const { return bRecheckPlanOnlyDependsOnWorldState; }
+
 	// If false, this task won't be shown in location summaries when visualizing the current plan. LogToVisualLog will still be called.
 	UPROPERTY(Category = "Planning", EditAnywhere)
 	uint8 bShowTaskNameOnCurrentPlanVisualization : 1;
@@ -71,6 +73,16 @@ protected:
 
 	virtual void LogToVisualLog(UHTNComponent& OwnerComp, const uint8* NodeMemory, const FHTNPlanStep& SubmittedPlanStep) const {}
 
+	// True if NativeClass is the closest native class of this task, 
+	// i.e. no C++ subclass of NativeClass could have overridden its virtual functions (e.g., RecheckPlan).
+	bool IsClosestNativeClass(const UClass* NativeClass) const;
+
 	uint8 bNotifyTick : 1;
 	uint8 bNotifyTaskFinished : 1;
+
+	// If true, the result of RecheckPlan only depends on the values of the worldstate it is given, 
+	// so plan rechecking can skip this task while none of the blackboard keys it read have changed.
+	// Off by default since RecheckPlan can look at anything (e.g., the world, time or other plan instances).
+	// Tasks that don't override RecheckPlan enable it in their constructor if IsClosestNativeClass(StaticClass()).
+	uint8 bRecheckPlanOnlyDependsOnWorldState : 1;
 };
\ No newline at end of file
@@ -12,9 +12,12 @@ class HTN_API UHTNNode_SubNetwork : public UHTNStandaloneNode
 	GENERATED_BODY()
 
 public:
+	UHTNNode_SubNetwork(const FObjectInitializer& Initializer);
 	virtual FString GetStaticDescription() const override;
 	virtual void MakePlanExpansions(FHTNPlanningContext& Context) override;
 	virtual void GetNextPrimitiveSteps(FHTNGetNextStepsContext& Context, const FHTNPlanStepID& ThisStepID) override;
+	virtual int32 GetPlanningCostLowerBound(FHTNPlanningHeuristic& Heuristic) const override;
+	virtual bool CanPlanContentsOnWorkerThread(FHTNWorkerThreadPlanningValidator& Validator) const override;
 
 	virtual FString GetNodeName() const override;
 #if WITH_EDITOR
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "BlackboardWorldstate.h"
 #include "HTNTask.h"
 #include "HTNTask_BlackboardBase.generated.h"
 
@@ -20,4 +21,7 @@ protected:
 	// Blackboard key selector
 	UPROPERTY(EditAnywhere, Category = Blackboard)
 	FBlackboardKeySelector BlackboardKey;
+
+	// The BlackboardKey resolved for fast access to its value in worldstates. Set in InitializeFromAsset.
+	FBlackboardWorldStateKeyHandle BlackboardKeyHandle;
 };
\ No newline at end of file
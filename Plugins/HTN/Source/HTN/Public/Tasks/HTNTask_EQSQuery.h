@@ -20,6 +20,7 @@ class HTN_API UHTNTask_EQSQuery : public UHTNTask_BlackboardBase
 	virtual void Serialize(FArchive& Ar) override;
 	virtual void InitializeFromAsset(UHTN& Asset) override;
 	virtual void CreatePlanSteps(UHTNComponent& OwnerComp, UAITask_MakeHTNPlan& PlanningTask, const TSharedRef<const FBlackboardWorldState>& WorldState) const override;
+	virtual int32 GetPlanningCostLowerBound(FHTNPlanningHeuristic& Heuristic) const override { return FMath::Max(0, Cost); }
 
 	virtual FString GetNodeName() const override;
 	virtual FString GetStaticDescription() const override;
@@ -31,6 +32,7 @@ class HTN_API UHTNTask_EQSQuery : public UHTNTask_BlackboardBase
 #endif
 
 private:
+	void SubmitPlanStepsFromQueryResult(UAITask_MakeHTNPlan& PlanningTask, const FBlackboardWorldState& WorldState, const FEnvQueryResult& Result) const;
 	bool StoreInWorldState(class UEnvQueryItemType* ItemTypeCDO, const struct FBlackboardKeySelector& KeySelector, FBlackboardWorldState& WorldState, const uint8* RawData) const;
 	
 	UPROPERTY(Category = EQS, EditAnywhere)
@@ -16,6 +16,7 @@ public:
 	UHTNTask_Success(const FObjectInitializer& ObjectInitializer);
 	virtual void Serialize(FArchive& Ar) override;
 	virtual void CreatePlanSteps(UHTNComponent& OwnerComp, UAITask_MakeHTNPlan& PlanningTask, const TSharedRef<const FBlackboardWorldState>& WorldState) const override;
+	virtual int32 GetPlanningCostLowerBound(FHTNPlanningHeuristic& Heuristic) const override { return FMath::Max(0, Cost); }
 	virtual FString GetStaticDescription() const override;
 	
 private:
@@ -17,6 +17,7 @@ public:
 	virtual void Serialize(FArchive& Ar) override;
 	
 	virtual void CreatePlanSteps(UHTNComponent& OwnerComp, UAITask_MakeHTNPlan& PlanningTask, const TSharedRef<const FBlackboardWorldState>& WorldState) const override;
+	virtual int32 GetPlanningCostLowerBound(FHTNPlanningHeuristic& Heuristic) const override { return FMath::Max(0, Cost); }
 	
 	virtual uint16 GetInstanceMemorySize() const override;
 
@@ -0,0 +1,48 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FBlackboardWorldState;
+struct FHTNPlan;
+
+// The states of plans that were already expanded during a single planning session.
+// The state of a plan is everything its continuation depends on: the levels that are still being planned,
+// the node each of them continues after, the structural nodes containing them, and their worldstates.
+// A plan that reaches an already expanded state at an equal or higher cost cannot lead to a cheaper plan, so it can be discarded.
+// See UHTNComponent::bPruneEquivalentPlans.
+struct HTN_API FHTNPlanningClosedSet
+{
+	// Returns true if a plan in the same state was already expanded at a cost no higher than the cost of this one.
+	// Otherwise remembers the state of this plan and returns false.
+	bool CheckAndAdd(const FHTNPlan& Plan);
+
+	FORCEINLINE int32 GetNumStates() const { return States.Num(); }
+	FORCEINLINE int32 GetNumPrunedPlans() const { return NumPrunedPlans; }
+
+	void Reset();
+
+private:
+	struct FElement
+	{
+		const void* Object = nullptr;
+		uint64 Data = 0;
+		uint32 Flags = 0;
+		TSharedPtr<const FBlackboardWorldState> WorldState;
+	};
+
+	struct FState
+	{
+		TArray<FElement> Elements;
+		int32 Cost = 0;
+	};
+
+	static void MakeStateElements(const FHTNPlan& Plan, TArray<FElement>& OutElements);
+	static uint32 GetStateHash(TArrayView<const FElement> Elements);
+	static bool AreStatesEqual(TArrayView<const FElement> A, TArrayView<const FElement> B);
+
+	TMultiMap<uint32, FState> States;
+	TArray<FElement> ScratchElements;
+	int32 NumPrunedPlans = 0;
+};
@@ -0,0 +1,66 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnvironmentQuery/EnvQueryTypes.h"
+
+class FBlackboardWorldState;
+class UEnvQuery;
+
+// Identifies an EQS query by what it runs and who runs it.
+// The worldstate values the query reads are matched separately, see FHTNPlanningEQSCache.
+struct HTN_API FHTNEQSCacheKey
+{
+	const UEnvQuery* QueryTemplate = nullptr;
+	const AActor* Querier = nullptr;
+	uint32 StaticParamsHash = 0;
+
+	friend FORCEINLINE bool operator==(const FHTNEQSCacheKey& Lhs, const FHTNEQSCacheKey& Rhs)
+	{
+		return Lhs.QueryTemplate == Rhs.QueryTemplate && Lhs.Querier == Rhs.Querier && Lhs.StaticParamsHash == Rhs.StaticParamsHash;
+	}
+
+	friend FORCEINLINE uint32 GetTypeHash(const FHTNEQSCacheKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.QueryTemplate), GetTypeHash(Key.Querier)), Key.StaticParamsHash);
+	}
+};
+
+// Results of EQS queries made during a single planning session.
+// Planning branches that reach the same query from worldstates that agree on every key the query read share the result
+// instead of running the query again. See UHTNTask_EQSQuery.
+struct HTN_API FHTNPlanningEQSCache
+{
+	~FHTNPlanningEQSCache();
+
+	// Returns the result of a query made earlier in this planning session with the same key,
+	// from a worldstate that had the same values as this one in all the keys that query read.
+	TSharedPtr<FEnvQueryResult> Find(const FHTNEQSCacheKey& Key, const FBlackboardWorldState& WorldState) const;
+
+	// Starts recording which keys are read from the worldstate until FinishRecording is called.
+	// Only one recording can be active at a time. Returns an ID to pass to FinishRecording.
+	int32 StartRecording(const TSharedRef<const FBlackboardWorldState>& WorldState, int32 NumKeys);
+
+	// Stops the recording and, if the result is valid, stores it to be shared with other branches.
+	void FinishRecording(int32 InRecordingID, const FHTNEQSCacheKey& Key, const TSharedPtr<FEnvQueryResult>& Result);
+
+	void Reset();
+
+private:
+	void StopRecording();
+
+	struct FEntry
+	{
+		// A snapshot of the worldstate the query ran from.
+		TSharedPtr<const FBlackboardWorldState> WorldState;
+		TBitArray<> ReadKeys;
+		TSharedPtr<FEnvQueryResult> Result;
+	};
+	TMultiMap<FHTNEQSCacheKey, FEntry> Entries;
+
+	TWeakPtr<const FBlackboardWorldState> RecordedWorldState;
+	TBitArray<> RecordedReadKeys;
+	int32 RecordingID = 0;
+	int32 NextRecordingID = 1;
+};
@@ -0,0 +1,36 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UHTN;
+class UHTNStandaloneNode;
+struct FHTNPlan;
+
+// Estimates how much cost is still to be added to an incomplete plan, so that the planner can consider the plans
+// whose cost plus estimate is the lowest first (A* search). The estimate never exceeds the actual remaining cost,
+// so the first complete plan found is still the cheapest one.
+// The bounds of nodes (see UHTNStandaloneNode::GetPlanningCostLowerBound) and of the paths after them are cached for the planning session.
+struct HTN_API FHTNPlanningHeuristic
+{
+	// A lower bound of the cost the incomplete levels of the plan will add before the plan is complete.
+	int32 GetRemainingCostLowerBound(const FHTNPlan& Plan);
+
+	// A lower bound of the cost of planning the given HTN from its start nodes to the end.
+	int32 GetCostLowerBound(const UHTN& HTN);
+
+	// A lower bound of the cost of planning one of the given nodes and the nodes after it until the end of their level.
+	int32 GetCostLowerBound(TArrayView<UHTNStandaloneNode* const> Nodes);
+
+	// A lower bound of the cost of planning the given node and the nodes after it until the end of its level.
+	int32 GetCostLowerBound(const UHTNStandaloneNode& Node);
+
+	void Reset();
+
+private:
+	int32 GetLevelRemainingCostLowerBound(const FHTNPlan& Plan, int32 LevelIndex);
+
+	// Bounds of nodes and HTNs. INDEX_NONE while being calculated, to stop at cycles.
+	TMap<const UObject*, int32> CachedBounds;
+};
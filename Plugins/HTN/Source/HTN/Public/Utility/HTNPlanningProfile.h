@@ -0,0 +1,45 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UHTNStandaloneNode;
+
+// Where the time of a planning session went, recorded by UAITask_MakeHTNPlan when profiling is enabled (see ai.htn.ProfilePlanning).
+// Unlike FHTNPlanningDebugInfo, which records the structure of the search, this records its cost.
+struct HTN_API FHTNPlanningProfile
+{
+	struct FNodeStats
+	{
+		// The number of times the planner tried to add the node to a plan.
+		int32 NumExpansions = 0;
+
+		// The number of plans the node submitted.
+		int32 NumSubmittedPlans = 0;
+
+		// Time spent entering and exiting the decorators of the node and of the levels it starts.
+		uint64 DecoratorCycles = 0;
+
+		// Time spent in MakePlanExpansions of the node, which includes exiting decorators when submitting plans.
+		uint64 PlanningCycles = 0;
+
+		// The number of worldstates made (see FBlackboardWorldState::MakeNext) while planning the node.
+		uint32 NumWorldStateCopies = 0;
+	};
+
+	TMap<TWeakObjectPtr<const UHTNStandaloneNode>, FNodeStats> NodeStats;
+
+	// The number of candidate plans (in the frontier and blocked) each time a plan was taken out of the frontier.
+	TArray<int32> FrontierSizes;
+
+	int32 NumExpandedPlans = 0;
+	uint64 TotalCycles = 0;
+
+	FORCEINLINE FNodeStats& FindOrAddNodeStats(const UHTNStandaloneNode& Node) { return NodeStats.FindOrAdd(&Node); }
+
+	void Reset();
+
+	// A human-readable report with the nodes sorted by the time spent planning them.
+	FString ToString() const;
+};
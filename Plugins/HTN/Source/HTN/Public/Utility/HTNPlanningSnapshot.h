@@ -0,0 +1,29 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+class UBlackboardComponent;
+class UHTN;
+
+// A planning situation that can be replayed outside of the game it was recorded in: an HTN and the blackboard values planning started from.
+// Recorded by UAITask_MakeHTNPlan when ai.htn.PlanningSnapshotDirectory is set, replayed by the HTNPlanningBenchmark commandlet.
+struct HTN_API FHTNPlanningSnapshot
+{
+	FSoftObjectPath HTN;
+	FSoftObjectPath BlackboardAsset;
+
+	// The values of the blackboard keys as strings.
+	// Object and class keys aren't recorded, since the objects they point to don't exist outside of the recorded game.
+	TMap<FName, FString> Values;
+
+	static FHTNPlanningSnapshot Capture(const UHTN& HTN, const UBlackboardComponent& Blackboard);
+
+	// Sets the recorded values on a blackboard that uses the recorded blackboard asset. Keys that weren't recorded are cleared.
+	void ApplyTo(UBlackboardComponent& Blackboard) const;
+
+	bool SaveToFile(const FString& FilePath) const;
+	bool LoadFromFile(const FString& FilePath);
+};
@@ -0,0 +1,90 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+#include "WorldCollision.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+// Identifies a trace by its quantized endpoints, shape, channel and the actors it ignores.
+struct HTN_API FHTNTraceCacheKey
+{
+	FIntVector Start = FIntVector::ZeroValue;
+	FIntVector End = FIntVector::ZeroValue;
+	FIntVector Extent = FIntVector::ZeroValue;
+	// Compared as is, so that a hash collision can't return the result of a different trace.
+	TArray<TWeakObjectPtr<const AActor>, TInlineAllocator<2>> IgnoredActors;
+	uint32 IgnoredActorsHash = 0;
+	uint8 ShapeType = 0;
+	uint8 Channel = 0;
+	bool bTraceComplex = false;
+
+	friend FORCEINLINE bool operator==(const FHTNTraceCacheKey& Lhs, const FHTNTraceCacheKey& Rhs)
+	{
+		return Lhs.Start == Rhs.Start && Lhs.End == Rhs.End && Lhs.Extent == Rhs.Extent &&
+			Lhs.ShapeType == Rhs.ShapeType && Lhs.Channel == Rhs.Channel && Lhs.bTraceComplex == Rhs.bTraceComplex &&
+			Lhs.IgnoredActorsHash == Rhs.IgnoredActorsHash && Lhs.IgnoredActors == Rhs.IgnoredActors;
+	}
+
+	friend FORCEINLINE uint32 GetTypeHash(const FHTNTraceCacheKey& Key)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Key.Start), GetTypeHash(Key.End));
+		Hash = HashCombine(Hash, GetTypeHash(Key.Extent));
+		Hash = HashCombine(Hash, Key.IgnoredActorsHash);
+		return HashCombine(Hash, Key.ShapeType | (Key.Channel << 8) | (uint32(Key.bTraceComplex) << 16));
+	}
+};
+
+// A trace that is waiting to be submitted to the physics scene as part of an async batch.
+struct HTN_API FHTNQueuedTrace
+{
+	FHTNTraceCacheKey Key;
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FCollisionShape Shape;
+	ECollisionChannel Channel = ECC_Visibility;
+	FCollisionQueryParams Params;
+};
+
+// Results of trace tests made during a single planning session.
+// Planning branches that reach the same trace test with the same endpoints reuse the result instead of tracing again.
+// Can also gather traces and submit them to the world as a single batch of async traces. See UHTNDecorator_TraceTest.
+struct HTN_API FHTNPlanningTraceCache
+{
+	static FHTNTraceCacheKey MakeKey(const FVector& Start, const FVector& End, const FCollisionShape& Shape,
+		ECollisionChannel Channel, bool bTraceComplex, TArrayView<AActor* const> IgnoredActors, float QuantizationStep);
+
+	FORCEINLINE const bool* FindResult(const FHTNTraceCacheKey& Key) const { return Results.Find(Key); }
+	FORCEINLINE void AddResult(const FHTNTraceCacheKey& Key, bool bHit) { Results.Add(Key, bHit); }
+
+	// Queues a trace to be submitted with the next batch. Does nothing if the same trace is already queued or in flight.
+	void QueueTrace(FHTNQueuedTrace&& Trace);
+	FORCEINLINE int32 GetNumQueuedTraces() const { return QueuedTraces.Num(); }
+	FORCEINLINE int32 GetNumTracesInFlight() const { return NumTracesInFlight; }
+
+	// Submits all queued traces to the world as async traces. Returns false if there was nothing to submit.
+	bool SubmitQueuedTraces(UWorld& World, const FTraceDelegate& OnTraceDone);
+
+	// Stores the result of a finished async trace. Returns true if that was the last trace in flight.
+	bool OnAsyncTraceDone(const FTraceDatum& TraceDatum);
+
+	void Reset();
+
+	// While set, trace tests don't trace synchronously on a cache miss.
+	// They only queue async traces (if they allow it) and pass, so that the decorators after them get to queue theirs too.
+	bool bIsGatheringTraces = false;
+
+private:
+	TMap<FHTNTraceCacheKey, bool> Results;
+	TArray<FHTNQueuedTrace> QueuedTraces;
+
+	// The keys of traces that are queued or in flight, to avoid submitting the same trace twice.
+	TSet<FHTNTraceCacheKey> PendingKeys;
+
+	// Indexed by the UserData of the submitted async traces.
+	TArray<FHTNTraceCacheKey> TracesInFlight;
+	int32 NumTracesInFlight = 0;
+};
@@ -0,0 +1,35 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UHTN;
+class UHTNDecorator;
+class UHTNStandaloneNode;
+
+// Checks if planning an HTN only involves nodes that can plan on a worker thread (see UHTNNode::bCanPlanOnWorkerThread): 
+// the root decorators of the HTN, the nodes reachable from its start nodes, their decorators, and the HTNs those nodes plan as part of themselves.
+// Blackboards with instanced keys are rejected too, because copying their values into worldstates creates UObjects.
+// If given a TopLevelHTN, also initializes every visited node from it like the planner does when it reaches the node,
+// so that planning on a worker thread doesn't need to. This must be done on the game thread.
+struct HTN_API FHTNWorkerThreadPlanningValidator
+{
+	explicit FHTNWorkerThreadPlanningValidator(UHTN* TopLevelHTN = nullptr);
+
+	bool CanPlanOnWorkerThread(const UHTN& HTN);
+	bool CanPlanOnWorkerThread(UHTNStandaloneNode& Node);
+
+	// Describes the first thing that was found to prevent planning on a worker thread.
+	FORCEINLINE const FString& GetFailureReason() const { return FailureReason; }
+
+private:
+	bool CanPlanOnWorkerThread(TArrayView<UHTNDecorator* const> Decorators);
+
+	UHTN* TopLevelHTN;
+
+	// HTNs and nodes that were checked already or are being checked further up the stack.
+	TSet<const UObject*> VisitedObjects;
+
+	FString FailureReason;
+};
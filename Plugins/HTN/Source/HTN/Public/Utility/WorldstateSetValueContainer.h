@@ -35,18 +35,19 @@ struct HTN_API FWorldstateSetValueContainer
 	UObject* ObjectValue = nullptr;
 	
 	bool SetValue(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
+	bool SetValue(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
 	FString GetValueDescription(const UBlackboardData* BlackboardAsset, FBlackboard::FKey KeyID) const;
 	FString GetValueDescription(const UBlackboardKeyType* ValueType) const;
 
-	bool SetValueInt(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
-	bool SetValueBool(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
-	bool SetValueEnum(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
-	bool SetValueNativeEnum(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
-	bool SetValueFloat(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
-	bool SetValueString(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
-	bool SetValueName(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
-	bool SetValueVector(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
-	bool SetValueRotator(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
-	bool SetValueClass(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
-	bool SetValueObject(FBlackboardWorldState& WorldState, const FBlackboardKeySelector& KeySelector) const;
+	bool SetValueInt(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
+	bool SetValueBool(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
+	bool SetValueEnum(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
+	bool SetValueNativeEnum(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
+	bool SetValueFloat(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
+	bool SetValueString(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
+	bool SetValueName(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
+	bool SetValueVector(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
+	bool SetValueRotator(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
+	bool SetValueClass(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
+	bool SetValueObject(FBlackboardWorldState& WorldState, const FBlackboardWorldStateKeyHandle& Key) const;
 };
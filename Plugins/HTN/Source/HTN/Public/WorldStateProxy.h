@@ -42,11 +42,21 @@ public:
 	template<class TDataClass>
 	bool SetValue(FBlackboard::FKey KeyID, typename TDataClass::FDataType Value);
 
+	template<class TDataClass>
+	typename TDataClass::FDataType GetValue(const FBlackboardWorldStateKeyHandle& Key) const;
+
+	template<class TDataClass>
+	bool SetValue(const FBlackboardWorldStateKeyHandle& Key, typename TDataClass::FDataType Value);
+
 	bool CopyValueFrom(const FBlackboardWorldState& SourceWorldState, FBlackboard::FKey KeyID);
 	
 	bool TestBasicOperation(const UBlackboardKeyType& Key, FBlackboard::FKey KeyID, EBasicKeyOperation::Type Type) const;
 	bool TestArithmeticOperation(const UBlackboardKeyType& Key, FBlackboard::FKey KeyID, EArithmeticKeyOperation::Type Type, int32 IntValue, float FloatValue) const;
 	bool TestTextOperation(const UBlackboardKeyType& Key, FBlackboard::FKey KeyID, ETextKeyOperation::Type Type, const FString& StringValue) const;
+
+	bool TestBasicOperation(const FBlackboardWorldStateKeyHandle& Key, EBasicKeyOperation::Type Type) const;
+	bool TestArithmeticOperation(const FBlackboardWorldStateKeyHandle& Key, EArithmeticKeyOperation::Type Type, int32 IntValue, float FloatValue) const;
+	bool TestTextOperation(const FBlackboardWorldStateKeyHandle& Key, ETextKeyOperation::Type Type, const FString& StringValue) const;
 	
 	UFUNCTION(BlueprintCallable, Category="AI|HTN")
 	bool GetLocation(const FBlackboardKeySelector& KeySelector, FVector& OutLocation, AActor*& OutActor) const;
@@ -238,6 +248,28 @@ bool UWorldStateProxy::SetValue(FBlackboard::FKey KeyID, typename TDataClass::FD
 	return false;
 }
 
+template <class TDataClass>
+typename TDataClass::FDataType UWorldStateProxy::GetValue(const FBlackboardWorldStateKeyHandle& Key) const
+{
+	if (WorldState.IsValid())
+	{
+		return WorldState->GetValue<TDataClass>(Key);
+	}
+
+	return GetValue<TDataClass>(Key.KeyID);
+}
+
+template <class TDataClass>
+bool UWorldStateProxy::SetValue(const FBlackboardWorldStateKeyHandle& Key, typename TDataClass::FDataType Value)
+{
+	if (bIsEditable && WorldState.IsValid())
+	{
+		return WorldState->SetValue<TDataClass>(Key, Value);
+	}
+
+	return SetValue<TDataClass>(Key.KeyID, Value);
+}
+
 FORCEINLINE FVector UWorldStateProxy::GetSelfLocation() const
 {
 	return GetValue<UBlackboardKeyType_Vector>(FBlackboard::KeySelfLocation);
@@ -0,0 +1,228 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#include "HTNPlanningBenchmarkCommandlet.h"
+#include "AITask_MakeHTNPlan.h"
+#include "BlackboardWorldstate.h"
+#include "HTN.h"
+#include "HTNComponent.h"
+#include "HTNPlan.h"
+#include "HTNTypes.h"
+#include "Utility/HTNPlanningSnapshot.h"
+
+#include "AIController.h"
+#include "Algo/Accumulate.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+
+namespace
+{
+	// The world is ticked while waiting for nodes that plan latently (e.g. EQS queries), but not indefinitely.
+	constexpr int32 MaxTicksPerPlanning = 1000;
+	constexpr float TickDeltaTime = 1.0f / 60.0f;
+
+	TArray<FString> FindSnapshotFiles(const FString& SnapshotsPath)
+	{
+		TArray<FString> Files;
+		if (IFileManager::Get().DirectoryExists(*SnapshotsPath))
+		{
+			IFileManager::Get().FindFiles(Files, *FPaths::Combine(SnapshotsPath, TEXT("*.json")), /*Files=*/true, /*Directories=*/false);
+			for (FString& File : Files)
+			{
+				File = FPaths::Combine(SnapshotsPath, File);
+			}
+			Files.Sort();
+		}
+		else if (FPaths::FileExists(SnapshotsPath))
+		{
+			Files.Add(SnapshotsPath);
+		}
+
+		return Files;
+	}
+}
+
+UHTNPlanningBenchmarkCommandlet::UHTNPlanningBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UHTNPlanningBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString SnapshotsPath;
+	if (!FParse::Value(*Params, TEXT("Snapshots="), SnapshotsPath))
+	{
+		UE_LOG(LogHTN, Error, TEXT("Usage: -run=HTNPlanningBenchmark -Snapshots=<snapshot file or directory> [-Iterations=100] [-Output=<csv file>] [-Profile]"));
+		return 1;
+	}
+
+	int32 NumIterations = 100;
+	FParse::Value(*Params, TEXT("Iterations="), NumIterations);
+	NumIterations = FMath::Max(NumIterations, 1);
+
+	FString OutputPath;
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	const bool bLogProfile = FParse::Param(*Params, TEXT("Profile"));
+
+	const TArray<FString> SnapshotFiles = FindSnapshotFiles(SnapshotsPath);
+	if (SnapshotFiles.Num() == 0)
+	{
+		UE_LOG(LogHTN, Error, TEXT("No planning snapshots found at %s"), *SnapshotsPath);
+		return 1;
+	}
+
+	UWorld* const World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld=*/false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	TArray<FResult> Results;
+	int32 NumFailedSnapshots = 0;
+	for (const FString& SnapshotFile : SnapshotFiles)
+	{
+		FHTNPlanningSnapshot Snapshot;
+		FResult Result;
+		if (!Snapshot.LoadFromFile(SnapshotFile) ||
+			!RunSnapshot(*World, FPaths::GetBaseFilename(SnapshotFile), Snapshot, NumIterations, bLogProfile, Result))
+		{
+			++NumFailedSnapshots;
+			continue;
+		}
+
+		UE_LOG(LogHTN, Display, TEXT("%s: %d iterations, min %.3f ms, median %.3f ms, mean %.3f ms, %d expanded plans, plan cost %d"),
+			*Result.SnapshotName, Result.NumIterations, Result.MinMilliseconds, Result.MedianMilliseconds, Result.MeanMilliseconds,
+			Result.NumExpandedPlans, Result.PlanCost);
+		Results.Add(MoveTemp(Result));
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(/*bInformEngineOfWorld=*/false);
+
+	if (!OutputPath.IsEmpty())
+	{
+		FString Csv = TEXT("Snapshot,Iterations,MinMs,MedianMs,MeanMs,ExpandedPlans,PlanCost\n");
+		for (const FResult& Result : Results)
+		{
+			Csv += FString::Printf(TEXT("%s,%d,%.4f,%.4f,%.4f,%d,%d\n"),
+				*Result.SnapshotName, Result.NumIterations, Result.MinMilliseconds, Result.MedianMilliseconds, Result.MeanMilliseconds,
+				Result.NumExpandedPlans, Result.PlanCost);
+		}
+
+		if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+		{
+			UE_LOG(LogHTN, Error, TEXT("Could not write benchmark results to %s"), *OutputPath);
+			return 1;
+		}
+	}
+
+	return NumFailedSnapshots > 0 ? 1 : 0;
+}
+
+bool UHTNPlanningBenchmarkCommandlet::RunSnapshot(UWorld& World, const FString& SnapshotName, const FHTNPlanningSnapshot& Snapshot,
+	int32 NumIterations, bool bLogProfile, FResult& OutResult)
+{
+	UHTN* const HTN = Cast<UHTN>(Snapshot.HTN.TryLoad());
+	UBlackboardData* const BlackboardAsset = Cast<UBlackboardData>(Snapshot.BlackboardAsset.TryLoad());
+	if (!HTN || !BlackboardAsset)
+	{
+		UE_LOG(LogHTN, Error, TEXT("%s: could not load HTN %s or blackboard %s"),
+			*SnapshotName, *Snapshot.HTN.ToString(), *Snapshot.BlackboardAsset.ToString());
+		return false;
+	}
+
+	AAIController* const Controller = World.SpawnActor<AAIController>();
+	if (!Controller)
+	{
+		UE_LOG(LogHTN, Error, TEXT("%s: could not spawn an AIController"), *SnapshotName);
+		return false;
+	}
+	ON_SCOPE_EXIT { World.DestroyActor(Controller); };
+
+	UBlackboardComponent* BlackboardComponent = nullptr;
+	if (!Controller->UseBlackboard(BlackboardAsset, BlackboardComponent) || !BlackboardComponent)
+	{
+		UE_LOG(LogHTN, Error, TEXT("%s: could not use blackboard %s"), *SnapshotName, *BlackboardAsset->GetName());
+		return false;
+	}
+	Snapshot.ApplyTo(*BlackboardComponent);
+
+	UHTNComponent* const HTNComponent = NewObject<UHTNComponent>(Controller);
+	HTNComponent->RegisterComponent();
+	HTNComponent->CacheBlackboardComponent(BlackboardComponent);
+
+	TArray<double> Milliseconds;
+	Milliseconds.Reserve(NumIterations);
+
+	// The first run is a warmup that initializes the nodes and isn't measured.
+	for (int32 Iteration = -1; Iteration < NumIterations; ++Iteration)
+	{
+		bool bFinished = false;
+		TSharedPtr<FHTNPlan> FinishedPlan;
+		const bool bIsLastIteration = Iteration == NumIterations - 1;
+
+		UAITask_MakeHTNPlan* const PlanningTask = HTNComponent->MakePlanningTask();
+		{
+			const TSharedRef<FBlackboardWorldState> WorldStateAtPlanStart = MakeShared<FBlackboardWorldState>(*BlackboardComponent);
+			PlanningTask->SetUp(HTNComponent->GetRootPlanInstance(), MakeShared<FHTNPlan>(HTN, WorldStateAtPlanStart), EHTNPlanningType::Normal);
+		}
+		if (bIsLastIteration)
+		{
+			PlanningTask->RequestProfiling();
+		}
+		PlanningTask->OnPlanningFinished.AddLambda([&](UAITask_MakeHTNPlan& Sender, TSharedPtr<FHTNPlan> Plan)
+		{
+			bFinished = true;
+			FinishedPlan = Plan;
+			if (const FHTNPlanningProfile* const Profile = Sender.GetProfile())
+			{
+				OutResult.NumExpandedPlans = Profile->NumExpandedPlans;
+				if (bLogProfile)
+				{
+					UE_LOG(LogHTN, Display, TEXT("%s profile:\n%s"), *SnapshotName, *Profile->ToString());
+				}
+			}
+		});
+
+		const double StartSeconds = FPlatformTime::Seconds();
+		PlanningTask->ReadyForActivation();
+		for (int32 NumTicks = 0; !bFinished && NumTicks < MaxTicksPerPlanning; ++NumTicks)
+		{
+			World.Tick(LEVELTICK_All, TickDeltaTime);
+		}
+		const double EndSeconds = FPlatformTime::Seconds();
+
+		if (!bFinished)
+		{
+			UE_LOG(LogHTN, Error, TEXT("%s: planning did not finish after %d ticks"), *SnapshotName, MaxTicksPerPlanning);
+			PlanningTask->ExternalCancel();
+			return false;
+		}
+
+		if (Iteration >= 0)
+		{
+			Milliseconds.Add((EndSeconds - StartSeconds) * 1000.0);
+		}
+
+		if (bIsLastIteration)
+		{
+			OutResult.PlanCost = FinishedPlan.IsValid() ? FinishedPlan->Cost : INDEX_NONE;
+		}
+	}
+
+	Milliseconds.Sort();
+	OutResult.SnapshotName = SnapshotName;
+	OutResult.NumIterations = NumIterations;
+	OutResult.MinMilliseconds = Milliseconds[0];
+	OutResult.MedianMilliseconds = Milliseconds[Milliseconds.Num() / 2];
+	OutResult.MeanMilliseconds = Algo::Accumulate(Milliseconds, 0.0) / Milliseconds.Num();
+	return true;
+}
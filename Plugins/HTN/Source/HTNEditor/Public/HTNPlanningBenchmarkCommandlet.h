@@ -0,0 +1,43 @@
+// Copyright 2020-2024 Maksym Maisak. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HTNPlanningBenchmarkCommandlet.generated.h"
+
+struct FHTNPlanningSnapshot;
+
+/**
+ * Replays recorded planning situations (see FHTNPlanningSnapshot and ai.htn.PlanningSnapshotDirectory) headlessly
+ * and reports how long planning takes, so that planning performance can be tracked across changes.
+ *
+ * Usage: -run=HTNPlanningBenchmark -Snapshots=<snapshot file or directory> [-Iterations=100] [-Output=<csv file>] [-Profile]
+ * -Profile also logs the FHTNPlanningProfile of the last iteration of each snapshot.
+ */
+UCLASS()
+class HTNEDITOR_API UHTNPlanningBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UHTNPlanningBenchmarkCommandlet();
+
+	// Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet Interface
+
+private:
+	struct FResult
+	{
+		FString SnapshotName;
+		int32 NumIterations = 0;
+		double MinMilliseconds = 0.0;
+		double MedianMilliseconds = 0.0;
+		double MeanMilliseconds = 0.0;
+		int32 NumExpandedPlans = 0;
+		int32 PlanCost = INDEX_NONE;
+	};
+
+	bool RunSnapshot(UWorld& World, const FString& SnapshotName, const FHTNPlanningSnapshot& Snapshot, int32 NumIterations, bool bLogProfile, FResult& OutResult);
+};
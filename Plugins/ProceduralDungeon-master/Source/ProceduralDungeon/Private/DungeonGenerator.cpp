@@ -140,6 +140,7 @@ void ADungeonGenerator::CreateDungeon()
 
 		// Create the first room
 		Graph->Clear();
+		RoomGrid.Reset();
 
 		// Create the list with the correct mode (depth or breadth)
 		TQueueOrStack<URoom*>::EMode listMode;
@@ -261,6 +262,9 @@ bool ADungeonGenerator::AddNewRooms(URoom& ParentRoom, TArray<URoom*>& AddedRoom
 	if (nbDoor <= 0)
 		DungeonLog_Error("The room data '%s' has no door! Nothing could be generated with it!", *GetNameSafe(ParentRoom.GetRoomData()));
 
+	// Keep the grid in sync with the room list, in case it has been modified outside of this function
+	URoom::UpdateRoomGrid(RoomGrid, InOutRoomList);
+
 	AddedRooms.Reset();
 	bool shouldContinue = false;
 	for (int i = 0; shouldContinue = ContinueToAddRoom(), i < nbDoor && shouldContinue; ++i)
@@ -317,29 +321,25 @@ bool ADungeonGenerator::AddNewRooms(URoom& ParentRoom, TArray<URoom*>& AddedRoom
 				continue;
 			}
 
-			// Create room from roomdef and set connections with current room
-			newRoom = NewObject<URoom>(this);
-			newRoom->Init(roomDef, this, InOutRoomList.Num());
-			newRoom->SetPositionAndRotationFromDoor(doorIndex, newRoomPos, newRoomDoorDir);
-
-			// Test if it fits in the place
-			if (!URoom::Overlap(*newRoom, InOutRoomList))
+			// Test if it fits in the place before creating any room object
+			const FRoomCandidate candidate(roomDef, doorIndex, newRoomPos, newRoomDoorDir);
+			if (!RoomGrid.Overlap(candidate.GetIntBounds()))
 			{
+				// Create room from the candidate and set connections with current room
+				newRoom = NewObject<URoom>(this);
+				newRoom->Init(candidate, this, InOutRoomList.Num());
+
 				// connect the doors to all possible existing rooms
 				URoom::Connect(*newRoom, doorIndex, ParentRoom, i);
 				if (Dungeon::CanLoop())
 				{
-					newRoom->TryConnectToExistingDoors(InOutRoomList);
+					newRoom->TryConnectToExistingDoors(InOutRoomList, RoomGrid);
 				}
 				InOutRoomList.Add(newRoom);
+				RoomGrid.AddRoom(newRoom->GetIntBounds());
 				AddedRooms.Add(newRoom);
 				OnRoomAdded(newRoom->GetRoomData());
 			}
-			else
-			{
-				// The object will be automatically deleted by the GC
-				newRoom = nullptr;
-			}
 		} while (nbTries > 0 && newRoom == nullptr);
 	}
 
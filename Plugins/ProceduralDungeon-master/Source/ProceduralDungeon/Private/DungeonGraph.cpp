@@ -192,7 +192,8 @@ bool UDungeonGraph::HasValidPath(const URoom* From, const URoom* To, bool Ignore
 
 URoom* UDungeonGraph::GetRoomAt(FIntVector RoomCell) const
 {
-	return URoom::GetRoomAt(RoomCell, Rooms);
+	URoom::UpdateRoomGrid(RoomGrid, Rooms);
+	return URoom::GetRoomAt(RoomCell, Rooms, RoomGrid);
 }
 
 URoom* UDungeonGraph::GetRoomByIndex(int64 Index) const
@@ -208,6 +209,7 @@ URoom* UDungeonGraph::GetRoomByIndex(int64 Index) const
 void UDungeonGraph::Clear()
 {
 	Rooms.Empty();
+	RoomGrid.Reset();
 }
 
 int UDungeonGraph::CountRoomByPredicate(TFunction<bool(const URoom*)> Predicate) const
@@ -405,6 +407,7 @@ void UDungeonGraph::SynchronizeRooms()
 	}
 	else
 		CopyRooms(Rooms, ReplicatedRooms);
+	RoomGrid.Reset();
 	CurrentState = EDungeonGraphState::None;
 }
 
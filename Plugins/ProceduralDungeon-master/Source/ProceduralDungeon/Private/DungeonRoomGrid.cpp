@@ -0,0 +1,115 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Benoit Pelletier
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "DungeonRoomGrid.h"
+#include "ProceduralDungeonUtils.h"
+
+void FDungeonRoomGrid::Reset()
+{
+	Chunks.Reset();
+	RoomBounds.Reset();
+}
+
+void FDungeonRoomGrid::AddRoom(const FBoxMinAndMax& Bounds)
+{
+	const int32 RoomIndex = RoomBounds.Add(Bounds);
+
+	FIntVector MinChunk, MaxChunk;
+	GetChunkRange(Bounds, MinChunk, MaxChunk);
+	for (int32 z = MinChunk.Z; z <= MaxChunk.Z; ++z)
+	{
+		for (int32 y = MinChunk.Y; y <= MaxChunk.Y; ++y)
+		{
+			for (int32 x = MinChunk.X; x <= MaxChunk.X; ++x)
+			{
+				Chunks.FindOrAdd(FIntVector(x, y, z)).Add(RoomIndex);
+			}
+		}
+	}
+}
+
+void FDungeonRoomGrid::AddPlaceholder()
+{
+	RoomBounds.Add(FBoxMinAndMax());
+}
+
+bool FDungeonRoomGrid::Overlap(const FBoxMinAndMax& Bounds) const
+{
+	FIntVector MinChunk, MaxChunk;
+	GetChunkRange(Bounds, MinChunk, MaxChunk);
+	for (int32 z = MinChunk.Z; z <= MaxChunk.Z; ++z)
+	{
+		for (int32 y = MinChunk.Y; y <= MaxChunk.Y; ++y)
+		{
+			for (int32 x = MinChunk.X; x <= MaxChunk.X; ++x)
+			{
+				const auto* RoomIndices = Chunks.Find(FIntVector(x, y, z));
+				if (!RoomIndices)
+					continue;
+
+				for (int32 RoomIndex : *RoomIndices)
+				{
+					if (FBoxMinAndMax::Overlap(Bounds, RoomBounds[RoomIndex]))
+						return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+int32 FDungeonRoomGrid::GetRoomIndexAt(const FIntVector& Cell) const
+{
+	const auto* RoomIndices = Chunks.Find(GetChunk(Cell));
+	if (!RoomIndices)
+		return INDEX_NONE;
+
+	// Indices are stored in ascending order, so the first match is the first added room
+	for (int32 RoomIndex : *RoomIndices)
+	{
+		const FBoxMinAndMax& Bounds = RoomBounds[RoomIndex];
+		if (Cell.X >= Bounds.Min.X && Cell.X < Bounds.Max.X
+			&& Cell.Y >= Bounds.Min.Y && Cell.Y < Bounds.Max.Y
+			&& Cell.Z >= Bounds.Min.Z && Cell.Z < Bounds.Max.Z)
+		{
+			return RoomIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+FIntVector FDungeonRoomGrid::GetChunk(const FIntVector& Cell)
+{
+	return FIntVector(
+		FMath::DivideAndRoundDown(Cell.X, ChunkSize),
+		FMath::DivideAndRoundDown(Cell.Y, ChunkSize),
+		FMath::DivideAndRoundDown(Cell.Z, ChunkSize));
+}
+
+void FDungeonRoomGrid::GetChunkRange(const FBoxMinAndMax& Bounds, FIntVector& OutMinChunk, FIntVector& OutMaxChunk)
+{
+	// Bounds are half-open, but a flat box still overlaps the boxes strictly around it (see FBoxMinAndMax::Overlap)
+	OutMinChunk = GetChunk(Bounds.Min);
+	OutMaxChunk = GetChunk(IntVector::Max(Bounds.Max - FIntVector(1), Bounds.Min));
+}
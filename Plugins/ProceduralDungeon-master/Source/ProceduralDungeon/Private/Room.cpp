@@ -65,6 +65,21 @@ bool URoom::ReplicateSubobjects(UActorChannel* Channel, FOutBunch* Bunch, FRepli
 	return bWroteSomething;
 }
 
+FRoomCandidate::FRoomCandidate(URoomData* Data, int DoorIndex, FIntVector WorldPos, EDoorDirection WorldRot)
+	: RoomData(Data)
+{
+	check(IsValid(RoomData));
+	check(DoorIndex >= 0 && DoorIndex < RoomData->Doors.Num());
+	Direction = WorldRot - RoomData->Doors[DoorIndex].Direction;
+	Position = WorldPos - Rotate(RoomData->Doors[DoorIndex].Position, Direction);
+}
+
+FBoxMinAndMax FRoomCandidate::GetIntBounds() const
+{
+	check(IsValid(RoomData));
+	return Rotate(RoomData->GetIntBounds(), Direction) + Position;
+}
+
 void URoom::Init(URoomData* Data, ADungeonGenerator* Generator, int32 RoomId)
 {
 	RoomData = Data;
@@ -87,6 +102,13 @@ void URoom::Init(URoomData* Data, ADungeonGenerator* Generator, int32 RoomId)
 	}
 }
 
+void URoom::Init(const FRoomCandidate& Candidate, ADungeonGenerator* Generator, int32 RoomId)
+{
+	Init(Candidate.RoomData, Generator, RoomId);
+	Position = Candidate.Position;
+	Direction = Candidate.Direction;
+}
+
 bool URoom::IsConnected(int Index) const
 {
 	check(Index >= 0 && Index < Connections.Num());
@@ -350,7 +372,7 @@ bool URoom::IsOccupied(FIntVector Cell)
 		&& local.Z >= Bounds.Min.Z && local.Z < Bounds.Max.Z;
 }
 
-void URoom::TryConnectToExistingDoors(TArray<URoom*>& RoomList)
+void URoom::TryConnectToExistingDoors(TArray<URoom*>& RoomList, const FDungeonRoomGrid& RoomGrid)
 {
 	for (int i = 0; i < RoomData->GetNbDoor(); ++i)
 	{
@@ -359,7 +381,7 @@ void URoom::TryConnectToExistingDoors(TArray<URoom*>& RoomList)
 
 		EDoorDirection dir = GetDoorWorldOrientation(i);
 		FIntVector pos = GetDoorWorldPosition(i) + ToIntVector(dir);
-		URoom* otherRoom = GetRoomAt(pos, RoomList);
+		URoom* otherRoom = GetRoomAt(pos, RoomList, RoomGrid);
 
 		if (IsValid(otherRoom))
 		{
@@ -526,6 +548,11 @@ bool URoom::Overlap(const URoom& Room, const TArray<URoom*>& RoomList)
 	return overlap;
 }
 
+bool URoom::Overlap(const URoom& Room, const FDungeonRoomGrid& RoomGrid)
+{
+	return RoomGrid.Overlap(Room.GetIntBounds());
+}
+
 void URoom::Connect(URoom& RoomA, int DoorA, URoom& RoomB, int DoorB)
 {
 	RoomA.SetConnection(DoorA, &RoomB, DoorB);
@@ -544,6 +571,33 @@ URoom* URoom::GetRoomAt(FIntVector RoomCell, const TArray<URoom*>& RoomList)
 	return nullptr;
 }
 
+URoom* URoom::GetRoomAt(FIntVector RoomCell, const TArray<URoom*>& RoomList, const FDungeonRoomGrid& RoomGrid)
+{
+	check(RoomGrid.Num() == RoomList.Num());
+	const int32 RoomIndex = RoomGrid.GetRoomIndexAt(RoomCell);
+	if (RoomIndex == INDEX_NONE)
+		return nullptr;
+
+	URoom* Room = RoomList[RoomIndex];
+	return IsValid(Room) ? Room : nullptr;
+}
+
+void URoom::UpdateRoomGrid(FDungeonRoomGrid& RoomGrid, const TArray<URoom*>& RoomList)
+{
+	if (RoomGrid.Num() > RoomList.Num())
+		RoomGrid.Reset();
+
+	for (int i = RoomGrid.Num(); i < RoomList.Num(); ++i)
+	{
+		// Invalid rooms still take an index to keep it matching the list
+		const URoom* Room = RoomList[i];
+		if (IsValid(Room))
+			RoomGrid.AddRoom(Room->GetIntBounds());
+		else
+			RoomGrid.AddPlaceholder();
+	}
+}
+
 ULevelStreamingDynamic* URoom::LoadInstance(UObject* WorldContextObject, const TSoftObjectPtr<UWorld>& Level, const FString& InstanceNameSuffix, FVector Location, FRotator Rotation)
 {
 	DungeonLog_InfoSilent("[W:%s] Loading LevelStreamingDynamic", *GetNameSafe(WorldContextObject));
@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Benoit Pelletier
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "CoreTypes.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "DungeonRoomGrid.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonRoomGridTest, "ProceduralDungeon.Types.RoomGrid", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FDungeonRoomGridTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(1234);
+	auto RandomBox = [&Random]()
+	{
+		const FIntVector Min(Random.RandRange(-40, 40), Random.RandRange(-40, 40), Random.RandRange(-10, 10));
+		const FIntVector Size(Random.RandRange(0, 12), Random.RandRange(0, 12), Random.RandRange(0, 4));
+		return FBoxMinAndMax(Min, Min + Size);
+	};
+
+	FDungeonRoomGrid Grid;
+	TArray<FBoxMinAndMax> Rooms;
+	for (int i = 0; i < 200; ++i)
+	{
+		const FBoxMinAndMax Room = RandomBox();
+		Grid.AddRoom(Room);
+		Rooms.Add(Room);
+	}
+	TestEqual(TEXT("Num"), Grid.Num(), Rooms.Num());
+
+	// Overlap should give the same result as testing against each room
+	for (int i = 0; i < 500; ++i)
+	{
+		const FBoxMinAndMax Box = RandomBox();
+		bool bExpected = false;
+		for (const FBoxMinAndMax& Room : Rooms)
+			bExpected |= FBoxMinAndMax::Overlap(Box, Room);
+		TestEqual(FString::Printf(TEXT("Overlap [%s] - [%s]"), *Box.Min.ToString(), *Box.Max.ToString()), Grid.Overlap(Box), bExpected);
+	}
+
+	// GetRoomIndexAt should return the first room containing the cell
+	for (int i = 0; i < 500; ++i)
+	{
+		const FIntVector Cell(Random.RandRange(-45, 55), Random.RandRange(-45, 55), Random.RandRange(-12, 16));
+		int32 Expected = INDEX_NONE;
+		for (int j = 0; j < Rooms.Num() && Expected == INDEX_NONE; ++j)
+		{
+			const FBoxMinAndMax& Room = Rooms[j];
+			if (Cell.X >= Room.Min.X && Cell.X < Room.Max.X
+				&& Cell.Y >= Room.Min.Y && Cell.Y < Room.Max.Y
+				&& Cell.Z >= Room.Min.Z && Cell.Z < Room.Max.Z)
+			{
+				Expected = j;
+			}
+		}
+		TestEqual(FString::Printf(TEXT("GetRoomIndexAt [%s]"), *Cell.ToString()), Grid.GetRoomIndexAt(Cell), Expected);
+	}
+
+	Grid.Reset();
+	TestEqual(TEXT("Num after reset"), Grid.Num(), 0);
+	TestFalse(TEXT("Overlap after reset"), Grid.Overlap(Rooms[0]));
+
+	return true;
+}
+
+#endif
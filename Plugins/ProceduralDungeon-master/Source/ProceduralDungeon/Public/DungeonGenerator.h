@@ -28,6 +28,7 @@
 #include "GameFramework/Actor.h"
 #include "Math/RandomStream.h"
 #include "DungeonOctree.h"
+#include "DungeonRoomGrid.h"
 #include "ProceduralDungeonTypes.h"
 #include "DungeonGenerator.generated.h"
 
@@ -296,6 +297,9 @@ private:
 	// Set to avoid adding increment the seed after we've set manually the seed
 	bool bShouldIncrement {false};
 
+	// Bounds of the generated rooms, to speed up overlap and neighbour queries during generation
+	FDungeonRoomGrid RoomGrid;
+
 	// Occlusion culling system
 	TUniquePtr<FDungeonOctree> Octree;
 	TSet<URoom*> CurrentPlayerRooms;
@@ -25,6 +25,7 @@
 #pragma once
 
 #include "ReplicableObject.h"
+#include "DungeonRoomGrid.h"
 #include "DungeonGraph.generated.h"
 
 class URoom;
@@ -167,6 +168,9 @@ private:
 	UPROPERTY(ReplicatedUsing = OnRep_Rooms, Transient)
 	TArray<URoom*> ReplicatedRooms;
 
+	// Lazily filled from Rooms by GetRoomAt
+	mutable FDungeonRoomGrid RoomGrid;
+
 	UFUNCTION()
 	void OnRep_Rooms();
 
@@ -0,0 +1,61 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Benoit Pelletier
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralDungeonTypes.h"
+
+// Sparse grid of room bounds, used to speed up room placement queries during generation.
+// The dungeon space is split in chunks of ChunkSize^3 cells, and only the chunks touched by a room are stored,
+// each with the indices of the rooms overlapping it.
+// Rooms are referenced by their index in the room list the grid has been filled from.
+struct PROCEDURALDUNGEON_API FDungeonRoomGrid
+{
+public:
+	static constexpr int32 ChunkSize {8};
+
+	void Reset();
+
+	// Room indices must be added in order, starting from 0
+	void AddRoom(const FBoxMinAndMax& Bounds);
+
+	// Takes a room index without registering it in any chunk, so it is never returned by the queries
+	void AddPlaceholder();
+
+	// Returns true if any added room overlaps the bounds
+	bool Overlap(const FBoxMinAndMax& Bounds) const;
+
+	// Returns the index of the first added room containing the cell, or INDEX_NONE
+	int32 GetRoomIndexAt(const FIntVector& Cell) const;
+
+	int32 Num() const { return RoomBounds.Num(); }
+
+private:
+	static FIntVector GetChunk(const FIntVector& Cell);
+	static void GetChunkRange(const FBoxMinAndMax& Bounds, FIntVector& OutMinChunk, FIntVector& OutMaxChunk);
+
+	TMap<FIntVector, TArray<int32, TInlineAllocator<4>>> Chunks;
+	TArray<FBoxMinAndMax> RoomBounds;
+};
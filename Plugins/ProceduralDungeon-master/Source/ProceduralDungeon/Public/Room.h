@@ -27,6 +27,7 @@
 #include "ReplicableObject.h"
 #include "GameFramework/Actor.h"
 #include "ProceduralDungeonTypes.h"
+#include "DungeonRoomGrid.h"
 #include "Math/GenericOctree.h" // for FBoxCenterAndExtent (required for UE5.0)
 #include "Room.generated.h"
 
@@ -48,6 +49,23 @@ struct FRoomConnection
 	ADoor* DoorInstance {nullptr};
 };
 
+// Placement of a room data in the dungeon, without any room instance.
+// Used to validate a room placement before creating its URoom.
+struct PROCEDURALDUNGEON_API FRoomCandidate
+{
+public:
+	URoomData* RoomData {nullptr};
+	FIntVector Position {0};
+	EDoorDirection Direction {EDoorDirection::North};
+
+public:
+	FRoomCandidate() = default;
+	// Places the room data so that its door DoorIndex is at WorldPos and faces WorldRot
+	FRoomCandidate(URoomData* Data, int DoorIndex, FIntVector WorldPos, EDoorDirection WorldRot);
+
+	FBoxMinAndMax GetIntBounds() const;
+};
+
 USTRUCT()
 struct FCustomDataPair
 {
@@ -153,6 +171,8 @@ protected:
 
 public:
 	void Init(URoomData* RoomData, ADungeonGenerator* Generator, int32 RoomId);
+	// Same as Init, but also takes the position and rotation of the candidate
+	void Init(const FRoomCandidate& Candidate, ADungeonGenerator* Generator, int32 RoomId);
 
 	bool IsConnected(int Index) const;
 	void SetConnection(int Index, URoom* Room, int OtherDoorIndex);
@@ -173,7 +193,8 @@ public:
 	bool IsDoorInstanced(int DoorIndex);
 	void SetDoorInstance(int DoorIndex, ADoor* Door);
 	int GetOtherDoorIndex(int DoorIndex);
-	void TryConnectToExistingDoors(TArray<URoom*>& RoomList);
+	// RoomGrid must have been filled from RoomList
+	void TryConnectToExistingDoors(TArray<URoom*>& RoomList, const FDungeonRoomGrid& RoomGrid);
 
 	FIntVector WorldToRoom(const FIntVector& WorldPos) const;
 	FIntVector RoomToWorld(const FIntVector& RoomPos) const;
@@ -194,9 +215,13 @@ public:
 	// AABB Overlapping
 	static bool Overlap(const URoom& A, const URoom& B);
 	static bool Overlap(const URoom& Room, const TArray<URoom*>& RoomList);
+	static bool Overlap(const URoom& Room, const FDungeonRoomGrid& RoomGrid);
 
 	static void Connect(URoom& RoomA, int DoorA, URoom& RoomB, int DoorB);
 	static URoom* GetRoomAt(FIntVector RoomCell, const TArray<URoom*>& RoomList);
+	static URoom* GetRoomAt(FIntVector RoomCell, const TArray<URoom*>& RoomList, const FDungeonRoomGrid& RoomGrid);
+	// Adds to the grid the rooms appended to the list since the last call, or refills it when the list has shrunk
+	static void UpdateRoomGrid(FDungeonRoomGrid& RoomGrid, const TArray<URoom*>& RoomList);
 
 private:
 	// Utility functions to load/unload level instances
@@ -563,6 +563,7 @@ void STiledFloorList::ClearFloorContent() const
 	GetActiveFloor()->EdgePlacements.Empty();
 	GetActiveFloor()->PillarPlacements.Empty();
 	GetActiveFloor()->PointPlacements.Empty();
+	GetActiveFloor()->MarkIndexDirty();
 	TiledLevelAssetPtr.Get()->ClearAutoPaintDataForFloor(GetActiveFloor()->FloorPosition);
 	OnResetInstances.Execute();
 }
@@ -577,6 +578,7 @@ void STiledFloorList::ClearNormalInstances() const
 	GetActiveFloor()->EdgePlacements.Empty();
 	GetActiveFloor()->PillarPlacements.Empty();
 	GetActiveFloor()->PointPlacements.Empty();
+	GetActiveFloor()->MarkIndexDirty();
 	OnResetInstances.Execute();
 }
 
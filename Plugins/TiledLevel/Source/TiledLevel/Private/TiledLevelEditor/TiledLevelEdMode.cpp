@@ -1183,7 +1183,7 @@ bool FTiledLevelEdMode::GetShowAutoPaintHint()
 	return ActiveAsset->GetAutoPaintRule()->bShowHint;
 }
 
-void FTiledLevelEdMode::CreateAutoPaintPlacements()
+void FTiledLevelEdMode::CreateAutoPaintPlacements(bool bIncremental)
 {
     if (ActiveLevel == nullptr || ActiveAsset == nullptr || Helper == nullptr)
     {
@@ -1193,7 +1193,7 @@ void FTiledLevelEdMode::CreateAutoPaintPlacements()
     TArray<FAutoPaintPlacement_Tile> GenTiles;
     TArray<FAutoPaintPlacement_Edge> GenEdges;
     TArray<FAutoPaintPlacement_Point> GenPoints;
-    ActiveAsset->CollectAutoPaintPlacements(GenTiles, GenEdges, GenPoints);
+    ActiveAsset->CollectAutoPaintPlacements(GenTiles, GenEdges, GenPoints, bIncremental);
     TArray<FAutoPaintPlacement*> GenAll; 
     for (auto& P : GenTiles)
     {
@@ -1310,6 +1310,93 @@ void FTiledLevelEdMode::UpdateAutoPaintPlacements()
     ActiveLevel->ResetAllInstance();
 }
 
+// placements in Old but not in New goes to OutRemoved, and vice versa
+template <typename T>
+static void DiffAutoPaintPlacements(const TArray<T>& Old, const TArray<T>& New, TArray<T>& OutRemoved, TArray<T>& OutAdded)
+{
+    TMultiMap<FTiledInstanceKey, int32> OldLookup;
+    for (int i = 0; i < Old.Num(); i++)
+        OldLookup.Add(FTiledInstanceKey(Old[i]), i);
+    TBitArray<> IsKept(false, Old.Num());
+    for (const T& P : New)
+    {
+        bool Found = false;
+        for (auto It = OldLookup.CreateKeyIterator(FTiledInstanceKey(P)); It; ++It)
+        {
+            const T& O = Old[It.Value()];
+            if (O == P && O.IsMirrored == P.IsMirrored && O.TileObjectTransform.Equals(P.TileObjectTransform))
+            {
+                IsKept[It.Value()] = true;
+                It.RemoveCurrent();
+                Found = true;
+                break;
+            }
+        }
+        if (!Found)
+            OutAdded.Add(P);
+    }
+    for (int i = 0; i < Old.Num(); i++)
+    {
+        if (!IsKept[i])
+            OutRemoved.Add(Old[i]);
+    }
+}
+
+void FTiledLevelEdMode::UpdateChangedAutoPaintPlacements()
+{
+    if (ActiveLevel == nullptr || ActiveAsset == nullptr) return;
+    // only the auto paint results are rendered in auto paint view, otherwise let reset all handle it as before
+    if (!ActiveAsset->ViewAsAutoPaint)
+    {
+        CreateAutoPaintPlacements(true);
+        ActiveLevel->ResetAllInstance();
+        return;
+    }
+    TArray<FTilePlacement> OldTiles;
+    TArray<FEdgePlacement> OldEdges;
+    TArray<FPointPlacement> OldPoints;
+    for (const FTiledFloor& F : ActiveAsset->TiledFloors)
+    {
+        if (!F.ShouldRenderInEditor) continue;
+        OldTiles.Append(F.AutoPaintGenTiles);
+        OldEdges.Append(F.AutoPaintGenEdges);
+        OldPoints.Append(F.AutoPaintGenPoints);
+    }
+    CreateAutoPaintPlacements(true);
+    TArray<FTilePlacement> NewTiles;
+    TArray<FEdgePlacement> NewEdges;
+    TArray<FPointPlacement> NewPoints;
+    for (const FTiledFloor& F : ActiveAsset->TiledFloors)
+    {
+        if (!F.ShouldRenderInEditor) continue;
+        NewTiles.Append(F.AutoPaintGenTiles);
+        NewEdges.Append(F.AutoPaintGenEdges);
+        NewPoints.Append(F.AutoPaintGenPoints);
+    }
+
+    TArray<FTilePlacement> RemovedTiles, AddedTiles;
+    TArray<FEdgePlacement> RemovedEdges, AddedEdges;
+    TArray<FPointPlacement> RemovedPoints, AddedPoints;
+    DiffAutoPaintPlacements(OldTiles, NewTiles, RemovedTiles, AddedTiles);
+    DiffAutoPaintPlacements(OldEdges, NewEdges, RemovedEdges, AddedEdges);
+    DiffAutoPaintPlacements(OldPoints, NewPoints, RemovedPoints, AddedPoints);
+    ActiveLevel->RemovePlacementInstances(RemovedTiles);
+    ActiveLevel->RemovePlacementInstances(RemovedEdges);
+    ActiveLevel->RemovePlacementInstances(RemovedPoints);
+    const int NumSpawnedActors = ActiveLevel->SpawnedTiledActors.Num();
+    for (const FTilePlacement& P : AddedTiles)
+        ActiveLevel->PopulateSinglePlacement(P);
+    for (const FEdgePlacement& P : AddedEdges)
+        ActiveLevel->PopulateSinglePlacement(P);
+    for (const FPointPlacement& P : AddedPoints)
+        ActiveLevel->PopulateSinglePlacement(P);
+    for (int i = NumSpawnedActors; i < ActiveLevel->SpawnedTiledActors.Num(); i++)
+    {
+        ActiveLevel->SpawnedTiledActors[i]->AttachToActor(ActiveLevel, FAttachmentTransformRules::KeepRelativeTransform);
+    }
+    ActiveLevel->VersionNumber = ActiveAsset->VersionNumber;
+}
+
 
 void FTiledLevelEdMode::ToggleEditViewMode()
 {
@@ -1632,48 +1719,35 @@ void FTiledLevelEdMode::UpdateEyedropperTarget(FEditorViewportClient* ViewportCl
 void FTiledLevelEdMode::EnterNewGrid_Fill()
 {
     if (SelectedItems.Num() == 0) return;
-    FIntPoint BoardSize = {ActiveAsset->X_Num, ActiveAsset->Y_Num};
     if (IsFillTiles)
     {
         CandidateFillTiles.Empty();
         if (IsTileAsFillBoundary)
         {
             SetupFillBoardFromTiles();
-            FTiledLevelUtility::FloodFill(Board, BoardSize,CurrentTilePosition.X, CurrentTilePosition.Y, CandidateFillTiles);
+            FTiledLevelUtility::FloodFill(Board, CurrentTilePosition.X, CurrentTilePosition.Y, CandidateFillTiles);
         }
         else
         {
             // Init board
-            Board.Empty();
-            BoardSize = { ActiveAsset->X_Num,ActiveAsset->Y_Num };
-            TArray<int> Zeros;
-            Zeros.Init(0, ActiveAsset->Y_Num);
-            for (int i = 0; i < ActiveAsset->X_Num; i++)
-                Board.Add(Zeros);
+            Board.Init({ ActiveAsset->X_Num,ActiveAsset->Y_Num });
             if (NeedGround)
                 UpdateFillBoardFromGround();
             // extract edge from 2D-shape placement
-            TArray<FTiledLevelEdge> BlockingEdges;
-            for (auto EdgePlacement : ActiveAsset->GetActiveFloor()->Get2DShapePlacements())
+            for (const FEdgePlacement& EdgePlacement : ActiveAsset->GetActiveFloor()->Get2DShapePlacements())
             {
                 int Extent = EdgePlacement.GetItem()->Extent.X;
-                FTiledLevelEdge FirstEdge = EdgePlacement.Edge;
-                FirstEdge.Z = 1;
-                BlockingEdges.AddUnique(FirstEdge);            
-                if (Extent != 1)
+                const FTiledLevelEdge& FirstEdge = EdgePlacement.Edge;
+                for (int e = 0; e < Extent; e++)
                 {
-                    for (int e = 1; e < Extent; e++)
-                    {
-                        FTiledLevelEdge NewEdge = EdgePlacement.Edge.EdgeType == EEdgeType::Horizontal?
-                                                      FTiledLevelEdge(FirstEdge.X + e, FirstEdge.Y, 1, EEdgeType::Horizontal) :
-                                                      FTiledLevelEdge(FirstEdge.X, FirstEdge.Y + e, 1, EEdgeType::Vertical);
-                        BlockingEdges.AddUnique(NewEdge);
-                    }
+                    Board.AddBlockingEdge(FirstEdge.EdgeType == EEdgeType::Horizontal?
+                                              FTiledLevelEdge(FirstEdge.X + e, FirstEdge.Y, 1, EEdgeType::Horizontal) :
+                                              FTiledLevelEdge(FirstEdge.X, FirstEdge.Y + e, 1, EEdgeType::Vertical));
                 }
             }
             // implement fill
             CandidateFillTiles.Empty();
-            FTiledLevelUtility::FloodFillByEdges(BlockingEdges, Board, BoardSize, CurrentTilePosition.X, CurrentTilePosition.Y, CandidateFillTiles);
+            FTiledLevelUtility::FloodFill(Board, CurrentTilePosition.X, CurrentTilePosition.Y, CandidateFillTiles);
         }
         Helper->UpdateFillPreviewGrids(CandidateFillTiles, ActiveAsset->ActiveFloorPosition, MaxZInFillItems);
     }
@@ -1681,7 +1755,7 @@ void FTiledLevelEdMode::EnterNewGrid_Fill()
     {
         CandidateFillTiles.Empty();
         SetupFillBoardFromTiles();
-        FTiledLevelUtility::GetConsecutiveTiles(Board, BoardSize, CurrentTilePosition.X, CurrentTilePosition.Y, CandidateFillTiles);
+        FTiledLevelUtility::GetConsecutiveTiles(Board, CurrentTilePosition.X, CurrentTilePosition.Y, CandidateFillTiles);
         const TSet<FIntPoint> Region = TSet<FIntPoint>(CandidateFillTiles);
         CandidateFillEdges = FTiledLevelUtility::GetEdgesAroundArea(Region, ActiveAsset->ActiveFloorPosition, true);
         CandidateFillEdges.Sort();
@@ -2109,7 +2183,7 @@ void FTiledLevelEdMode::PaintEnd()
     
     if ((HasPaintAnything || HasEraseAnything) && (PaintMode == ETiledLevelPaintMode::Auto))
     {
-        UpdateAutoPaintPlacements();
+        UpdateChangedAutoPaintPlacements();
         // TODO: will this goes to right position?
         Helper->SetupAutoPaintBrush(GetActiveAutoPaintColor());
         Helper->MoveBrush(CurrentTilePosition, false);
@@ -2465,7 +2539,7 @@ void FTiledLevelEdMode::EraserEnd()
     }
     if (HasEraseAnything && PaintMode == ETiledLevelPaintMode::Auto)
     {
-        UpdateAutoPaintPlacements();
+        UpdateChangedAutoPaintPlacements();
         Helper->SetupEraserBrush(EraserExtent, EPlacedType::Block);
         Helper->MoveBrush(CurrentTilePosition, false);
     }
@@ -2836,11 +2910,7 @@ void FTiledLevelEdMode::PerformFillEdge()
 void FTiledLevelEdMode::SetupFillBoardFromTiles()
 {
     // Init board
-    Board.Empty();
-    TArray<int> Zeros;
-    Zeros.Init(0, ActiveAsset->Y_Num);
-    for (int i = 0; i < ActiveAsset->X_Num; i++)
-        Board.Add(Zeros);
+    Board.Init({ ActiveAsset->X_Num, ActiveAsset->Y_Num });
     // fill in board value by tile placements
     for (auto Block : ActiveAsset->GetActiveFloor()->GetTilePlacements())
     {
@@ -2850,7 +2920,8 @@ void FTiledLevelEdMode::SetupFillBoardFromTiles()
         {
             for (int y = tile_y; y < tile_y + Block.Extent.Y; y++)
             {
-                Board[x][y] = 1;
+                if (Board.IsInside(x, y))
+                    Board.SetOccupied(x, y);
             } 
         }
     }
@@ -2865,8 +2936,10 @@ void FTiledLevelEdMode::UpdateFillBoardFromGround()
 {
     if (FTiledFloor* BelowFloor = ActiveAsset->GetBelowActiveFloor())
     {
-        TArray<FIntPoint> ExistingBelowTiles;
-        for (auto Block : BelowFloor->GetTilePlacements())
+        // cells without ground below are blocked, so start fully blocked and open up the ground
+        FTiledFillBoard Ground;
+        Ground.Init(Board.GetSize());
+        for (const FTilePlacement& Block : BelowFloor->GetTilePlacements())
         {
             int tile_x = Block.GridPosition.X;
             int tile_y = Block.GridPosition.Y;
@@ -2874,16 +2947,17 @@ void FTiledLevelEdMode::UpdateFillBoardFromGround()
             {
                 for (int y = tile_y; y < tile_y + Block.Extent.Y; y++)
                 {
-                    ExistingBelowTiles.AddUnique(FIntPoint(x, y));
+                    if (Ground.IsInside(x, y))
+                        Ground.SetOccupied(x, y);
                 } 
             }
         }
-        for (int x = 0; x < ActiveAsset->X_Num; x++)
+        for (int y = 0; y < Board.GetSize().Y; y++)
         {
-            for (int y = 0; y < ActiveAsset->Y_Num; y++)
+            for (int x = 0; x < Board.GetSize().X; x++)
             {
-                if (!ExistingBelowTiles.Contains(FIntPoint(x, y)))
-                    Board[x][y] = 1;
+                if (!Ground.IsOccupied(x, y))
+                    Board.SetOccupied(x, y);
             } 
         }
     }
@@ -2982,7 +3056,7 @@ void FTiledLevelEdMode::ClearAutoData(FName ItemName, bool IsSelectedFloorOnly)
         }
     }
     for (auto P : PosToRemove)
-        ActiveAsset->GetAutoPaintData().Remove(P);
+        ActiveAsset->RemoveAutoPaintDataAt(P);
     UpdateAutoPaintPlacements();
     DisplayAutoPaintHint();
 }
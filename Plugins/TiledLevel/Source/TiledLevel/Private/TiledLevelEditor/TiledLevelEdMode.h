@@ -3,6 +3,7 @@
 #pragma once
 #include "CoreMinimal.h"
 #include "TiledLevelTypes.h"
+#include "TiledLevelUtility.h"
 #include "EdMode.h"
 
 class AAutoPaintHelper;
@@ -143,8 +144,9 @@ public:
 	void SetAutoPaintRandomSeed(int NewSeed) const;
 	void ToggleAutoPaintVisibility();
 	bool GetShowAutoPaintHint();
-	void CreateAutoPaintPlacements(); // apply the transform from origin adjustment, rotation, gird actual position, and ... to each placement
+	void CreateAutoPaintPlacements(bool bIncremental = false); // apply the transform from origin adjustment, rotation, gird actual position, and ... to each placement
 	void UpdateAutoPaintPlacements();
+	void UpdateChangedAutoPaintPlacements(); // only re-evaluate around changed auto paint data and patch the changed instances
 
 	// where this edmode is triggered
 	bool IsInLevelAssetEditor = false; // in level asset editor?
@@ -286,7 +288,7 @@ private:
 	TArray<bool> CachedFloorsVisibility;
 
 	// Fill tool params
-	TArray<TArray<int>> Board;
+	FTiledFillBoard Board;
 	TArray<FIntPoint> CandidateFillTiles;
 	TArray<FTiledLevelEdge> CandidateFillEdges;
 	int MaxZInFillItems = 1;
@@ -2,8 +2,10 @@
 
 
 #include "TiledLevelEditorUtility.h"
+#include "StaticTiledLevel.h"
 #include "TiledLevelAsset.h"
 #include "TiledLevel.h"
+#include "TiledLevelUtility.h"
 #include "TiledLevelItem.h"
 #include "TiledLevelSettings.h"
 #include "AssetToolsModule.h"
@@ -17,47 +19,18 @@
 #include "AssetThumbnail.h"
 #include "PhysicsEngine/BodySetup.h"
 #include "Engine/World.h"
+#include "Materials/Material.h"
+#include "MaterialDomain.h"
 
 #define LOCTEXT_NAMESPACE "TiledLevel"
 
-UStaticMesh* FTiledLevelEditorUtility::MergeTiledLevelAsset(UTiledLevelAsset* TargetAsset)
+namespace
 {
-	// if it's empty asset, just stop here
-	if (TargetAsset->GetNumOfAllPlacements() == 0)
-		return nullptr;
-	
-	// Find first selected ProcMeshComp
-	FString NewNameSuggestion = FString(TEXT("TiledLevelMesh"));
-	FString PackageName = FString(TEXT("/Game/")) + NewNameSuggestion;
-	FString Name;
-	FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools");
-	AssetToolsModule.Get().CreateUniqueAssetName(PackageName, TEXT(""), PackageName, Name);
-
-	TSharedPtr<SDlgPickAssetPath> PickAssetPathWidget =
-		 SNew(SDlgPickAssetPath)
-		 .Title(LOCTEXT("ConvertToStaticMeshPickName", "Choose New StaticMesh Location"))
-		 .DefaultAssetPath(FText::FromString(PackageName));
-
-	if (PickAssetPathWidget->ShowModal() == EAppReturnType::Ok)
+	// Creates a static mesh asset from one proc mesh per LOD, sections sharing a material are merged into one material slot
+	UStaticMesh* CreateStaticMeshAsset(const FString& PackageName, FName MeshName, int MaxLOD, TFunctionRef<UProceduralMeshComponent*(int LOD)> MakeProcMesh)
 	{
-		 // Get the full name of where we want to create the physics asset.
-		 FString UserPackageName = PickAssetPathWidget->GetFullAssetPath().ToString();
-		 FName MeshName(*FPackageName::GetLongPackageAssetName(UserPackageName));
-
-		 // Check if the user inputed a valid asset name, if they did not, give it the generated default name
-		 if (MeshName == NAME_None)
-		 {
-			 // Use the defaults that were already generated.
-			 UserPackageName = PackageName;
-			 MeshName = *Name;
-		 }
-		int MaxLOD = 1;
-		for ( UStaticMesh* SMPtr : TargetAsset->GetUsedStaticMeshSet())
-		{
-			MaxLOD = FMath::Max(SMPtr->GetNumLODs(), MaxLOD);
-		}
 		// Then find/create it.
-		UPackage* Package = CreatePackage(*UserPackageName);
+		UPackage* Package = CreatePackage(*PackageName);
 		check(Package);
 
 		// Create StaticMesh object
@@ -67,13 +40,14 @@ UStaticMesh* FTiledLevelEditorUtility::MergeTiledLevelAsset(UTiledLevelAsset* Ta
 		StaticMesh->SetLightingGuid(FGuid::NewGuid());
 		for (int LOD = 0; LOD < MaxLOD; LOD ++)
 		{
-			UProceduralMeshComponent* ProcMeshComp = FTiledLevelUtility::ConvertTiledLevelAssetToProcMesh(TargetAsset, LOD);
+			UProceduralMeshComponent* ProcMeshComp = MakeProcMesh(LOD);
 			FMeshDescription MeshDescription = FTiledLevelUtility::BuildMeshDescription(ProcMeshComp);
 
 			 // If we got some valid data.
 			if (MeshDescription.Polygons().Num() == 0) continue;
 			
 			 // Add source to new StaticMesh
+			 const int SourceModelIndex = StaticMesh->GetNumSourceModels();
 			 FStaticMeshSourceModel& SrcModel = StaticMesh->AddSourceModel();
 			 SrcModel.BuildSettings.bRecomputeNormals = false;
 			 SrcModel.BuildSettings.bRecomputeTangents = false;
@@ -83,34 +57,37 @@ UStaticMesh* FTiledLevelEditorUtility::MergeTiledLevelAsset(UTiledLevelAsset* Ta
 			 SrcModel.BuildSettings.bGenerateLightmapUVs = true;
 			 SrcModel.BuildSettings.SrcLightmapIndex = 0;
 			 SrcModel.BuildSettings.DstLightmapIndex = 1;
-			 StaticMesh->CreateMeshDescription(LOD, MoveTemp(MeshDescription));
-			 StaticMesh->CommitMeshDescription(LOD);
+			 StaticMesh->CreateMeshDescription(SourceModelIndex, MoveTemp(MeshDescription));
+			 StaticMesh->CommitMeshDescription(SourceModelIndex);
 
 			 //// SIMPLE COLLISION
 
-			  StaticMesh->CreateBodySetup();
-			  UBodySetup* NewBodySetup = StaticMesh->GetBodySetup();
-			  NewBodySetup->BodySetupGuid = FGuid::NewGuid();
-			  NewBodySetup->AggGeom.ConvexElems = ProcMeshComp->ProcMeshBodySetup->AggGeom.ConvexElems;
-			  NewBodySetup->bGenerateMirroredCollision = false;
-			  NewBodySetup->bDoubleSidedGeometry = true;
-			  NewBodySetup->CollisionTraceFlag = CTF_UseDefault;
-			  NewBodySetup->CreatePhysicsMeshes();
+			  if (ProcMeshComp->ProcMeshBodySetup)
+			  {
+				  StaticMesh->CreateBodySetup();
+				  UBodySetup* NewBodySetup = StaticMesh->GetBodySetup();
+				  NewBodySetup->BodySetupGuid = FGuid::NewGuid();
+				  NewBodySetup->AggGeom.ConvexElems = ProcMeshComp->ProcMeshBodySetup->AggGeom.ConvexElems;
+				  NewBodySetup->bGenerateMirroredCollision = false;
+				  NewBodySetup->bDoubleSidedGeometry = true;
+				  NewBodySetup->CollisionTraceFlag = CTF_UseDefault;
+				  NewBodySetup->CreatePhysicsMeshes();
+			  }
 
 			 //// MATERIALS
-			 TSet<UMaterialInterface*> UniqueMaterials;
+			 // slot names match the polygon group names of BuildMeshDescription, every LOD shares the same slots
 			 const int32 NumSections = ProcMeshComp->GetNumSections();
 			 for (int32 SectionIdx = 0; SectionIdx < NumSections; SectionIdx++)
 			 {
-				 FProcMeshSection *ProcSection =
-					  ProcMeshComp->GetProcMeshSection(SectionIdx);
 				 UMaterialInterface *Material = ProcMeshComp->GetMaterial(SectionIdx);
-				 UniqueMaterials.Add(Material);
-			 }
-			 // Copy materials to new mesh
-			 for (auto* Material : UniqueMaterials)
-			 {
-				 StaticMesh->GetStaticMaterials().Add(FStaticMaterial(Material));
+				 if (Material == nullptr)
+					 Material = UMaterial::GetDefaultMaterial(MD_Surface);
+				 const bool bHasSlot = StaticMesh->GetStaticMaterials().ContainsByPredicate([=](const FStaticMaterial& Slot)
+				 {
+					 return Slot.ImportedMaterialSlotName == Material->GetFName();
+				 });
+				 if (!bHasSlot)
+					 StaticMesh->GetStaticMaterials().Add(FStaticMaterial(Material, Material->GetFName(), Material->GetFName()));
 			 }
 
 			 //Set the Imported version before calling the build
@@ -124,7 +101,183 @@ UStaticMesh* FTiledLevelEditorUtility::MergeTiledLevelAsset(UTiledLevelAsset* Ta
 		FAssetRegistryModule::AssetCreated(StaticMesh);
 		return StaticMesh;
 	}
-	return nullptr;
+
+	// returns false if the user cancels
+	bool PickNewAssetPath(const FString& NewNameSuggestion, FString& OutPackageName, FName& OutAssetName)
+	{
+		FString PackageName = FString(TEXT("/Game/")) + NewNameSuggestion;
+		FString Name;
+		FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools");
+		AssetToolsModule.Get().CreateUniqueAssetName(PackageName, TEXT(""), PackageName, Name);
+
+		TSharedPtr<SDlgPickAssetPath> PickAssetPathWidget =
+			 SNew(SDlgPickAssetPath)
+			 .Title(LOCTEXT("ConvertToStaticMeshPickName", "Choose New StaticMesh Location"))
+			 .DefaultAssetPath(FText::FromString(PackageName));
+
+		if (PickAssetPathWidget->ShowModal() != EAppReturnType::Ok)
+			return false;
+
+		 // Get the full name of where we want to create the physics asset.
+		OutPackageName = PickAssetPathWidget->GetFullAssetPath().ToString();
+		OutAssetName = FName(*FPackageName::GetLongPackageAssetName(OutPackageName));
+
+		 // Check if the user inputed a valid asset name, if they did not, give it the generated default name
+		if (OutAssetName == NAME_None)
+		{
+			 // Use the defaults that were already generated.
+			OutPackageName = PackageName;
+			OutAssetName = *Name;
+		}
+		return true;
+	}
+
+	// the static mesh components of spawned tiled actors, by the tags that identify their placement
+	FString MakeSpawnedActorKey(const TArray<FName>& Tags)
+	{
+		return FString::JoinBy(Tags, TEXT("|"), [](const FName& Tag) { return Tag.ToString(); });
+	}
+
+	struct FBakeCell
+	{
+		FStaticTiledLevelCell Cell;
+		TArray<UStaticMesh*> Meshes;
+		TArray<FTransform> Transforms;
+	};
+
+	template <typename T>
+	void AddPlacementToBake(TMap<FIntVector, FBakeCell>& Cells, const TMap<FString, AActor*>& SpawnedActors, const FTransform& LevelTransform,
+		const T& Placement, EPlacedType PlacedType, int32 FloorPosition, int32 CellSize)
+	{
+		UTiledLevelItem* Item = Placement.GetItem();
+		if (!Item) return;
+		const FTiledInstanceKey Key(Placement);
+		const FIntPoint CellPosition = CellSize > 0?
+			FIntPoint(FMath::FloorToInt(float(Key.Position.X) / CellSize), FMath::FloorToInt(float(Key.Position.Y) / CellSize)) :
+			FIntPoint::ZeroValue;
+
+		FBakeCell& BakeCell = Cells.FindOrAdd(FIntVector(CellPosition.X, CellPosition.Y, FloorPosition));
+		BakeCell.Cell.FloorPosition = FloorPosition;
+		BakeCell.Cell.CellPosition = CellPosition;
+		BakeCell.Cell.Placements.Add(FStaticTiledLevelPlacementRef(PlacedType, Placement, Key));
+
+		if (Item->SourceType == ETLSourceType::Mesh && !Placement.IsMirrored)
+		{
+			if (Item->TiledMesh)
+			{
+				BakeCell.Meshes.Add(Item->TiledMesh);
+				BakeCell.Transforms.Add(Placement.TileObjectTransform);
+			}
+		}
+		else if (AActor* const* SpawnedActor = SpawnedActors.Find(MakeSpawnedActorKey(FTiledLevelUtility::GetSpawnedActorTags(Placement))))
+		{
+			for (UActorComponent* AC : (*SpawnedActor)->GetComponents())
+			{
+				UStaticMeshComponent* SMC = Cast<UStaticMeshComponent>(AC);
+				if (SMC && SMC->GetStaticMesh())
+				{
+					BakeCell.Meshes.Add(SMC->GetStaticMesh());
+					BakeCell.Transforms.Add(SMC->GetComponentTransform().GetRelativeTransform(LevelTransform));
+				}
+			}
+		}
+	}
+}
+
+UStaticMesh* FTiledLevelEditorUtility::MergeTiledLevelAsset(UTiledLevelAsset* TargetAsset)
+{
+	// if it's empty asset, just stop here
+	if (TargetAsset->GetNumOfAllPlacements() == 0)
+		return nullptr;
+	
+	FString UserPackageName;
+	FName MeshName;
+	if (!PickNewAssetPath(TEXT("TiledLevelMesh"), UserPackageName, MeshName))
+		return nullptr;
+
+	int MaxLOD = 1;
+	for ( UStaticMesh* SMPtr : TargetAsset->GetUsedStaticMeshSet())
+	{
+		MaxLOD = FMath::Max(SMPtr->GetNumLODs(), MaxLOD);
+	}
+	return CreateStaticMeshAsset(UserPackageName, MeshName, MaxLOD, [=](int LOD)
+	{
+		return FTiledLevelUtility::ConvertTiledLevelAssetToProcMesh(TargetAsset, LOD);
+	});
+}
+
+AStaticTiledLevel* FTiledLevelEditorUtility::BakeTiledLevel(ATiledLevel* TargetTiledLevel, int32 CellSize)
+{
+	UTiledLevelAsset* TargetAsset = TargetTiledLevel->GetAsset();
+	if (!TargetAsset || TargetAsset->GetNumOfAllPlacements() == 0)
+		return nullptr;
+
+	FString UserPackageName;
+	FName MeshName;
+	if (!PickNewAssetPath(TEXT("TiledLevelMesh"), UserPackageName, MeshName))
+		return nullptr;
+
+	TMap<FString, AActor*> SpawnedActors;
+	for (AActor* SpawnedActor : TargetTiledLevel->SpawnedTiledActors)
+	{
+		if (IsValid(SpawnedActor) && SpawnedActor->Tags.Num() >= 3)
+			SpawnedActors.Add(MakeSpawnedActorKey(TArray<FName>(&SpawnedActor->Tags[SpawnedActor->Tags.Num() - 3], 3)), SpawnedActor);
+	}
+
+	// group the meshes of every placement by floor and cell, both in the space of the tiled level
+	const FTransform LevelTransform = TargetTiledLevel->GetActorTransform();
+	TMap<FIntVector, FBakeCell> Cells;
+	for (const FTiledFloor& Floor : TargetAsset->TiledFloors)
+	{
+		for (const FTilePlacement& P : Floor.BlockPlacements)
+			AddPlacementToBake(Cells, SpawnedActors, LevelTransform, P, EPlacedType::Block, Floor.FloorPosition, CellSize);
+		for (const FTilePlacement& P : Floor.FloorPlacements)
+			AddPlacementToBake(Cells, SpawnedActors, LevelTransform, P, EPlacedType::Floor, Floor.FloorPosition, CellSize);
+		for (const FEdgePlacement& P : Floor.WallPlacements)
+			AddPlacementToBake(Cells, SpawnedActors, LevelTransform, P, EPlacedType::Wall, Floor.FloorPosition, CellSize);
+		for (const FEdgePlacement& P : Floor.EdgePlacements)
+			AddPlacementToBake(Cells, SpawnedActors, LevelTransform, P, EPlacedType::Edge, Floor.FloorPosition, CellSize);
+		for (const FPointPlacement& P : Floor.PillarPlacements)
+			AddPlacementToBake(Cells, SpawnedActors, LevelTransform, P, EPlacedType::Pillar, Floor.FloorPosition, CellSize);
+		for (const FPointPlacement& P : Floor.PointPlacements)
+			AddPlacementToBake(Cells, SpawnedActors, LevelTransform, P, EPlacedType::Point, Floor.FloorPosition, CellSize);
+	}
+
+	FActorSpawnParameters Params;
+	Params.bNoFail = 1;
+	AStaticTiledLevel* STA = TargetTiledLevel->GetWorld()->SpawnActor<AStaticTiledLevel>(Params);
+	STA->SetSourceAsset(TargetAsset);
+	STA->SetActorTransform(LevelTransform);
+
+	for (TPair<FIntVector, FBakeCell>& Pair : Cells)
+	{
+		FBakeCell& BakeCell = Pair.Value;
+		if (BakeCell.Meshes.Num() > 0)
+		{
+			int MaxLOD = 1;
+			for (UStaticMesh* SMPtr : BakeCell.Meshes)
+				MaxLOD = FMath::Max(SMPtr->GetNumLODs(), MaxLOD);
+
+			const FString FloorName = FTiledLevelUtility::GetFloorNameFromPosition(BakeCell.Cell.FloorPosition);
+			const FString Suffix = CellSize > 0?
+				FString::Printf(TEXT("_%s_%d_%d"), *FloorName, BakeCell.Cell.CellPosition.X, BakeCell.Cell.CellPosition.Y) :
+				FString::Printf(TEXT("_%s"), *FloorName);
+			UStaticMesh* CellMesh = CreateStaticMeshAsset(UserPackageName + Suffix, FName(MeshName.ToString() + Suffix), MaxLOD, [&](int LOD)
+			{
+				return FTiledLevelUtility::ConvertMeshesToProcMesh(BakeCell.Meshes, BakeCell.Transforms, LOD, GetTransientPackage());
+			});
+
+			UStaticMeshComponent* CellComponent = NewObject<UStaticMeshComponent>(STA, FName(TEXT("Baked") + Suffix), RF_Transactional);
+			CellComponent->Mobility = STA->GetStaticMeshComponent()->Mobility;
+			CellComponent->SetStaticMesh(CellMesh);
+			CellComponent->SetupAttachment(STA->GetRootComponent());
+			STA->AddInstanceComponent(CellComponent);
+			CellComponent->RegisterComponent();
+			BakeCell.Cell.MeshComponent = CellComponent;
+		}
+		STA->AddBakedCell(BakeCell.Cell);
+	}
+	return STA;
 }
 
 void FTiledLevelEditorUtility::ConfigThumbnailAssetColor(FAssetThumbnailConfig& ThumbnailConfig, UTiledLevelItem* Item)
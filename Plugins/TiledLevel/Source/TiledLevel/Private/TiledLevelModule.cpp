@@ -179,6 +179,12 @@ void FTiledLevelModule::AddLevelViewportMenuExtender()
 						FSlateIcon(FTiledLevelStyle::GetStyleSetName(), "TiledLevel.MergeAsset"),
 						FUIAction(FExecuteAction::CreateRaw(this, &FTiledLevelModule::MergeTiledLevelAndReplace, ATL))
 					);
+					MenuBuilder.AddMenuEntry(
+						LOCTEXT("BakeTiledLevel", "Bake Tiled Level"),
+						LOCTEXT("BakeTiledLevelTooltip", "Merge each floor, or each cell of the bake cell size in tiled level settings, into its own static mesh asset and replace it here. Can be reverted to tiled level"),
+						FSlateIcon(FTiledLevelStyle::GetStyleSetName(), "TiledLevel.MergeAsset"),
+						FUIAction(FExecuteAction::CreateRaw(this, &FTiledLevelModule::BakeTiledLevel, ATL))
+					);
 				})
 				);
 			}
@@ -254,6 +260,19 @@ void FTiledLevelModule::MergeTiledLevelAndReplace(ATiledLevel* TargetTiledLevel)
 	}
 }
 
+void FTiledLevelModule::BakeTiledLevel(ATiledLevel* TargetTiledLevel)
+{
+	FScopedTransaction Transaction(LOCTEXT("BakeTransaction", "Bake tiled level"));
+	if (FTiledLevelEditorUtility::BakeTiledLevel(TargetTiledLevel, GetDefault<UTiledLevelSettings>()->BakeCellSize))
+	{
+		TArray<AActor*> Attached;
+		TargetTiledLevel->GetAttachedActors(Attached);
+		for (AActor* A : Attached)
+			A->Destroy();
+		TargetTiledLevel->Destroy();
+	}
+}
+
 void FTiledLevelModule::RevertStaticTiledLevel(AStaticTiledLevel* TargetStaticTiledLevel)
 {
 	FScopedTransaction Transaction(LOCTEXT("RevertSTLTransaction", "Revert static tiled level"));
@@ -11,6 +11,10 @@ class TILEDLEVEL_API FTiledLevelEditorUtility
 {
 public:
 	static class UStaticMesh* MergeTiledLevelAsset(class UTiledLevelAsset* TargetAsset);
+
+	// Merges the meshes of each floor, or of each CellSize x CellSize tiles of a floor when CellSize > 0, into one static mesh asset per cell,
+	// and spawns a static tiled level that renders them and remembers which placements went into which cell.
+	static class AStaticTiledLevel* BakeTiledLevel(class ATiledLevel* TargetTiledLevel, int32 CellSize);
 	
 	static void ConfigThumbnailAssetColor(struct FAssetThumbnailConfig& ThumbnailConfig, class UTiledLevelItem* Item);
  };
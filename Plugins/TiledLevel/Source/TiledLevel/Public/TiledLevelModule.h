@@ -21,6 +21,7 @@ private:
 	void BreakTiledLevel(class ATiledLevel* TargetTiledLevel);
 	void MergeTiledLevel(class ATiledLevel* TargetTiledLevel);
 	void MergeTiledLevelAndReplace(class ATiledLevel* TargetTiledLevel);
+	void BakeTiledLevel(class ATiledLevel* TargetTiledLevel);
 	void RevertStaticTiledLevel(class AStaticTiledLevel* TargetStaticTiledLevel);
 	
 };
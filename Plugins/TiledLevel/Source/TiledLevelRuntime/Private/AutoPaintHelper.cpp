@@ -25,6 +25,8 @@ AAutoPaintHelper::AAutoPaintHelper()
 	SetRootComponent(Root);
 	HintBlocks = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("HintBlocks"));
 	HintBlocks->SetupAttachment(Root);
+	MatchedHintBlocks = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("MatchedHintBlocks"));
+	MatchedHintBlocks->SetupAttachment(Root);
 	RulePreviewBlocks = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("RulePreviewBlocks"));
 	RulePreviewBlocks->SetupAttachment(Root);
 	PreviewSpawns = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("PreviewSpawns"));
@@ -35,6 +37,8 @@ void AAutoPaintHelper::Init(UTiledLevelAsset* InAsset)
 {
 	AssetPtr = InAsset;
 	RulePtr = AssetPtr->GetAutoPaintRule();
+	// cached hint sections belong to the previous asset
+	ClearHint();
 }
 
 bool AAutoPaintHelper::HasInit()
@@ -44,35 +48,53 @@ bool AAutoPaintHelper::HasInit()
 
 void AAutoPaintHelper::UpdateVisual(float InOpacity)
 {
-	// clear existing...
-	HintBlocks->ClearAllMeshSections();
-	M_Hints.Empty();
-	HintNames.Empty();
+	// all cached geometry is sized by the tiles
+	if (HintTileSize != AssetPtr->GetTileSize())
+	{
+		ClearHint();
+		HintTileSize = AssetPtr->GetTileSize();
+	}
 
 	// draw the hints
-	TMap<FName, TArray<FIntVector>> PerItemPoints;
-	for (auto elem : AssetPtr->GetAutoPaintData())
+	TMap<TPair<int32, FName>, TArray<FIntVector>> PerFloorItemPoints;
+	for (const TPair<FIntVector, FName>& elem : AssetPtr->GetAutoPaintData())
 	{
-		if (PerItemPoints.Contains(elem.Value))
-		{
-			PerItemPoints[elem.Value].Add(elem.Key);
-		}
-		else
-		{
-			PerItemPoints.Add(elem.Value, {elem.Key});
-		}
+		if (!RulePtr->Items.FindByKey(elem.Value)) continue;
+		PerFloorItemPoints.FindOrAdd(TPair<int32, FName>(elem.Key.Z, elem.Value)).Add(elem.Key);
 	}
-	int SectionId = 0;
-	for (auto elem : PerItemPoints)
+
+	for (auto It = HintSectionIds.CreateIterator(); It; ++It)
 	{
-		const FAutoPaintItem* TargetItem = RulePtr->Items.FindByKey(elem.Key);
-		if (!TargetItem) return;
-		if (!RulePtr->Items.ContainsByPredicate([=](const FAutoPaintItem& Item)
+		if (PerFloorItemPoints.Contains(It.Key())) continue;
+		HintBlocks->ClearMeshSection(It.Value());
+		HintSectionPositions[It.Value()].Empty();
+		HintNames[It.Value()] = NAME_None;
+		FreeHintSections.Add(It.Value());
+		It.RemoveCurrent();
+	}
+
+	for (TPair<TPair<int32, FName>, TArray<FIntVector>>& elem : PerFloorItemPoints)
+	{
+		const FName ItemName = elem.Key.Value;
+		if (!M_ItemHints.Contains(ItemName))
+			M_ItemHints.Add(ItemName, CreateHintMaterial(FLinearColor::White, InOpacity));
+
+		elem.Value.Sort([](const FIntVector& A, const FIntVector& B)
 		{
-			return Item.ItemName == elem.Key;
-		}))
+			if (A.Y != B.Y) return A.Y < B.Y;
+			return A.X < B.X;
+		});
+		int32 SectionId;
+		if (const int32* Found = HintSectionIds.Find(elem.Key))
 		{
-			return;
+			SectionId = *Found;
+			if (HintSectionPositions[SectionId] == elem.Value) continue;
+		}
+		else
+		{
+			SectionId = FreeHintSections.Num() > 0? FreeHintSections.Pop(false) : HintSectionPositions.AddDefaulted();
+			HintNames.SetNum(HintSectionPositions.Num());
+			HintSectionIds.Add(elem.Key, SectionId);
 		}
 		TArray<FVector> Vertices;
 		TArray<int32> Triangles;
@@ -80,49 +102,67 @@ void AAutoPaintHelper::UpdateVisual(float InOpacity)
 		TArray<FVector2D> UVs;
 		FTiledLevelUtility::GenerateCubesWithUniqueFaces(elem.Value, AssetPtr->GetTileSize(), Vertices, Triangles, Normals, UVs, 3.f);
 		HintBlocks->CreateMeshSection(SectionId, Vertices, Triangles, Normals, UVs, TArray<FColor>{}, TArray<FProcMeshTangent>{}, true);
-		UMaterialInterface* M_Base = LoadObject<UMaterialInterface>(NULL, TEXT("/TiledLevel/Materials/M_UVOutline"), NULL, 0, NULL);
-		UMaterialInstanceDynamic* M_Hint = UMaterialInstanceDynamic::Create(M_Base, this);
-		M_Hint->SetScalarParameterValue("Opacity", InOpacity);
-		M_Hint->SetVectorParameterValue("BorderColor", TargetItem->PreviewColor);
-		M_Hint->SetScalarParameterValue("BorderWidth", 0.5f);
-		HintBlocks->SetMaterial(SectionId, M_Hint);
-		M_Hints.Add(M_Hint);
-		HintNames.Add(elem.Key);
-		SectionId++;
+		HintBlocks->SetMaterial(SectionId, M_ItemHints[ItemName]);
+		HintSectionPositions[SectionId] = MoveTemp(elem.Value);
+		HintNames[SectionId] = ItemName;
+	}
+
+	// colors may be edited in the rule asset at any time
+	for (const TPair<FName, TObjectPtr<UMaterialInstanceDynamic>>& M_ItemHint : M_ItemHints)
+	{
+		if (const FAutoPaintItem* TargetItem = RulePtr->Items.FindByKey(M_ItemHint.Key))
+		{
+			M_ItemHint.Value->SetScalarParameterValue("Opacity", InOpacity);
+			M_ItemHint.Value->SetVectorParameterValue("BorderColor", TargetItem->PreviewColor);
+		}
 	}
 }
 
 void AAutoPaintHelper::ClearHint()
 {
 	HintBlocks->ClearAllMeshSections();
-	M_Hints.Empty();
+	MatchedHintBlocks->ClearAllMeshSections();
+	HintSectionIds.Empty();
+	HintSectionPositions.Empty();
+	FreeHintSections.Empty();
+	HintNames.Empty();
 }
 
 void AAutoPaintHelper::UpdateOpacity(float NewOpacity)
 {
-	for (auto& M_Hint : M_Hints)
+	for (const TPair<FName, TObjectPtr<UMaterialInstanceDynamic>>& M_ItemHint : M_ItemHints)
+		M_ItemHint.Value->SetScalarParameterValue("Opacity", NewOpacity);
+	for (auto& M_Hint : M_RulePreviewHints)
 		M_Hint->SetScalarParameterValue("Opacity", NewOpacity);
 }
 
 void AAutoPaintHelper::UpdateMatchedHint(const TArray<FIntVector>& MatchedPositions)
 {
-	const int SectionId = AssetPtr->GetAppliedAutoItemCount();
-	HintBlocks->ClearMeshSection(SectionId);
+	MatchedHintBlocks->ClearAllMeshSections();
 	if (MatchedPositions.IsEmpty()) return;
 	TArray<FVector> Vertices;
 	TArray<int32> Triangles;
 	TArray<FVector> Normals;
 	TArray<FVector2D> UVs;
 	FTiledLevelUtility::GenerateCubesWithUniqueFaces(MatchedPositions, AssetPtr->GetTileSize(), Vertices, Triangles, Normals, UVs, 5.f);
-	HintBlocks->CreateMeshSection(SectionId, Vertices, Triangles, Normals, UVs, TArray<FColor>{}, TArray<FProcMeshTangent>{}, false);
-	UMaterialInterface* M_Base = LoadObject<UMaterialInterface>(NULL, TEXT("/TiledLevel/Materials/M_UVOutline"), NULL, 0, NULL);
-	UMaterialInstanceDynamic* M_Hint = UMaterialInstanceDynamic::Create(M_Base, this);
-	M_Hint->SetScalarParameterValue("Opacity", 1.f);
-	M_Hint->SetVectorParameterValue("BorderColor", FLinearColor::Red);
-	M_Hint->SetScalarParameterValue("BorderWidth", 0.5f);
-	HintBlocks->SetMaterial(SectionId, M_Hint);
+	MatchedHintBlocks->CreateMeshSection(0, Vertices, Triangles, Normals, UVs, TArray<FColor>{}, TArray<FProcMeshTangent>{}, false);
+	if (!M_MatchedHint)
+		M_MatchedHint = CreateHintMaterial(FLinearColor::Red, 1.f);
+	MatchedHintBlocks->SetMaterial(0, M_MatchedHint);
 	
 }
+
+UMaterialInstanceDynamic* AAutoPaintHelper::CreateHintMaterial(const FLinearColor& BorderColor, float Opacity)
+{
+	if (!M_HintBase)
+		M_HintBase = LoadObject<UMaterialInterface>(NULL, TEXT("/TiledLevel/Materials/M_UVOutline"), NULL, 0, NULL);
+	UMaterialInstanceDynamic* M_Hint = UMaterialInstanceDynamic::Create(M_HintBase, this);
+	M_Hint->SetScalarParameterValue("Opacity", Opacity);
+	M_Hint->SetVectorParameterValue("BorderColor", BorderColor);
+	M_Hint->SetScalarParameterValue("BorderWidth", 0.5f);
+	return M_Hint;
+}
+
 void AAutoPaintHelper::UpdateRulePreview(UAutoPaintItemRule* SelectedItemRule)
 {
 	RulePreviewBlocks->ClearAllMeshSections();
@@ -218,17 +258,17 @@ void AAutoPaintHelper::UpdateRulePreview(UAutoPaintItemRule* SelectedItemRule)
 		for (FVector& V : Vertices)
 			V += PositionOffset;
 		RulePreviewBlocks->CreateMeshSection(SectionId, Vertices, Triangles, Normals, UVs, TArray<FColor>{}, TArray<FProcMeshTangent>{}, false);
-		UMaterialInterface* M_Base = LoadObject<UMaterialInterface>(NULL, TEXT("/TiledLevel/Materials/M_UVOutline"), NULL, 0, NULL);
-		UMaterialInstanceDynamic* M_Hint = UMaterialInstanceDynamic::Create(M_Base, this);
+		if (!M_RulePreviewHints.IsValidIndex(SectionId))
+			M_RulePreviewHints.Add(CreateHintMaterial(PreviewColor, 0.5f));
+		UMaterialInstanceDynamic* M_Hint = M_RulePreviewHints[SectionId];
 		M_Hint->SetScalarParameterValue("Opacity", 0.5f);
 		M_Hint->SetVectorParameterValue("BorderColor", PreviewColor);
-		M_Hint->SetScalarParameterValue("BorderWidth", 0.5f);
 		RulePreviewBlocks->SetMaterial(SectionId, M_Hint);
-		M_Hints.Add(M_Hint);
 		SectionId++;
 	}
 	// handle negate hint
-	UMaterialInterface* M_Empty = LoadObject<UMaterialInterface>(NULL, TEXT("/TiledLevel/Materials/M_EmptyHint"), NULL, 0, NULL);
+	if (!M_EmptyHint)
+		M_EmptyHint = LoadObject<UMaterialInterface>(NULL, TEXT("/TiledLevel/Materials/M_EmptyHint"), NULL, 0, NULL);
 	/*
 	 * this check is for too reduce unused actor components...
 	 * no need the delete all comps and then create required amount of them
@@ -240,7 +280,7 @@ void AAutoPaintHelper::UpdateRulePreview(UAutoPaintItemRule* SelectedItemRule)
 		{
 			UMaterialBillboardComponent* NewBill = NewObject<UMaterialBillboardComponent>(this, NAME_None, RF_Transactional);
 			NewBill->AttachToComponent(Root, FAttachmentTransformRules::KeepRelativeTransform);
-			NewBill->AddElement(M_Empty, nullptr, false, 64, 64, nullptr);
+			NewBill->AddElement(M_EmptyHint, nullptr, false, 64, 64, nullptr);
 			NewBill->RegisterComponentWithWorld(GetWorld());
 			NewBill->SetVisibility(false);
 			BillboardComponents.Add(NewBill);
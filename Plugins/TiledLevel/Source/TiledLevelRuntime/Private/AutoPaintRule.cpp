@@ -6,6 +6,37 @@
 
 #define LOCTEXT_NAMESPACE "AutoPaintRuleEditor"
 
+namespace
+{
+	// rules with a non empty out of boundary rule see it around the boundary
+	int GetOutOfBoundaryPadding(const UAutoPaintItemRule* Rule)
+	{
+		if (Rule->OutOfBoundaryRule == "Empty" || Rule->ImpactSize == EImpactSize::One)
+			return 0;
+		return Rule->ImpactSize == EImpactSize::Three? 1 : 2;
+	}
+
+	// tiles far enough from the boundary skip the out of boundary lookup
+	bool ShouldUseOutOfBoundaryPadding(int PaddingSize, const FIntVector& QueryPosition, const FIntVector& MinBoundary, const FIntVector& MaxBoundary)
+	{
+		if (PaddingSize == 0) return false;
+		return !(QueryPosition.X > MinBoundary.X + PaddingSize - 1 && QueryPosition.X < MaxBoundary.X + PaddingSize - 2 &&
+			QueryPosition.Y > MinBoundary.Y + PaddingSize - 1 && QueryPosition.Y < MaxBoundary.Y + PaddingSize - 2 &&
+			QueryPosition.Z > MinBoundary.Z + PaddingSize - 1 && QueryPosition.Z < MaxBoundary.Z + PaddingSize - 2);
+	}
+
+	// probability, spawn list and step size, checked before any adjacency
+	bool PassesRulePrecheck(const UAutoPaintItemRule* QueryRule, const FIntVector& QueryPosition, const FRandomStream& Random)
+	{
+		if (QueryRule->AutoPaintItemSpawns.IsEmpty()) return false;
+		if (QueryRule->Probability + 0.00001 < Random.FRand()) return false;
+		const FIntVector StepPosition = QueryPosition - QueryRule->StepOffset;
+		return StepPosition.X % QueryRule->StepSize.X == 0 &&
+			StepPosition.Y % QueryRule->StepSize.Y == 0 &&
+			StepPosition.Z % QueryRule->StepSize.Z == 0;
+	}
+}
+
 UAutoPaintItemRule::UAutoPaintItemRule(const FObjectInitializer& ObjectInitializer)
 	:Super(ObjectInitializer)
 {
@@ -31,6 +62,16 @@ void UAutoPaintItemRule::UpdateImpactSize(EImpactSize NewImpactSize)
 }
 
 FTiledItemObj UAutoPaintItemRule::PickWhatToSpawn() const
+{
+	return PickWhatToSpawn(FMath::FRand());
+}
+
+FTiledItemObj UAutoPaintItemRule::PickWhatToSpawn(const FRandomStream& Random) const
+{
+	return PickWhatToSpawn(Random.FRand());
+}
+
+FTiledItemObj UAutoPaintItemRule::PickWhatToSpawn(float RandValue) const
 {
 	TArray<float> TempWeights;
 	for (auto [k, v] : AutoPaintItemSpawns)
@@ -39,7 +80,6 @@ FTiledItemObj UAutoPaintItemRule::PickWhatToSpawn() const
 		TempWeights.Add(v.RandomCoefficient);
 	}
 	TArray<float> Weights = FTiledLevelUtility::GetWeightedCoefficient(TempWeights);
-	const float RandValue = FMath::FRand();
 	int i = 0;
 	for (auto [k, v] : AutoPaintItemSpawns)
 	{
@@ -68,11 +108,25 @@ TArray<EDuplicationType> UAutoPaintItemRule::GetDuplicateCases() const
 }
 
 
+bool UAutoPaintItemRule::Modify(bool bAlwaysMarkDirty)
+{
+	if (UAutoPaintRule* Rule = Cast<UAutoPaintRule>(GetOutermostObject()))
+	{
+		Rule->MarkRuleChanged();
+	}
+	return UObject::Modify(bAlwaysMarkDirty);
+}
+
 #if WITH_EDITOR
 void UAutoPaintItemRule::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	UObject::PostEditChangeProperty(PropertyChangedEvent);
 
+	if (UAutoPaintRule* Rule = Cast<UAutoPaintRule>(GetOutermostObject()))
+	{
+		Rule->MarkRuleChanged();
+	}
+
 	if (PropertyChangedEvent.Property == nullptr) return;
 	if (PropertyChangedEvent.Property->GetFName() == "PlacedType")
 	{
@@ -190,92 +244,73 @@ void UAutoPaintRule::ReorderItem(const FName& ItemName1, const FName& ItemName2)
 }
 
 bool UAutoPaintRule::IsRuleMet(UAutoPaintItemRule* QueryRule, EDuplicationType DupCase, FIntVector QueryPosition,
-	const TMap<FIntVector, FName>& ExistingData, FIntVector MinBoundary, FIntVector MaxBoundary)
+	const TMap<FIntVector, FName>& ExistingData, FIntVector MinBoundary, FIntVector MaxBoundary, const FRandomStream& Random)
 {
 	// return no need to test
-	if (QueryRule->AutoPaintItemSpawns.IsEmpty()) return false;
-	if (QueryRule->Probability + 0.00001 < FMath::FRand()) return false;
-	const FIntVector StepPosition = QueryPosition - QueryRule->StepOffset;
-	if (StepPosition.X % QueryRule->StepSize.X != 0 ||
-		StepPosition.Y % QueryRule->StepSize.Y != 0 ||
-		StepPosition.Z % QueryRule->StepSize.Z != 0)
-		return false;
+	if (!PassesRulePrecheck(QueryRule, QueryPosition, Random)) return false;
 	
-	// rotate raw adj rule points in response to dup case...
-	TMap<FIntVector, FAdjacencyRule> ToCheck;
-	for (auto [k, v] : QueryRule->AdjacencyRules)
-	{
-		ToCheck.Add(RotatePosToDuplicated(k, DupCase), v);
-	}
 	// early return for OOB checking
-	// place it earlier than creating padding data... this should improve performance a little bit...
-	for (auto [AdjPoint, AdjInfo] : ToCheck)
+	// place it earlier than looking up any data... this should improve performance a little bit...
+	if (QueryRule->OutOfBoundaryRule == "Not Applicable")
 	{
-		FIntVector TestPoint = AdjPoint + QueryPosition;
-		if (QueryRule->OutOfBoundaryRule == "Not Applicable")
+		for (const auto& [AdjPoint, AdjInfo] : QueryRule->AdjacencyRules)
 		{
+			const FIntVector TestPoint = RotatePosToDuplicated(AdjPoint, DupCase) + QueryPosition;
 			if (TestPoint.X < MinBoundary.X || TestPoint.Y < MinBoundary.Y || TestPoint.Z < MinBoundary.Z)
 				return false;
 			if (TestPoint.X > MaxBoundary.X || TestPoint.Y > MaxBoundary.Y || TestPoint.Z > MaxBoundary.Z)
 				return false;
 		}
 	}
-	// create padding for OOB check
-	TMap<FIntVector, FName> ExistingData_Padding = ExistingData;
-	if (QueryRule->OutOfBoundaryRule != "Empty" && QueryRule->ImpactSize != EImpactSize::One)
+	// padding for OOB check, looked up on the fly instead of copying the whole existing data
+	int PaddingSize = GetOutOfBoundaryPadding(QueryRule);
+	if (!ShouldUseOutOfBoundaryPadding(PaddingSize, QueryPosition, MinBoundary, MaxBoundary))
+		PaddingSize = 0;
+	auto FindData = [&](const FIntVector& TestPoint) -> const FName*
 	{
-		const int PaddingSize = QueryRule->ImpactSize == EImpactSize::Three? 1 : 2;
-		bool NeedToPad = true;
-		if (QueryPosition.X > MinBoundary.X + PaddingSize - 1 && QueryPosition.X < MaxBoundary.X + PaddingSize - 2 &&
-			QueryPosition.Y > MinBoundary.Y + PaddingSize - 1 && QueryPosition.Y < MaxBoundary.Y + PaddingSize - 2 &&
-			QueryPosition.Z > MinBoundary.Z + PaddingSize - 1 && QueryPosition.Z < MaxBoundary.Z + PaddingSize - 2
-			)
-		{
-			NeedToPad = false;
-		}
-
-		if (NeedToPad)
+		if (PaddingSize > 0)
 		{
-			for (int x = MinBoundary.X - PaddingSize; x < MaxBoundary.X + PaddingSize; x++)
-			{
-				for (int y = MinBoundary.Y - PaddingSize; y < MaxBoundary.Y + PaddingSize; y++)
-				{
-					for (int z = MinBoundary.Z - PaddingSize; z < MaxBoundary.Z + PaddingSize; z++)
-					{
-						if (x >= MinBoundary.X && x < MaxBoundary.X && y >= MinBoundary.Y && y < MaxBoundary.Y && z >= MinBoundary.Z && z < MaxBoundary.Z)
-							continue;
-						ExistingData_Padding.Add(FIntVector(x, y, z), QueryRule->OutOfBoundaryRule);
-					}
-				}
-			}
+			const bool InPadding =
+				TestPoint.X >= MinBoundary.X - PaddingSize && TestPoint.X < MaxBoundary.X + PaddingSize &&
+				TestPoint.Y >= MinBoundary.Y - PaddingSize && TestPoint.Y < MaxBoundary.Y + PaddingSize &&
+				TestPoint.Z >= MinBoundary.Z - PaddingSize && TestPoint.Z < MaxBoundary.Z + PaddingSize;
+			const bool InBoundary =
+				TestPoint.X >= MinBoundary.X && TestPoint.X < MaxBoundary.X &&
+				TestPoint.Y >= MinBoundary.Y && TestPoint.Y < MaxBoundary.Y &&
+				TestPoint.Z >= MinBoundary.Z && TestPoint.Z < MaxBoundary.Z;
+			if (InPadding && !InBoundary)
+				return &QueryRule->OutOfBoundaryRule;
 		}
-	}
+		return ExistingData.Find(TestPoint);
+	};
 	// The actual checking algorithm...
-	for (auto [AdjPoint, AdjInfo] : ToCheck)
+	for (const auto& [AdjPoint, AdjInfo] : QueryRule->AdjacencyRules)
 	{
-		FIntVector TestPoint = AdjPoint + QueryPosition;
+		const FIntVector TestPoint = RotatePosToDuplicated(AdjPoint, DupCase) + QueryPosition;
 		// if any not met return false
-		if (ExistingData_Padding.Contains(TestPoint))
-		{
-			if (ExistingData_Padding[TestPoint] != AdjInfo.AutoPaintItemName && AdjInfo.bNegate)
-			{
-				continue;
-			}
-			if (ExistingData_Padding[TestPoint] == AdjInfo.AutoPaintItemName && !AdjInfo.bNegate)
-			{
-				continue;
-			}
+		if (!IsAdjacencyMet(AdjInfo, FindData(TestPoint)))
 			return false;
-		}
-		if (AdjInfo.AutoPaintItemName != TEXT("Empty") && AdjInfo.bNegate)
-			continue;
-		if (AdjInfo.AutoPaintItemName == TEXT("Empty"))
-			continue;
-		return false;
 	}
 	return true;
 }
 
+bool UAutoPaintRule::IsAdjacencyMet(const FAdjacencyRule& AdjInfo, const FName* Found)
+{
+	if (Found)
+	{
+		if (*Found != AdjInfo.AutoPaintItemName && AdjInfo.bNegate)
+			return true;
+		if (*Found == AdjInfo.AutoPaintItemName && !AdjInfo.bNegate)
+			return true;
+		return false;
+	}
+	if (AdjInfo.AutoPaintItemName != TEXT("Empty") && AdjInfo.bNegate)
+		return true;
+	if (AdjInfo.AutoPaintItemName == TEXT("Empty"))
+		return true;
+	return false;
+}
+
 FIntVector UAutoPaintRule::RotatePosToDuplicated(const FIntVector& InPos, EDuplicationType DupType)
 {
 	switch (DupType) {
@@ -354,6 +389,173 @@ FDuplicationMod UAutoPaintRule::GetDuplicationMod(EDuplicationType DupType, EPla
  	return Out;
 }
 
+bool FAutoPaintCodeGrid::Init(const TMap<FIntVector, FName>& Data, const FIntVector& InMinBoundary, const FIntVector& InMaxBoundary)
+{
+	return Init(Data, InMinBoundary, InMaxBoundary, InMinBoundary, InMaxBoundary);
+}
+
+bool FAutoPaintCodeGrid::Init(const TMap<FIntVector, FName>& Data, const FIntVector& InMinBoundary, const FIntVector& InMaxBoundary,
+	const FIntVector& RegionMin, const FIntVector& RegionMax)
+{
+	// keep the grid well below what a full evaluation would allocate anyway
+	constexpr int64 MaxCells = 64 * 1024 * 1024;
+	Cells.Reset();
+	CodeNames.Reset();
+	MinBoundary = InMinBoundary;
+	MaxBoundary = InMaxBoundary;
+	GridMin = RegionMin - FIntVector(Padding);
+	GridSize = RegionMax - RegionMin + FIntVector(Padding * 2);
+	const int64 NumCells = static_cast<int64>(GridSize.X) * GridSize.Y * GridSize.Z;
+	if (GridSize.X <= 0 || GridSize.Y <= 0 || GridSize.Z <= 0 || NumCells > MaxCells)
+		return false;
+
+	CodeNames.Add(NAME_None);
+	CodeNames.Add(NAME_None);
+	TMap<FName, uint8> Codes;
+	Cells.SetNumZeroed(static_cast<int32>(NumCells));
+	auto SetCell = [&](const FIntVector& Pos, const FName& ItemName)
+	{
+		uint8* Code = Codes.Find(ItemName);
+		if (!Code)
+		{
+			if (CodeNames.Num() == MaxCodes)
+			{
+				Cells.Reset();
+				return false;
+			}
+			Code = &Codes.Add(ItemName, static_cast<uint8>(CodeNames.Num()));
+			CodeNames.Add(ItemName);
+		}
+		Cells[GetCellIndex(Pos)] = *Code;
+		return true;
+	};
+	// a small region looks its cells up, instead of going through all the data of the level
+	if (NumCells < Data.Num())
+	{
+		for (int z = 0; z < GridSize.Z; z++)
+		{
+			for (int y = 0; y < GridSize.Y; y++)
+			{
+				for (int x = 0; x < GridSize.X; x++)
+				{
+					const FIntVector Pos = GridMin + FIntVector(x, y, z);
+					if (const FName* ItemName = Data.Find(Pos))
+					{
+						if (!SetCell(Pos, *ItemName))
+							return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
+	for (const auto& [Pos, ItemName] : Data)
+	{
+		const FIntVector GridPos = Pos - GridMin;
+		if (GridPos.X < 0 || GridPos.Y < 0 || GridPos.Z < 0 || GridPos.X >= GridSize.X || GridPos.Y >= GridSize.Y || GridPos.Z >= GridSize.Z)
+			continue;
+		if (!SetCell(Pos, ItemName))
+			return false;
+	}
+	return true;
+}
+
+int32 FAutoPaintCodeGrid::GetCellIndex(const FIntVector& Position) const
+{
+	const FIntVector GridPos = Position - GridMin;
+	return (GridPos.Z * GridSize.Y + GridPos.Y) * GridSize.X + GridPos.X;
+}
+
+int32 FAutoPaintCodeGrid::GetCellOffset(const FIntVector& Offset) const
+{
+	return (Offset.Z * GridSize.Y + Offset.Y) * GridSize.X + Offset.X;
+}
+
+bool FAutoPaintCodeGrid::IsInBoundary(const FIntVector& Position) const
+{
+	return Position.X >= MinBoundary.X && Position.X < MaxBoundary.X &&
+		Position.Y >= MinBoundary.Y && Position.Y < MaxBoundary.Y &&
+		Position.Z >= MinBoundary.Z && Position.Z < MaxBoundary.Z;
+}
+
+FAutoPaintCompiledRule FAutoPaintCompiledRule::Compile(UAutoPaintItemRule* InRule, const FAutoPaintCodeGrid& Grid)
+{
+	FAutoPaintCompiledRule Out;
+	Out.Rule = InRule;
+	if (!Grid.IsValid()) return Out;
+	for (EDuplicationType DupType : InRule->GetDuplicateCases())
+	{
+		FVariant& Variant = Out.Variants.AddDefaulted_GetRef();
+		Variant.DupType = DupType;
+		Variant.MinOffset = FIntVector(0);
+		Variant.MaxOffset = FIntVector(0);
+		for (const auto& [AdjPoint, AdjInfo] : InRule->AdjacencyRules)
+		{
+			const FIntVector Offset = UAutoPaintRule::RotatePosToDuplicated(AdjPoint, DupType);
+			// the grid is only padded for the impact sizes the editor allows
+			if (FMath::Abs(Offset.X) > FAutoPaintCodeGrid::Padding || FMath::Abs(Offset.Y) > FAutoPaintCodeGrid::Padding ||
+				FMath::Abs(Offset.Z) > FAutoPaintCodeGrid::Padding)
+			{
+				Out.Variants.Empty();
+				return Out;
+			}
+			FCondition& Condition = Variant.Conditions.AddDefaulted_GetRef();
+			Condition.Offset = Offset;
+			Condition.CellOffset = Grid.GetCellOffset(Offset);
+			Condition.MetCodes = 0;
+			for (int32 Code = 0; Code < Grid.CodeNames.Num(); Code++)
+			{
+				const FName* Found = Code == FAutoPaintCodeGrid::NoDataCode? nullptr :
+					Code == FAutoPaintCodeGrid::OutOfBoundaryCode? &InRule->OutOfBoundaryRule : &Grid.CodeNames[Code];
+				if (UAutoPaintRule::IsAdjacencyMet(AdjInfo, Found))
+					Condition.MetCodes |= uint64(1) << Code;
+			}
+			Variant.MinOffset = FIntVector(FMath::Min(Variant.MinOffset.X, Offset.X), FMath::Min(Variant.MinOffset.Y, Offset.Y), FMath::Min(Variant.MinOffset.Z, Offset.Z));
+			Variant.MaxOffset = FIntVector(FMath::Max(Variant.MaxOffset.X, Offset.X), FMath::Max(Variant.MaxOffset.Y, Offset.Y), FMath::Max(Variant.MaxOffset.Z, Offset.Z));
+		}
+	}
+	Out.bCompiled = true;
+	return Out;
+}
+
+bool FAutoPaintCompiledRule::IsMet(const FVariant& Variant, const FIntVector& QueryPosition, const FAutoPaintCodeGrid& Grid,
+	const FRandomStream& Random) const
+{
+	if (!PassesRulePrecheck(Rule, QueryPosition, Random)) return false;
+
+	const FIntVector Low = QueryPosition + Variant.MinOffset;
+	const FIntVector High = QueryPosition + Variant.MaxOffset;
+	if (Rule->OutOfBoundaryRule == "Not Applicable")
+	{
+		if (Low.X < Grid.MinBoundary.X || Low.Y < Grid.MinBoundary.Y || Low.Z < Grid.MinBoundary.Z)
+			return false;
+		if (High.X > Grid.MaxBoundary.X || High.Y > Grid.MaxBoundary.Y || High.Z > Grid.MaxBoundary.Z)
+			return false;
+	}
+	const int PaddingSize = GetOutOfBoundaryPadding(Rule);
+	const bool bCheckBoundary = ShouldUseOutOfBoundaryPadding(PaddingSize, QueryPosition, Grid.MinBoundary, Grid.MaxBoundary) &&
+		!(Grid.IsInBoundary(Low) && Grid.IsInBoundary(High));
+
+	const uint8* Cell = &Grid.Cells[Grid.GetCellIndex(QueryPosition)];
+	for (const FCondition& Condition : Variant.Conditions)
+	{
+		uint8 Code = Cell[Condition.CellOffset];
+		if (bCheckBoundary)
+		{
+			const FIntVector TestPoint = QueryPosition + Condition.Offset;
+			const bool InPadding =
+				TestPoint.X >= Grid.MinBoundary.X - PaddingSize && TestPoint.X < Grid.MaxBoundary.X + PaddingSize &&
+				TestPoint.Y >= Grid.MinBoundary.Y - PaddingSize && TestPoint.Y < Grid.MaxBoundary.Y + PaddingSize &&
+				TestPoint.Z >= Grid.MinBoundary.Z - PaddingSize && TestPoint.Z < Grid.MaxBoundary.Z + PaddingSize;
+			if (InPadding && !Grid.IsInBoundary(TestPoint))
+				Code = FAutoPaintCodeGrid::OutOfBoundaryCode;
+		}
+		if (!(Condition.MetCodes >> Code & 1))
+			return false;
+	}
+	return true;
+}
+
 UTiledItemSet* UAutoPaintRule::GetItemSet()
 {
 	if (UTiledLevelAsset* TA = Cast<UTiledLevelAsset>(GetOuter()))
@@ -368,20 +570,30 @@ TMap<UAutoPaintItemRule*, TArray<FIntVector>> UAutoPaintRule::GetMatchedPosition
 	TMap<UAutoPaintItemRule*, TArray<FIntVector>> Out;
 	for (auto Data : MatchData)
 	{
-		if (Out.Contains(Data.BaseRulePtr))
-			Out[Data.BaseRulePtr].Add(Data.MetPos);
+		UAutoPaintItemRule* BaseRule = Data.BaseRulePtr.Get();
+		if (!BaseRule) continue;
+		if (Out.Contains(BaseRule))
+			Out[BaseRule].Add(Data.MetPos);
 		else
 		{
-			Out.Add(Data.BaseRulePtr, {Data.MetPos});
+			Out.Add(BaseRule, {Data.MetPos});
 		}
 	}
 	return Out;
 }
 
+bool UAutoPaintRule::Modify(bool bAlwaysMarkDirty)
+{
+	// the rule editor always modifies this rule before changing any of its item rules
+	MarkRuleChanged();
+	return UObject::Modify(bAlwaysMarkDirty);
+}
+
 #if WITH_EDITOR
 
 void UAutoPaintRule::PostEditUndo()
 {
+	MarkRuleChanged();
 	RefreshAutoPalette_Delegate.Execute();
 	RefreshRuleEditor_Delegate.Execute();
 	RefreshSpawnedInstance_Delegate.Execute();
@@ -24,3 +24,12 @@ void AStaticTiledLevel::RevertToTiledLevel()
 	}
 }
 
+void AStaticTiledLevel::AddBakedCell(const FStaticTiledLevelCell& InCell)
+{
+	BakedCells.Add(InCell);
+}
+
+const FStaticTiledLevelCell* AStaticTiledLevel::FindBakedCell(const FStaticTiledLevelPlacementRef& Placement) const
+{
+	return BakedCells.FindByPredicate([&](const FStaticTiledLevelCell& Cell) { return Cell.Placements.Contains(Placement); });
+}
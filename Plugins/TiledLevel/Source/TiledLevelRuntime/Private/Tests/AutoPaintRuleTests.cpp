@@ -0,0 +1,106 @@
+﻿// Copyright 2022 PufStudio. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Misc/AutomationTest.h"
+#include "AutoPaintRule.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AutoPaintRuleTests
+{
+	const FName ItemNames[] = { FName("Empty"), FName("Wall"), FName("Ground"), FName("Water") };
+	const FName OutOfBoundaryRules[] = { FName("Empty"), FName("Not Applicable"), FName("Wall") };
+
+	UAutoPaintItemRule* MakeRandomRule(const FRandomStream& Random)
+	{
+		UAutoPaintItemRule* Rule = NewObject<UAutoPaintItemRule>();
+		Rule->ImpactSize = Random.RandBool()? EImpactSize::Three : EImpactSize::Five;
+		Rule->bIncludeZ = Random.RandBool();
+		Rule->OutOfBoundaryRule = OutOfBoundaryRules[Random.RandRange(0, 2)];
+		Rule->RuleDuplication = static_cast<ERuleDuplication>(Random.RandRange(0, 2));
+		Rule->StepSize = FIntVector(Random.RandRange(1, 2), 1, 1);
+		Rule->AutoPaintItemSpawns.Add(FTiledItemObj(FGuid::NewGuid()));
+		const int Reach = Rule->ImpactSize == EImpactSize::Three? 1 : 2;
+		const int NumAdjacency = Random.RandRange(0, 6);
+		for (int32 i = 0; i < NumAdjacency; i++)
+		{
+			const FIntVector Offset(Random.RandRange(-Reach, Reach), Random.RandRange(-Reach, Reach), Rule->bIncludeZ? Random.RandRange(-Reach, Reach) : 0);
+			Rule->AdjacencyRules.Add(Offset, FAdjacencyRule(ItemNames[Random.RandRange(0, 3)], Random.RandBool()));
+		}
+		return Rule;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutoPaintCompiledRuleTest, "TiledLevel.AutoPaint.CompiledRule", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FAutoPaintCompiledRuleTest::RunTest(const FString& Parameters)
+{
+	using namespace AutoPaintRuleTests;
+
+	FRandomStream Random(20461);
+	for (int32 Round = 0; Round < 20; ++Round)
+	{
+		const FIntVector MinBoundary(0, 0, Random.RandRange(-1, 0));
+		const FIntVector MaxBoundary(Random.RandRange(1, 12), Random.RandRange(1, 12), Random.RandRange(1, 3));
+		TMap<FIntVector, FName> Data;
+		// data outside of the boundary as well, like after shrinking the asset
+		for (int x = MinBoundary.X - 1; x <= MaxBoundary.X; x++)
+		{
+			for (int y = MinBoundary.Y - 1; y <= MaxBoundary.Y; y++)
+			{
+				for (int z = MinBoundary.Z; z < MaxBoundary.Z; z++)
+				{
+					if (Random.FRand() < 0.6f)
+						Data.Add(FIntVector(x, y, z), ItemNames[Random.RandRange(0, 3)]);
+				}
+			}
+		}
+
+		FAutoPaintCodeGrid Grid;
+		if (!TestTrue(TEXT("data is packed"), Grid.Init(Data, MinBoundary, MaxBoundary)))
+			return false;
+
+		// a grid covering only part of the level, like the one built for a few dirty tiles
+		const FIntVector RegionMin(Random.RandRange(MinBoundary.X, MaxBoundary.X - 1), Random.RandRange(MinBoundary.Y, MaxBoundary.Y - 1), MinBoundary.Z);
+		const FIntVector RegionMax(Random.RandRange(RegionMin.X + 1, MaxBoundary.X), Random.RandRange(RegionMin.Y + 1, MaxBoundary.Y), MaxBoundary.Z);
+		FAutoPaintCodeGrid RegionGrid;
+		if (!TestTrue(TEXT("region data is packed"), RegionGrid.Init(Data, MinBoundary, MaxBoundary, RegionMin, RegionMax)))
+			return false;
+
+		for (int32 RuleIndex = 0; RuleIndex < 10; ++RuleIndex)
+		{
+			UAutoPaintItemRule* Rule = MakeRandomRule(Random);
+			const FAutoPaintCompiledRule Compiled = FAutoPaintCompiledRule::Compile(Rule, Grid);
+			const FAutoPaintCompiledRule RegionCompiled = FAutoPaintCompiledRule::Compile(Rule, RegionGrid);
+			if (!TestTrue(TEXT("rule is compiled"), Compiled.bCompiled && RegionCompiled.bCompiled))
+				return false;
+			for (int x = MinBoundary.X; x < MaxBoundary.X; x++)
+			{
+				for (int y = MinBoundary.Y; y < MaxBoundary.Y; y++)
+				{
+					for (int z = MinBoundary.Z; z < MaxBoundary.Z; z++)
+					{
+						const FIntVector Position(x, y, z);
+						const bool bInRegion = x >= RegionMin.X && x < RegionMax.X && y >= RegionMin.Y && y < RegionMax.Y;
+						for (int32 VariantIndex = 0; VariantIndex < Compiled.Variants.Num(); VariantIndex++)
+						{
+							const FAutoPaintCompiledRule::FVariant& Variant = Compiled.Variants[VariantIndex];
+							const int32 Seed = Random.GetUnsignedInt();
+							const bool bExpected = UAutoPaintRule::IsRuleMet(Rule, Variant.DupType, Position, Data, MinBoundary, MaxBoundary, FRandomStream(Seed));
+							const bool bCompiled = Compiled.IsMet(Variant, Position, Grid, FRandomStream(Seed));
+							if (!TestEqual(FString::Printf(TEXT("round %d rule %d at %s"), Round, RuleIndex, *Position.ToString()), bCompiled, bExpected))
+								return false;
+							if (bInRegion && !TestEqual(FString::Printf(TEXT("round %d rule %d at %s in region"), Round, RuleIndex, *Position.ToString()),
+								RegionCompiled.IsMet(RegionCompiled.Variants[VariantIndex], Position, RegionGrid, FRandomStream(Seed)), bExpected))
+								return false;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,99 @@
+﻿// Copyright 2022 PufStudio. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Misc/AutomationTest.h"
+#include "TiledLevelUtility.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TiledFillBoardTests
+{
+	// plain four-way breadth first fill with the same edge rules the old recursive fill used
+	TSet<FIntPoint> ReferenceFill(const TBitArray<>& Occupied, const FIntPoint& Size, const TSet<FTiledLevelEdge>& Edges, int X, int Y)
+	{
+		TSet<FIntPoint> Filled;
+		TArray<FIntPoint> Queue;
+		Queue.Add(FIntPoint(X, Y));
+		for (int32 i = 0; i < Queue.Num(); ++i)
+		{
+			const FIntPoint P = Queue[i];
+			if (P.X < 0 || P.X >= Size.X || P.Y < 0 || P.Y >= Size.Y || Occupied[P.Y * Size.X + P.X] || Filled.Contains(P))
+				continue;
+			Filled.Add(P);
+			if (!Edges.Contains(FTiledLevelEdge(P.X + 1, P.Y, 1, EEdgeType::Vertical)))
+				Queue.Add(FIntPoint(P.X + 1, P.Y));
+			if (!Edges.Contains(FTiledLevelEdge(P.X, P.Y, 1, EEdgeType::Vertical)))
+				Queue.Add(FIntPoint(P.X - 1, P.Y));
+			if (!Edges.Contains(FTiledLevelEdge(P.X, P.Y, 1, EEdgeType::Horizontal)))
+				Queue.Add(FIntPoint(P.X, P.Y - 1));
+			if (!Edges.Contains(FTiledLevelEdge(P.X, P.Y + 1, 1, EEdgeType::Horizontal)))
+				Queue.Add(FIntPoint(P.X, P.Y + 1));
+		}
+		return Filled;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiledFillBoardTest, "TiledLevel.Utility.FillBoard", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiledFillBoardTest::RunTest(const FString& Parameters)
+{
+	using namespace TiledFillBoardTests;
+
+	FRandomStream Random(20422);
+	for (int32 Round = 0; Round < 200; ++Round)
+	{
+		const FIntPoint Size(Random.RandRange(1, 24), Random.RandRange(1, 24));
+		FTiledFillBoard Board;
+		Board.Init(Size);
+
+		TBitArray<> Occupied(false, Size.X * Size.Y);
+		for (int y = 0; y < Size.Y; y++)
+		{
+			for (int x = 0; x < Size.X; x++)
+			{
+				if (Random.FRand() < 0.2f)
+				{
+					Occupied[y * Size.X + x] = true;
+					Board.SetOccupied(x, y);
+				}
+			}
+		}
+
+		TSet<FTiledLevelEdge> Edges;
+		const int32 NumEdges = Random.RandRange(0, Size.X * Size.Y / 2);
+		for (int32 i = 0; i < NumEdges; ++i)
+		{
+			const FTiledLevelEdge Edge(Random.RandRange(0, Size.X), Random.RandRange(0, Size.Y), 1,
+				Random.RandBool() ? EEdgeType::Vertical : EEdgeType::Horizontal);
+			Edges.Add(Edge);
+			Board.AddBlockingEdge(Edge);
+		}
+
+		const int X = Random.RandRange(0, Size.X - 1);
+		const int Y = Random.RandRange(0, Size.Y - 1);
+		const TSet<FIntPoint> Expected = ReferenceFill(Occupied, Size, Edges, X, Y);
+
+		TArray<FIntPoint> Filled;
+		FTiledLevelUtility::FloodFill(Board, X, Y, Filled);
+		const FString Step = FString::Printf(TEXT("round %d"), Round);
+		if (!TestEqual(Step + TEXT(" filled count"), Filled.Num(), Expected.Num()))
+			return false;
+		for (const FIntPoint& P : Filled)
+		{
+			if (!TestTrue(Step + TEXT(" filled cell is reachable"), Expected.Contains(P)) ||
+				!TestTrue(Step + TEXT(" filled cell is marked occupied"), Board.IsOccupied(P.X, P.Y)))
+				return false;
+		}
+	}
+
+	// large boards used to overflow the stack with the recursive fill
+	FTiledFillBoard Large;
+	Large.Init(FIntPoint(512, 512));
+	TArray<FIntPoint> Filled;
+	FTiledLevelUtility::FloodFill(Large, 256, 256, Filled);
+	TestEqual(TEXT("large board is completely filled"), Filled.Num(), 512 * 512);
+
+	return true;
+}
+
+#endif
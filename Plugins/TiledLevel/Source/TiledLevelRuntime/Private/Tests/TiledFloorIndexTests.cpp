@@ -0,0 +1,162 @@
+﻿// Copyright 2022 PufStudio. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+#include "UObject/StrongObjectPtr.h"
+#include "TiledLevelAsset.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TiledFloorIndexTests
+{
+	bool Occupies(const FTilePlacement& Tile, const TSet<FIntVector>& Cells)
+	{
+		for (const FIntVector& Position : Tile.GetOccupiedTilePositions())
+		{
+			if (Cells.Contains(Position))
+				return true;
+		}
+		return false;
+	}
+
+	template <typename T>
+	bool HaveSameElements(TArray<T> A, TArray<T> B)
+	{
+		if (A.Num() != B.Num())
+			return false;
+		for (const T& Element : A)
+		{
+			const int32 Found = B.Find(Element);
+			if (Found == INDEX_NONE)
+				return false;
+			B.RemoveAtSwap(Found);
+		}
+		return true;
+	}
+
+	FTilePlacement MakeTile(const FIntVector& GridPosition, const FGuid& ItemID = FGuid())
+	{
+		FTilePlacement Tile;
+		Tile.GridPosition = GridPosition;
+		Tile.Extent = FIntVector(1, 1, 1);
+		Tile.ItemID = ItemID;
+		return Tile;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiledFloorIndexTest, "TiledLevel.Asset.FloorIndex", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiledFloorIndexTest::RunTest(const FString& Parameters)
+{
+	using namespace TiledFloorIndexTests;
+
+	FTiledFloor Floor(0);
+	FRandomStream Random(20431);
+
+	for (int32 Round = 0; Round < 100; ++Round)
+	{
+		const FString Step = FString::Printf(TEXT("round %d"), Round);
+		const int32 NumToAdd = Random.RandRange(0, 30);
+		for (int32 i = 0; i < NumToAdd; ++i)
+		{
+			FTilePlacement Tile;
+			Tile.GridPosition = FIntVector(Random.RandRange(0, 20), Random.RandRange(0, 20), 0);
+			Tile.Extent = FIntVector(Random.RandRange(1, 3), Random.RandRange(1, 3), 1);
+			Floor.AddPlacement(Tile, Random.RandBool()? EPlacedType::Block : EPlacedType::Floor);
+
+			FPointPlacement Point;
+			Point.GridPosition = FIntVector(Random.RandRange(0, 20), Random.RandRange(0, 20), 0);
+			Floor.AddPlacement(Point, Random.RandBool()? EPlacedType::Pillar : EPlacedType::Point);
+		}
+
+		// placements changed behind the index's back are picked up as well
+		if (Random.RandBool())
+		{
+			FTilePlacement Tile;
+			Tile.GridPosition = FIntVector(Random.RandRange(0, 20), Random.RandRange(0, 20), 0);
+			Floor.BlockPlacements.Add(Tile);
+		}
+
+		TSet<FIntVector> Cells;
+		TSet<FIntVector> Points;
+		const FIntVector Min(Random.RandRange(0, 20), Random.RandRange(0, 20), 0);
+		const FIntVector Size(Random.RandRange(1, 6), Random.RandRange(1, 6), 1);
+		for (int x = 0; x < Size.X; x++)
+		{
+			for (int y = 0; y < Size.Y; y++)
+			{
+				Cells.Add(Min + FIntVector(x, y, 0));
+				Points.Add(Min + FIntVector(x, y, 0));
+			}
+		}
+
+		TArray<FTilePlacement> ExpectedBlocks = Floor.BlockPlacements.FilterByPredicate([&](const FTilePlacement& P) { return !Occupies(P, Cells); });
+		TArray<FTilePlacement> ExpectedFloors = Floor.FloorPlacements.FilterByPredicate([&](const FTilePlacement& P) { return !Occupies(P, Cells); });
+		TArray<FPointPlacement> ExpectedPillars = Floor.PillarPlacements.FilterByPredicate([&](const FPointPlacement& P) { return !Points.Contains(P.GridPosition); });
+		TArray<FPointPlacement> ExpectedPoints = Floor.PointPlacements.FilterByPredicate([&](const FPointPlacement& P) { return !Points.Contains(P.GridPosition); });
+
+		Floor.EmptyRegion(Cells, TArray<FTiledLevelEdge>(), Points);
+		if (!TestTrue(Step + TEXT(" blocks left after region erase"), HaveSameElements(Floor.BlockPlacements, ExpectedBlocks)) ||
+			!TestTrue(Step + TEXT(" floors left after region erase"), HaveSameElements(Floor.FloorPlacements, ExpectedFloors)) ||
+			!TestTrue(Step + TEXT(" pillars left after region erase"), HaveSameElements(Floor.PillarPlacements, ExpectedPillars)) ||
+			!TestTrue(Step + TEXT(" points left after region erase"), HaveSameElements(Floor.PointPlacements, ExpectedPoints)))
+			return false;
+
+		// remove a few specific placements
+		TArray<FTilePlacement> TilesToDelete;
+		for (const FTilePlacement& P : Floor.FloorPlacements)
+		{
+			if (Random.FRand() < 0.2f)
+				TilesToDelete.Add(P);
+		}
+		ExpectedFloors = Floor.FloorPlacements.FilterByPredicate([&](const FTilePlacement& P) { return !TilesToDelete.Contains(P); });
+		ExpectedBlocks = Floor.BlockPlacements.FilterByPredicate([&](const FTilePlacement& P) { return !TilesToDelete.Contains(P); });
+		Floor.RemovePlacements(TilesToDelete);
+		if (!TestTrue(Step + TEXT(" blocks left after removal"), HaveSameElements(Floor.BlockPlacements, ExpectedBlocks)) ||
+			!TestTrue(Step + TEXT(" floors left after removal"), HaveSameElements(Floor.FloorPlacements, ExpectedFloors)))
+			return false;
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiledFloorIndexDirtyTest, "TiledLevel.Asset.FloorIndexDirty", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiledFloorIndexDirtyTest::RunTest(const FString& Parameters)
+{
+	using namespace TiledFloorIndexTests;
+
+	TStrongObjectPtr<UTiledLevelAsset> Asset(NewObject<UTiledLevelAsset>(GetTransientPackage()));
+	Asset->TiledFloors.Add(FTiledFloor(0));
+	FTiledFloor& Floor = Asset->TiledFloors[0];
+
+	const FGuid ClearedID = FGuid::NewGuid();
+	const FTilePlacement Cleared = MakeTile(FIntVector(0, 0, 0), ClearedID);
+	const FTilePlacement Kept = MakeTile(FIntVector(2, 2, 0));
+	Floor.AddPlacement(Cleared, EPlacedType::Block);
+	Floor.AddPlacement(Kept, EPlacedType::Block);
+	// builds the index
+	Floor.EmptyRegion(TSet<FIntVector>(), TArray<FTiledLevelEdge>(), TSet<FIntVector>());
+
+	// clearing one placement directly and adding another one keeps the number of placements
+	Asset->ClearItem(ClearedID);
+	const FTilePlacement Added = MakeTile(FIntVector(4, 4, 0));
+	Floor.AddPlacement(Added, EPlacedType::Block);
+	Floor.EmptyRegion({ FIntVector(4, 4, 0) }, TArray<FTiledLevelEdge>(), TSet<FIntVector>());
+	TestFalse(TEXT("Placement added after clearing an item is erased"), Floor.BlockPlacements.Contains(Added));
+	TestTrue(TEXT("Placement outside the erased region is kept"), Floor.BlockPlacements.Contains(Kept));
+
+	// moving a placement in place keeps the number of placements as well
+	const int32 KeptIndex = Floor.BlockPlacements.Find(Kept);
+	if (!TestNotEqual(TEXT("Kept placement index"), KeptIndex, INDEX_NONE))
+		return false;
+	Floor.BlockPlacements[KeptIndex].GridPosition = FIntVector(6, 6, 0);
+	Floor.MarkIndexDirty();
+	Floor.EmptyRegion({ FIntVector(6, 6, 0) }, TArray<FTiledLevelEdge>(), TSet<FIntVector>());
+	TestEqual(TEXT("Placement moved in place is erased at its new position"), Floor.BlockPlacements.Num(), 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,182 @@
+﻿// Copyright 2022 PufStudio. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Misc/AutomationTest.h"
+#include "Algo/Unique.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "UObject/StrongObjectPtr.h"
+#include "TiledLevelTypes.h"
+#include "TiledLevelUtility.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TiledInstanceIndexTests
+{
+	TArray<float> MakeCustomData(const FTiledInstanceKey& Key)
+	{
+		return {
+			static_cast<float>(Key.Position.X), static_cast<float>(Key.Position.Y), static_cast<float>(Key.Position.Z),
+			static_cast<float>(Key.Extent.X), static_cast<float>(Key.Extent.Y), static_cast<float>(Key.Extent.Z)
+		};
+	}
+
+	// same order as ATiledLevel::RemoveInstances: sort, dedupe, index first, then the component
+	void RemoveInstances(FTiledInstanceIndex& Index, UHierarchicalInstancedStaticMeshComponent* HISM, TArray<int32> Indices)
+	{
+		Indices.Sort();
+		Indices.SetNum(Algo::Unique(Indices));
+		Index.RemoveInstances(HISM, Indices);
+		HISM->RemoveInstances(Indices);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiledInstanceIndexTest, "TiledLevel.Types.InstanceIndex", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiledInstanceIndexTest::RunTest(const FString& Parameters)
+{
+	using namespace TiledInstanceIndexTests;
+
+	TStrongObjectPtr<UHierarchicalInstancedStaticMeshComponent> HISM(NewObject<UHierarchicalInstancedStaticMeshComponent>(GetTransientPackage()));
+	HISM->NumCustomDataFloats = 6;
+	HISM->bAutoRebuildTreeOnInstanceChanges = false;
+
+	FTiledInstanceIndex Index;
+	TArray<FTiledInstanceKey> LiveKeys;
+	TSet<FTiledInstanceKey> RemovedKeys;
+	FRandomStream Random(20221);
+
+	auto VerifyIndex = [&](FTiledInstanceIndex& InIndex, const FString& Step)
+	{
+		TestEqual(Step + TEXT(" instance count"), HISM->GetInstanceCount(), LiveKeys.Num());
+		for (const FTiledInstanceKey& Key : LiveKeys)
+		{
+			const int32 Found = InIndex.FindInstance(HISM.Get(), Key);
+			if (!TestTrue(Step + TEXT(" live key is found"), HISM->IsValidInstance(Found)))
+				return;
+			const FTiledInstanceKey Actual(&HISM->PerInstanceSMCustomData[Found * 6]);
+			if (!TestTrue(Step + TEXT(" found instance holds the key"), Actual == Key))
+				return;
+		}
+		for (const FTiledInstanceKey& Key : RemovedKeys)
+		{
+			if (!TestEqual(Step + TEXT(" removed key is not found"), InIndex.FindInstance(HISM.Get(), Key), INDEX_NONE))
+				return;
+		}
+	};
+
+	for (int32 Round = 0; Round < 100; ++Round)
+	{
+		const int32 NumToAdd = Random.RandRange(0, 40);
+		for (int32 i = 0; i < NumToAdd; ++i)
+		{
+			const FTiledInstanceKey Key(
+				FIntVector(Random.RandRange(-32, 32), Random.RandRange(-32, 32), Random.RandRange(0, 4)),
+				FIntVector(Random.RandRange(1, 3), Random.RandRange(1, 3), Random.RandRange(-1, 2)));
+			if (LiveKeys.Contains(Key))
+				continue;
+			const int32 NewIndex = HISM->AddInstance(FTransform(FVector(Key.Position)));
+			HISM->SetCustomData(NewIndex, MakeCustomData(Key));
+			Index.AddInstance(HISM.Get(), NewIndex, Key);
+			LiveKeys.Add(Key);
+			RemovedKeys.Remove(Key);
+		}
+
+		// remove a random batch, with duplicated indices like overlapping erase regions produce
+		TArray<int32> ToRemove;
+		const int32 NumToRemove = FMath::Min(Random.RandRange(0, 30), LiveKeys.Num());
+		for (int32 i = 0; i < NumToRemove; ++i)
+		{
+			const FTiledInstanceKey& Key = LiveKeys[Random.RandRange(0, LiveKeys.Num() - 1)];
+			const int32 Found = Index.FindInstance(HISM.Get(), Key);
+			if (Found != INDEX_NONE)
+				ToRemove.Add(Found);
+		}
+		TArray<int32> UniqueToRemove = ToRemove;
+		UniqueToRemove.Sort();
+		UniqueToRemove.SetNum(Algo::Unique(UniqueToRemove));
+		for (int32 InstanceIndex : UniqueToRemove)
+		{
+			const FTiledInstanceKey Key(&HISM->PerInstanceSMCustomData[InstanceIndex * 6]);
+			LiveKeys.Remove(Key);
+			RemovedKeys.Add(Key);
+		}
+		RemoveInstances(Index, HISM.Get(), ToRemove);
+
+		VerifyIndex(Index, FString::Printf(TEXT("Round %d:"), Round));
+		TestEqual(TEXT("Index size matches the component"), Index.Num(HISM.Get()), HISM->GetInstanceCount());
+	}
+
+	// an index that never saw the instances being added rebuilds itself from the custom data
+	{
+		FTiledInstanceIndex FreshIndex;
+		VerifyIndex(FreshIndex, TEXT("Rebuilt:"));
+	}
+
+	// dropping the component forgets everything about it
+	{
+		Index.RemoveComponent(HISM.Get());
+		TestEqual(TEXT("Removed component has no indexed instance"), Index.Num(HISM.Get()), 0);
+		VerifyIndex(Index, TEXT("After RemoveComponent:"));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTiledInstanceIndexDuplicateTest, "TiledLevel.Types.InstanceIndexDuplicates", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FTiledInstanceIndexDuplicateTest::RunTest(const FString& Parameters)
+{
+	using namespace TiledInstanceIndexTests;
+
+	TStrongObjectPtr<UHierarchicalInstancedStaticMeshComponent> HISM(NewObject<UHierarchicalInstancedStaticMeshComponent>(GetTransientPackage()));
+	HISM->NumCustomDataFloats = 6;
+	HISM->bAutoRebuildTreeOnInstanceChanges = false;
+
+	FTiledInstanceIndex Index;
+	auto AddInstance = [&](const FTiledInstanceKey& Key, float Yaw)
+	{
+		const int32 NewIndex = HISM->AddInstance(FTransform(FRotator(0, Yaw, 0), FVector(Key.Position)));
+		HISM->SetCustomData(NewIndex, MakeCustomData(Key));
+		Index.AddInstance(HISM.Get(), NewIndex, Key);
+	};
+
+	// same mesh at the same position and extent, only the rotation differs
+	const FTiledInstanceKey Shared(FIntVector(2, 3, 0), FIntVector(1, 1, 1));
+	const FTiledInstanceKey Other(FIntVector(5, 5, 0), FIntVector(1, 1, 1));
+	AddInstance(Shared, 0.f);
+	AddInstance(Other, 0.f);
+	AddInstance(Shared, 90.f);
+	AddInstance(Shared, 180.f);
+	TestEqual(TEXT("Every instance of a shared key is indexed"), Index.FindInstances(HISM.Get(), Shared).Num(), 3);
+	TestEqual(TEXT("Index size counts shared keys"), Index.Num(HISM.Get()), 4);
+
+	// erasing two of the placements removes two distinct instances
+	TArray<int32> Found;
+	FTiledLevelUtility::FindInstanceIndexByPlacement(Found, Index, HISM.Get(), Shared);
+	FTiledLevelUtility::FindInstanceIndexByPlacement(Found, Index, HISM.Get(), Shared);
+	TestEqual(TEXT("Two placements find two instances"), Found.Num(), 2);
+	if (Found.Num() == 2)
+		TestNotEqual(TEXT("Two placements find distinct instances"), Found[0], Found[1]);
+	RemoveInstances(Index, HISM.Get(), Found);
+	TestEqual(TEXT("Instances left after erasing two shared placements"), HISM->GetInstanceCount(), 2);
+	TestEqual(TEXT("One shared instance is left"), Index.FindInstances(HISM.Get(), Shared).Num(), 1);
+	TestEqual(TEXT("The other key is still found"), Index.FindInstances(HISM.Get(), Other).Num(), 1);
+	for (const FTiledInstanceKey& Key : { Shared, Other })
+	{
+		const int32 InstanceIndex = Index.FindInstance(HISM.Get(), Key);
+		if (TestTrue(TEXT("Left instance is valid"), HISM->IsValidInstance(InstanceIndex)))
+			TestTrue(TEXT("Left instance holds its key"), FTiledInstanceKey(&HISM->PerInstanceSMCustomData[InstanceIndex * 6]) == Key);
+	}
+
+	// a removal followed by an addition behind the index's back keeps the instance count
+	const FTiledInstanceKey Replacement(FIntVector(9, 9, 1), FIntVector(2, 2, 1));
+	HISM->RemoveInstance(Index.FindInstance(HISM.Get(), Other));
+	HISM->SetCustomData(HISM->AddInstance(FTransform(FVector(Replacement.Position))), MakeCustomData(Replacement));
+	Index.MarkStale(HISM.Get());
+	TestEqual(TEXT("Stale index forgets the replaced key"), Index.FindInstance(HISM.Get(), Other), INDEX_NONE);
+	TestTrue(TEXT("Stale index finds the new key"), HISM->IsValidInstance(Index.FindInstance(HISM.Get(), Replacement)));
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -24,6 +24,7 @@ void UTiledItemSet::AddNewItem(UStaticMesh* TiledMesh, const EPlacedType& Placed
 	NewItem->bAutoPlacement = DefaultAutoPlacement;
 	NewItem->PivotPosition = GetDefaultPivotPosition(PlacedType);
 	ItemSet.Add(NewItem);
+	MarkItemIndexDirty();
 }
 
 void UTiledItemSet::AddNewItem(UObject* NewActorObject, const EPlacedType& PlacedType, const ETLStructureType& StructureType,
@@ -39,6 +40,7 @@ void UTiledItemSet::AddNewItem(UObject* NewActorObject, const EPlacedType& Place
 	NewItem->bAutoPlacement = DefaultAutoPlacement;
 	NewItem->PivotPosition = GetDefaultPivotPosition(PlacedType);
 	ItemSet.Add(NewItem);
+	MarkItemIndexDirty();
 }
 
 void UTiledItemSet::AddSpecialItem_Restriction()
@@ -53,6 +55,7 @@ void UTiledItemSet::AddSpecialItem_Restriction()
 	NewItem->bAutoPlacement = false;
 	NewItem->PivotPosition = EPivotPosition::Center;
 	ItemSet.Add(NewItem);
+	MarkItemIndexDirty();
 }
 
 void UTiledItemSet::AddSpecialItem_Template()
@@ -66,6 +69,7 @@ void UTiledItemSet::AddSpecialItem_Template()
 	NewItem->bAutoPlacement = false;
 	NewItem->PivotPosition = EPivotPosition::Corner;
 	ItemSet.Add(NewItem);
+	MarkItemIndexDirty();
 }
 
 void UTiledItemSet::RemoveItem(UTiledLevelItem* ItemPtr)
@@ -78,16 +82,38 @@ void UTiledItemSet::RemoveItem(UTiledLevelItem* ItemPtr)
 	// 	Asset->VersionNumber += 100;
 	// }
 	ItemSet.Remove(ItemPtr);
+	MarkItemIndexDirty();
 }
 
 UTiledLevelItem* UTiledItemSet::GetItem(const FGuid& ItemID) const
 {
+	UpdateItemIndex();
+	return ItemIndex.FindRef(ItemID);
+}
+
+uint32 UTiledItemSet::GetItemIndexRevision() const
+{
+	UpdateItemIndex();
+	return ItemIndexRevision;
+}
+
+void UTiledItemSet::UpdateItemIndex() const
+{
+	// shared by all item sets, so a revision never matches a placement's cached item from another item set
+	static uint32 NextItemIndexRevision = 0;
+
+	if (!bItemIndexDirty) return;
+	ItemIndex.Reset();
 	for (UTiledLevelItem* I : ItemSet)
 	{
-		if (I)
-			if (I->ItemID == ItemID) return I;
+		// keep the first item if ids are duplicated, same as the linear search used to
+		if (I && !ItemIndex.Contains(I->ItemID))
+			ItemIndex.Add(I->ItemID, I);
 	}
-	return nullptr;
+	// 0 is never used, so that default constructed placements always look up their item
+	if (++NextItemIndexRevision == 0) ++NextItemIndexRevision;
+	ItemIndexRevision = NextItemIndexRevision;
+	bItemIndexDirty = false;
 }
 
 TSet<UStaticMesh*> UTiledItemSet::GetAllItemMeshes() const
@@ -120,6 +146,12 @@ void UTiledItemSet::GetAssetRegistryTags(TArray<FAssetRegistryTag>& AssetRegistr
 	UObject::GetAssetRegistryTags(AssetRegistryTags);
 }
 
+void UTiledItemSet::PostLoad()
+{
+	Super::PostLoad();
+	MarkItemIndexDirty();
+}
+
 #if WITH_EDITOR
 
 void UTiledItemSet::InitializeData()
@@ -153,6 +185,8 @@ void UTiledItemSet::InitializeData()
 
 void UTiledItemSet::PostEditUndo()
 {
+	// undo can bring back removed items or remove added ones
+	MarkItemIndexDirty();
 	ItemSetPostUndo.Broadcast();
 	UObject::PostEditUndo();
 }
@@ -16,9 +16,95 @@
 #include "UObject/ObjectSaveContext.h"
 #include "Engine/Blueprint.h"
 #include "Engine/World.h"
+#include "Algo/Unique.h"
 
 #define LOCTEXT_NAMESPACE "TiledLevel"
 
+namespace
+{
+	struct FInstanceToRender
+	{
+		FTiledInstanceKey Key;
+		FTransform Transform;
+		TArray<float> CustomData;
+	};
+
+	struct FActorToRender
+	{
+		TArray<FName> Tags;
+		FTransform Transform;
+		// class of an actor item, mesh of a mirrored placement
+		const UObject* Source = nullptr;
+		bool bMirrored = false;
+		TFunction<void()> Spawn;
+	};
+
+	struct FRenderSyncState
+	{
+		TMap<UStaticMesh*, TArray<FInstanceToRender>> Instances;
+		TMap<UStaticMesh*, UTiledLevelItem*> MeshItems;
+		TArray<FActorToRender> Actors;
+		TArray<TFunction<void()>> RestrictionSpawns;
+	};
+
+	// instance transforms are stored in single precision
+	constexpr float RenderedTransformTolerance = 0.01f;
+
+	const UObject* GetRenderedActorSource(const AActor* Actor, bool bMirrored)
+	{
+		if (!bMirrored)
+			return Actor->GetClass();
+		if (const AStaticMeshActor* MeshActor = Cast<AStaticMeshActor>(Actor))
+			return MeshActor->GetStaticMeshComponent()->GetStaticMesh();
+		return nullptr;
+	}
+
+	bool HasInstanceCustomData(const UHierarchicalInstancedStaticMeshComponent* HISM, int32 InstanceIndex, const TArray<float>& CustomData)
+	{
+		const int32 Start = InstanceIndex * HISM->NumCustomDataFloats;
+		if (CustomData.Num() != HISM->NumCustomDataFloats || Start + CustomData.Num() > HISM->PerInstanceSMCustomData.Num())
+			return false;
+		return FMemory::Memcmp(&HISM->PerInstanceSMCustomData[Start], CustomData.GetData(), CustomData.Num() * sizeof(float)) == 0;
+	}
+
+	template <typename T>
+	void GatherPlacementToRender(ATiledLevel* Level, const T& P, bool bIgnoreCustomData, FRenderSyncState& State)
+	{
+		UTiledLevelItem* Item = P.GetItem();
+		if (!Item) return;
+		if (Item->IsA<UTiledLevelRestrictionItem>())
+		{
+			State.RestrictionSpawns.Add([Level, &P, bIgnoreCustomData]() { Level->PopulateSinglePlacement(P, bIgnoreCustomData); });
+		}
+		else if (Item->SourceType == ETLSourceType::Actor || P.IsMirrored)
+		{
+			const UObject* Source = Item->TiledMesh;
+			if (Item->SourceType == ETLSourceType::Actor)
+			{
+				if (!IsValid(Item->TiledActor)) return;
+				const UBlueprint* Blueprint = Cast<UBlueprint>(Item->TiledActor);
+				Source = Blueprint? Blueprint->GeneratedClass.Get() : nullptr;
+			}
+			FActorToRender& Actor = State.Actors.AddDefaulted_GetRef();
+			Actor.Tags = FTiledLevelUtility::GetSpawnedActorTags(P);
+			Actor.Transform = P.TileObjectTransform;
+			Actor.Source = Source;
+			Actor.bMirrored = Item->SourceType != ETLSourceType::Actor;
+			Actor.Spawn = [Level, &P, bIgnoreCustomData]() { Level->PopulateSinglePlacement(P, bIgnoreCustomData); };
+		}
+		else
+		{
+			if (!Item->TiledMesh) return;
+			State.MeshItems.FindOrAdd(Item->TiledMesh, Item);
+			FInstanceToRender& Instance = State.Instances.FindOrAdd(Item->TiledMesh).AddDefaulted_GetRef();
+			Instance.Key = FTiledInstanceKey(P);
+			Instance.Transform = P.TileObjectTransform;
+			if (!bIgnoreCustomData && !GetMutableDefault<UTiledLevelSettings>()->bBlockAddCustomData)
+				Instance.CustomData = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(P);
+		}
+	}
+}
+
 // Sets default values
 ATiledLevel::ATiledLevel()
 {
@@ -95,6 +181,12 @@ void ATiledLevel::PostDuplicate(bool bDuplicateForPIE)
 	Super::PostDuplicate(bDuplicateForPIE);
 }
 
+void ATiledLevel::PostEditUndo()
+{
+	InstanceIndex.Reset();
+	Super::PostEditUndo();
+}
+
 void ATiledLevel::PostInitProperties()
 {
 	Super::PostInitProperties();
@@ -153,7 +245,8 @@ void ATiledLevel::RemoveAsset()
 	}
 	SpawnedTiledActors.Empty();
 	TiledObjectSpawner.Empty();
-    
+	InstanceIndex.Reset();
+
 }
 
 void ATiledLevel::RemoveInstances(const TMap<UStaticMesh*, TArray<int32>>& TargetInstancesData)
@@ -162,13 +255,20 @@ void ATiledLevel::RemoveInstances(const TMap<UStaticMesh*, TArray<int32>>& Targe
 	TArray<UStaticMesh*> KeysToDelete;
 	for (auto& elem : TargetInstancesData)
 	{
-		TiledObjectSpawner[elem.Key]->RemoveInstances(elem.Value);
+		UHierarchicalInstancedStaticMeshComponent* HISM = TiledObjectSpawner[elem.Key];
+		// the same placement may be requested more than once, HISM can not remove an index twice
+		TArray<int32> Indices = elem.Value;
+		Indices.Sort();
+		Indices.SetNum(Algo::Unique(Indices));
+		InstanceIndex.RemoveInstances(HISM, Indices);
+		HISM->RemoveInstances(Indices);
 		
-		if (TiledObjectSpawner[elem.Key]->GetInstanceCount() == 0)
+		if (HISM->GetInstanceCount() == 0)
 		 	KeysToDelete.Add(elem.Key);
 	}
 	for (const UStaticMesh* MeshPtr : KeysToDelete)
 	{
+		InstanceIndex.RemoveComponent(TiledObjectSpawner[MeshPtr]);
 		TiledObjectSpawner[MeshPtr]->DestroyComponent();
 		TiledObjectSpawner.Remove(MeshPtr);
 	}
@@ -303,8 +403,7 @@ int ATiledLevel::EraseItem(FIntVector Pos, FIntVector Extent, bool bIsFloor, boo
 			 UStaticMesh* TiledMesh = Placement.GetItem()->TiledMesh;
 			 if (!TargetInstanceData.Contains(TiledMesh))				
 				  TargetInstanceData.Add(TiledMesh, TArray<int32>{});
-			 TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-			 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh], TiledObjectSpawner[TiledMesh]->PerInstanceSMCustomData, TargetInfo);
+			 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh], InstanceIndex, TiledObjectSpawner[TiledMesh], FTiledInstanceKey(Placement));
 		}
 	}
 	ActiveAsset->RemovePlacements(TilesToDelete);
@@ -346,8 +445,7 @@ int ATiledLevel::EraseItem(FTiledLevelEdge Edge, FIntVector Extent, bool bIsEdge
 		{
 			 if (!TargetInstanceData.Contains(Item->TiledMesh))				
 				  TargetInstanceData.Add(Item->TiledMesh, TArray<int32>{});
-			 TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-			 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[Item->TiledMesh],TiledObjectSpawner[Item->TiledMesh]->PerInstanceSMCustomData, TargetInfo);
+			 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[Item->TiledMesh], InstanceIndex, TiledObjectSpawner[Item->TiledMesh], FTiledInstanceKey(Placement));
 		}
 	}
 	ActiveAsset->RemovePlacements(EdgesToDelete);
@@ -392,8 +490,7 @@ int ATiledLevel::EraseItem(FIntVector Pos, int ZExtent, bool bIsPoint, bool Both
 			 UStaticMesh* TiledMesh = Placement.GetItem()->TiledMesh;
 			 if (!TargetInstanceData.Contains(TiledMesh))				
 				  TargetInstanceData.Add(TiledMesh, TArray<int32>{});
-			 TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-			 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh],TiledObjectSpawner[TiledMesh]->PerInstanceSMCustomData, TargetInfo);
+			 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh], InstanceIndex, TiledObjectSpawner[TiledMesh], FTiledInstanceKey(Placement));
 		}
 	}
 	ActiveAsset->RemovePlacements(PointsToDelete);
@@ -432,8 +529,7 @@ int ATiledLevel::EraseItem_Any(FIntVector Pos, FIntVector Extent)
 			 UStaticMesh* TiledMesh = Placement.GetItem()->TiledMesh;
 			 if (!TargetInstanceData.Contains(TiledMesh))				
 				  TargetInstanceData.Add(TiledMesh, TArray<int32>{});
-			 TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-			 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh],TiledObjectSpawner[TiledMesh]->PerInstanceSMCustomData, TargetInfo);
+			 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh], InstanceIndex, TiledObjectSpawner[TiledMesh], FTiledInstanceKey(Placement));
 		}
 		TileToDelete.Add(Placement);
 	}
@@ -451,8 +547,7 @@ int ATiledLevel::EraseItem_Any(FIntVector Pos, FIntVector Extent)
 		{
 			  if (!TargetInstanceData.Contains(Item->TiledMesh))				
 				  TargetInstanceData.Add(Item->TiledMesh, TArray<int32>{});
-			  TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-			  FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[Item->TiledMesh],TiledObjectSpawner[Item->TiledMesh]->PerInstanceSMCustomData, TargetInfo);
+			  FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[Item->TiledMesh], InstanceIndex, TiledObjectSpawner[Item->TiledMesh], FTiledInstanceKey(Placement));
 		}
 		WallToDelete.Add(Placement);
 	}
@@ -470,8 +565,7 @@ int ATiledLevel::EraseItem_Any(FIntVector Pos, FIntVector Extent)
 			 UStaticMesh* TiledMesh = Placement.GetItem()->TiledMesh;
 			 if (!TargetInstanceData.Contains(TiledMesh))				
 				  TargetInstanceData.Add(TiledMesh, TArray<int32>{});
-			 TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-			 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh],TiledObjectSpawner[TiledMesh]->PerInstanceSMCustomData, TargetInfo);
+			 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh], InstanceIndex, TiledObjectSpawner[TiledMesh], FTiledInstanceKey(Placement));
 		}
 		PointToDelete.Add(Placement);
 	}
@@ -514,8 +608,7 @@ int ATiledLevel::EraseSingleItem(FIntVector Pos, FIntVector Extent, FGuid Target
 				 // find placement instance ID, and its mesh
 				 if (!TargetInstanceData.Contains(Item->TiledMesh))				
 					  TargetInstanceData.Add(Item->TiledMesh, TArray<int32>{});
-				 TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-				 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[Item->TiledMesh],TiledObjectSpawner[Item->TiledMesh]->PerInstanceSMCustomData, TargetInfo);
+				 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[Item->TiledMesh], InstanceIndex, TiledObjectSpawner[Item->TiledMesh], FTiledInstanceKey(Placement));
 			}
 			TilesToDelete.Add(Placement);
 		}
@@ -552,8 +645,7 @@ int ATiledLevel::EraseSingleItem(FTiledLevelEdge Edge, FIntVector Extent, FGuid
 			{
 				 if (!TargetInstanceData.Contains(Item->TiledMesh))				
 					  TargetInstanceData.Add(Item->TiledMesh, TArray<int32>{});
-				 TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-				 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[Item->TiledMesh],TiledObjectSpawner[Item->TiledMesh]->PerInstanceSMCustomData, TargetInfo);
+				 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[Item->TiledMesh], InstanceIndex, TiledObjectSpawner[Item->TiledMesh], FTiledInstanceKey(Placement));
 			}
 			WallsToDelete.Add(Placement);
 		}
@@ -595,8 +687,7 @@ int ATiledLevel::EraseSingleItem(FIntVector Pos, int ZExtent, FGuid TargetID)
 				 // find placement instance ID, and its mesh
 				 if (!TargetInstanceData.Contains(Item->TiledMesh))				
 					  TargetInstanceData.Add(Item->TiledMesh, TArray<int32>{});
-				 TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-				 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[Item->TiledMesh],TiledObjectSpawner[Item->TiledMesh]->PerInstanceSMCustomData, TargetInfo);
+				 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[Item->TiledMesh], InstanceIndex, TiledObjectSpawner[Item->TiledMesh], FTiledInstanceKey(Placement));
 			}
 			PointsToDelete.Add(Placement);
 		}
@@ -616,111 +707,228 @@ void ATiledLevel::ResetAllInstance(bool IgnoreVersion, bool bIgnoreCustomData)
 	}
 
 	VersionNumber = ActiveAsset->VersionNumber;
-	for (AActor* SpawnedActor : SpawnedTiledActors)
-	{
-		if (SpawnedActor)
-			SpawnedActor->Destroy();
-	}
-	SpawnedTiledActors.Empty();
-	
-	for (auto& elem : TiledObjectSpawner)
-	{
-		if (elem.Value)
-		{
-			elem.Value->ClearInstances();
-		}
-	}
-
-	TiledObjectSpawner.Empty();
 	ActiveAsset->ClearInvalidPlacements();
 
-	for (FTiledFloor& F : ActiveAsset->TiledFloors)
+	FPlacementsToRender ToRender;
+	for (const FTiledFloor& F : ActiveAsset->TiledFloors)
 	{
 		if (!F.ShouldRenderInEditor) continue;
 		if (ActiveAsset->ViewAsAutoPaint)
 		{
 			for (const FTilePlacement& P : F.AutoPaintGenTiles)
-				PopulateSinglePlacement(P, bIgnoreCustomData);
+				ToRender.Tiles.Add(&P);
 			for (const FEdgePlacement& P : F.AutoPaintGenEdges)
-				PopulateSinglePlacement(P, bIgnoreCustomData);
+				ToRender.Edges.Add(&P);
 			for (const FPointPlacement& P : F.AutoPaintGenPoints)
-				PopulateSinglePlacement(P, bIgnoreCustomData);
+				ToRender.Points.Add(&P);
 		}
 		else
 		{
-			for (FTilePlacement& Placement : F.BlockPlacements)
-				PopulateSinglePlacement(Placement, bIgnoreCustomData);
-			for (FTilePlacement& Placement : F.FloorPlacements)
-				PopulateSinglePlacement(Placement, bIgnoreCustomData);
-			for (FPointPlacement& Placement : F.PillarPlacements)
-				PopulateSinglePlacement(Placement, bIgnoreCustomData);
-			for (FEdgePlacement& Placement : F.WallPlacements)
-				PopulateSinglePlacement(Placement, bIgnoreCustomData);
-			for (FEdgePlacement& Placement : F.EdgePlacements)
-				PopulateSinglePlacement(Placement, bIgnoreCustomData);
-			for (FPointPlacement& Placement : F.PointPlacements)
-				PopulateSinglePlacement(Placement, bIgnoreCustomData);
+			for (const FTilePlacement& Placement : F.BlockPlacements)
+				ToRender.Tiles.Add(&Placement);
+			for (const FTilePlacement& Placement : F.FloorPlacements)
+				ToRender.Tiles.Add(&Placement);
+			for (const FPointPlacement& Placement : F.PillarPlacements)
+				ToRender.Points.Add(&Placement);
+			for (const FEdgePlacement& Placement : F.WallPlacements)
+				ToRender.Edges.Add(&Placement);
+			for (const FEdgePlacement& Placement : F.EdgePlacements)
+				ToRender.Edges.Add(&Placement);
+			for (const FPointPlacement& Placement : F.PointPlacements)
+				ToRender.Points.Add(&Placement);
 		}
 	}
- 
-	for (AActor* Actor : SpawnedTiledActors)
-	{
-		Actor->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
-	}
+	SyncRenderedPlacements(ToRender, bIgnoreCustomData);
 }
 
 void ATiledLevel::ResetAllInstanceFromData()
 {
-	for (AActor* SpawnedActor : SpawnedTiledActors)
-	{
-		if (SpawnedActor)
-			SpawnedActor->Destroy();
-	}
-	SpawnedTiledActors.Empty();
-	for (auto& elem : TiledObjectSpawner)
-	{
-		if (elem.Value)
-		{
-			elem.Value->ClearInstances();
-		}
-	}
-
-	TiledObjectSpawner.Empty();
-	
-	for (FTilePlacement& Placement : GametimeData.BlockPlacements)
+	FPlacementsToRender ToRender;
+	for (const FTilePlacement& Placement : GametimeData.BlockPlacements)
 	{
 		if (GametimeData.HiddenFloors.Contains(Placement.GridPosition.Z)) continue;
-	    PopulateSinglePlacement(Placement);
+		ToRender.Tiles.Add(&Placement);
 	}
-	for (FTilePlacement& Placement : GametimeData.FloorPlacements)
+	for (const FTilePlacement& Placement : GametimeData.FloorPlacements)
 	{
 		if (GametimeData.HiddenFloors.Contains(Placement.GridPosition.Z)) continue;
-		PopulateSinglePlacement(Placement);
+		ToRender.Tiles.Add(&Placement);
 	}
-	for (FPointPlacement& Placement : GametimeData.PillarPlacements)
+	for (const FPointPlacement& Placement : GametimeData.PillarPlacements)
 	{
 		if (GametimeData.HiddenFloors.Contains(Placement.GridPosition.Z)) continue;
-		PopulateSinglePlacement(Placement);
+		ToRender.Points.Add(&Placement);
 	}
-	for (FEdgePlacement& Placement : GametimeData.WallPlacements)
+	for (const FEdgePlacement& Placement : GametimeData.WallPlacements)
 	{
 		if (GametimeData.HiddenFloors.Contains(Placement.GetEdgePosition().Z)) continue;
-		PopulateSinglePlacement(Placement);
+		ToRender.Edges.Add(&Placement);
 	}
-	for (FEdgePlacement& Placement : GametimeData.EdgePlacements)
+	for (const FEdgePlacement& Placement : GametimeData.EdgePlacements)
 	{
 		if (GametimeData.HiddenFloors.Contains(Placement.GetEdgePosition().Z)) continue;
-		PopulateSinglePlacement(Placement);
+		ToRender.Edges.Add(&Placement);
 	}
-	for (FPointPlacement& Placement : GametimeData.PointPlacements)
+	for (const FPointPlacement& Placement : GametimeData.PointPlacements)
 	{
 		if (GametimeData.HiddenFloors.Contains(Placement.GridPosition.Z)) continue;
-		PopulateSinglePlacement(Placement);
+		ToRender.Points.Add(&Placement);
+	}
+	SyncRenderedPlacements(ToRender, false);
+}
+
+void ATiledLevel::SyncRenderedPlacements(const FPlacementsToRender& Placements, bool bIgnoreCustomData)
+{
+	FRenderSyncState State;
+	for (const FTilePlacement* P : Placements.Tiles)
+		GatherPlacementToRender(this, *P, bIgnoreCustomData, State);
+	for (const FEdgePlacement* P : Placements.Edges)
+		GatherPlacementToRender(this, *P, bIgnoreCustomData, State);
+	for (const FPointPlacement* P : Placements.Points)
+		GatherPlacementToRender(this, *P, bIgnoreCustomData, State);
+
+	// instances: an instance is kept when a placement with its key still wants the same transform,
+	// its custom data is rewritten when it differs (e.g. it was reset by a sync that ignored custom data)
+	TMap<UStaticMesh*, TArray<int32>> InstancesToAdd;
+	TMap<UStaticMesh*, TArray<int32>> InstancesToRemove;
+	TArray<UStaticMesh*> MeshesToDestroy;
+	for (auto& elem : TiledObjectSpawner)
+	{
+		UHierarchicalInstancedStaticMeshComponent* HISM = elem.Value;
+		const TArray<FInstanceToRender>* Instances = State.Instances.Find(elem.Key);
+		if (!HISM || !Instances)
+		{
+			MeshesToDestroy.Add(elem.Key);
+			continue;
+		}
+
+		TMultiMap<FTiledInstanceKey, int32> Unmatched;
+		for (int32 i = 0; i < Instances->Num(); i++)
+			Unmatched.Add((*Instances)[i].Key, i);
+
+		TArray<int32>& ToRemove = InstancesToRemove.Add(elem.Key);
+		const TArray<FTiledInstanceKey>& Keys = InstanceIndex.GetInstanceKeys(HISM);
+		bool bCustomDataChanged = false;
+		for (int32 i = 0; i < Keys.Num(); i++)
+		{
+			FTransform Transform;
+			HISM->GetInstanceTransform(i, Transform);
+			bool bMatched = false;
+			for (auto It = Unmatched.CreateKeyIterator(Keys[i]); It; ++It)
+			{
+				const FInstanceToRender& Instance = (*Instances)[It.Value()];
+				if (Transform.Equals(Instance.Transform, RenderedTransformTolerance))
+				{
+					if (Instance.CustomData.Num() > 0 && !HasInstanceCustomData(HISM, i, Instance.CustomData))
+					{
+						HISM->SetCustomData(i, Instance.CustomData);
+						bCustomDataChanged = true;
+					}
+					It.RemoveCurrent();
+					bMatched = true;
+					break;
+				}
+			}
+			if (!bMatched)
+				ToRemove.Add(i);
+		}
+		if (bCustomDataChanged)
+			HISM->MarkRenderStateDirty();
+		if (ToRemove.Num() == 0)
+			InstancesToRemove.Remove(elem.Key);
+
+		TArray<int32>& ToAdd = InstancesToAdd.Add(elem.Key);
+		Unmatched.GenerateValueArray(ToAdd);
+		ToAdd.Sort();
+	}
+	for (auto& elem : State.Instances)
+	{
+		if (!TiledObjectSpawner.Contains(elem.Key))
+		{
+			TArray<int32>& ToAdd = InstancesToAdd.Add(elem.Key);
+			for (int32 i = 0; i < elem.Value.Num(); i++)
+				ToAdd.Add(i);
+		}
+	}
+
+	for (UStaticMesh* Mesh : MeshesToDestroy)
+	{
+		if (UHierarchicalInstancedStaticMeshComponent* HISM = TiledObjectSpawner[Mesh])
+		{
+			InstanceIndex.RemoveComponent(HISM);
+			HISM->DestroyComponent();
+		}
+		TiledObjectSpawner.Remove(Mesh);
+	}
+
+	// add before removing, so that a component that only changes its instances is never emptied and destroyed
+	for (auto& elem : InstancesToAdd)
+	{
+		if (elem.Value.Num() == 0) continue;
+		const TArray<FInstanceToRender>& Instances = State.Instances[elem.Key];
+		CreateNewHISM(State.MeshItems[elem.Key]);
+		UHierarchicalInstancedStaticMeshComponent* HISM = TiledObjectSpawner[elem.Key];
+		TArray<FTransform> Transforms;
+		Transforms.Reserve(elem.Value.Num());
+		for (const int32 i : elem.Value)
+			Transforms.Add(Instances[i].Transform);
+		const TArray<int32> NewIndices = HISM->AddInstances(Transforms, true);
+		for (int32 n = 0; n < NewIndices.Num(); n++)
+		{
+			const FInstanceToRender& Instance = Instances[elem.Value[n]];
+			InstanceIndex.AddInstance(HISM, NewIndices[n], Instance.Key);
+			if (Instance.CustomData.Num() > 0)
+				HISM->SetCustomData(NewIndices[n], Instance.CustomData);
+		}
 	}
+	RemoveInstances(InstancesToRemove);
 
-	for (AActor* Actor : SpawnedTiledActors)
+	// actors: an actor is kept when it carries the tags of a placement and still has its transform and source
+	TMultiMap<FName, int32> UnmatchedActors;
+	for (int32 i = 0; i < State.Actors.Num(); i++)
+		UnmatchedActors.Add(State.Actors[i].Tags.Last(), i);
+
+	TArray<TObjectPtr<AActor>> KeptActors;
+	for (AActor* SpawnedActor : SpawnedTiledActors)
 	{
-		Actor->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
+		if (!SpawnedActor) continue;
+		bool bMatched = false;
+		if (!SpawnedActor->IsA<ATiledLevelRestrictionHelper>() && SpawnedActor->Tags.Num() >= 3 && SpawnedActor->GetRootComponent())
+		{
+			const TArray<FName>& Tags = SpawnedActor->Tags;
+			const int32 NumTags = Tags.Num();
+			for (auto It = UnmatchedActors.CreateKeyIterator(Tags.Last()); It; ++It)
+			{
+				const FActorToRender& Actor = State.Actors[It.Value()];
+				if (Actor.Tags[0] == Tags[NumTags - 3] && Actor.Tags[1] == Tags[NumTags - 2] &&
+					Actor.Source == GetRenderedActorSource(SpawnedActor, Actor.bMirrored) &&
+					SpawnedActor->GetRootComponent()->GetRelativeTransform().Equals(Actor.Transform, RenderedTransformTolerance))
+				{
+					It.RemoveCurrent();
+					bMatched = true;
+					break;
+				}
+			}
+		}
+		if (bMatched)
+			KeptActors.Add(SpawnedActor);
+		else
+			SpawnedActor->Destroy();
+	}
+	SpawnedTiledActors = MoveTemp(KeptActors);
+	const int32 NumKeptActors = SpawnedTiledActors.Num();
+
+	TArray<int32> ActorsToSpawn;
+	UnmatchedActors.GenerateValueArray(ActorsToSpawn);
+	ActorsToSpawn.Sort();
+	for (const int32 i : ActorsToSpawn)
+		State.Actors[i].Spawn();
+	for (const TFunction<void()>& Spawn : State.RestrictionSpawns)
+		Spawn();
+
+	for (int32 i = NumKeptActors; i < SpawnedTiledActors.Num(); i++)
+	{
+		SpawnedTiledActors[i]->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
 	}
 }
 
@@ -738,9 +946,10 @@ void ATiledLevel::MakeEditable()
 		if (Item->SourceType == ETLSourceType::Actor) continue;
 		if (TiledObjectSpawner.Find(Item->TiledMesh))
 		{
-			Item->UpdateHISM.BindLambda([=]()
+			Item->UpdateHISM.BindWeakLambda(this, [this, Item]()
 			{
-				UpdateHISM_Properties(TiledObjectSpawner[Item->TiledMesh], Item);
+				if (UHierarchicalInstancedStaticMeshComponent* HISM = TiledObjectSpawner.FindRef(Item->TiledMesh))
+					UpdateHISM_Properties(HISM, Item);
 			});
 		}
 	}
@@ -813,40 +1022,41 @@ FTiledLevelGameData ATiledLevel::MakeGametimeData()
 	const FVector TileSize = GetAsset()->GetTileSize();
 	const FIntVector Offset = FIntVector(MyLocation / TileSize);
 	FTiledLevelGameData Data;
-	for (FTiledFloor Floor : GetAsset()->TiledFloors)
+	const TArray<FTiledFloor>& Floors = GetAsset()->TiledFloors;
+	// each placement is copied once, straight into its final slot
+	int32 NumBlocks = 0, NumFloors = 0, NumWalls = 0, NumEdges = 0, NumPillars = 0, NumPoints = 0;
+	for (const FTiledFloor& Floor : Floors)
 	{
-		for (auto p : Floor.BlockPlacements)
-		{
-			p.OffsetGridPosition(Offset, TileSize);
-			Data.BlockPlacements.Add(p);
-		}
-		for (auto p : Floor.FloorPlacements)
-		{
-			p.OffsetGridPosition(Offset, TileSize);
-			Data.FloorPlacements.Add(p);
-		}
-		for (auto p: Floor.WallPlacements)
-		{
-			p.OffsetEdgePosition(Offset, TileSize);
-			Data.WallPlacements.Add(p);
-		}
-		for (auto p: Floor.EdgePlacements)
-		{
-			p.OffsetEdgePosition(Offset, TileSize);
-			Data.EdgePlacements.Add(p);
-		}
-		for (auto p: Floor.PillarPlacements)
-		{
-			p.OffsetPointPosition(Offset, TileSize);
-			Data.PillarPlacements.Add(p);
-		}
-		for (auto p: Floor.PointPlacements)
-		{
-			p.OffsetPointPosition(Offset, TileSize);
-			Data.PointPlacements.Add(p);
-		}
+		NumBlocks += Floor.BlockPlacements.Num();
+		NumFloors += Floor.FloorPlacements.Num();
+		NumWalls += Floor.WallPlacements.Num();
+		NumEdges += Floor.EdgePlacements.Num();
+		NumPillars += Floor.PillarPlacements.Num();
+		NumPoints += Floor.PointPlacements.Num();
+	}
+	Data.BlockPlacements.Reserve(NumBlocks);
+	Data.FloorPlacements.Reserve(NumFloors);
+	Data.WallPlacements.Reserve(NumWalls);
+	Data.EdgePlacements.Reserve(NumEdges);
+	Data.PillarPlacements.Reserve(NumPillars);
+	Data.PointPlacements.Reserve(NumPoints);
+	for (const FTiledFloor& Floor : Floors)
+	{
+		for (const auto& p : Floor.BlockPlacements)
+			Data.BlockPlacements.Add_GetRef(p).OffsetGridPosition(Offset, TileSize);
+		for (const auto& p : Floor.FloorPlacements)
+			Data.FloorPlacements.Add_GetRef(p).OffsetGridPosition(Offset, TileSize);
+		for (const auto& p: Floor.WallPlacements)
+			Data.WallPlacements.Add_GetRef(p).OffsetEdgePosition(Offset, TileSize);
+		for (const auto& p: Floor.EdgePlacements)
+			Data.EdgePlacements.Add_GetRef(p).OffsetEdgePosition(Offset, TileSize);
+		for (const auto& p: Floor.PillarPlacements)
+			Data.PillarPlacements.Add_GetRef(p).OffsetPointPosition(Offset, TileSize);
+		for (const auto& p: Floor.PointPlacements)
+			Data.PointPlacements.Add_GetRef(p).OffsetPointPosition(Offset, TileSize);
 	}
 	Data.Boundaries.Add(GetBoundaryBox());
+	Data.MarkPlacementsChanged();
 	return Data;
 }
 
@@ -880,9 +1090,12 @@ void ATiledLevel::CreateNewHISM(UTiledLevelItem* SourceItem)
 	NewHISM->NumCustomDataFloats = 6;
 	NewHISM->RegisterComponentWithWorld(GetWorld());
 	UpdateHISM_Properties(NewHISM, SourceItem);
-	SourceItem->UpdateHISM.BindLambda([=]()
+	// the component is destroyed once no placement renders its mesh anymore, while the item keeps the delegate
+	TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent> WeakHISM = NewHISM;
+	SourceItem->UpdateHISM.BindWeakLambda(this, [this, WeakHISM, SourceItem]()
 	{
-		UpdateHISM_Properties(NewHISM, SourceItem);
+		if (UHierarchicalInstancedStaticMeshComponent* HISM = WeakHISM.Get())
+			UpdateHISM_Properties(HISM, SourceItem);
 	});
 	TiledObjectSpawner.Add(SourceItem->TiledMesh, NewHISM);
 }
@@ -6,11 +6,247 @@
 #include "TiledLevelEditorLog.h"
 #include "TiledLevelItem.h"
 #include "TiledLevelUtility.h"
+#include "Algo/Unique.h"
+#include "Async/ParallelFor.h"
 #include "Components/StaticMeshComponent.h"
 #include "Misc/MessageDialog.h"
 
 #define LOCTEXT_NAMESPACE "TiledLevel"
 
+namespace TiledFloorIndex
+{
+	typedef TArray<FIntVector, TInlineAllocator<8>> FCellKeys;
+	typedef TArray<FTiledLevelEdge, TInlineAllocator<8>> FEdgeKeys;
+
+	void GetKeys(const FTilePlacement& Placement, FCellKeys& OutKeys)
+	{
+		for (int x = 0; x < FMath::Max(1, Placement.Extent.X); x++)
+			for (int y = 0; y < FMath::Max(1, Placement.Extent.Y); y++)
+				for (int z = 0; z < FMath::Max(1, Placement.Extent.Z); z++)
+					OutKeys.Add(Placement.GridPosition + FIntVector(x, y, z));
+	}
+
+	void GetKeys(const FEdgePlacement& Placement, FEdgeKeys& OutKeys)
+	{
+		// missing item: only the edge it starts at is known
+		const UTiledLevelItem* Item = Placement.GetItem();
+		OutKeys.Append(Placement.GetOccupiedEdges(Item? Item->Extent : FVector(1)));
+	}
+
+	void GetKeys(const FPointPlacement& Placement, FCellKeys& OutKeys)
+	{
+		OutKeys.Add(Placement.GridPosition);
+	}
+
+	template <typename PlacementType, typename KeyType>
+	void Add(TMultiMap<KeyType, int32>& Map, const PlacementType& Placement, int32 ArrayIndex)
+	{
+		TArray<KeyType, TInlineAllocator<8>> Keys;
+		GetKeys(Placement, Keys);
+		for (const KeyType& Key : Keys)
+			Map.Add(Key, ArrayIndex);
+	}
+
+	template <typename PlacementType, typename KeyType>
+	void Remove(TMultiMap<KeyType, int32>& Map, const PlacementType& Placement, int32 ArrayIndex)
+	{
+		TArray<KeyType, TInlineAllocator<8>> Keys;
+		GetKeys(Placement, Keys);
+		for (const KeyType& Key : Keys)
+			Map.RemoveSingle(Key, ArrayIndex);
+	}
+
+	// array indices of the placements at that key, checked against the placements themselves in case an item extent changed since indexing
+	template <typename PlacementType, typename KeyType>
+	void Find(const TArray<PlacementType>& Placements, const TMultiMap<KeyType, int32>& Map, const KeyType& Key, TArray<int32>& OutIndices)
+	{
+		for (auto It = Map.CreateConstKeyIterator(Key); It; ++It)
+		{
+			const int32 ArrayIndex = It.Value();
+			if (!Placements.IsValidIndex(ArrayIndex))
+				continue;
+			TArray<KeyType, TInlineAllocator<8>> Keys;
+			GetKeys(Placements[ArrayIndex], Keys);
+			if (Keys.Contains(Key))
+				OutIndices.Add(ArrayIndex);
+		}
+	}
+
+	// array indices of the placements equal to the placement, found through the first key it occupies
+	template <typename PlacementType, typename KeyType>
+	void FindEqual(const TArray<PlacementType>& Placements, const TMultiMap<KeyType, int32>& Map, const PlacementType& Placement, TArray<int32>& OutIndices)
+	{
+		TArray<KeyType, TInlineAllocator<8>> Keys;
+		GetKeys(Placement, Keys);
+		if (Keys.Num() == 0)
+			return;
+		for (auto It = Map.CreateConstKeyIterator(Keys[0]); It; ++It)
+		{
+			if (Placements.IsValidIndex(It.Value()) && Placements[It.Value()] == Placement)
+				OutIndices.Add(It.Value());
+		}
+	}
+
+	// removes by swapping the last placement into the removed slot, and moves its index entries along
+	template <typename PlacementType, typename KeyType>
+	int32 RemoveAt(TArray<PlacementType>& Placements, TMultiMap<KeyType, int32>& Map, TArray<int32>& ArrayIndices)
+	{
+		// from the back, so the placement swapped in is never one still to be removed
+		ArrayIndices.Sort(TGreater<int32>());
+		ArrayIndices.SetNum(Algo::Unique(ArrayIndices));
+		for (const int32 ArrayIndex : ArrayIndices)
+		{
+			Remove(Map, Placements[ArrayIndex], ArrayIndex);
+			const int32 LastIndex = Placements.Num() - 1;
+			if (ArrayIndex != LastIndex)
+			{
+				Remove(Map, Placements[LastIndex], LastIndex);
+				Add(Map, Placements[LastIndex], ArrayIndex);
+			}
+			Placements.RemoveAtSwap(ArrayIndex, 1, false);
+		}
+		return ArrayIndices.Num();
+	}
+}
+
+void FTiledFloor::AddPlacement(const FTilePlacement& NewPlacement, EPlacedType PlacedType)
+{
+	const bool bWasIndexed = Index.NumIndexed == GetNumPlacements();
+	const bool bIsBlock = PlacedType == EPlacedType::Block;
+	const int32 ArrayIndex = (bIsBlock? BlockPlacements : FloorPlacements).Add(NewPlacement);
+	if (!bWasIndexed) return;
+	TiledFloorIndex::Add(bIsBlock? Index.BlockCells : Index.FloorCells, NewPlacement, ArrayIndex);
+	Index.NumIndexed++;
+}
+
+void FTiledFloor::AddPlacement(const FEdgePlacement& NewPlacement, EPlacedType PlacedType)
+{
+	const bool bWasIndexed = Index.NumIndexed == GetNumPlacements();
+	const bool bIsWall = PlacedType == EPlacedType::Wall;
+	const int32 ArrayIndex = (bIsWall? WallPlacements : EdgePlacements).Add(NewPlacement);
+	if (!bWasIndexed) return;
+	TiledFloorIndex::Add(bIsWall? Index.WallEdges : Index.EdgeEdges, NewPlacement, ArrayIndex);
+	Index.NumIndexed++;
+}
+
+void FTiledFloor::AddPlacement(const FPointPlacement& NewPlacement, EPlacedType PlacedType)
+{
+	const bool bWasIndexed = Index.NumIndexed == GetNumPlacements();
+	const bool bIsPillar = PlacedType == EPlacedType::Pillar;
+	const int32 ArrayIndex = (bIsPillar? PillarPlacements : PointPlacements).Add(NewPlacement);
+	if (!bWasIndexed) return;
+	TiledFloorIndex::Add(bIsPillar? Index.PillarPoints : Index.PointPoints, NewPlacement, ArrayIndex);
+	Index.NumIndexed++;
+}
+
+int32 FTiledFloor::RemovePlacements(const TArray<FTilePlacement>& ToDelete)
+{
+	UpdateIndex();
+	TArray<int32> BlockIndices;
+	TArray<int32> FloorIndices;
+	for (const FTilePlacement& P : ToDelete)
+	{
+		TiledFloorIndex::FindEqual(BlockPlacements, Index.BlockCells, P, BlockIndices);
+		TiledFloorIndex::FindEqual(FloorPlacements, Index.FloorCells, P, FloorIndices);
+	}
+	const int32 NumRemoved = TiledFloorIndex::RemoveAt(BlockPlacements, Index.BlockCells, BlockIndices)
+		+ TiledFloorIndex::RemoveAt(FloorPlacements, Index.FloorCells, FloorIndices);
+	Index.NumIndexed -= NumRemoved;
+	return NumRemoved;
+}
+
+int32 FTiledFloor::RemovePlacements(const TArray<FEdgePlacement>& ToDelete)
+{
+	UpdateIndex();
+	TArray<int32> WallIndices;
+	TArray<int32> EdgeIndices;
+	for (const FEdgePlacement& P : ToDelete)
+	{
+		TiledFloorIndex::FindEqual(WallPlacements, Index.WallEdges, P, WallIndices);
+		TiledFloorIndex::FindEqual(EdgePlacements, Index.EdgeEdges, P, EdgeIndices);
+	}
+	const int32 NumRemoved = TiledFloorIndex::RemoveAt(WallPlacements, Index.WallEdges, WallIndices)
+		+ TiledFloorIndex::RemoveAt(EdgePlacements, Index.EdgeEdges, EdgeIndices);
+	Index.NumIndexed -= NumRemoved;
+	return NumRemoved;
+}
+
+int32 FTiledFloor::RemovePlacements(const TArray<FPointPlacement>& ToDelete)
+{
+	UpdateIndex();
+	TArray<int32> PillarIndices;
+	TArray<int32> PointIndices;
+	for (const FPointPlacement& P : ToDelete)
+	{
+		TiledFloorIndex::FindEqual(PillarPlacements, Index.PillarPoints, P, PillarIndices);
+		TiledFloorIndex::FindEqual(PointPlacements, Index.PointPoints, P, PointIndices);
+	}
+	const int32 NumRemoved = TiledFloorIndex::RemoveAt(PillarPlacements, Index.PillarPoints, PillarIndices)
+		+ TiledFloorIndex::RemoveAt(PointPlacements, Index.PointPoints, PointIndices);
+	Index.NumIndexed -= NumRemoved;
+	return NumRemoved;
+}
+
+int32 FTiledFloor::EmptyRegion(const TSet<FIntVector>& Cells, const TArray<FTiledLevelEdge>& Edges, const TSet<FIntVector>& Points)
+{
+	UpdateIndex();
+	TArray<int32> BlockIndices;
+	TArray<int32> FloorIndices;
+	for (const FIntVector& Cell : Cells)
+	{
+		TiledFloorIndex::Find(BlockPlacements, Index.BlockCells, Cell, BlockIndices);
+		TiledFloorIndex::Find(FloorPlacements, Index.FloorCells, Cell, FloorIndices);
+	}
+	TArray<int32> WallIndices;
+	TArray<int32> EdgeIndices;
+	for (const FTiledLevelEdge& Edge : Edges)
+	{
+		TiledFloorIndex::Find(WallPlacements, Index.WallEdges, Edge, WallIndices);
+		TiledFloorIndex::Find(EdgePlacements, Index.EdgeEdges, Edge, EdgeIndices);
+	}
+	TArray<int32> PillarIndices;
+	TArray<int32> PointIndices;
+	for (const FIntVector& Point : Points)
+	{
+		TiledFloorIndex::Find(PillarPlacements, Index.PillarPoints, Point, PillarIndices);
+		TiledFloorIndex::Find(PointPlacements, Index.PointPoints, Point, PointIndices);
+	}
+	const int32 NumRemoved = TiledFloorIndex::RemoveAt(BlockPlacements, Index.BlockCells, BlockIndices)
+		+ TiledFloorIndex::RemoveAt(FloorPlacements, Index.FloorCells, FloorIndices)
+		+ TiledFloorIndex::RemoveAt(WallPlacements, Index.WallEdges, WallIndices)
+		+ TiledFloorIndex::RemoveAt(EdgePlacements, Index.EdgeEdges, EdgeIndices)
+		+ TiledFloorIndex::RemoveAt(PillarPlacements, Index.PillarPoints, PillarIndices)
+		+ TiledFloorIndex::RemoveAt(PointPlacements, Index.PointPoints, PointIndices);
+	Index.NumIndexed -= NumRemoved;
+	return NumRemoved;
+}
+
+int32 FTiledFloor::GetNumPlacements() const
+{
+	return BlockPlacements.Num() + FloorPlacements.Num() + WallPlacements.Num() + EdgePlacements.Num()
+		+ PillarPlacements.Num() + PointPlacements.Num();
+}
+
+void FTiledFloor::UpdateIndex()
+{
+	if (Index.NumIndexed == GetNumPlacements())
+		return;
+	Index = FTiledFloorIndex();
+	for (int32 i = 0; i < BlockPlacements.Num(); i++)
+		TiledFloorIndex::Add(Index.BlockCells, BlockPlacements[i], i);
+	for (int32 i = 0; i < FloorPlacements.Num(); i++)
+		TiledFloorIndex::Add(Index.FloorCells, FloorPlacements[i], i);
+	for (int32 i = 0; i < WallPlacements.Num(); i++)
+		TiledFloorIndex::Add(Index.WallEdges, WallPlacements[i], i);
+	for (int32 i = 0; i < EdgePlacements.Num(); i++)
+		TiledFloorIndex::Add(Index.EdgeEdges, EdgePlacements[i], i);
+	for (int32 i = 0; i < PillarPlacements.Num(); i++)
+		TiledFloorIndex::Add(Index.PillarPoints, PillarPlacements[i], i);
+	for (int32 i = 0; i < PointPlacements.Num(); i++)
+		TiledFloorIndex::Add(Index.PointPoints, PointPlacements[i], i);
+	Index.NumIndexed = GetNumPlacements();
+}
+
 /*
  *  TODO: trigger update of auto paint data here is just a temporarily solution, need to trigger it inside tiled level actor somehow...
  */
@@ -86,6 +322,7 @@ void UTiledLevelAsset::ClearOrphan()
 		{
 			return PP.ItemSet != ActiveItemSet.Get();
 		});
+		Floor.MarkIndexDirty();
 	}
 	DEV_LOGF("%d orphan placements are removed!", N_Removed)
 	if (HostLevel)
@@ -129,6 +366,15 @@ void UTiledLevelAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyCha
 	UObject::PostEditChangeProperty(PropertyChangedEvent);
 }
 
+void UTiledLevelAsset::PostEditUndo()
+{
+	UObject::PostEditUndo();
+	// placements may have been restored in place, which the floor indices can not tell from their count
+	for (FTiledFloor& Floor : TiledFloors)
+		Floor.MarkIndexDirty();
+	InvalidateAutoPaintEvaluation();
+}
+
 void UTiledLevelAsset::ClearOutOfBoundPlacements()
 {
 	int NumRemoved = 0;
@@ -158,6 +404,7 @@ void UTiledLevelAsset::ClearOutOfBoundPlacements()
 		{
 			return P.GridPosition.X > X_Num || P.GridPosition.Y > Y_Num;
 		});
+		Floor.MarkIndexDirty();
 	}
 	if (NumRemoved)
 	{
@@ -274,6 +521,7 @@ void UTiledLevelAsset::DuplicatedFloor(int SourcePosition)
 	TargetFloor->WallPlacements = WP;
 	TargetFloor->EdgePlacements = BmP;
 	TargetFloor->PointPlacements = PP;
+	TargetFloor->MarkIndexDirty();
 	TMap<FIntVector, FName> ToAppend;
 	for (auto [K, V] : AutoPaintData)
 	{
@@ -282,6 +530,8 @@ void UTiledLevelAsset::DuplicatedFloor(int SourcePosition)
 			ToAppend.Add(K + FIntVector(0, 0, 1), V);
 		}
 	}
+	for (const auto& [K, V] : ToAppend)
+		MarkAutoPaintDataDirty(K);
 	AutoPaintData.Append(ToAppend);
 	if (ActiveAutoPaintRule) ActiveAutoPaintRule->RefreshSpawnedInstance_Delegate.Execute();
 }
@@ -302,6 +552,7 @@ void UTiledLevelAsset::MoveAllFloors(bool Up)
 		NewData.Add(K + Mod, V);
 	}
 	AutoPaintData = NewData;
+	InvalidateAutoPaintEvaluation();
 
 	if (ActiveAutoPaintRule) ActiveAutoPaintRule->RefreshSpawnedInstance_Delegate.Execute();
 	OnTiledLevelAreaChanged.Broadcast(TileSizeX, TileSizeY, TileSizeZ, X_Num, Y_Num, TiledFloors.Num(),
@@ -349,6 +600,7 @@ void UTiledLevelAsset::MoveFloor(bool IsUp, int SelectedFloorPosition, int EndFl
 			}
 		}
 		AutoPaintData = NewData;
+		InvalidateAutoPaintEvaluation();
 		VersionNumber += 1;
 	}
 	else
@@ -393,6 +645,7 @@ void UTiledLevelAsset::ChangeFloorOrdering(int OldPosition, int NewPosition)
 			}
 		}
 		AutoPaintData = NewData;
+		InvalidateAutoPaintEvaluation();
 		VersionNumber += 1;
 	}
 }
@@ -429,6 +682,7 @@ void UTiledLevelAsset::RemoveFloor(int32 DeleteIndex)
 		}
 	}
 	AutoPaintData = NewData;
+	InvalidateAutoPaintEvaluation();
 
 	// reorder
 	if (DeleteIndex >= 0)
@@ -461,12 +715,16 @@ void UTiledLevelAsset::EmptyFloor(int FloorPosition)
 		F->WallPlacements.Empty();
 		F->EdgePlacements.Empty();
 		F->PillarPlacements.Empty();
+		F->MarkIndexDirty();
 	}
 	TArray<FIntVector> ToRemove;
 	for (auto& [K, V] : AutoPaintData)
 		if (K.Z == FloorPosition) ToRemove.Add(K);
 	for (auto& P : ToRemove)
+	{
 		AutoPaintData.Remove(P);
+		MarkAutoPaintDataDirty(P);
+	}
 	if (ActiveAutoPaintRule) ActiveAutoPaintRule->RefreshSpawnedInstance_Delegate.Execute();
 	VersionNumber += 100;
 }
@@ -481,8 +739,10 @@ void UTiledLevelAsset::EmptyAllFloors()
 		F.WallPlacements.Empty();
 		F.EdgePlacements.Empty();
 		F.PillarPlacements.Empty();
+		F.MarkIndexDirty();
 	}
 	AutoPaintData.Empty();
+	InvalidateAutoPaintEvaluation();
 	if (ActiveAutoPaintRule) ActiveAutoPaintRule->RefreshSpawnedInstance_Delegate.Execute();
 	VersionNumber += 100;
 }
@@ -500,52 +760,26 @@ bool UTiledLevelAsset::IsFloorExists(int32 PositionIndex)
 void UTiledLevelAsset::RemovePlacements(const TArray<FTilePlacement>& TilesToDelete)
 {
 	for (FTiledFloor& F : TiledFloors)
-	{
-		F.BlockPlacements.RemoveAll([=](const FTilePlacement& P)
-		{
-			return TilesToDelete.Contains(P);
-		});
-		F.FloorPlacements.RemoveAll([=](const FTilePlacement& P)
-		{
-			return TilesToDelete.Contains(P);
-		});
-	}
+		F.RemovePlacements(TilesToDelete);
 }
 
 void UTiledLevelAsset::RemovePlacements(const TArray<FEdgePlacement>& WallsToDelete)
 {
 	for (FTiledFloor& F : TiledFloors)
-	{
-		F.WallPlacements.RemoveAll([=](const FEdgePlacement& P)
-		{
-			return WallsToDelete.Contains(P);
-		});
-		F.EdgePlacements.RemoveAll([=](const FEdgePlacement& P)
-		{
-			return WallsToDelete.Contains(P);
-		});
-	}
+		F.RemovePlacements(WallsToDelete);
 }
 
 void UTiledLevelAsset::RemovePlacements(const TArray<FPointPlacement>& PointsToDelete)
 {
 	for (FTiledFloor& F : TiledFloors)
-	{
-		F.PillarPlacements.RemoveAll([=](const FPointPlacement& P)
-		{
-			return PointsToDelete.Contains(P);
-		});
-		F.PointPlacements.RemoveAll([=](const FPointPlacement& P)
-		{
-			return PointsToDelete.Contains(P);
-		});
-	}
+		F.RemovePlacements(PointsToDelete);
 }
 
 void UTiledLevelAsset::ClearItem(const FGuid& ItemID)
 {
 	for (FTiledFloor& F : TiledFloors)
 	{
+		F.MarkIndexDirty();
 		if (F.BlockPlacements.RemoveAll([=](const FTilePlacement& P)
 		{
 			return P.ItemID == ItemID;
@@ -581,6 +815,7 @@ void UTiledLevelAsset::ClearItem(const FGuid& ItemID)
 
 void UTiledLevelAsset::ClearItemInActiveFloor(const FGuid& ItemID)
 {
+	GetActiveFloor()->MarkIndexDirty();
 	GetActiveFloor()->BlockPlacements.RemoveAll([=](const FTilePlacement& P)
 	{
 		return P.ItemID == ItemID;
@@ -654,10 +889,10 @@ void UTiledLevelAsset::AddNewTilePlacement(FTilePlacement NewTile)
 	switch (Item->PlacedType)
 	{
 	case EPlacedType::Block:
-		TargetFloor->BlockPlacements.Add(NewTile);
+		TargetFloor->AddPlacement(NewTile, EPlacedType::Block);
 		break;
 	case EPlacedType::Floor:
-		TargetFloor->FloorPlacements.Add(NewTile);
+		TargetFloor->AddPlacement(NewTile, EPlacedType::Floor);
 		break;
 	default: ;
 	}
@@ -671,10 +906,10 @@ void UTiledLevelAsset::AddNewEdgePlacement(FEdgePlacement NewEdge)
 	switch (Item->PlacedType)
 	{
 	case EPlacedType::Wall:
-		TargetFloor->WallPlacements.Add(NewEdge);
+		TargetFloor->AddPlacement(NewEdge, EPlacedType::Wall);
 		break;
 	case EPlacedType::Edge:
-		TargetFloor->EdgePlacements.Add(NewEdge);
+		TargetFloor->AddPlacement(NewEdge, EPlacedType::Edge);
 	default: ;
 	}
 }
@@ -687,10 +922,10 @@ void UTiledLevelAsset::AddNewPointPlacement(FPointPlacement NewPoint)
 	switch (Item->PlacedType)
 	{
 	case EPlacedType::Pillar:
-		TargetFloor->PillarPlacements.Add(NewPoint);
+		TargetFloor->AddPlacement(NewPoint, EPlacedType::Pillar);
 		break;
 	case EPlacedType::Point:
-		TargetFloor->PointPlacements.Add(NewPoint);
+		TargetFloor->AddPlacement(NewPoint, EPlacedType::Point);
 		break;
 	default: ;
 	}
@@ -825,84 +1060,18 @@ TSet<UStaticMesh*> UTiledLevelAsset::GetUsedStaticMeshSet() const
 void UTiledLevelAsset::EmptyRegionData(const TArray<FIntVector>& Points)
 {
 	if (Points.Num() == 0) return;
-	TArray<FTilePlacement> TileToDelete;
-	TArray<FTilePlacement> TargetTilePlacements;
-	TargetTilePlacements.Append(GetAllBlockPlacements());
-	TargetTilePlacements.Append(GetAllFloorPlacements());
-	TArray<FEdgePlacement> WallToDelete;
-	TArray<FEdgePlacement> TargetWallPlacements;
-	TargetWallPlacements.Append(GetAllWallPlacements());
-	TargetWallPlacements.Append(GetAllEdgePlacements());
-	TArray<FPointPlacement> PointToDelete;
-	TArray<FPointPlacement> TargetPointPlacements;
-	TargetPointPlacements.Append(GetAllPillarPlacements());
-	TargetPointPlacements.Append(GetAllPointPlacements());
-
-	bool Found = false;
-	for (FTilePlacement& Placement : TargetTilePlacements)
-	{
-		for (FIntVector& Position : Placement.GetOccupiedTilePositions())
-		{
-			if (Points.Contains(Position))
-			{
-				TileToDelete.Add(Placement);
-				break;
-			}
-		}
-	}
-
-	TSet<FIntVector> Region = TSet<FIntVector>(Points);
-
+	const TSet<FIntVector> Region = TSet<FIntVector>(Points);
 	const TArray<FTiledLevelEdge> InnerEdges = FTiledLevelUtility::GetEdgesAroundArea(Region, false);
-	for (FEdgePlacement& Placement : TargetWallPlacements)
-	{
-		FVector Extent = Placement.GetItem()->Extent;
-		for (FTiledLevelEdge& E : Placement.GetOccupiedEdges(Extent))
-		{
-			if (InnerEdges.Contains(Placement.Edge))
-			{
-				WallToDelete.Add(Placement);
-				break;
-			}
-		}
-	}
-
 	const TSet<FIntVector> InnerPoints = FTiledLevelUtility::GetPointsAroundArea(Region, false);
-
-	for (FPointPlacement& Placement : TargetPointPlacements)
-	{
-		if (InnerPoints.Contains(Placement.GridPosition))
-		{
-			PointToDelete.Add(Placement);
-		}
-	}
-	RemovePlacements(TileToDelete);
-	RemovePlacements(WallToDelete);
-	RemovePlacements(PointToDelete);
+	for (FTiledFloor& F : TiledFloors)
+		F.EmptyRegion(Region, InnerEdges, InnerPoints);
 }
 
 void UTiledLevelAsset::EmptyEdgeRegionData(const TArray<FTiledLevelEdge>& EdgeRegions)
 {
 	if (EdgeRegions.Num() == 0) return;
-	TArray<FEdgePlacement> WallToDelete;
-	TArray<FEdgePlacement> TargetWallPlacements;
-	TargetWallPlacements.Append(GetAllWallPlacements());
-	TargetWallPlacements.Append(GetAllEdgePlacements());
-
-	for (FEdgePlacement& Placement : TargetWallPlacements)
-	{
-		FVector EdgeExtent = Placement.GetItem()->Extent;
-
-		for (FTiledLevelEdge& Edge : Placement.GetOccupiedEdges(EdgeExtent))
-		{
-			if (EdgeRegions.Contains(Edge))
-			{
-				WallToDelete.Add(Placement);
-				break;
-			}
-		}
-	}
-	RemovePlacements(WallToDelete);
+	for (FTiledFloor& F : TiledFloors)
+		F.EmptyRegion(TSet<FIntVector>(), EdgeRegions, TSet<FIntVector>());
 }
 
 void UTiledLevelAsset::GetAssetRegistryTags(TArray<FAssetRegistryTag>& AssetRegistryTags) const
@@ -931,6 +1100,7 @@ bool UTiledLevelAsset::UpdateAutoPaintData(const FIntVector& NewPos, const FName
 		if (AutoPaintData[NewPos] == NewItemName)
 			return false;
 	AutoPaintData.Add(NewPos, NewItemName);
+	MarkAutoPaintDataDirty(NewPos);
 	VersionNumber += 1;
 	return true;
 }
@@ -940,6 +1110,7 @@ bool UTiledLevelAsset::RemoveAutoPaintDataAt(const FIntVector& PosToRemove)
 	if (AutoPaintData.Contains(PosToRemove))
 	{
 		AutoPaintData.Remove(PosToRemove);
+		MarkAutoPaintDataDirty(PosToRemove);
 		VersionNumber += 1;
 		return true;
 	}
@@ -972,50 +1143,117 @@ TArray<FIntVector> UTiledLevelAsset::GetAllTilePositions()
 
 void UTiledLevelAsset::CollectAutoPaintPlacements(TArray<FAutoPaintPlacement_Tile>& OutTiles,
                                               TArray<FAutoPaintPlacement_Edge>& OutEdges,
-                                              TArray<FAutoPaintPlacement_Point>& OutPoints)
+                                              TArray<FAutoPaintPlacement_Point>& OutPoints,
+                                              bool bIncremental)
 {
 	if (!IsValid(ActiveAutoPaintRule)) return;
 	ActiveAutoPaintRule->MatchData.Empty();
 
-	bool IsRuleMet = false;
-	for (FIntVector TilePosition : GetAllTilePositions())
+	const TArray<UAutoPaintItemRule*> Rules = ActiveAutoPaintRule->GetEnabledRuleList();
+	const FIntVector MinBoundary = {0, 0, GetBottomFloor().FloorPosition};
+	const FIntVector MaxBoundary = {X_Num, Y_Num, GetTopFloor().FloorPosition + 1};
+
+	const bool bUseRandomSeed = ActiveAutoPaintRule->UseRandomSeed;
+	// the cached matches are only reusable if the very same rules are evaluated, unchanged
+	auto IsSameRuleList = [&]()
 	{
-		for (UAutoPaintItemRule* R : ActiveAutoPaintRule->GetEnabledRuleList())
+		if (EvaluatedAutoPaintRules.Num() != Rules.Num()) return false;
+		for (int32 i = 0; i < Rules.Num(); i++)
 		{
-			IsRuleMet = false;
-			for (EDuplicationType D: R->GetDuplicateCases())
+			if (EvaluatedAutoPaintRules[i].Get() != Rules[i]) return false;
+		}
+		return true;
+	};
+	if (bIncremental && IsAutoPaintEvaluationValid && EvaluatedRuleVersion == ActiveAutoPaintRule->GetRuleVersion() &&
+		IsSameRuleList() && EvaluatedMinBoundary == MinBoundary && EvaluatedMaxBoundary == MaxBoundary &&
+		(!bUseRandomSeed || EvaluatedRandomSeed == ActiveAutoPaintRule->RandomSeed))
+	{
+		// only the tiles which may see the changed data within their adjacency rules need to be evaluated again
+		FIntVector Reach(0);
+		for (UAutoPaintItemRule* R : Rules)
+		{
+			for (const auto& [AdjPoint, AdjInfo] : R->AdjacencyRules)
 			{
-				if (UAutoPaintRule::IsRuleMet(R, D, TilePosition, AutoPaintData, {0, 0, GetBottomFloor().FloorPosition},
-								 {X_Num, Y_Num, GetTopFloor().FloorPosition + 1}))
+				// rotated duplications swap X and Y
+				const int ReachXY = FMath::Max(FMath::Abs(AdjPoint.X), FMath::Abs(AdjPoint.Y));
+				Reach.X = FMath::Max(Reach.X, ReachXY);
+				Reach.Z = FMath::Max(Reach.Z, FMath::Abs(AdjPoint.Z));
+			}
+		}
+		Reach.Y = Reach.X;
+		TSet<FIntVector> ToEvaluate;
+		for (const FIntVector& DirtyPos : AutoPaintDirtyPositions)
+		{
+			for (int x = FMath::Max(DirtyPos.X - Reach.X, MinBoundary.X); x <= FMath::Min(DirtyPos.X + Reach.X, MaxBoundary.X - 1); x++)
+			{
+				for (int y = FMath::Max(DirtyPos.Y - Reach.Y, MinBoundary.Y); y <= FMath::Min(DirtyPos.Y + Reach.Y, MaxBoundary.Y - 1); y++)
 				{
-					FTiledItemObj SpawnID = R->PickWhatToSpawn();
-					// may become empty when item set is changed...
-					if (SpawnID.TiledItemID.IsEmpty()) continue;
-					FDuplicationMod DMod = UAutoPaintRule::GetDuplicationMod(D, FTiledLevelUtility::PlacedTypeToShape(R->PlacedType),
-						R->AutoPaintItemSpawns[SpawnID].RotationTimes, R->PositionOffset);
-					FAutoPaintMatchData Data;
-					Data.DupType = D;
-					Data.MetPos = TilePosition;
-					Data.ToPaint = FGuid(SpawnID.TiledItemID);
-					Data.PosOffset = DMod.PosOffset;
-					Data.RotateTimes = DMod.RotationTimes;
-					Data.SpawnAdj = &R->AutoPaintItemSpawns[SpawnID];
-					Data.BaseRulePtr = R;
-					ActiveAutoPaintRule->MatchData.Add(Data);
-					IsRuleMet = true;
+					for (int z = FMath::Max(DirtyPos.Z - Reach.Z, MinBoundary.Z); z <= FMath::Min(DirtyPos.Z + Reach.Z, MaxBoundary.Z - 1); z++)
+					{
+						ToEvaluate.Add(FIntVector(x, y, z));
+					}
 				}
 			}
-			if (IsRuleMet && R->bStopOnMet)
-				break;
+		}
+		const TArray<FIntVector> Positions = ToEvaluate.Array();
+		TArray<TArray<FAutoPaintMatchData>> Matches;
+		EvaluateAutoPaint(Positions, Rules, MinBoundary, MaxBoundary, EvaluatedRandomSeed, Matches);
+		bool bHasNewMatchedTile = false;
+		for (int32 i = 0; i < Positions.Num(); i++)
+		{
+			if (Matches[i].IsEmpty())
+			{
+				EvaluatedAutoPaintMatches.Remove(Positions[i]);
+			}
+			else
+			{
+				bHasNewMatchedTile |= !EvaluatedAutoPaintMatches.Contains(Positions[i]);
+				EvaluatedAutoPaintMatches.Add(Positions[i], MoveTemp(Matches[i]));
+			}
+		}
+		// removing keeps the order of the rest, new tiles may take any free slot though
+		if (bHasNewMatchedTile)
+		{
+			EvaluatedAutoPaintMatches.KeySort([](const FIntVector& A, const FIntVector& B)
+			{
+				if (A.X != B.X) return A.X < B.X;
+				if (A.Y != B.Y) return A.Y < B.Y;
+				return A.Z < B.Z;
+			});
 		}
 	}
+	else
+	{
+		const TArray<FIntVector> AllTilePositions = GetAllTilePositions();
+		EvaluatedAutoPaintMatches.Empty();
+		EvaluatedRandomSeed = bUseRandomSeed? ActiveAutoPaintRule->RandomSeed : FMath::Rand();
+		TArray<TArray<FAutoPaintMatchData>> Matches;
+		EvaluateAutoPaint(AllTilePositions, Rules, MinBoundary, MaxBoundary, EvaluatedRandomSeed, Matches);
+		for (int32 i = 0; i < AllTilePositions.Num(); i++)
+		{
+			if (!Matches[i].IsEmpty())
+				EvaluatedAutoPaintMatches.Add(AllTilePositions[i], MoveTemp(Matches[i]));
+		}
+	}
+	AutoPaintDirtyPositions.Reset();
+	EvaluatedAutoPaintRules = TArray<TWeakObjectPtr<UAutoPaintItemRule>>(Rules);
+	EvaluatedRuleVersion = ActiveAutoPaintRule->GetRuleVersion();
+	EvaluatedMinBoundary = MinBoundary;
+	EvaluatedMaxBoundary = MaxBoundary;
+	IsAutoPaintEvaluationValid = true;
+
+	// keep the tile ordering, space checking below depends on it
+	for (const auto& [TilePosition, Matches] : EvaluatedAutoPaintMatches)
+	{
+		ActiveAutoPaintRule->MatchData.Append(Matches);
+	}
 
-	TArray<FIntVector> HasSpawnedBlockPositions;
-	TArray<FIntVector> HasSpawnedFloorPositions;
-	TArray<FTiledLevelEdge> HasSpawnedWallPositions;
-	TArray<FTiledLevelEdge> HasSpawnedEdgePositions;
-	TArray<FIntVector> HasSpawnedPillarPositions;
-	TArray<FIntVector> HasSpawnedPointPositions;
+	TSet<FIntVector> HasSpawnedBlockPositions;
+	TSet<FIntVector> HasSpawnedFloorPositions;
+	TSet<FTiledLevelEdge> HasSpawnedWallPositions;
+	TSet<FTiledLevelEdge> HasSpawnedEdgePositions;
+	TSet<FIntVector> HasSpawnedPillarPositions;
+	TSet<FIntVector> HasSpawnedPointPositions;
 
 	// structure type checking...
 	/*
@@ -1027,53 +1265,57 @@ void UTiledLevelAsset::CollectAutoPaintPlacements(TArray<FAutoPaintPlacement_Til
 		case EPlacedType::Block:
 		{
 			FTilePlacement* TP = static_cast<FTilePlacement*>(P);
-			for (FIntVector Pos : TP->GetOccupiedTilePositions())
+			const TArray<FIntVector> Occupied = TP->GetOccupiedTilePositions();
+			for (const FIntVector& Pos : Occupied)
 			{
 				if (HasSpawnedBlockPositions.Contains(Pos))
 				{
 					return false;
 				}
 			}
-			HasSpawnedBlockPositions.Append(TP->GetOccupiedTilePositions());
+			HasSpawnedBlockPositions.Append(Occupied);
 			return true;
 		}
 		case EPlacedType::Floor:
 		{
 			FTilePlacement* TP = static_cast<FTilePlacement*>(P);
-			for (FIntVector Pos : TP->GetOccupiedTilePositions())
+			const TArray<FIntVector> Occupied = TP->GetOccupiedTilePositions();
+			for (const FIntVector& Pos : Occupied)
 			{
 				if (HasSpawnedFloorPositions.Contains(Pos))
 				{
 					return false;
 				}
 			}
-			HasSpawnedFloorPositions.Append(TP->GetOccupiedTilePositions());
+			HasSpawnedFloorPositions.Append(Occupied);
 			return true;
 		}
 		case EPlacedType::Wall:
 		{
 			FEdgePlacement* EP = static_cast<FEdgePlacement*>(P);
-			for (FTiledLevelEdge Pos : EP->GetOccupiedEdges(EP->GetItem()->Extent))
+			const TArray<FTiledLevelEdge> Occupied = EP->GetOccupiedEdges(EP->GetItem()->Extent);
+			for (const FTiledLevelEdge& Pos : Occupied)
 			{
 				if (HasSpawnedWallPositions.Contains(Pos))
 				{
 					return false;
 				}
 			}
-			HasSpawnedWallPositions.Append(EP->GetOccupiedEdges(EP->GetItem()->Extent));
+			HasSpawnedWallPositions.Append(Occupied);
 			return true;
 		}
 		case EPlacedType::Edge:
 		{
 			FEdgePlacement* EP = static_cast<FEdgePlacement*>(P);
-			for (FTiledLevelEdge Pos : EP->GetOccupiedEdges(EP->GetItem()->Extent))
+			const TArray<FTiledLevelEdge> Occupied = EP->GetOccupiedEdges(EP->GetItem()->Extent);
+			for (const FTiledLevelEdge& Pos : Occupied)
 			{
 				if (HasSpawnedEdgePositions.Contains(Pos))
 				{
 					return false;
 				}
 			}
-			HasSpawnedEdgePositions.Append(EP->GetOccupiedEdges(EP->GetItem()->Extent));
+			HasSpawnedEdgePositions.Append(Occupied);
 			return true;
 		}
 		case EPlacedType::Pillar:
@@ -1100,7 +1342,7 @@ void UTiledLevelAsset::CollectAutoPaintPlacements(TArray<FAutoPaintPlacement_Til
 		return false;	
 	};
 	
-	for (auto D : ActiveAutoPaintRule->MatchData)
+	for (const FAutoPaintMatchData& D : ActiveAutoPaintRule->MatchData)
 	{
 		UTiledLevelItem* Item = ActiveItemSet->GetItem(D.ToPaint);
 		if (!Item)
@@ -1109,6 +1351,19 @@ void UTiledLevelAsset::CollectAutoPaintPlacements(TArray<FAutoPaintPlacement_Til
 			ERROR_LOG("Changing the valid source item set may fix it!")
 			continue;
 		}
+		// cached match data may outlive the rule and the spawn map it points to, look it up again
+		const UAutoPaintItemRule* BaseRule = D.BaseRulePtr.Get();
+		if (!BaseRule) continue;
+		const FAutoPaintSpawnAdjustment* SpawnAdj = nullptr;
+		for (const auto& [SpawnKey, Adj] : BaseRule->AutoPaintItemSpawns)
+		{
+			if (FGuid(SpawnKey.TiledItemID) == D.ToPaint)
+			{
+				SpawnAdj = &Adj;
+				break;
+			}
+		}
+		if (!SpawnAdj) continue;
 		FTilePlacement NewTile;
 		FEdgePlacement NewEdge;
 		FPointPlacement NewPoint;
@@ -1138,8 +1393,8 @@ void UTiledLevelAsset::CollectAutoPaintPlacements(TArray<FAutoPaintPlacement_Til
 			if (Item->StructureType == ETLStructureType::Structure)
 				HasEnoughSpace = CheckSpace(Item->PlacedType, &NewTile);
 			if (HasEnoughSpace)
-				OutTiles.Add(FAutoPaintPlacement_Tile(NewTile, D.RotateTimes, D.SpawnAdj->TransformAdjustment,
-												 D.SpawnAdj->MirrorX, D.SpawnAdj->MirrorY, D.SpawnAdj->MirrorZ));
+				OutTiles.Add(FAutoPaintPlacement_Tile(NewTile, D.RotateTimes, SpawnAdj->TransformAdjustment,
+												 SpawnAdj->MirrorX, SpawnAdj->MirrorY, SpawnAdj->MirrorZ));
 			break;
 		case Shape2D:
 			NewEdge.Edge = FTiledLevelEdge(
@@ -1148,16 +1403,16 @@ void UTiledLevelAsset::CollectAutoPaintPlacements(TArray<FAutoPaintPlacement_Til
 			if (Item->StructureType == ETLStructureType::Structure)
 				HasEnoughSpace = CheckSpace(Item->PlacedType, &NewEdge);
 			if (HasEnoughSpace)
-				OutEdges.Add(FAutoPaintPlacement_Edge(NewEdge,D.RotateTimes, D.SpawnAdj->TransformAdjustment,
-					D.SpawnAdj->MirrorX, D.SpawnAdj->MirrorY, D.SpawnAdj->MirrorZ));
+				OutEdges.Add(FAutoPaintPlacement_Edge(NewEdge,D.RotateTimes, SpawnAdj->TransformAdjustment,
+					SpawnAdj->MirrorX, SpawnAdj->MirrorY, SpawnAdj->MirrorZ));
 			break;
 		case Shape1D:
 			NewPoint.GridPosition = D.MetPos + D.PosOffset;
 			if (Item->StructureType == ETLStructureType::Structure)
 				HasEnoughSpace = CheckSpace(Item->PlacedType, &NewPoint);
 			if (HasEnoughSpace)
-				OutPoints.Add(FAutoPaintPlacement_Point(NewPoint,D.RotateTimes, D.SpawnAdj->TransformAdjustment,
-					D.SpawnAdj->MirrorX, D.SpawnAdj->MirrorY, D.SpawnAdj->MirrorZ));
+				OutPoints.Add(FAutoPaintPlacement_Point(NewPoint,D.RotateTimes, SpawnAdj->TransformAdjustment,
+					SpawnAdj->MirrorX, SpawnAdj->MirrorY, SpawnAdj->MirrorZ));
 			break;
 		default: break;
 		}
@@ -1167,6 +1422,94 @@ void UTiledLevelAsset::CollectAutoPaintPlacements(TArray<FAutoPaintPlacement_Til
 	OutPoints.Sort();
 }
 
+void UTiledLevelAsset::EvaluateAutoPaint(const TArray<FIntVector>& TilePositions, const TArray<UAutoPaintItemRule*>& Rules,
+	const FIntVector& MinBoundary, const FIntVector& MaxBoundary, int32 RandomSeed, TArray<TArray<FAutoPaintMatchData>>& OutMatches) const
+{
+	// the grid only has to cover the evaluated tiles, which are few after a small edit
+	FAutoPaintCodeGrid CodeGrid;
+	if (TilePositions.Num() > 0)
+	{
+		FIntVector RegionMin = TilePositions[0];
+		FIntVector RegionMax = TilePositions[0] + FIntVector(1);
+		for (const FIntVector& P : TilePositions)
+		{
+			RegionMin = FIntVector(FMath::Min(RegionMin.X, P.X), FMath::Min(RegionMin.Y, P.Y), FMath::Min(RegionMin.Z, P.Z));
+			RegionMax = FIntVector(FMath::Max(RegionMax.X, P.X + 1), FMath::Max(RegionMax.Y, P.Y + 1), FMath::Max(RegionMax.Z, P.Z + 1));
+		}
+		CodeGrid.Init(AutoPaintData, MinBoundary, MaxBoundary, RegionMin, RegionMax);
+	}
+	TArray<FAutoPaintCompiledRule> CompiledRules;
+	CompiledRules.Reserve(Rules.Num());
+	for (UAutoPaintItemRule* R : Rules)
+		CompiledRules.Add(FAutoPaintCompiledRule::Compile(R, CodeGrid));
+
+	// each tile writes its own slot, the caller merges them in tile order
+	OutMatches.SetNum(TilePositions.Num());
+	ParallelFor(TilePositions.Num(), [&](int32 i)
+	{
+		EvaluateAutoPaintAt(TilePositions[i], CompiledRules, CodeGrid, MinBoundary, MaxBoundary, RandomSeed, OutMatches[i]);
+	});
+}
+
+void UTiledLevelAsset::EvaluateAutoPaintAt(const FIntVector& TilePosition, const TArray<FAutoPaintCompiledRule>& Rules,
+	const FAutoPaintCodeGrid& CodeGrid, const FIntVector& MinBoundary, const FIntVector& MaxBoundary, int32 RandomSeed,
+	TArray<FAutoPaintMatchData>& OutMatches) const
+{
+	const FRandomStream Random(static_cast<int32>(HashCombine(GetTypeHash(TilePosition), static_cast<uint32>(RandomSeed))));
+	for (const FAutoPaintCompiledRule& Compiled : Rules)
+	{
+		UAutoPaintItemRule* R = Compiled.Rule;
+		bool IsRuleMet = false;
+		auto AddMatch = [&](EDuplicationType D)
+		{
+			FTiledItemObj SpawnID = R->PickWhatToSpawn(Random);
+			// may become empty when item set is changed...
+			if (SpawnID.TiledItemID.IsEmpty()) return;
+			FDuplicationMod DMod = UAutoPaintRule::GetDuplicationMod(D, FTiledLevelUtility::PlacedTypeToShape(R->PlacedType),
+				R->AutoPaintItemSpawns[SpawnID].RotationTimes, R->PositionOffset);
+			FAutoPaintMatchData Data;
+			Data.DupType = D;
+			Data.MetPos = TilePosition;
+			Data.ToPaint = FGuid(SpawnID.TiledItemID);
+			Data.PosOffset = DMod.PosOffset;
+			Data.RotateTimes = DMod.RotationTimes;
+			Data.BaseRulePtr = R;
+			OutMatches.Add(Data);
+			IsRuleMet = true;
+		};
+		if (Compiled.bCompiled)
+		{
+			for (const FAutoPaintCompiledRule::FVariant& Variant : Compiled.Variants)
+			{
+				if (Compiled.IsMet(Variant, TilePosition, CodeGrid, Random))
+					AddMatch(Variant.DupType);
+			}
+		}
+		else
+		{
+			for (EDuplicationType D: R->GetDuplicateCases())
+			{
+				if (UAutoPaintRule::IsRuleMet(R, D, TilePosition, AutoPaintData, MinBoundary, MaxBoundary, Random))
+					AddMatch(D);
+			}
+		}
+		if (IsRuleMet && R->bStopOnMet)
+			break;
+	}
+}
+
+void UTiledLevelAsset::MarkAutoPaintDataDirty(const FIntVector& Position)
+{
+	if (IsAutoPaintEvaluationValid)
+		AutoPaintDirtyPositions.Add(Position);
+}
+
+void UTiledLevelAsset::InvalidateAutoPaintEvaluation()
+{
+	IsAutoPaintEvaluationValid = false;
+	AutoPaintDirtyPositions.Empty();
+}
+
 FAutoPaintItem UTiledLevelAsset::GetAutoPaintItemRule(const FName& QueryName)
 {
 	if (ActiveAutoPaintRule && ActiveAutoPaintRule->Items.Contains(QueryName))
@@ -1185,6 +1528,7 @@ void UTiledLevelAsset::ClearAutoPaintDataForFloor(int InFloorPosition)
 	{
 		if (It.Key().Z == InFloorPosition)
 		{
+			MarkAutoPaintDataDirty(It.Key());
 			It.RemoveCurrent();
 			HasRemoveAny = true;
 		}
@@ -1300,8 +1644,10 @@ void UTiledLevelAsset::ConvertAutoPlacementsToNormal()
 				Floor.PointPlacements.Add(P);
 		}
 		Floor.AutoPaintGenPoints.Empty();
+		Floor.MarkIndexDirty();
 	}
 	AutoPaintData.Empty();
+	InvalidateAutoPaintEvaluation();
 }
 
 void UTiledLevelAsset::OnAutoPaintItemChanged(const FAutoPaintItem& Old, const FAutoPaintItem& New)
@@ -1309,7 +1655,10 @@ void UTiledLevelAsset::OnAutoPaintItemChanged(const FAutoPaintItem& Old, const F
 	for (auto& [k, v] : AutoPaintData)
 	{
 		if (v == Old.ItemName)
+		{
 			v = New.ItemName;
+			MarkAutoPaintDataDirty(k);
+		}
 	}
 }
 
@@ -1322,7 +1671,10 @@ void UTiledLevelAsset::OnAutoPaintItemRemoved(const FName& ToRemove)
 			KeysToRemove.Add(k);
 	}
 	for (auto k : KeysToRemove)
+	{
 		AutoPaintData.Remove(k);
+		MarkAutoPaintDataDirty(k);
+	}
 }
 
 
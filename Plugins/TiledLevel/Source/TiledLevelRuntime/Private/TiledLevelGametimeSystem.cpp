@@ -4,7 +4,6 @@
 #include "TiledLevel.h"
 #include "TiledLevelEditorHelper.h"
 #include "TiledLevelEditorLog.h"
-#include "TiledLevelRestrictionHelper.h"
 #include "TiledLevelUtility.h"
 #include "DrawDebugHelpers.h"
 #include "TiledLevelItem.h"
@@ -378,25 +377,16 @@ void UTiledLevelGametimeSystem:: BuildItem()
 
 	switch (ShapeType) {
 		case Shape3D:
-			if (ActiveItem->PlacedType == EPlacedType::Block)
-				GametimeData.BlockPlacements.Add(NewTile);
-			else
-				GametimeData.FloorPlacements.Add(NewTile);
+			GametimeData.AddPlacement(NewTile);
 			GametimeLevel->PopulateSinglePlacement(NewTile);
 			break;
 		case Shape2D:
-			if (ActiveItem->PlacedType == EPlacedType::Edge)
-				GametimeData.EdgePlacements.Add(NewEdge);
-			else
-				GametimeData.WallPlacements.Add(NewEdge);
+			GametimeData.AddPlacement(NewEdge);
 			GametimeLevel->PopulateSinglePlacement(NewEdge);
 			break;
 		case Shape1D:
 			// TargetLevel->GetAsset()->AddNewPointPlacement(NewPoint);
-			if (ActiveItem->PlacedType == EPlacedType::Point)
-				GametimeData.PointPlacements.Add(NewPoint);
-			else
-				GametimeData.PillarPlacements.Add(NewPoint);
+			GametimeData.AddPlacement(NewPoint);
 			GametimeLevel->PopulateSinglePlacement(NewPoint);
 			break;
 	}
@@ -467,6 +457,7 @@ bool UTiledLevelGametimeSystem::RemoveItem_FromHit(const FHitResult& HitResult)
 		HISM->GetInstanceTransform(HitResult.Item, PlacedTransform);
 		GametimeData.RemovePlacement(PlacedTransform, HitItem->ItemID);
 		// remove that instance
+		GametimeLevel->InstanceIndex.RemoveInstances(HISM, { HitResult.Item });
 		HISM->RemoveInstance(HitResult.Item);
 		OnItemRemoved.Broadcast(HitItem, BuildPosition);
 		return true;
@@ -654,33 +645,30 @@ void UTiledLevelGametimeSystem::EraseItem()
 		FTilePlacement TestPlacement;
 		TestPlacement.GridPosition = CurrentTilePosition;
 		TestPlacement.Extent = EraserExtent;
+		const FTiledOccupancyGrid& Occupancy = GametimeData.GetOccupancy();
 		if (EraserType == EPlacedType::Any)
 		{
-			TargetTilePlacements.Append(GametimeData.BlockPlacements);
-			TargetTilePlacements.Append(GametimeData.FloorPlacements);
+			TargetTilePlacements.Append(Occupancy.FindOverlapping(EPlacedType::Block, TestPlacement));
+			TargetTilePlacements.Append(Occupancy.FindOverlapping(EPlacedType::Floor, TestPlacement));
 		}
 		else if (EraserType == EPlacedType::Block)
-			TargetTilePlacements.Append(GametimeData.BlockPlacements);
+			TargetTilePlacements.Append(Occupancy.FindOverlapping(EPlacedType::Block, TestPlacement));
 		else
-			TargetTilePlacements.Append(GametimeData.FloorPlacements);
+			TargetTilePlacements.Append(Occupancy.FindOverlapping(EPlacedType::Floor, TestPlacement));
+		// all of them overlap the eraser already
 		for (FTilePlacement& Placement : TargetTilePlacements)
 		{
-			
-			if (FTiledLevelUtility::IsTilePlacementOverlapping(TestPlacement, Placement))
+			TilesToDelete.Add(Placement);
+			if (Placement.GetItem()->SourceType == ETLSourceType::Actor || Placement.IsMirrored)
 			{
-				TilesToDelete.Add(Placement);
-				if (Placement.GetItem()->SourceType == ETLSourceType::Actor || Placement.IsMirrored)
-				{
-					GametimeLevel->DestroyTiledActorByPlacement(Placement);
-				}
-				else
-				{
-					 UStaticMesh* TiledMesh = Placement.GetItem()->TiledMesh;
-					 if (!TargetInstanceData.Contains(TiledMesh))				
-						  TargetInstanceData.Add(TiledMesh, TArray<int32>{});
-					 TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-					 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh],GametimeLevel->TiledObjectSpawner[TiledMesh]->PerInstanceSMCustomData, TargetInfo);
-				}
+				GametimeLevel->DestroyTiledActorByPlacement(Placement);
+			}
+			else
+			{
+				 UStaticMesh* TiledMesh = Placement.GetItem()->TiledMesh;
+				 if (!TargetInstanceData.Contains(TiledMesh))				
+					  TargetInstanceData.Add(TiledMesh, TArray<int32>{});
+				 FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh], GametimeLevel->InstanceIndex, GametimeLevel->TiledObjectSpawner[TiledMesh], FTiledInstanceKey(Placement));
 			}
 		}
 	}
@@ -688,35 +676,30 @@ void UTiledLevelGametimeSystem::EraseItem()
 	if (EraserShape == EPlacedShapeType::Shape2D || EraserType == EPlacedType::Any)
 	{
 		 TArray<FEdgePlacement> TargetEdgePlacements;
+		 const FTiledOccupancyGrid& Occupancy = GametimeData.GetOccupancy();
 		 if (EraserType == EPlacedType::Any)
 		 {
-			  TargetEdgePlacements.Append(GametimeData.WallPlacements);
-			  TargetEdgePlacements.Append(GametimeData.EdgePlacements);
+			  TargetEdgePlacements.Append(Occupancy.FindEdgesInsideTile(EPlacedType::Wall, CurrentTilePosition, EraserExtent));
+			  TargetEdgePlacements.Append(Occupancy.FindEdgesInsideTile(EPlacedType::Edge, CurrentTilePosition, EraserExtent));
 		 }
 		 else if (EraserType == EPlacedType::Wall)
-			  TargetEdgePlacements.Append(GametimeData.WallPlacements);
+			  TargetEdgePlacements.Append(Occupancy.FindOverlapping(EPlacedType::Wall, CurrentEdge, FVector(EraserExtent)));
 		 else
-			  TargetEdgePlacements.Append(GametimeData.EdgePlacements);
+			  TargetEdgePlacements.Append(Occupancy.FindOverlapping(EPlacedType::Edge, CurrentEdge, FVector(EraserExtent)));
+		 // all of them touch the eraser already
 		 for (FEdgePlacement& Placement : TargetEdgePlacements)
 		 {
-		 	  bool Con = EraserType == EPlacedType::Any?
-			 	  FTiledLevelUtility::IsEdgeInsideTile(Placement.Edge, FIntVector(Placement.GetItem()->Extent), CurrentTilePosition, EraserExtent) :
-			      FTiledLevelUtility::IsEdgeOverlapping(CurrentEdge, FVector(EraserExtent), Placement.Edge, Placement.GetItem()->Extent);
-			  if (Con)
+			  EdgesToDelete.Add(Placement);
+			  if (Placement.GetItem()->SourceType == ETLSourceType::Actor || Placement.IsMirrored)
+			  {
+				   GametimeLevel->DestroyTiledActorByPlacement(Placement);
+			  }
+			  else
 			  {
-				  EdgesToDelete.Add(Placement);
-				  if (Placement.GetItem()->SourceType == ETLSourceType::Actor || Placement.IsMirrored)
-				  {
-					   GametimeLevel->DestroyTiledActorByPlacement(Placement);
-				  }
-				  else
-				  {
-						UStaticMesh* TiledMesh = Placement.GetItem()->TiledMesh;
-						if (!TargetInstanceData.Contains(TiledMesh))				
-							  TargetInstanceData.Add(TiledMesh, TArray<int32>{});
-						TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-						FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh],GametimeLevel->TiledObjectSpawner[TiledMesh]->PerInstanceSMCustomData, TargetInfo);
-				  }
+					UStaticMesh* TiledMesh = Placement.GetItem()->TiledMesh;
+					if (!TargetInstanceData.Contains(TiledMesh))				
+						  TargetInstanceData.Add(TiledMesh, TArray<int32>{});
+					FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh], GametimeLevel->InstanceIndex, GametimeLevel->TiledObjectSpawner[TiledMesh], FTiledInstanceKey(Placement));
 			  }
 		 }
 	}
@@ -726,38 +709,30 @@ void UTiledLevelGametimeSystem::EraseItem()
 		 TArray<FPointPlacement> TargetPointPlacements;
 		 FPointPlacement TestPlacement;
 		 TestPlacement.GridPosition = CurrentTilePosition;
+		 const FTiledOccupancyGrid& Occupancy = GametimeData.GetOccupancy();
 		 if (EraserType == EPlacedType::Any)
 		 {
-			  TargetPointPlacements.Append(GametimeData.PillarPlacements);
-			  TargetPointPlacements.Append(GametimeData.PointPlacements);
+			  TargetPointPlacements.Append(Occupancy.FindPointsInsideTile(EPlacedType::Pillar, CurrentTilePosition, EraserExtent));
+			  TargetPointPlacements.Append(Occupancy.FindPointsInsideTile(EPlacedType::Point, CurrentTilePosition, EraserExtent));
 		 }
 		 else if (EraserType == EPlacedType::Pillar)
-			  TargetPointPlacements.Append(GametimeData.PillarPlacements);
+			  TargetPointPlacements.Append(Occupancy.FindOverlapping(EPlacedType::Pillar, TestPlacement, EraserExtent.Z));
 		 else
-			  TargetPointPlacements.Append(GametimeData.PointPlacements);
+			  TargetPointPlacements.Append(Occupancy.FindOverlapping(EPlacedType::Point, TestPlacement, EraserExtent.Z));
+		 // all of them touch the eraser already
 		 for (FPointPlacement& Placement : TargetPointPlacements)
 		 {
-		 	  bool Con;
-		 	  if (EraserType == EPlacedType::Any)
-		 	  	  Con = FTiledLevelUtility::IsPointInsideTile(Placement.GridPosition, Placement.GetItem()->Extent.Z, CurrentTilePosition, EraserExtent);
-		 	  else
-			      Con = FTiledLevelUtility::IsPointPlacementOverlapping(TestPlacement, EraserExtent.Z, Placement, Placement.GetItem()->Extent.Z);
-		 	
-		 	  if (Con)
+			  PointsToDelete.Add(Placement);
+			  if (Placement.GetItem()->SourceType == ETLSourceType::Actor || Placement.IsMirrored)
 			  {
-				  PointsToDelete.Add(Placement);
-				  if (Placement.GetItem()->SourceType == ETLSourceType::Actor || Placement.IsMirrored)
-				  {
-					   GametimeLevel->DestroyTiledActorByPlacement(Placement);
-				  }
-				  else
-				  {
-						UStaticMesh* TiledMesh = Placement.GetItem()->TiledMesh;
-						if (!TargetInstanceData.Contains(TiledMesh))				
-							  TargetInstanceData.Add(TiledMesh, TArray<int32>{});
-						TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
-						FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh],GametimeLevel->TiledObjectSpawner[TiledMesh]->PerInstanceSMCustomData, TargetInfo);
-				  }
+				   GametimeLevel->DestroyTiledActorByPlacement(Placement);
+			  }
+			  else
+			  {
+					UStaticMesh* TiledMesh = Placement.GetItem()->TiledMesh;
+					if (!TargetInstanceData.Contains(TiledMesh))				
+						  TargetInstanceData.Add(TiledMesh, TArray<int32>{});
+					FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[TiledMesh], GametimeLevel->InstanceIndex, GametimeLevel->TiledObjectSpawner[TiledMesh], FTiledInstanceKey(Placement));
 			  }
 		 }
 	}
@@ -1052,35 +1027,25 @@ bool UTiledLevelGametimeSystem::HasEnoughSpaceToBuild()
 {
 	if (!IsPreviewItemActivated()) return false;
 	
-	TArray<ATiledLevelRestrictionHelper*> Restrictions;
-	for (AActor* A : GametimeLevel->SpawnedTiledActors)
-	{
-		if (ATiledLevelRestrictionHelper* Arh = Cast<ATiledLevelRestrictionHelper>(A))
-		{
-			Restrictions.Add(Arh);
-		}
-	}
 	TArray<FIntVector> PointsToCheck;
 	if (ActiveItem->PlacedType == EPlacedType::Edge ||ActiveItem->PlacedType == EPlacedType::Wall)
 		PointsToCheck = FTiledLevelUtility::GetOccupiedPositions(ActiveItem, CurrentEdge);
 	else
 		PointsToCheck = FTiledLevelUtility::GetOccupiedPositions(ActiveItem, CurrentTilePosition, ShouldRotatePreviewBrush);
+	TArray<UTiledLevelRestrictionItem*> Restrictions = GetRestrictionsAt(PointsToCheck);
 	
 	if (bLockBuild)
 	{
 		bool bPassBlockBuild = false;
 		// check if it is explicitly allowed building here 
-		for (ATiledLevelRestrictionHelper* Arh : Restrictions)
+		for (UTiledLevelRestrictionItem* Restriction : Restrictions)
 		{
-			if (Arh->GetSourceItem()->RestrictionType == ERestrictionType::AllowBuilding || Arh->GetSourceItem()->RestrictionType == ERestrictionType::AllowBuildingAndRemoving)
+			if (Restriction->RestrictionType == ERestrictionType::AllowBuilding || Restriction->RestrictionType == ERestrictionType::AllowBuildingAndRemoving)
 			{
-				if (Arh->GetSourceItem()->bTargetAllItems || Arh->GetSourceItem()->TargetItems.Contains(ActiveItem->ItemID))
+				if (Restriction->bTargetAllItems || Restriction->TargetItems.Contains(ActiveItem->ItemID))
 				{
-					if (Arh->IsInsideTargetedTilePositions(PointsToCheck))
-					{
-						bPassBlockBuild = true;
-						break;
-					}
+					bPassBlockBuild = true;
+					break;
 				}
 			}
 		}
@@ -1090,17 +1055,17 @@ bool UTiledLevelGametimeSystem::HasEnoughSpaceToBuild()
 	else
 	{
 		// check if it is explicitly freeze building here
-		for (ATiledLevelRestrictionHelper* Arh : Restrictions)
+		for (UTiledLevelRestrictionItem* Restriction : Restrictions)
 		{
-			if (Arh->GetSourceItem()->RestrictionType == ERestrictionType::DisallowBuilding || Arh->GetSourceItem()->RestrictionType == ERestrictionType::DisallowBuildingAndRemoving)
+			if (Restriction->RestrictionType == ERestrictionType::DisallowBuilding || Restriction->RestrictionType == ERestrictionType::DisallowBuildingAndRemoving)
 			{
-				if (Arh->GetSourceItem()->bTargetAllItems || Arh->GetSourceItem()->TargetItems.Contains(ActiveItem->ItemID))
-					if (Arh->IsInsideTargetedTilePositions(PointsToCheck))
-						return false;
+				if (Restriction->bTargetAllItems || Restriction->TargetItems.Contains(ActiveItem->ItemID))
+					return false;
 			}
 		}
 	}
 	
+	const FTiledOccupancyGrid& Occupancy = GametimeData.GetOccupancy();
 	EPlacedShapeType ActiveShape = FTiledLevelUtility::PlacedTypeToShape(ActiveItem->PlacedType);
 	switch (ActiveShape)
 	{
@@ -1113,19 +1078,16 @@ bool UTiledLevelGametimeSystem::HasEnoughSpaceToBuild()
 			TArray<FTilePlacement> OverlappingPlacements;
 			if (ActiveItem->PlacedType == EPlacedType::Block)
 			{
-				OverlappingPlacements = GametimeData.BlockPlacements.FilterByPredicate([=](const FTilePlacement& Block)
+				OverlappingPlacements = Occupancy.FindOverlapping(EPlacedType::Block, TestPlacement);
+				// exclude special helpers from including as overlapped...
+				OverlappingPlacements.RemoveAll([](const FTilePlacement& Block)
 				{
-					 // exclude special helpers from including as overlapped...
-					 if (Cast<UTiledLevelRestrictionItem>(Block.GetItem())) return false;
-					 return FTiledLevelUtility::IsTilePlacementOverlapping(TestPlacement, Block);
+					 return Cast<UTiledLevelRestrictionItem>(Block.GetItem()) != nullptr;
 				});
 			}
 			else
 			{
-				OverlappingPlacements = GametimeData.FloorPlacements.FilterByPredicate([=](const FTilePlacement& Floor)
-				{
-					 return FTiledLevelUtility::IsTilePlacementOverlapping(TestPlacement, Floor);
-				});
+				OverlappingPlacements = Occupancy.FindOverlapping(EPlacedType::Floor, TestPlacement);
 			}
 			if (OverlappingPlacements.Num() == 0)
 				return true;
@@ -1147,17 +1109,11 @@ bool UTiledLevelGametimeSystem::HasEnoughSpaceToBuild()
 			TArray<FEdgePlacement> OverlappingPlacements;
 			if (ActiveItem->PlacedType == EPlacedType::Wall)
 			{
-				OverlappingPlacements = GametimeData.WallPlacements.FilterByPredicate([=](const FEdgePlacement& Wall)
-				{
-						 return FTiledLevelUtility::IsEdgePlacementOverlapping(TestPlacement, Wall);
-				});
+				OverlappingPlacements = Occupancy.FindOverlapping(EPlacedType::Wall, TestPlacement);
 			}
 			else
 			{
-				OverlappingPlacements = GametimeData.EdgePlacements.FilterByPredicate([=](const FEdgePlacement& Edge)
-				{
-						 return FTiledLevelUtility::IsEdgePlacementOverlapping(TestPlacement, Edge);
-				});
+				OverlappingPlacements = Occupancy.FindOverlapping(EPlacedType::Edge, TestPlacement);
 			}
 			if (OverlappingPlacements.Num() == 0)
 				return true;
@@ -1177,17 +1133,11 @@ bool UTiledLevelGametimeSystem::HasEnoughSpaceToBuild()
 			TArray<FPointPlacement> OverlappingPlacements;
 			if (ActiveItem->PlacedType == EPlacedType::Pillar)
 			{
-			   OverlappingPlacements = GametimeData.PillarPlacements.FilterByPredicate([=](const FPointPlacement& Pillar)
-			   {
-			   		return FTiledLevelUtility::IsPointPlacementOverlapping(TestPlacement, ActiveItem->Extent.Z, Pillar, Pillar.GetItem()->Extent.Z );
-			   });
+			   OverlappingPlacements = Occupancy.FindOverlapping(EPlacedType::Pillar, TestPlacement, ActiveItem->Extent.Z);
 			}
 			else
 			{
-			   OverlappingPlacements = GametimeData.PointPlacements.FilterByPredicate([=](const FPointPlacement& Point)
-			   {
-			   		return FTiledLevelUtility::IsPointPlacementOverlapping(TestPlacement, ActiveItem->Extent.Z, Point, Point.GetItem()->Extent.Z);
-			   });
+			   OverlappingPlacements = Occupancy.FindOverlapping(EPlacedType::Point, TestPlacement, ActiveItem->Extent.Z);
 			}
 			if (OverlappingPlacements.Num() == 0)
 				return true;
@@ -1207,51 +1157,53 @@ bool UTiledLevelGametimeSystem::HasEnoughSpaceToBuild()
 
 bool UTiledLevelGametimeSystem::IsRemoveRestricted(UTiledLevelItem* TestItem, FVector HitPosition)
 {
-	TArray<ATiledLevelRestrictionHelper*> Restrictions;
- 	for (AActor* A : GametimeLevel->SpawnedTiledActors)
- 	{
- 		if (ATiledLevelRestrictionHelper* Arh = Cast<ATiledLevelRestrictionHelper>(A))
- 		{
- 			Restrictions.Add(Arh);
- 		}
- 	}
 	const int X_mod = HitPosition.X < 0? -1 : 0;
 	const int Y_mod = HitPosition.Y < 0? -1 : 0;
 	const int Z_mod = HitPosition.Z < 0? -1 : 0;
 	const FIntVector PointToCheck = FIntVector(HitPosition / TileSize) + FIntVector(X_mod, Y_mod, Z_mod);
- 	TArray<FIntVector> PointsToCheck = { PointToCheck };
+	TArray<UTiledLevelRestrictionItem*> Restrictions = GetRestrictionsAt({ PointToCheck });
  	if (bLockRemove)
  	{
  		// check if it is explicitly allowed removing here 
- 		for (ATiledLevelRestrictionHelper* Arh : Restrictions)
+ 		for (UTiledLevelRestrictionItem* Restriction : Restrictions)
  		{
- 			if (Arh->GetSourceItem()->RestrictionType == ERestrictionType::AllowRemoving || Arh->GetSourceItem()->RestrictionType == ERestrictionType::AllowBuildingAndRemoving)
+ 			if (Restriction->RestrictionType == ERestrictionType::AllowRemoving || Restriction->RestrictionType == ERestrictionType::AllowBuildingAndRemoving)
  			{
- 				if (Arh->GetSourceItem()->bTargetAllItems || Arh->GetSourceItem()->TargetItems.Contains(TestItem->ItemID))
+ 				if (Restriction->bTargetAllItems || Restriction->TargetItems.Contains(TestItem->ItemID))
  				{
-					 if (Arh->IsInsideTargetedTilePositions(PointsToCheck))
-					 {
-						   return false;
-					 }
+					 return false;
  				}
  			}
  		}
  		return true;
  	}
  	// check if it is explicitly freeze removing here
- 	for (ATiledLevelRestrictionHelper* Arh : Restrictions)
+ 	for (UTiledLevelRestrictionItem* Restriction : Restrictions)
  	{
- 		if (Arh->GetSourceItem()->RestrictionType == ERestrictionType::DisallowRemoving || Arh->GetSourceItem()->RestrictionType == ERestrictionType::DisallowBuildingAndRemoving)
+ 		if (Restriction->RestrictionType == ERestrictionType::DisallowRemoving || Restriction->RestrictionType == ERestrictionType::DisallowBuildingAndRemoving)
  		{
- 			if (Arh->IsInsideTargetedTilePositions(PointsToCheck))
- 			{
- 				return true;
- 			}
+ 			return true;
  		}
  	}
 	return false;
 }
 
+TArray<UTiledLevelRestrictionItem*> UTiledLevelGametimeSystem::GetRestrictionsAt(const TArray<FIntVector>& PositionsToCheck)
+{
+	// restriction areas are block placements of the restriction items, same tiles their helper actors display
+	TArray<UTiledLevelRestrictionItem*> OutRestrictions;
+	const FTiledOccupancyGrid& Occupancy = GametimeData.GetOccupancy();
+	for (const FIntVector& P : PositionsToCheck)
+	{
+		for (const FTilePlacement& Block : Occupancy.FindTilesAt(EPlacedType::Block, P))
+		{
+			if (UTiledLevelRestrictionItem* Restriction = Cast<UTiledLevelRestrictionItem>(Block.GetItem()))
+				OutRestrictions.AddUnique(Restriction);
+		}
+	}
+	return OutRestrictions;
+}
+
 FVector UTiledLevelGametimeSystem::GetBuildLocation()
 {
 	if (!IsPreviewItemActivated()) return FVector(-1);
@@ -3,12 +3,22 @@
 #include "TiledLevelTypes.h"
 #include "TiledItemSet.h"
 #include "TiledLevelItem.h"
+#include "TiledLevelUtility.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Algo/Unique.h"
 
 UTiledLevelItem* FItemPlacement::GetItem() const
 {
-	if (ItemSet)
-		return ItemSet->GetItem(ItemID);
-	return nullptr;
+	if (!ItemSet)
+		return nullptr;
+	// ItemSet and ItemID are assigned directly all over the place, so check the id as well as the revision
+	const uint32 Revision = ItemSet->GetItemIndexRevision();
+	if (Revision != CachedItemRevision || !CachedItem || CachedItem->ItemID != ItemID)
+	{
+		CachedItem = ItemSet->GetItem(ItemID);
+		CachedItemRevision = Revision;
+	}
+	return CachedItem;
 }
 
 bool FTilePlacement::IsBlock() const
@@ -17,13 +27,17 @@ bool FTilePlacement::IsBlock() const
 }
 
 #define SEARCH_REMOVE_PLACEMENT(Type)\
-FoundID = Type.IndexOfByPredicate([=](FItemPlacement P) \
+FoundID = Type.IndexOfByPredicate([&](const FItemPlacement& P) \
 {\
 	return P.ItemID == ItemID && P.TileObjectTransform.Equals(CompareTransform); \
 }); \
 if (FoundID != INDEX_NONE) \
 { \
+	const bool bWasSynced = IsOccupancySynced(); \
+	if (bWasSynced) \
+		Occupancy.Remove(Type[FoundID]); \
 	Type.RemoveAt(FoundID);\
+	OnPlacementsChanged(bWasSynced); \
 	return true; \
 }
 
@@ -55,6 +69,44 @@ void FTiledLevelGameData::Empty()
 	EdgePlacements.Empty();
 	PillarPlacements.Empty();
 	PointPlacements.Empty();
+	Occupancy.Reset();
+	OnPlacementsChanged(true);
+}
+
+void FTiledLevelGameData::AddPlacement(const FTilePlacement& NewPlacement)
+{
+	const bool bWasSynced = IsOccupancySynced();
+	if (NewPlacement.IsBlock())
+		BlockPlacements.Add(NewPlacement);
+	else
+		FloorPlacements.Add(NewPlacement);
+	if (bWasSynced)
+		Occupancy.Add(NewPlacement);
+	OnPlacementsChanged(bWasSynced);
+}
+
+void FTiledLevelGameData::AddPlacement(const FEdgePlacement& NewPlacement)
+{
+	const bool bWasSynced = IsOccupancySynced();
+	if (NewPlacement.IsWall())
+		WallPlacements.Add(NewPlacement);
+	else
+		EdgePlacements.Add(NewPlacement);
+	if (bWasSynced)
+		Occupancy.Add(NewPlacement);
+	OnPlacementsChanged(bWasSynced);
+}
+
+void FTiledLevelGameData::AddPlacement(const FPointPlacement& NewPlacement)
+{
+	const bool bWasSynced = IsOccupancySynced();
+	if (NewPlacement.IsPillar())
+		PillarPlacements.Add(NewPlacement);
+	else
+		PointPlacements.Add(NewPlacement);
+	if (bWasSynced)
+		Occupancy.Add(NewPlacement);
+	OnPlacementsChanged(bWasSynced);
 }
 
 bool FTiledLevelGameData::RemovePlacement(FTransform CompareTransform, FGuid ItemID)
@@ -71,55 +123,64 @@ bool FTiledLevelGameData::RemovePlacement(FTransform CompareTransform, FGuid Ite
 
 void FTiledLevelGameData::RemovePlacements(const TArray<FTilePlacement>& ToDelete)
 {
-	BlockPlacements.RemoveAll([=](const FTilePlacement& P)
-	{
-		return ToDelete.Contains(P);
-	});
-	FloorPlacements.RemoveAll([=](const FTilePlacement& P)
+	const bool bWasSynced = IsOccupancySynced();
+	auto ShouldRemove = [&](const FTilePlacement& P)
 	{
-		return ToDelete.Contains(P);
-	});
+		if (!ToDelete.Contains(P)) return false;
+		if (bWasSynced)
+			Occupancy.Remove(P);
+		return true;
+	};
+	BlockPlacements.RemoveAll(ShouldRemove);
+	FloorPlacements.RemoveAll(ShouldRemove);
+	OnPlacementsChanged(bWasSynced);
 }
 
 void FTiledLevelGameData::RemovePlacements(const TArray<FEdgePlacement>& ToDelete)
 {
-	WallPlacements.RemoveAll([=](const FEdgePlacement& P)
+	const bool bWasSynced = IsOccupancySynced();
+	auto ShouldRemove = [&](const FEdgePlacement& P)
 	{
-		return ToDelete.Contains(P);
-	});
-	EdgePlacements.RemoveAll([=](const FEdgePlacement& P)
-	{
-		return ToDelete.Contains(P);
-	});
+		if (!ToDelete.Contains(P)) return false;
+		if (bWasSynced)
+			Occupancy.Remove(P);
+		return true;
+	};
+	WallPlacements.RemoveAll(ShouldRemove);
+	EdgePlacements.RemoveAll(ShouldRemove);
+	OnPlacementsChanged(bWasSynced);
 }
 
 void FTiledLevelGameData::RemovePlacements(const TArray<FPointPlacement>& ToDelete)
 {
-	PillarPlacements.RemoveAll([=](const FPointPlacement& P)
-	{
-		return ToDelete.Contains(P);
-	});
-	PointPlacements.RemoveAll([=](const FPointPlacement& P)
+	const bool bWasSynced = IsOccupancySynced();
+	auto ShouldRemove = [&](const FPointPlacement& P)
 	{
-		return ToDelete.Contains(P);
-	});
+		if (!ToDelete.Contains(P)) return false;
+		if (bWasSynced)
+			Occupancy.Remove(P);
+		return true;
+	};
+	PillarPlacements.RemoveAll(ShouldRemove);
+	PointPlacements.RemoveAll(ShouldRemove);
+	OnPlacementsChanged(bWasSynced);
 }
 
 
 void FTiledLevelGameData::SetFocusFloor(int FloorPosition)
 {
 	HiddenFloors.Empty();
-	for (auto P : BlockPlacements)
+	for (const auto& P : BlockPlacements)
 		HiddenFloors.AddUnique(P.GridPosition.Z);
-	for (auto P : FloorPlacements)
+	for (const auto& P : FloorPlacements)
 		HiddenFloors.AddUnique(P.GridPosition.Z);
-	for (auto P : WallPlacements)
+	for (const auto& P : WallPlacements)
 		HiddenFloors.AddUnique(P.GetEdgePosition().Z);
-	for (auto P : EdgePlacements)
+	for (const auto& P : EdgePlacements)
 		HiddenFloors.AddUnique(P.GetEdgePosition().Z);
-	for (auto P : PillarPlacements)
+	for (const auto& P : PillarPlacements)
 		HiddenFloors.AddUnique(P.GridPosition.Z);
-	for (auto P : PointPlacements)
+	for (const auto& P : PointPlacements)
 		HiddenFloors.AddUnique(P.GridPosition.Z);
 	if (HiddenFloors.Contains(FloorPosition))
 	{
@@ -134,3 +195,555 @@ void FTiledLevelGameData::SetFocusFloor(int FloorPosition)
 		HiddenFloors.Remove(FMath::Min(HiddenFloors));
 	}
 }
+
+int32 FTiledLevelGameData::GetNumOfPlacements() const
+{
+	return BlockPlacements.Num() + FloorPlacements.Num() + WallPlacements.Num() + EdgePlacements.Num() + PillarPlacements.Num() + PointPlacements.Num();
+}
+
+const FTiledOccupancyGrid& FTiledLevelGameData::GetOccupancy()
+{
+	if (!IsOccupancySynced())
+	{
+		Occupancy.Reset();
+		for (const FTilePlacement& P : BlockPlacements)
+			Occupancy.Add(P);
+		for (const FTilePlacement& P : FloorPlacements)
+			Occupancy.Add(P);
+		for (const FEdgePlacement& P : WallPlacements)
+			Occupancy.Add(P);
+		for (const FEdgePlacement& P : EdgePlacements)
+			Occupancy.Add(P);
+		for (const FPointPlacement& P : PillarPlacements)
+			Occupancy.Add(P);
+		for (const FPointPlacement& P : PointPlacements)
+			Occupancy.Add(P);
+		OnPlacementsChanged(true);
+	}
+	return Occupancy;
+}
+
+bool FTiledLevelGameData::IsOccupancySynced() const
+{
+	// the count still catches most edits made straight to the arrays without MarkPlacementsChanged
+	return OccupancyVersion == PlacementsVersion && Occupancy.Num() == GetNumOfPlacements();
+}
+
+void FTiledLevelGameData::OnPlacementsChanged(bool bOccupancyUpdated)
+{
+	PlacementsVersion++;
+	if (bOccupancyUpdated)
+		OccupancyVersion = PlacementsVersion;
+}
+
+FTiledInstanceKey::FTiledInstanceKey(const float* CustomData)
+	: Position(FMath::RoundToInt(CustomData[0]), FMath::RoundToInt(CustomData[1]), FMath::RoundToInt(CustomData[2])),
+	  Extent(FMath::RoundToInt(CustomData[3]), FMath::RoundToInt(CustomData[4]), FMath::RoundToInt(CustomData[5]))
+{
+}
+
+namespace
+{
+	// placements whose item was removed from the item set still need a key, fall back to a single tile extent
+	FVector GetPlacementItemExtent(const FItemPlacement& P)
+	{
+		const UTiledLevelItem* Item = P.GetItem();
+		return Item? Item->Extent : FVector(1);
+	}
+}
+
+// keep these consistent with FTiledLevelUtility::ConvertPlacementToHISM_CustomData
+FTiledInstanceKey::FTiledInstanceKey(const FTilePlacement& P)
+	: Position(P.GridPosition), Extent(P.Extent)
+{
+}
+
+FTiledInstanceKey::FTiledInstanceKey(const FEdgePlacement& P)
+	: Position(P.Edge.X, P.Edge.Y, P.Edge.Z),
+	  Extent(FMath::RoundToInt(GetPlacementItemExtent(P).X), FMath::RoundToInt(GetPlacementItemExtent(P).Z), P.Edge.EdgeType == EEdgeType::Horizontal? -1 : 0)
+{
+}
+
+FTiledInstanceKey::FTiledInstanceKey(const FPointPlacement& P)
+	: Position(P.GridPosition), Extent(1, 1, FMath::RoundToInt(GetPlacementItemExtent(P).Z))
+{
+}
+
+void FTiledInstanceIndex::AddInstance(const UHierarchicalInstancedStaticMeshComponent* Component, int32 InstanceIndex, const FTiledInstanceKey& Key)
+{
+	FComponentInstances& Instances = Components.FindOrAdd(Component);
+	// instances were added without us knowing, catch up with the ones before the new instance
+	if (!Instances.bSynced || Instances.Keys.Num() != InstanceIndex)
+		RebuildComponent(Component, Instances, InstanceIndex);
+	Instances.Keys.Add(Key);
+	Instances.KeyToInstances.FindOrAdd(Key).Add(InstanceIndex);
+	Instances.NumIndexed++;
+}
+
+int32 FTiledInstanceIndex::FindInstance(const UHierarchicalInstancedStaticMeshComponent* Component, const FTiledInstanceKey& Key)
+{
+	const TConstArrayView<int32> Found = FindInstances(Component, Key);
+	int32 Lowest = INDEX_NONE;
+	for (const int32 InstanceIndex : Found)
+	{
+		if (Lowest == INDEX_NONE || InstanceIndex < Lowest)
+			Lowest = InstanceIndex;
+	}
+	return Lowest;
+}
+
+TConstArrayView<int32> FTiledInstanceIndex::FindInstances(const UHierarchicalInstancedStaticMeshComponent* Component, const FTiledInstanceKey& Key)
+{
+	if (!Component) return TConstArrayView<int32>();
+	if (const auto* Found = GetSyncedInstances(Component).KeyToInstances.Find(Key))
+		return *Found;
+	return TConstArrayView<int32>();
+}
+
+void FTiledInstanceIndex::RemoveInstances(const UHierarchicalInstancedStaticMeshComponent* Component, const TArray<int32>& InstanceIndices)
+{
+	FComponentInstances* Instances = Components.Find(Component);
+	if (!Instances) return;
+	if (!Instances->bSynced || Instances->Keys.Num() != Component->GetInstanceCount())
+	{
+		// out of sync already, re-index after the removal instead
+		Components.Remove(Component);
+		return;
+	}
+	// same order as UHierarchicalInstancedStaticMeshComponent::RemoveInstances
+	TArray<int32> SortedIndices = InstanceIndices;
+	SortedIndices.Sort(TGreater<int32>());
+	int32 LastRemoved = INDEX_NONE;
+	for (const int32 InstanceIndex : SortedIndices)
+	{
+		if (InstanceIndex == LastRemoved) continue;
+		RemoveInstanceAtSwap(*Instances, InstanceIndex);
+		LastRemoved = InstanceIndex;
+	}
+}
+
+const TArray<FTiledInstanceKey>& FTiledInstanceIndex::GetInstanceKeys(const UHierarchicalInstancedStaticMeshComponent* Component)
+{
+	return GetSyncedInstances(Component).Keys;
+}
+
+void FTiledInstanceIndex::RemoveComponent(const UHierarchicalInstancedStaticMeshComponent* Component)
+{
+	Components.Remove(Component);
+}
+
+void FTiledInstanceIndex::MarkStale(const UHierarchicalInstancedStaticMeshComponent* Component)
+{
+	if (FComponentInstances* Instances = Components.Find(Component))
+		Instances->bSynced = false;
+}
+
+void FTiledInstanceIndex::Reset()
+{
+	Components.Empty();
+}
+
+int32 FTiledInstanceIndex::Num(const UHierarchicalInstancedStaticMeshComponent* Component) const
+{
+	if (const FComponentInstances* Instances = Components.Find(Component))
+		return Instances->NumIndexed;
+	return 0;
+}
+
+FTiledInstanceIndex::FComponentInstances& FTiledInstanceIndex::GetSyncedInstances(const UHierarchicalInstancedStaticMeshComponent* Component)
+{
+	FComponentInstances& Instances = Components.FindOrAdd(Component);
+	// the count check only catches changes that were not marked stale and change the number of instances
+	if (!Instances.bSynced || Instances.Keys.Num() != Component->GetInstanceCount())
+		RebuildComponent(Component, Instances, Component->GetInstanceCount());
+	return Instances;
+}
+
+void FTiledInstanceIndex::RebuildComponent(const UHierarchicalInstancedStaticMeshComponent* Component, FComponentInstances& Instances, int32 NumInstances)
+{
+	Instances.Keys.Reset(NumInstances);
+	Instances.KeyToInstances.Reset();
+	Instances.NumIndexed = 0;
+	Instances.bSynced = true;
+	const TArray<float>& CustomData = Component->PerInstanceSMCustomData;
+	const bool bHasCustomData = Component->NumCustomDataFloats == 6 && CustomData.Num() >= NumInstances * 6;
+	for (int32 i = 0; i < NumInstances; i++)
+	{
+		// without custom data the instance can still be tracked, but can never be found
+		const FTiledInstanceKey Key = bHasCustomData? FTiledInstanceKey(&CustomData[i * 6]) : FTiledInstanceKey();
+		Instances.Keys.Add(Key);
+		if (bHasCustomData)
+		{
+			Instances.KeyToInstances.FindOrAdd(Key).Add(i);
+			Instances.NumIndexed++;
+		}
+	}
+}
+
+void FTiledInstanceIndex::RemoveInstanceAtSwap(FComponentInstances& Instances, int32 InstanceIndex)
+{
+	if (!Instances.Keys.IsValidIndex(InstanceIndex)) return;
+	const int32 LastIndex = Instances.Keys.Num() - 1;
+	const FTiledInstanceKey RemovedKey = Instances.Keys[InstanceIndex];
+	if (auto* Found = Instances.KeyToInstances.Find(RemovedKey); Found && Found->RemoveSingleSwap(InstanceIndex, false) > 0)
+	{
+		Instances.NumIndexed--;
+		if (Found->Num() == 0)
+			Instances.KeyToInstances.Remove(RemovedKey);
+	}
+	if (InstanceIndex != LastIndex)
+	{
+		// the last instance takes the place of the removed one
+		const FTiledInstanceKey& MovedKey = Instances.Keys[LastIndex];
+		if (auto* Found = Instances.KeyToInstances.Find(MovedKey))
+		{
+			if (int32* Moved = Found->FindByKey(LastIndex))
+				*Moved = InstanceIndex;
+		}
+	}
+	Instances.Keys.RemoveAtSwap(InstanceIndex, 1, false);
+}
+
+void FTiledOccupancyGrid::Add(const FTilePlacement& Placement)
+{
+	const int32 Entry = Tiles.Add(Placement);
+	if (const UTiledLevelItem* Item = Placement.GetItem())
+	{
+		TArray<FCell, TInlineAllocator<16>> Cells;
+		GetCells(Placement, Item->PlacedType, Cells);
+		AddEntry(TileCells, Cells, Entry);
+	}
+}
+
+void FTiledOccupancyGrid::Add(const FEdgePlacement& Placement)
+{
+	const int32 Entry = Edges.Add(Placement);
+	if (const UTiledLevelItem* Item = Placement.GetItem())
+	{
+		TArray<FCell, TInlineAllocator<16>> Cells;
+		GetCells(Placement.Edge, Item->PlacedType, Item->Extent, Cells);
+		AddEntry(EdgeCells, Cells, Entry);
+	}
+}
+
+void FTiledOccupancyGrid::Add(const FPointPlacement& Placement)
+{
+	const int32 Entry = Points.Add(Placement);
+	if (const UTiledLevelItem* Item = Placement.GetItem())
+	{
+		TArray<FCell, TInlineAllocator<16>> Cells;
+		GetCells(Placement, Item->PlacedType, Item->Extent.Z, Cells);
+		AddEntry(PointCells, Cells, Entry);
+	}
+}
+
+bool FTiledOccupancyGrid::Remove(const FTilePlacement& Placement)
+{
+	TArray<FCell, TInlineAllocator<16>> Cells;
+	if (const UTiledLevelItem* Item = Placement.GetItem())
+		GetCells(Placement, Item->PlacedType, Cells);
+	TArray<int32, TInlineAllocator<16>> Candidates;
+	GatherEntries(TileCells, Cells, Candidates);
+	for (const int32 Entry : Candidates)
+	{
+		if (Tiles[Entry] == Placement)
+		{
+			RemoveEntry(TileCells, Cells, Entry);
+			Tiles.RemoveAt(Entry);
+			return true;
+		}
+	}
+	// item is gone, can not tell where it was... slow path
+	for (auto It = Tiles.CreateIterator(); It; ++It)
+	{
+		if (*It == Placement)
+		{
+			RemoveEntry(TileCells, TArrayView<const FCell>(), It.GetIndex());
+			It.RemoveCurrent();
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FTiledOccupancyGrid::Remove(const FEdgePlacement& Placement)
+{
+	TArray<FCell, TInlineAllocator<16>> Cells;
+	if (const UTiledLevelItem* Item = Placement.GetItem())
+		GetCells(Placement.Edge, Item->PlacedType, Item->Extent, Cells);
+	TArray<int32, TInlineAllocator<16>> Candidates;
+	GatherEntries(EdgeCells, Cells, Candidates);
+	for (const int32 Entry : Candidates)
+	{
+		if (Edges[Entry] == Placement)
+		{
+			RemoveEntry(EdgeCells, Cells, Entry);
+			Edges.RemoveAt(Entry);
+			return true;
+		}
+	}
+	for (auto It = Edges.CreateIterator(); It; ++It)
+	{
+		if (*It == Placement)
+		{
+			RemoveEntry(EdgeCells, TArrayView<const FCell>(), It.GetIndex());
+			It.RemoveCurrent();
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FTiledOccupancyGrid::Remove(const FPointPlacement& Placement)
+{
+	TArray<FCell, TInlineAllocator<16>> Cells;
+	if (const UTiledLevelItem* Item = Placement.GetItem())
+		GetCells(Placement, Item->PlacedType, Item->Extent.Z, Cells);
+	TArray<int32, TInlineAllocator<16>> Candidates;
+	GatherEntries(PointCells, Cells, Candidates);
+	for (const int32 Entry : Candidates)
+	{
+		if (Points[Entry] == Placement)
+		{
+			RemoveEntry(PointCells, Cells, Entry);
+			Points.RemoveAt(Entry);
+			return true;
+		}
+	}
+	for (auto It = Points.CreateIterator(); It; ++It)
+	{
+		if (*It == Placement)
+		{
+			RemoveEntry(PointCells, TArrayView<const FCell>(), It.GetIndex());
+			It.RemoveCurrent();
+			return true;
+		}
+	}
+	return false;
+}
+
+void FTiledOccupancyGrid::Reset()
+{
+	Tiles.Empty();
+	Edges.Empty();
+	Points.Empty();
+	TileCells.Empty();
+	EdgeCells.Empty();
+	PointCells.Empty();
+}
+
+TArray<FTilePlacement> FTiledOccupancyGrid::FindOverlapping(EPlacedType PlacedType, const FTilePlacement& TestPlacement) const
+{
+	TArray<FCell, TInlineAllocator<16>> Cells;
+	GetCells(TestPlacement, PlacedType, Cells);
+	TArray<int32, TInlineAllocator<16>> Candidates;
+	GatherEntries(TileCells, Cells, Candidates);
+	TArray<FTilePlacement> OutPlacements;
+	for (const int32 Entry : Candidates)
+	{
+		if (FTiledLevelUtility::IsTilePlacementOverlapping(TestPlacement, Tiles[Entry]))
+			OutPlacements.Add(Tiles[Entry]);
+	}
+	return OutPlacements;
+}
+
+TArray<FEdgePlacement> FTiledOccupancyGrid::FindOverlapping(EPlacedType PlacedType, const FEdgePlacement& TestPlacement) const
+{
+	const UTiledLevelItem* TestItem = TestPlacement.GetItem();
+	if (!TestItem) return TArray<FEdgePlacement>();
+	return FindOverlapping(PlacedType, TestPlacement.Edge, TestItem->Extent);
+}
+
+TArray<FEdgePlacement> FTiledOccupancyGrid::FindOverlapping(EPlacedType PlacedType, const FTiledLevelEdge& TestEdge, const FVector& TestExtent) const
+{
+	TArray<FCell, TInlineAllocator<16>> Cells;
+	GetCells(TestEdge, PlacedType, TestExtent, Cells);
+	TArray<int32, TInlineAllocator<16>> Candidates;
+	GatherEntries(EdgeCells, Cells, Candidates);
+	TArray<FEdgePlacement> OutPlacements;
+	for (const int32 Entry : Candidates)
+	{
+		const FEdgePlacement& Edge = Edges[Entry];
+		const UTiledLevelItem* Item = Edge.GetItem();
+		if (Item && FTiledLevelUtility::IsEdgeOverlapping(TestEdge, TestExtent, Edge.Edge, Item->Extent))
+			OutPlacements.Add(Edge);
+	}
+	return OutPlacements;
+}
+
+TArray<FPointPlacement> FTiledOccupancyGrid::FindOverlapping(EPlacedType PlacedType, const FPointPlacement& TestPlacement, int ZExtent) const
+{
+	TArray<FCell, TInlineAllocator<16>> Cells;
+	GetCells(TestPlacement, PlacedType, ZExtent, Cells);
+	TArray<int32, TInlineAllocator<16>> Candidates;
+	GatherEntries(PointCells, Cells, Candidates);
+	TArray<FPointPlacement> OutPlacements;
+	for (const int32 Entry : Candidates)
+	{
+		const FPointPlacement& Point = Points[Entry];
+		const UTiledLevelItem* Item = Point.GetItem();
+		if (Item && FTiledLevelUtility::IsPointPlacementOverlapping(TestPlacement, ZExtent, Point, Item->Extent.Z))
+			OutPlacements.Add(Point);
+	}
+	return OutPlacements;
+}
+
+TArray<FEdgePlacement> FTiledOccupancyGrid::FindEdgesInsideTile(EPlacedType PlacedType, const FIntVector& TilePosition, const FIntVector& TileExtent) const
+{
+	// every unit edge on the borders and inside the area, an edge touching the area covers at least one of them
+	TArray<FCell, TInlineAllocator<16>> Cells;
+	const uint8 HorizontalLayer = static_cast<uint8>(PlacedType) * 2;
+	const uint8 VerticalLayer = HorizontalLayer + 1;
+	for (int z = 0; z < FMath::Max(1, TileExtent.Z); z++)
+	{
+		for (int x = 0; x <= TileExtent.X; x++)
+		{
+			for (int y = 0; y <= TileExtent.Y; y++)
+			{
+				if (x < TileExtent.X)
+					Cells.Emplace(TilePosition + FIntVector(x, y, z), HorizontalLayer);
+				if (y < TileExtent.Y)
+					Cells.Emplace(TilePosition + FIntVector(x, y, z), VerticalLayer);
+			}
+		}
+	}
+	TArray<int32, TInlineAllocator<16>> Candidates;
+	GatherEntries(EdgeCells, Cells, Candidates);
+	TArray<FEdgePlacement> OutPlacements;
+	for (const int32 Entry : Candidates)
+	{
+		const FEdgePlacement& Edge = Edges[Entry];
+		const UTiledLevelItem* Item = Edge.GetItem();
+		if (Item && FTiledLevelUtility::IsEdgeInsideTile(Edge.Edge, FIntVector(Item->Extent), TilePosition, TileExtent))
+			OutPlacements.Add(Edge);
+	}
+	return OutPlacements;
+}
+
+TArray<FPointPlacement> FTiledOccupancyGrid::FindPointsInsideTile(EPlacedType PlacedType, const FIntVector& TilePosition, const FIntVector& TileExtent) const
+{
+	// a point overlapping the area shares either its bottom or the bottom of the area, both steps are searched
+	TArray<FCell, TInlineAllocator<16>> Cells;
+	const uint8 Layer = static_cast<uint8>(PlacedType) * 2;
+	for (int x = 0; x <= TileExtent.X; x++)
+	{
+		for (int y = 0; y <= TileExtent.Y; y++)
+		{
+			for (int z = 0; z <= FMath::Max(0, TileExtent.Z); z++)
+			{
+				Cells.Emplace(TilePosition + FIntVector(x, y, z), Layer);
+			}
+		}
+	}
+	TArray<int32, TInlineAllocator<16>> Candidates;
+	GatherEntries(PointCells, Cells, Candidates);
+	TArray<FPointPlacement> OutPlacements;
+	for (const int32 Entry : Candidates)
+	{
+		const FPointPlacement& Point = Points[Entry];
+		const UTiledLevelItem* Item = Point.GetItem();
+		if (Item && FTiledLevelUtility::IsPointInsideTile(Point.GridPosition, Item->Extent.Z, TilePosition, TileExtent))
+			OutPlacements.Add(Point);
+	}
+	return OutPlacements;
+}
+
+TArray<FTilePlacement> FTiledOccupancyGrid::FindTilesAt(EPlacedType PlacedType, const FIntVector& GridPosition) const
+{
+	TArray<FTilePlacement> OutPlacements;
+	if (const FCellEntries* Entries = TileCells.Find(FCell(GridPosition, static_cast<uint8>(PlacedType) * 2)))
+	{
+		for (const int32 Entry : *Entries)
+		{
+			if (Tiles[Entry].GridPosition == GridPosition)
+				OutPlacements.Add(Tiles[Entry]);
+		}
+	}
+	return OutPlacements;
+}
+
+void FTiledOccupancyGrid::GetCells(const FTilePlacement& Placement, EPlacedType PlacedType, TArray<FCell, TInlineAllocator<16>>& OutCells)
+{
+	const uint8 Layer = static_cast<uint8>(PlacedType) * 2;
+	for (int x = 0; x < FMath::Max(1, Placement.Extent.X); x++)
+	{
+		for (int y = 0; y < FMath::Max(1, Placement.Extent.Y); y++)
+		{
+			for (int z = 0; z < FMath::Max(1, Placement.Extent.Z); z++)
+			{
+				OutCells.Emplace(Placement.GridPosition + FIntVector(x, y, z), Layer);
+			}
+		}
+	}
+}
+
+void FTiledOccupancyGrid::GetCells(const FTiledLevelEdge& Edge, EPlacedType PlacedType, const FVector& ItemExtent, TArray<FCell, TInlineAllocator<16>>& OutCells)
+{
+	const bool IsHorizontal = Edge.EdgeType == EEdgeType::Horizontal;
+	const uint8 Layer = static_cast<uint8>(PlacedType) * 2 + (IsHorizontal? 0 : 1);
+	const int Length = FMath::Max(1, FMath::CeilToInt(ItemExtent.X));
+	const int Height = FMath::Max(1, FMath::CeilToInt(ItemExtent.Z));
+	for (int l = 0; l < Length; l++)
+	{
+		for (int h = 0; h < Height; h++)
+		{
+			const FIntVector Offset = IsHorizontal? FIntVector(l, 0, h) : FIntVector(0, l, h);
+			OutCells.Emplace(Edge.GetEdgePosition() + Offset, Layer);
+		}
+	}
+}
+
+void FTiledOccupancyGrid::GetCells(const FPointPlacement& Placement, EPlacedType PlacedType, int ZExtent, TArray<FCell, TInlineAllocator<16>>& OutCells)
+{
+	// points overlap when one contains the other (top included), so also take the step at the top
+	const uint8 Layer = static_cast<uint8>(PlacedType) * 2;
+	for (int z = 0; z <= FMath::Max(0, ZExtent); z++)
+	{
+		OutCells.Emplace(Placement.GridPosition + FIntVector(0, 0, z), Layer);
+	}
+}
+
+void FTiledOccupancyGrid::GatherEntries(const TMap<FCell, FCellEntries>& InCells, TArrayView<const FCell> CellsToSearch,
+	TArray<int32, TInlineAllocator<16>>& OutEntries) const
+{
+	for (const FCell& Cell : CellsToSearch)
+	{
+		if (const FCellEntries* Entries = InCells.Find(Cell))
+		{
+			OutEntries.Append(*Entries);
+		}
+	}
+	// an entry spanning several cells is found once per cell
+	OutEntries.Sort();
+	OutEntries.SetNum(Algo::Unique(OutEntries), false);
+}
+
+void FTiledOccupancyGrid::AddEntry(TMap<FCell, FCellEntries>& InCells, TArrayView<const FCell> CellsToAdd, int32 Entry)
+{
+	for (const FCell& Cell : CellsToAdd)
+		InCells.FindOrAdd(Cell).AddUnique(Entry);
+}
+
+void FTiledOccupancyGrid::RemoveEntry(TMap<FCell, FCellEntries>& InCells, TArrayView<const FCell> CellsToRemove, int32 Entry)
+{
+	if (CellsToRemove.Num() == 0)
+	{
+		// don't know its cells, check them all
+		for (auto It = InCells.CreateIterator(); It; ++It)
+		{
+			It.Value().RemoveSingleSwap(Entry, false);
+			if (It.Value().Num() == 0)
+				It.RemoveCurrent();
+		}
+		return;
+	}
+	for (const FCell& Cell : CellsToRemove)
+	{
+		if (FCellEntries* Entries = InCells.Find(Cell))
+		{
+			Entries->RemoveSingleSwap(Entry, false);
+			if (Entries->Num() == 0)
+				InCells.Remove(Cell);
+		}
+	}
+}
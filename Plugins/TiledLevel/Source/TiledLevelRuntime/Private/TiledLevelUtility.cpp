@@ -108,20 +108,16 @@ bool FTiledLevelUtility::IsPointInsideTile(FIntVector PointPosition, int PointZE
 	return false;
 }
 
-void FTiledLevelUtility::FindInstanceIndexByPlacement(TArray<int32>& FoundIndex, const TArray<float>& CustomData,
-	const TArray<float>& SearchData)
+void FTiledLevelUtility::FindInstanceIndexByPlacement(TArray<int32>& FoundIndex, FTiledInstanceIndex& InstanceIndex,
+	const UHierarchicalInstancedStaticMeshComponent* HISM, const FTiledInstanceKey& SearchKey)
 {
-	for (int32 i = 0; i < CustomData.Num()/6; i++)
+	// several placements may share a key, each call takes one instance that was not found yet
+	for (const int32 Found : InstanceIndex.FindInstances(HISM, SearchKey))
 	{
-		if (FoundIndex.Contains(i)) continue;
-		for (int j = 0; j < 6;j++)
+		if (!FoundIndex.Contains(Found))
 		{
-			if (CustomData[6*i+j] != SearchData[j]) break;
-			if (j == 5)
-			{
-				FoundIndex.Add(i);
-				return;
-			}
+			FoundIndex.Add(Found);
+			return;
 		}
 	}
 }
@@ -164,23 +160,44 @@ TArray<float> FTiledLevelUtility::ConvertPlacementToHISM_CustomData(const FPoint
 
 void FTiledLevelUtility::SetSpawnedActorTag(const FTilePlacement& P, AActor* TargetActor)
 {
-	TargetActor->Tags.Add(FName(FString::Printf(TEXT("X=%d,Y=%d,Z=%d"),P.GridPosition.X,P.GridPosition.Y,P.GridPosition.Z)));
-	TargetActor->Tags.Add(FName(FString::Printf(TEXT("X=%d,Y=%d,Z=%d"),P.Extent.X,P.Extent.Y,P.Extent.Z)));
-	TargetActor->Tags.Add(FName(P.ItemID.ToString()));
+	TargetActor->Tags.Append(GetSpawnedActorTags(P));
 }
 
 void FTiledLevelUtility::SetSpawnedActorTag(const FEdgePlacement& P, AActor* TargetActor)
 {
-	TargetActor->Tags.Add(FName(FString::Printf(TEXT("X=%d,Y=%d,Z=%d"),P.Edge.X,P.Edge.Y,P.Edge.Z)));
-	TargetActor->Tags.Add(FName(FString::Printf(TEXT("X=%f,Y=%f,Z=%f"),P.GetItem()->Extent.X,P.GetItem()->Extent.Z,P.Edge.EdgeType == EEdgeType::Horizontal? -1.0f : 0.f)));
-	TargetActor->Tags.Add(FName(P.ItemID.ToString()));
+	TargetActor->Tags.Append(GetSpawnedActorTags(P));
 }
 
 void FTiledLevelUtility::SetSpawnedActorTag(const FPointPlacement& P, AActor* TargetActor)
 {
-	TargetActor->Tags.Add(FName(FString::Printf(TEXT("X=%d,Y=%d,Z=%d"),P.GridPosition.X,P.GridPosition.Y,P.GridPosition.Z)));
-	TargetActor->Tags.Add(FName(P.GetItem()->Extent.ToString()));
-	TargetActor->Tags.Add(FName(P.ItemID.ToString()));
+	TargetActor->Tags.Append(GetSpawnedActorTags(P));
+}
+
+TArray<FName> FTiledLevelUtility::GetSpawnedActorTags(const FTilePlacement& P)
+{
+	return {
+		FName(FString::Printf(TEXT("X=%d,Y=%d,Z=%d"),P.GridPosition.X,P.GridPosition.Y,P.GridPosition.Z)),
+		FName(FString::Printf(TEXT("X=%d,Y=%d,Z=%d"),P.Extent.X,P.Extent.Y,P.Extent.Z)),
+		FName(P.ItemID.ToString())
+	};
+}
+
+TArray<FName> FTiledLevelUtility::GetSpawnedActorTags(const FEdgePlacement& P)
+{
+	return {
+		FName(FString::Printf(TEXT("X=%d,Y=%d,Z=%d"),P.Edge.X,P.Edge.Y,P.Edge.Z)),
+		FName(FString::Printf(TEXT("X=%f,Y=%f,Z=%f"),P.GetItem()->Extent.X,P.GetItem()->Extent.Z,P.Edge.EdgeType == EEdgeType::Horizontal? -1.0f : 0.f)),
+		FName(P.ItemID.ToString())
+	};
+}
+
+TArray<FName> FTiledLevelUtility::GetSpawnedActorTags(const FPointPlacement& P)
+{
+	return {
+		FName(FString::Printf(TEXT("X=%d,Y=%d,Z=%d"),P.GridPosition.X,P.GridPosition.Y,P.GridPosition.Z)),
+		FName(P.GetItem()->Extent.ToString()),
+		FName(P.ItemID.ToString())
+	};
 }
 
 TArray<FIntVector> FTiledLevelUtility::GetOccupiedPositions(UTiledLevelItem* Item, FIntVector StartPosition,
@@ -628,65 +645,95 @@ FString FTiledLevelUtility::GetFloorNameFromPosition(int FloorPositionIndex)
 	return FString::Printf(TEXT("%dF"), FloorPositionIndex + 1);
 }
 
-void FTiledLevelUtility::FloodFill(TArray<TArray<int>>& InBoard, const FIntPoint& InBoardSize, int X, int Y,
-	TArray<FIntPoint>& FilledTarget)
+void FTiledFillBoard::Init(const FIntPoint& InSize)
 {
-	// copy from https://www.educative.io/edpresso/flood-fill-algorithm-in-cpp
-	// works like a charm!!
-	if (X < 0 || X >= InBoardSize.X || Y < 0 || Y >= InBoardSize.Y)
-		return;
-	// 0 will be empty place, 1 will be occupied region
-	if (InBoard[X][Y] == 1)
-		return;
-	InBoard[X][Y] = 1;
-	FilledTarget.Add(FIntPoint(X, Y));
-	
-	FloodFill(InBoard, InBoardSize, X+1, Y, FilledTarget);
-	FloodFill(InBoard, InBoardSize, X-1, Y, FilledTarget);
-	FloodFill(InBoard, InBoardSize, X, Y+1, FilledTarget);
-	FloodFill(InBoard, InBoardSize, X, Y-1, FilledTarget);
+	Size = FIntPoint(FMath::Max(InSize.X, 0), FMath::Max(InSize.Y, 0));
+	Occupied.Init(false, Size.X * Size.Y);
+	BlockedSides.Reset();
 }
 
-void FTiledLevelUtility::FloodFillByEdges(const TArray<FTiledLevelEdge>& BlockingEdges, TArray<TArray<int>>& InBoard, const FIntPoint& InBoardSize, int X,
-	int Y, TArray<FIntPoint>& FilledTarget)
+void FTiledFillBoard::AddBlockingEdge(const FTiledLevelEdge& Edge)
 {
-	if (X < 0 || X >= InBoardSize.X || Y < 0 || Y >= InBoardSize.Y)
-		return;
-	if (InBoard[X][Y] == 1)
-		return;
-	InBoard[X][Y] = 1;
-	FilledTarget.Add(FIntPoint(X, Y));
-
-	// test right
-	if (!BlockingEdges.Contains(FTiledLevelEdge(X + 1, Y, 1, EEdgeType::Vertical)))
-		FloodFillByEdges(BlockingEdges, InBoard, InBoardSize, X + 1, Y, FilledTarget);
-	// test left
-	if (!BlockingEdges.Contains(FTiledLevelEdge(X, Y, 1, EEdgeType::Vertical)))
-		FloodFillByEdges(BlockingEdges, InBoard, InBoardSize, X - 1, Y, FilledTarget);
-	//test up
-	if (!BlockingEdges.Contains(FTiledLevelEdge(X, Y, 1, EEdgeType::Horizontal)))
-		FloodFillByEdges(BlockingEdges, InBoard, InBoardSize, X, Y - 1, FilledTarget);
-	// test down
-	if (!BlockingEdges.Contains(FTiledLevelEdge(X, Y + 1, 1, EEdgeType::Horizontal)))
-		FloodFillByEdges(BlockingEdges, InBoard, InBoardSize, X, Y + 1, FilledTarget);
+	if (BlockedSides.Num() == 0)
+		BlockedSides.SetNumZeroed(Size.X * Size.Y);
+	// vertical edge (X, Y) lies between cell (X-1, Y) and (X, Y), horizontal edge (X, Y) between (X, Y-1) and (X, Y)
+	if (Edge.EdgeType == EEdgeType::Vertical)
+	{
+		if (IsInside(Edge.X - 1, Edge.Y))
+			BlockedSides[GetIndex(Edge.X - 1, Edge.Y)] |= Blocked_Right;
+		if (IsInside(Edge.X, Edge.Y))
+			BlockedSides[GetIndex(Edge.X, Edge.Y)] |= Blocked_Left;
+	}
+	else
+	{
+		if (IsInside(Edge.X, Edge.Y - 1))
+			BlockedSides[GetIndex(Edge.X, Edge.Y - 1)] |= Blocked_Down;
+		if (IsInside(Edge.X, Edge.Y))
+			BlockedSides[GetIndex(Edge.X, Edge.Y)] |= Blocked_Up;
+	}
 }
 
-void FTiledLevelUtility::GetConsecutiveTiles(TArray<TArray<int>>& InBoard, FIntPoint InBoardSize, int X, int Y,
-                                             TArray<FIntPoint>& OutTiles)
+namespace
+{
+	// Scanline fill of the cells connected to (X, Y) whose occupancy equals bTargetValue, flipping them as they are collected.
+	// Iterative, so large boards can't overflow the stack.
+	void ScanlineFill(FTiledFillBoard& Board, int X, int Y, bool bTargetValue, TArray<FIntPoint>& OutCells)
+	{
+		if (!Board.IsInside(X, Y) || Board.IsOccupied(X, Y) != bTargetValue)
+			return;
+
+		TArray<FIntPoint> Seeds;
+		Seeds.Add(FIntPoint(X, Y));
+		while (Seeds.Num() > 0)
+		{
+			const FIntPoint Seed = Seeds.Pop(false);
+			if (Board.IsOccupied(Seed.X, Seed.Y) != bTargetValue)
+				continue; // already filled from another seed
+
+			// extend the span along the row
+			int Left = Seed.X;
+			while (Left > 0 && !(Board.GetBlockedSides(Left, Seed.Y) & FTiledFillBoard::Blocked_Left) && Board.IsOccupied(Left - 1, Seed.Y) == bTargetValue)
+				Left--;
+			int Right = Seed.X;
+			while (Right < Board.GetSize().X - 1 && !(Board.GetBlockedSides(Right, Seed.Y) & FTiledFillBoard::Blocked_Right) && Board.IsOccupied(Right + 1, Seed.Y) == bTargetValue)
+				Right++;
+
+			for (int i = Left; i <= Right; i++)
+			{
+				Board.SetOccupied(i, Seed.Y, !bTargetValue);
+				OutCells.Add(FIntPoint(i, Seed.Y));
+			}
+
+			// seed every run of reachable cells in the rows above and below
+			for (const int Dir : {-1, 1})
+			{
+				const int NextY = Seed.Y + Dir;
+				if (NextY < 0 || NextY >= Board.GetSize().Y)
+					continue;
+				const uint8 BlockedToward = Dir < 0 ? FTiledFillBoard::Blocked_Up : FTiledFillBoard::Blocked_Down;
+				bool InRun = false;
+				for (int i = Left; i <= Right; i++)
+				{
+					const bool Reachable = !(Board.GetBlockedSides(i, Seed.Y) & BlockedToward) && Board.IsOccupied(i, NextY) == bTargetValue;
+					// a blocking edge inside the next row splits it into separate runs
+					if (Reachable && (!InRun || (Board.GetBlockedSides(i, NextY) & FTiledFillBoard::Blocked_Left)))
+						Seeds.Add(FIntPoint(i, NextY));
+					InRun = Reachable;
+				}
+			}
+		}
+	}
+}
+
+void FTiledLevelUtility::FloodFill(FTiledFillBoard& InBoard, int X, int Y, TArray<FIntPoint>& FilledTarget)
 {
-	if (X < 0 || X >= InBoardSize.X || Y < 0 || Y >= InBoardSize.Y)
-		return;
 	// 0 will be empty place, 1 will be occupied region
-	if (InBoard[X][Y] == 0)
-		return;
-	InBoard[X][Y] = 0;
-	OutTiles.Add(FIntPoint(X, Y));
-	
-	GetConsecutiveTiles(InBoard, InBoardSize, X+1, Y,OutTiles);
-	GetConsecutiveTiles(InBoard, InBoardSize, X-1, Y,OutTiles);
-	GetConsecutiveTiles(InBoard, InBoardSize, X, Y+1,OutTiles);
-	GetConsecutiveTiles(InBoard, InBoardSize, X, Y-1,OutTiles);
-	
+	ScanlineFill(InBoard, X, Y, false, FilledTarget);
+}
+
+void FTiledLevelUtility::GetConsecutiveTiles(FTiledFillBoard& InBoard, int X, int Y, TArray<FIntPoint>& OutTiles)
+{
+	ScanlineFill(InBoard, X, Y, true, OutTiles);
 }
 
 TArray<float> FTiledLevelUtility::GetWeightedCoefficient(TArray<float>& RawCoefficientArray)
@@ -1152,6 +1199,48 @@ FMeshDescription FTiledLevelUtility::BuildMeshDescription(UProceduralMeshCompone
 UProceduralMeshComponent* FTiledLevelUtility::ConvertTiledLevelAssetToProcMesh(UTiledLevelAsset* TargetAsset,
 	int TargetLOD, UObject* Outer, EObjectFlags Flags)
 {
+	TArray<UStaticMesh*> TargetMeshes;
+	TArray<FTransform> TransformMods;
+	for (FTiledFloor F : TargetAsset->TiledFloors)
+	{
+		for (FItemPlacement P : F.GetItemPlacements())
+		{
+			UStaticMesh* ItemMesh = P.GetItem()->TiledMesh;
+			if (ItemMesh)
+			{
+				TargetMeshes.Add(ItemMesh);
+				TransformMods.Add(P.TileObjectTransform);
+			}
+		}
+	}
+	FTransform CachedHostLevelTransform = TargetAsset->HostLevel->GetTransform();
+	TargetAsset->HostLevel->SetActorTransform(FTransform());
+	for (AActor* SpawnedActor : TargetAsset->HostLevel->SpawnedTiledActors)
+	{
+		for (UActorComponent* AC : SpawnedActor->GetComponents())
+		{
+			if (UStaticMeshComponent* SMC = Cast<UStaticMeshComponent>(AC))
+			{
+				if (SMC->GetStaticMesh())
+				{
+					TargetMeshes.Add(SMC->GetStaticMesh());
+					TransformMods.Add(SMC->GetComponentTransform());
+				}
+			}
+		}
+	}
+	TargetAsset->HostLevel->SetActorTransform(CachedHostLevelTransform);
+
+	if (!Outer)
+		Outer = TargetAsset;
+	return ConvertMeshesToProcMesh(TargetMeshes, TransformMods, TargetLOD, Outer, Flags);
+}
+
+UProceduralMeshComponent* FTiledLevelUtility::ConvertMeshesToProcMesh(const TArray<UStaticMesh*>& TargetMeshes,
+	const TArray<FTransform>& TransformMods, int TargetLOD, UObject* Outer, EObjectFlags Flags)
+{
+	check(TargetMeshes.Num() == TransformMods.Num());
+
 	struct FCollisionVertex
 	{
 		TArray<FVector> CollisionVertex;
@@ -1172,21 +1261,22 @@ UProceduralMeshComponent* FTiledLevelUtility::ConvertTiledLevelAssetToProcMesh(U
 		TArray<FCollisionVertex> CollisionData;
 	};
 
-	if (!Outer)
-		Outer = TargetAsset;
 	UProceduralMeshComponent* ProcMeshComp = NewObject<UProceduralMeshComponent>(Outer, NAME_None, Flags);
 	TMap<UStaticMesh*, int> MeshLODMap;
-	for (UStaticMesh* SMPtr : TargetAsset->GetUsedStaticMeshSet())
+	for (UStaticMesh* SMPtr : TargetMeshes)
 	{
+		if (MeshLODMap.Contains(SMPtr))
+			continue;
 		SMPtr->bAllowCPUAccess = true;
 		SMPtr->GetNumLODs() - 1 < TargetLOD ?
 			MeshLODMap.Add(SMPtr, SMPtr->GetNumLODs()-1) : MeshLODMap.Add(SMPtr, TargetLOD);
 	}
 	
 	// construct template data ... and
-	// init proc data
+	// init proc data, both indexed by mesh and section
 	TArray<FPerSectionData> SectionTemplateData;
 	TArray<FPerSectionData> ProcData;
+	TMap<TPair<UStaticMesh*, int>, int> SectionDataIndex;
 	for (auto MeshLOD : MeshLODMap)
 	{
 		for (int SectionID = 0; SectionID < MeshLOD.Key->GetNumSections(MeshLOD.Value); SectionID++)
@@ -1233,97 +1323,59 @@ UProceduralMeshComponent* FTiledLevelUtility::ConvertTiledLevelAssetToProcMesh(U
 				Whites.Init(FColor::White, NewSectionData.Vertex.Num());
 				NewSectionData.VertexColor.Append(Whites);
 			}
+			SectionDataIndex.Add(TPair<UStaticMesh*, int>(MeshLOD.Key, SectionID), ProcData.Num());
 			SectionTemplateData.Add(NewSectionData);	
 			ProcData.Add(InitSectionData);
 		}
 	}
 
 	// fill proc data
-	TArray<UStaticMesh*> TargetMeshes;
-	TArray<FTransform> TransformMods;
-	for (FTiledFloor F : TargetAsset->TiledFloors)
+	for (int i = 0; i < TargetMeshes.Num(); i++)
 	{
-		for (FItemPlacement P : F.GetItemPlacements())
+		const int LOD = MeshLODMap[TargetMeshes[i]];
+		for (int SectionID = 0 ; SectionID < TargetMeshes[i]->GetNumSections(LOD); SectionID++)
 		{
-			UStaticMesh* ItemMesh = P.GetItem()->TiledMesh;
-			if (ItemMesh)
+			const int* DataIndex = SectionDataIndex.Find(TPair<UStaticMesh*, int>(TargetMeshes[i], SectionID));
+			if (!DataIndex) continue;
+			FPerSectionData* DataToFill = &ProcData[*DataIndex];
+			const FPerSectionData* TemplateToCopy = &SectionTemplateData[*DataIndex];
+
+			// vertex
+			int NumOfExistingVertex = DataToFill->Vertex.Num();
+			for (FVector v : TemplateToCopy->Vertex)
 			{
-				TargetMeshes.Add(ItemMesh);
-				TransformMods.Add(P.TileObjectTransform);
+				DataToFill->Vertex.Add(TransformMods[i].TransformPosition(v));
 			}
-		}
-	}
-	FTransform CachedHostLevelTransform = TargetAsset->HostLevel->GetTransform();
-	TargetAsset->HostLevel->SetActorTransform(FTransform());
-	for (AActor* SpawnedActor : TargetAsset->HostLevel->SpawnedTiledActors)
-	{
-		for (UActorComponent* AC : SpawnedActor->GetComponents())
-		{
-			if (UStaticMeshComponent* SMC = Cast<UStaticMeshComponent>(AC))
+			
+			// triangle
+			for (int t : TemplateToCopy->Triangles)
 			{
-				if (SMC->GetStaticMesh())
-				{
-					TargetMeshes.Add(SMC->GetStaticMesh());
-					TransformMods.Add(SMC->GetComponentTransform());
-				}
+				DataToFill->Triangles.Add(t + NumOfExistingVertex);
 			}
-		}
-	}
-	TargetAsset->HostLevel->SetActorTransform(CachedHostLevelTransform);
-	
-	for (int i = 0; i < TargetMeshes.Num(); i++)
-	{
-		for (int LOD = 0; LOD < TargetMeshes[i]->GetNumLODs(); LOD++)
-		{
-			for (int SectionID = 0 ; SectionID < TargetMeshes[i]->GetNumSections(LOD); SectionID++)
-			{
-				FPerSectionData* DataToFill = ProcData.FindByPredicate([=](const FPerSectionData& Data)
-				{
-					return Data.SectionID == SectionID && Data.MeshPtr==TargetMeshes[i] && Data.LOD == LOD;
-				});
-				FPerSectionData* TemplateToCopy = SectionTemplateData.FindByPredicate([=](const FPerSectionData& Data)
-				{
-					return Data.SectionID == SectionID && Data.MeshPtr==TargetMeshes[i] && Data.LOD == LOD;
-				});
+			
+			// normal
+			for (FVector n : TemplateToCopy->Normals)
+				DataToFill->Normals.Add(TransformMods[i].GetRotation().RotateVector(n));
+			 
+			// uv
+			DataToFill->UV.Append(TemplateToCopy->UV);
+			
+			// tangent
+			DataToFill->Tangents.Append(TemplateToCopy->Tangents);
+			
+			// vertex color
+			DataToFill->VertexColor.Append(TemplateToCopy->VertexColor);
 
-				if (!DataToFill) continue;
-				// vertex
-				int NumOfExistingVertex = DataToFill->Vertex.Num();
-				for (FVector v : TemplateToCopy->Vertex)
-				{
-					DataToFill->Vertex.Add(TransformMods[i].TransformPosition(v));
-				}
-				
-				// triangle
-				for (int t : TemplateToCopy->Triangles)
-				{
-					DataToFill->Triangles.Add(t + NumOfExistingVertex);
-				}
-				
-				// normal
-				for (FVector n : TemplateToCopy->Normals)
-					DataToFill->Normals.Add(TransformMods[i].GetRotation().RotateVector(n));
-				 
-				// uv
-				DataToFill->UV.Append(TemplateToCopy->UV);
-				
-				// tangent
-				DataToFill->Tangents.Append(TemplateToCopy->Tangents);
-				
-				// vertex color
-				DataToFill->VertexColor.Append(TemplateToCopy->VertexColor);
-
-				// Collision data
-				int NumOfCollisions = TemplateToCopy->CollisionData.Num();
-				for (int CollisionIndex = 0; CollisionIndex < NumOfCollisions; CollisionIndex++ )
+			// Collision data
+			int NumOfCollisions = TemplateToCopy->CollisionData.Num();
+			for (int CollisionIndex = 0; CollisionIndex < NumOfCollisions; CollisionIndex++ )
+			{
+				FCollisionVertex CV;
+				for (FVector v : TemplateToCopy->CollisionData[CollisionIndex].CollisionVertex)
 				{
-					FCollisionVertex CV;
-					for (FVector v : TemplateToCopy->CollisionData[CollisionIndex].CollisionVertex)
-					{
-						CV.CollisionVertex.Add(TransformMods[i].TransformPosition(v));
-					}
-					 DataToFill->CollisionData.Add(CV);
+					CV.CollisionVertex.Add(TransformMods[i].TransformPosition(v));
 				}
+				 DataToFill->CollisionData.Add(CV);
 			}
 		}
 	}
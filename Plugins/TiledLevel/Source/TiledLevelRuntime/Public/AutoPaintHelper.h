@@ -8,6 +8,7 @@
 class UAutoPaintRule;
 class UTextRenderComponent;
 class UMaterialInstanceDynamic;
+class UMaterialInterface;
 class UMaterialBillboardComponent;
 class UAutoPaintItemRule;
 class UProceduralMeshComponent;
@@ -36,9 +37,21 @@ public:
 
 	void UpdateRulePreview(UAutoPaintItemRule* SelectedItemRule);
 
+	// auto paint item of each section of the hint blocks, NAME_None for unused sections
 	TArray<FName> HintNames;
 
 private:
+	UMaterialInstanceDynamic* CreateHintMaterial(const FLinearColor& BorderColor, float Opacity);
+
+	/*
+	 * The hints are split into one section per floor and auto paint item, so a paint stroke only rebuilds the sections it touched.
+	 * Sections of removed floors / items are cleared and reused later.
+	 */
+	TMap<TPair<int32, FName>, int32> HintSectionIds;
+	TArray<TArray<FIntVector>> HintSectionPositions; // sorted, by section id
+	TArray<int32> FreeHintSections;
+	FVector HintTileSize = FVector::ZeroVector;
+
 	UPROPERTY()
 	TObjectPtr<UTiledLevelAsset> AssetPtr;
 	
@@ -51,6 +64,9 @@ private:
 	UPROPERTY()
 	TObjectPtr<UProceduralMeshComponent> HintBlocks;
 
+	UPROPERTY()
+	TObjectPtr<UProceduralMeshComponent> MatchedHintBlocks;
+
 	UPROPERTY()
 	TObjectPtr<UProceduralMeshComponent> RulePreviewBlocks;
 
@@ -60,8 +76,22 @@ private:
 	UPROPERTY()
 	TArray<TObjectPtr<AActor>> PreviewSpawnActors;
 
+	// loaded once, every hint material is an instance of it
+	UPROPERTY()
+	TObjectPtr<UMaterialInterface> M_HintBase;
+
+	UPROPERTY()
+	TObjectPtr<UMaterialInterface> M_EmptyHint;
+
+	UPROPERTY()
+	TMap<FName, TObjectPtr<UMaterialInstanceDynamic>> M_ItemHints;
+
+	UPROPERTY()
+	TObjectPtr<UMaterialInstanceDynamic> M_MatchedHint;
+
+	// by section id of the rule preview blocks
 	UPROPERTY()
-	TArray<TObjectPtr<UMaterialInstanceDynamic>> M_Hints;
+	TArray<TObjectPtr<UMaterialInstanceDynamic>> M_RulePreviewHints;
 
 	UPROPERTY()
 	TArray<TObjectPtr<UMaterialBillboardComponent>> BillboardComponents;
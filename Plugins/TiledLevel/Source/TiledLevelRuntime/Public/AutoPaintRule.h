@@ -201,9 +201,14 @@ class TILEDLEVELRUNTIME_API UAutoPaintItemRule : public UObject
 	void UpdateImpactSize(EImpactSize NewImpactSize);
 	
 	FTiledItemObj PickWhatToSpawn() const;
+	FTiledItemObj PickWhatToSpawn(const FRandomStream& Random) const;
 	
 	TArray<EDuplicationType> GetDuplicateCases() const;
 
+private:
+	FTiledItemObj PickWhatToSpawn(float RandValue) const;
+
+public:
 	// deep copy?
 	void DeepCopy(const UAutoPaintItemRule& Other)
 	{
@@ -228,6 +233,9 @@ class TILEDLEVELRUNTIME_API UAutoPaintItemRule : public UObject
 		Note = Other.Note;
 	}
 	
+	// any change of the rule also changes the version of the auto paint rule it belongs to
+	virtual bool Modify(bool bAlwaysMarkDirty = true) override;
+
 #if WITH_EDITOR	
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
@@ -293,8 +301,8 @@ struct FAutoPaintMatchData
 	FIntVector PosOffset;
 	// What to spawn is picked during this struct is generated!
 	uint8 RotateTimes;
-	FAutoPaintSpawnAdjustment* SpawnAdj = nullptr;
-	UAutoPaintItemRule* BaseRulePtr;
+	// cached in the tiled level asset, which may outlive the rule (deleted in the rule editor, undo...)
+	TWeakObjectPtr<UAutoPaintItemRule> BaseRulePtr;
 
 };
 
@@ -366,6 +374,69 @@ struct FAutoPaintPlacement_Point : FAutoPaintPlacement
 };
 
 
+/*
+ * Auto paint data packed into a dense grid of small item codes, padded by the largest impact size,
+ * so that compiled rules look up neighbors by a fixed cell offset instead of hashing positions.
+ * The grid may cover only the region that is queried, the boundary is still the one of the whole level.
+ */
+struct TILEDLEVELRUNTIME_API FAutoPaintCodeGrid
+{
+	static constexpr int32 Padding = 2;
+	static constexpr uint8 NoDataCode = 0;
+	// never stored, compiled rules see it outside the boundary when their out of boundary rule applies
+	static constexpr uint8 OutOfBoundaryCode = 1;
+	static constexpr int32 MaxCodes = 64;
+
+	// false if the data can not be packed (too many distinct items or too large), rules are interpreted then
+	bool Init(const TMap<FIntVector, FName>& Data, const FIntVector& InMinBoundary, const FIntVector& InMaxBoundary);
+	// only positions in [RegionMin, RegionMax) can be queried then
+	bool Init(const TMap<FIntVector, FName>& Data, const FIntVector& InMinBoundary, const FIntVector& InMaxBoundary,
+		const FIntVector& RegionMin, const FIntVector& RegionMax);
+
+	bool IsValid() const { return Cells.Num() > 0; }
+	int32 GetCellIndex(const FIntVector& Position) const;
+	int32 GetCellOffset(const FIntVector& Offset) const;
+	bool IsInBoundary(const FIntVector& Position) const;
+
+	// item name of each code, NAME_None for the two reserved codes
+	TArray<FName> CodeNames;
+	TArray<uint8> Cells;
+	FIntVector MinBoundary;
+	FIntVector MaxBoundary;
+	FIntVector GridMin;
+	FIntVector GridSize;
+};
+
+/*
+ * An item rule and each of its duplication variants turned into a list of (cell offset, bit mask of the codes that meet it).
+ * Same results as UAutoPaintRule::IsRuleMet, which is still used for rules that can not be compiled.
+ */
+struct TILEDLEVELRUNTIME_API FAutoPaintCompiledRule
+{
+	struct FCondition
+	{
+		FIntVector Offset;
+		int32 CellOffset;
+		uint64 MetCodes;
+	};
+
+	struct FVariant
+	{
+		EDuplicationType DupType;
+		TArray<FCondition> Conditions;
+		FIntVector MinOffset;
+		FIntVector MaxOffset;
+	};
+
+	UAutoPaintItemRule* Rule = nullptr;
+	TArray<FVariant> Variants;
+	bool bCompiled = false;
+
+	static FAutoPaintCompiledRule Compile(UAutoPaintItemRule* InRule, const FAutoPaintCodeGrid& Grid);
+
+	bool IsMet(const FVariant& Variant, const FIntVector& QueryPosition, const FAutoPaintCodeGrid& Grid, const FRandomStream& Random) const;
+};
+
 DECLARE_DELEGATE(FAutoPaintRulePostEdit);
 DECLARE_DELEGATE_OneParam(FRequestForUpdateMatchHint, UAutoPaintItemRule*);
 DECLARE_DELEGATE_OneParam(FRequestForTransaction, FText);
@@ -391,7 +462,10 @@ public:
 	void ReorderItem(const FName& ItemName1, const FName& ItemName2);
 
 	static bool IsRuleMet(UAutoPaintItemRule* QueryRule, EDuplicationType DupCase, FIntVector QueryPosition, const TMap<FIntVector, FName>& ExistingData,
-		FIntVector MinBoundary, FIntVector MaxBoundary);
+		FIntVector MinBoundary, FIntVector MaxBoundary, const FRandomStream& Random);
+
+	// whether an adjacency rule accepts the found item name (nullptr for no data)
+	static bool IsAdjacencyMet(const FAdjacencyRule& AdjInfo, const FName* Found);
 
 	static FIntVector RotatePosToDuplicated(const FIntVector& InPos, EDuplicationType DupType);
 
@@ -411,6 +485,11 @@ public:
 	TArray<FAutoPaintMatchData> MatchData;
 
 	TMap<UAutoPaintItemRule*, TArray<FIntVector>> GetMatchedPositions();
+
+	// bumped whenever this rule or any of its item rules is changed, cached evaluations compare against it
+	uint32 GetRuleVersion() const { return RuleVersion; }
+	void MarkRuleChanged() { RuleVersion++; }
+	virtual bool Modify(bool bAlwaysMarkDirty = true) override;
 	
 	FAutoPaintRulePostEdit RefreshAutoPalette_Delegate;
 	FAutoPaintRulePostEdit RefreshRuleEditor_Delegate;
@@ -453,4 +532,7 @@ public:
 	TArray<FName> OpenedGroups;
 
 #endif
+
+private:
+	uint32 RuleVersion = 0;
 };
@@ -7,6 +7,55 @@
 #include "Engine/StaticMeshActor.h"
 #include "StaticTiledLevel.generated.h"
 
+// a placement merged into a baked mesh, same values as its FTiledInstanceKey
+USTRUCT()
+struct FStaticTiledLevelPlacementRef
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	EPlacedType PlacedType = EPlacedType::Block;
+
+	UPROPERTY()
+	FGuid ItemID;
+
+	UPROPERTY()
+	FIntVector Position = FIntVector(0);
+
+	UPROPERTY()
+	FIntVector Extent = FIntVector(0);
+
+	FStaticTiledLevelPlacementRef() {}
+
+	FStaticTiledLevelPlacementRef(EPlacedType InPlacedType, const FItemPlacement& P, const FTiledInstanceKey& Key)
+		: PlacedType(InPlacedType), ItemID(P.ItemID), Position(Key.Position), Extent(Key.Extent)
+	{}
+
+	bool operator== (const FStaticTiledLevelPlacementRef& Other) const
+	{
+		return PlacedType == Other.PlacedType && ItemID == Other.ItemID && Position == Other.Position && Extent == Other.Extent;
+	}
+};
+
+// one merged mesh of a baked floor or spatial cell, and the placements it is made of
+USTRUCT()
+struct FStaticTiledLevelCell
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 FloorPosition = 0;
+
+	// in units of the bake cell size, always zero when baked per floor
+	UPROPERTY()
+	FIntPoint CellPosition = FIntPoint::ZeroValue;
+
+	UPROPERTY()
+	TObjectPtr<UStaticMeshComponent> MeshComponent;
+
+	UPROPERTY()
+	TArray<FStaticTiledLevelPlacementRef> Placements;
+};
 
 UCLASS()
 class TILEDLEVELRUNTIME_API AStaticTiledLevel : public AStaticMeshActor
@@ -22,6 +71,13 @@ public:
 
 	void SetSourceAsset(UTiledLevelAsset* InSourceAsset) { SourceAsset = InSourceAsset; }
 
+	// baked meshes live in their own components attached to the root, the root mesh is left empty
+	void AddBakedCell(const FStaticTiledLevelCell& InCell);
+	const TArray<FStaticTiledLevelCell>& GetBakedCells() const { return BakedCells; }
+
+	// the baked cell a placement of the source asset was merged into, nullptr if it was not baked
+	const FStaticTiledLevelCell* FindBakedCell(const FStaticTiledLevelPlacementRef& Placement) const;
+
 private:
 	UPROPERTY()
 	TObjectPtr<UTiledLevelAsset> SourceAsset;
@@ -30,6 +86,9 @@ private:
 	
 	UPROPERTY()
 	bool IsAutoGenerated = false;
+
+	UPROPERTY()
+	TArray<FStaticTiledLevelCell> BakedCells;
 	
 
 };
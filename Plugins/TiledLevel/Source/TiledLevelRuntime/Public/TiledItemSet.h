@@ -30,6 +30,9 @@ public:
 
 	UFUNCTION(BlueprintPure, BlueprintPure, Category="TiledItemSet | Info")
 	UTiledLevelItem* GetItem(const FGuid& ItemID) const;
+
+	// Changes whenever items are added or removed, unique across all item sets. Placements use it to validate their cached item.
+	uint32 GetItemIndexRevision() const;
 	
 	UFUNCTION(BlueprintPure, BlueprintPure, Category="TiledItemSet | Info")
 	TArray<UTiledLevelItem*> GetItemSet() const { return ItemSet;}
@@ -102,6 +105,7 @@ public:
 
 
 	virtual void GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const override;
+	virtual void PostLoad() override;
 	
 #if WITH_EDITOR
 	UFUNCTION(CallInEditor, Category="CustomData")
@@ -115,6 +119,13 @@ private:
 	UPROPERTY()
 	TArray<TObjectPtr<UTiledLevelItem>> ItemSet;
 
+	// ItemID -> item, rebuilt lazily after ItemSet changes
+	mutable TMap<FGuid, UTiledLevelItem*> ItemIndex;
+	mutable uint32 ItemIndexRevision = 0;
+	mutable bool bItemIndexDirty = true;
+
+	void MarkItemIndexDirty() { bItemIndexDirty = true; }
+	void UpdateItemIndex() const;
 
 	EPivotPosition GetDefaultPivotPosition(EPlacedType TargetPlacedType);
 };
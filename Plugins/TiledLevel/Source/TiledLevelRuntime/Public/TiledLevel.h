@@ -45,6 +45,9 @@ public:
 	void SetupAssetLevel(class UTiledLevelAsset* SourceAsset);
 	
 	virtual void PostDuplicate(bool bDuplicateForPIE) override;
+
+	// undo restores the instances of the HISMs without going through the instance index
+	virtual void PostEditUndo() override;
 	
 	virtual void PostInitProperties() override;
 
@@ -61,6 +64,9 @@ public:
 	// TODO: with this setup, there is no way to handle same SMptr in different ItemSet!?
 	UPROPERTY()
 	TMap<TObjectPtr<UStaticMesh> , TObjectPtr<UHierarchicalInstancedStaticMeshComponent>> TiledObjectSpawner;
+
+	// which instance of TiledObjectSpawner renders which placement, keep it updated whenever instances are added or removed
+	FTiledInstanceIndex InstanceIndex;
 	
 	UPROPERTY()
 	TArray<TObjectPtr<AActor>> SpawnedTiledActors;
@@ -72,6 +78,9 @@ public:
 	void PopulateSinglePlacement(const T& Placement, bool bForceBlockCustomData = false);
 	template <typename T>
 	void RemovePlacements(const TArray<T>& PlacementsToDelete);
+	// only remove the rendered instances / actors, asset data is untouched
+	template <typename T>
+	void RemovePlacementInstances(const TArray<T>& PlacementsToRemove);
 	void RemoveInstances(const TMap<UStaticMesh*, TArray<int32>>& TargetInstancesData);
 	void DestroyTiledActorByPlacement(const FTilePlacement& Placement);
 	void DestroyTiledActorByPlacement(const FEdgePlacement& Placement);
@@ -84,10 +93,10 @@ public:
 	int EraseSingleItem(FIntVector Pos, FIntVector Extent, FGuid TargetID);
 	int EraseSingleItem(FTiledLevelEdge Edge, FIntVector Extent, FGuid TargetID);
 	int EraseSingleItem(FIntVector Pos, int ZExtent, FGuid TargetID);
+	// both only touch the instances and actors that differ from the placements, see SyncRenderedPlacements
 	void ResetAllInstance(bool IgnoreVersion = false, bool bIgnoreCustomData = false);
 	void ResetAllInstanceFromData();
 	// TODO: separated spawner? better control for anything... need to rewrite so many things?
-	// TODO: better reset algorithm? just remove adjacent tiles and recalculate the stuff??
 
 	void MakeEditable();
 
@@ -125,6 +134,20 @@ private:
 	AActor* SpawnActorPlacement(const FItemPlacement& ItemPlacement);
 	AActor* SpawnMirroredPlacement(const FItemPlacement& ItemPlacement);
 
+	struct FPlacementsToRender
+	{
+		TArray<const FTilePlacement*> Tiles;
+		TArray<const FEdgePlacement*> Edges;
+		TArray<const FPointPlacement*> Points;
+	};
+	/*
+	 * Make the rendered instances and actors match the placements:
+	 * instances and actors that still match a placement (same key / tags and transform) are kept,
+	 * missing ones are added in one batch per mesh, and the rest are removed.
+	 * Restriction helpers gather several placements, so they are always respawned.
+	 */
+	void SyncRenderedPlacements(const FPlacementsToRender& Placements, bool bIgnoreCustomData);
+
 private:
 #if WITH_EDITOR
 	FDelegateHandle OnPostWorldInitializationDelegateHandle;
@@ -165,18 +188,27 @@ void ATiledLevel::PopulateSinglePlacement(const T& Placement, bool bForceBlockCu
 		 * Fixed by totally remove the use of custom data...???
 		 */
 		CreateNewHISM(Placement.GetItem());
-		const int NewIndex = TiledObjectSpawner[Placement.GetItem()->TiledMesh]->AddInstance(Placement.TileObjectTransform);
+		UHierarchicalInstancedStaticMeshComponent* HISM = TiledObjectSpawner[Placement.GetItem()->TiledMesh];
+		const int NewIndex = HISM->AddInstance(Placement.TileObjectTransform);
+		InstanceIndex.AddInstance(HISM, NewIndex, FTiledInstanceKey(Placement));
 		const TArray<float> InstanceData = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(Placement);
 		if (!GetMutableDefault<UTiledLevelSettings>()->bBlockAddCustomData && !bForceBlockCustomData)
-			TiledObjectSpawner[Placement.GetItem()->TiledMesh]->SetCustomData(NewIndex, InstanceData);
+			HISM->SetCustomData(NewIndex, InstanceData);
 	}	
 }
 
 template <typename T>
 void ATiledLevel::RemovePlacements(const TArray<T>& PlacementsToDelete)
+{
+	RemovePlacementInstances(PlacementsToDelete);
+	ActiveAsset->RemovePlacements(PlacementsToDelete);
+}
+
+template <typename T>
+void ATiledLevel::RemovePlacementInstances(const TArray<T>& PlacementsToRemove)
 {
 	TMap<UStaticMesh*, TArray<int32>> TargetInstanceData;
-	for (auto P : PlacementsToDelete)
+	for (auto P : PlacementsToRemove)
 	{
 		if (P.GetItem()->SourceType == ETLSourceType::Actor || P.IsMirrored)
 		{
@@ -184,14 +216,13 @@ void ATiledLevel::RemovePlacements(const TArray<T>& PlacementsToDelete)
 		}
 		else
 		{
+			if (!TiledObjectSpawner.Contains(P.GetItem()->TiledMesh)) continue;
 			if (!TargetInstanceData.Contains(P.GetItem()->TiledMesh))
 				TargetInstanceData.Add(P.GetItem()->TiledMesh, TArray<int32>{});
-			TArray<float> TargetInfo = FTiledLevelUtility::ConvertPlacementToHISM_CustomData(P);
 			FTiledLevelUtility::FindInstanceIndexByPlacement(TargetInstanceData[P.GetItem()->TiledMesh],
-				TiledObjectSpawner[P.GetItem()->TiledMesh]->PerInstanceSMCustomData, TargetInfo);
+				InstanceIndex, TiledObjectSpawner[P.GetItem()->TiledMesh], FTiledInstanceKey(P));
 		}
 	}
-	ActiveAsset->RemovePlacements(PlacementsToDelete);
 	RemoveInstances(TargetInstanceData);
 }
 
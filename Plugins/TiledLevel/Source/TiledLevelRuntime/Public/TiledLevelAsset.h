@@ -5,10 +5,28 @@
 #include "TiledItemSet.h"
 #include "UObject/Object.h"
 #include "TiledLevelTypes.h"
+#include "AutoPaintRule.h"
 #include "TiledLevelAsset.generated.h"
 
 struct FAutoPaintItem;
 class UAutoPaintRule;
+/*
+ * Lookup from grid positions to indices into the placement arrays of a FTiledFloor.
+ * Tiles are keyed by every cell they occupy, edges by every unit edge they occupy, points by their grid position.
+ */
+struct FTiledFloorIndex
+{
+	TMultiMap<FIntVector, int32> BlockCells;
+	TMultiMap<FIntVector, int32> FloorCells;
+	TMultiMap<FTiledLevelEdge, int32> WallEdges;
+	TMultiMap<FTiledLevelEdge, int32> EdgeEdges;
+	TMultiMap<FIntVector, int32> PillarPoints;
+	TMultiMap<FIntVector, int32> PointPoints;
+
+	// number of placements indexed, INDEX_NONE when it has to be rebuilt
+	int32 NumIndexed = INDEX_NONE;
+};
+
 /*
  * TODO: change this to layer... so that front-back / right-left side editing is possible??
  */
@@ -86,8 +104,30 @@ struct FTiledFloor
 			FloorName =  FName(FString::Printf(TEXT("B%d"), abs(FloorPosition)));
 		else
 			FloorName = FName(FString::Printf(TEXT("%dF"), FloorPosition + 1));	
+		MarkIndexDirty();
 	}
 
+	/*
+	 * Region queries and removal go through the spatial index, so they only touch the placements around the affected cells.
+	 * The index is not serialized. It is rebuilt on first use and after MarkIndexDirty, which every code changing the placement arrays
+	 * without going through these functions has to call. A change in the number of placements is caught as well, but an edit that
+	 * keeps the number (e.g. removing one placement directly and adding another one here) can only be told by the dirty mark.
+	 * Removal swaps the last placement of the array into the removed slot, so the order of placements is not kept.
+	 */
+	void AddPlacement(const FTilePlacement& NewPlacement, EPlacedType PlacedType);
+	void AddPlacement(const FEdgePlacement& NewPlacement, EPlacedType PlacedType);
+	void AddPlacement(const FPointPlacement& NewPlacement, EPlacedType PlacedType);
+
+	// removes every placement equal to one of the given placements, returns how many were removed
+	int32 RemovePlacements(const TArray<FTilePlacement>& ToDelete);
+	int32 RemovePlacements(const TArray<FEdgePlacement>& ToDelete);
+	int32 RemovePlacements(const TArray<FPointPlacement>& ToDelete);
+
+	// removes tiles occupying any of the cells, edges occupying any of the edges and points placed at any of the points
+	int32 EmptyRegion(const TSet<FIntVector>& Cells, const TArray<FTiledLevelEdge>& Edges, const TSet<FIntVector>& Points);
+
+	void MarkIndexDirty() { Index.NumIndexed = INDEX_NONE; }
+
 	TArray<FItemPlacement> GetItemPlacements() const
 	{
 		TArray<FItemPlacement> Out;
@@ -157,9 +197,15 @@ struct FTiledFloor
 	}
 
 	// this is reverse order
-	bool operator< (const FTiledFloor Other) const { return FloorPosition > Other.FloorPosition; }
-	bool operator== (const FTiledFloor Other) const { return FloorPosition == Other.FloorPosition; }
+	bool operator< (const FTiledFloor& Other) const { return FloorPosition > Other.FloorPosition; }
+	bool operator== (const FTiledFloor& Other) const { return FloorPosition == Other.FloorPosition; }
 	bool operator== (const int InFloorPosition) const { return FloorPosition == InFloorPosition; }
+
+private:
+	int32 GetNumPlacements() const;
+	void UpdateIndex();
+
+	FTiledFloorIndex Index;
 };
 
 
@@ -240,6 +286,7 @@ public:
 
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
 	void ClearOutOfBoundPlacements();
 #endif
 
@@ -315,14 +362,20 @@ public:
 	bool UpdateAutoPaintData(const FIntVector& NewPos, const FName& NewItemName);
 	bool RemoveAutoPaintDataAt(const FIntVector& PosToRemove);
 	TArray<FIntVector> GetAllTilePositions();
+	/*
+	 * Incremental collection only re-evaluates tiles around the auto paint data changed since last collection,
+	 * falls back to full evaluation when the rule list or the boundary is changed
+	 */
 	void CollectAutoPaintPlacements(TArray<struct FAutoPaintPlacement_Tile>& OutTiles, TArray<struct FAutoPaintPlacement_Edge>& OutEdges,
-		TArray<struct FAutoPaintPlacement_Point>& OutPoints);
+		TArray<struct FAutoPaintPlacement_Point>& OutPoints, bool bIncremental = false);
 	FAutoPaintItem GetAutoPaintItemRule(const FName& QueryName);
 	void SetAutoPaintData(const TMap<FIntVector, FName>& InData)
 	{
 		AutoPaintData = InData;
+		InvalidateAutoPaintEvaluation();
 	}
-	TMap<FIntVector, FName>& GetAutoPaintData()
+	// change it through UpdateAutoPaintData / RemoveAutoPaintDataAt, so the changed positions are tracked for incremental collection
+	const TMap<FIntVector, FName>& GetAutoPaintData() const
 	{
 		return AutoPaintData;
 	}
@@ -349,4 +402,24 @@ private:
 
 	UPROPERTY(VisibleDefaultsOnly, Category="Setup", AdvancedDisplay)
 	bool CanEditTileSize = false;
+
+	// auto paint evaluation cache, what the match data is evaluated from
+	// auto paint data positions changed since the last evaluation, bulk changes invalidate the whole evaluation instead
+	TSet<FIntVector> AutoPaintDirtyPositions;
+	// kept in the tile ordering of GetAllTilePositions
+	TMap<FIntVector, TArray<FAutoPaintMatchData>> EvaluatedAutoPaintMatches;
+	TArray<TWeakObjectPtr<UAutoPaintItemRule>> EvaluatedAutoPaintRules;
+	uint32 EvaluatedRuleVersion = 0;
+	FIntVector EvaluatedMinBoundary;
+	FIntVector EvaluatedMaxBoundary;
+	int32 EvaluatedRandomSeed = 0;
+	bool IsAutoPaintEvaluationValid = false;
+
+	// thread safe, randomness only comes from the tile position and the seed
+	void EvaluateAutoPaintAt(const FIntVector& TilePosition, const TArray<FAutoPaintCompiledRule>& Rules, const FAutoPaintCodeGrid& CodeGrid,
+		const FIntVector& MinBoundary, const FIntVector& MaxBoundary, int32 RandomSeed, TArray<FAutoPaintMatchData>& OutMatches) const;
+	void EvaluateAutoPaint(const TArray<FIntVector>& TilePositions, const TArray<UAutoPaintItemRule*>& Rules, const FIntVector& MinBoundary,
+		const FIntVector& MaxBoundary, int32 RandomSeed, TArray<TArray<FAutoPaintMatchData>>& OutMatches) const;
+	void MarkAutoPaintDataDirty(const FIntVector& Position);
+	void InvalidateAutoPaintEvaluation();
 };
@@ -274,6 +274,7 @@ private:
 	void MoveEdgePreviewItem(FTiledLevelEdge NewEdge, bool IgnoreSameEdge = true);
 	bool HasEnoughSpaceToBuild(); // Check has enough place to build active item to current position and restriction rules
 	bool IsRemoveRestricted(UTiledLevelItem* TestItem, FVector HitPosition);
+	TArray<class UTiledLevelRestrictionItem*> GetRestrictionsAt(const TArray<FIntVector>& PositionsToCheck);
 	FVector GetBuildLocation(); // return grid bottom center...
 	FVector GetBuildLocation(EPlacedShapeType Shape, FVector InTilePosition, FVector InTileExtent);
 	
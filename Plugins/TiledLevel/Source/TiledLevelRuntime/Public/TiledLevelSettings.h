@@ -31,6 +31,11 @@ public:
 	UPROPERTY(EditAnywhere, Config, Category="Debug")
 	bool bBlockAddCustomData = false;
 
+	// "Bake Tiled Level" merges each floor into one static mesh per square cell of this many tiles.
+	// 0 merges each whole floor into a single static mesh.
+	UPROPERTY(EditAnywhere, Config, Category="Bake", meta=(UIMin = 0, ClampMin = 0))
+	int32 BakeCellSize = 0;
+
 	// not exposed in config
 	
 	// Tiled Palette setup
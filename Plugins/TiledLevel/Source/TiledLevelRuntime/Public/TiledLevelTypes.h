@@ -5,6 +5,8 @@
 #include "TiledLevelEditorLog.h"
 #include "TiledLevelTypes.generated.h"
 
+class UHierarchicalInstancedStaticMeshComponent;
+
 
 UENUM()
 enum class EPlacedType :uint8
@@ -106,6 +108,11 @@ struct TILEDLEVELRUNTIME_API FItemPlacement
             return ID1.C < ID2.C;
         return ID1.D < ID2.D;
 	}
+
+private:
+	// GetItem result, valid while the item set's index revision is unchanged
+	mutable class UTiledLevelItem* CachedItem = nullptr;
+	mutable uint32 CachedItemRevision = 0;
 };
 
 // includes block, floor
@@ -235,6 +242,11 @@ struct FTiledLevelEdge
 		return X != OtherEdge.X || Y != OtherEdge.Y || Z != OtherEdge.Z || EdgeType != OtherEdge.EdgeType;
 	}
 
+	friend uint32 GetTypeHash(const FTiledLevelEdge& Edge)
+	{
+		return HashCombine(GetTypeHash(FIntVector(Edge.X, Edge.Y, Edge.Z)), static_cast<uint32>(Edge.EdgeType));
+	}
+
 	bool operator< (const FTiledLevelEdge& OtherEdge) const
 	{
 		if (EdgeType != OtherEdge.EdgeType)
@@ -395,6 +407,80 @@ struct FPointPlacement : public FItemPlacement
 };
 
 
+/*
+ * Hash grid of the cells each placement occupies, so overlap tests only need to look at the placements around the tested position.
+ * Tiles occupy every tile inside their extent, edges every unit edge along their length and height, points every height step they span.
+ * Cells are keyed by placed type as well, placements are only ever tested against placements of the same type.
+ */
+class TILEDLEVELRUNTIME_API FTiledOccupancyGrid
+{
+public:
+	void Add(const FTilePlacement& Placement);
+	void Add(const FEdgePlacement& Placement);
+	void Add(const FPointPlacement& Placement);
+
+	bool Remove(const FTilePlacement& Placement);
+	bool Remove(const FEdgePlacement& Placement);
+	bool Remove(const FPointPlacement& Placement);
+
+	void Reset();
+
+	int32 Num() const { return Tiles.Num() + Edges.Num() + Points.Num(); }
+
+	// placements of that type which overlap the test placement, same rules as FTiledLevelUtility::Is...PlacementOverlapping
+	TArray<FTilePlacement> FindOverlapping(EPlacedType PlacedType, const FTilePlacement& TestPlacement) const;
+	TArray<FEdgePlacement> FindOverlapping(EPlacedType PlacedType, const FEdgePlacement& TestPlacement) const;
+	TArray<FEdgePlacement> FindOverlapping(EPlacedType PlacedType, const FTiledLevelEdge& TestEdge, const FVector& TestExtent) const;
+	TArray<FPointPlacement> FindOverlapping(EPlacedType PlacedType, const FPointPlacement& TestPlacement, int ZExtent) const;
+
+	// placements of that type touching the tile area, same rules as FTiledLevelUtility::IsEdgeInsideTile / IsPointInsideTile
+	TArray<FEdgePlacement> FindEdgesInsideTile(EPlacedType PlacedType, const FIntVector& TilePosition, const FIntVector& TileExtent) const;
+	TArray<FPointPlacement> FindPointsInsideTile(EPlacedType PlacedType, const FIntVector& TilePosition, const FIntVector& TileExtent) const;
+
+	// tile placements of that type whose grid position is exactly this one (ex: restriction areas)
+	TArray<FTilePlacement> FindTilesAt(EPlacedType PlacedType, const FIntVector& GridPosition) const;
+
+private:
+	struct FCell
+	{
+		FIntVector Position;
+		uint8 Layer; // placed type, edges also separate horizontal and vertical
+
+		FCell(const FIntVector& InPosition, uint8 InLayer)
+			: Position(InPosition), Layer(InLayer)
+		{}
+
+		bool operator== (const FCell& Other) const
+		{
+			return Position == Other.Position && Layer == Other.Layer;
+		}
+
+		friend uint32 GetTypeHash(const FCell& Cell)
+		{
+			return HashCombine(GetTypeHash(Cell.Position), Cell.Layer);
+		}
+	};
+
+	typedef TArray<int32, TInlineAllocator<2>> FCellEntries;
+
+	static void GetCells(const FTilePlacement& Placement, EPlacedType PlacedType, TArray<FCell, TInlineAllocator<16>>& OutCells);
+	static void GetCells(const FTiledLevelEdge& Edge, EPlacedType PlacedType, const FVector& ItemExtent, TArray<FCell, TInlineAllocator<16>>& OutCells);
+	static void GetCells(const FPointPlacement& Placement, EPlacedType PlacedType, int ZExtent, TArray<FCell, TInlineAllocator<16>>& OutCells);
+
+	// gathers each entry found in the cells once
+	void GatherEntries(const TMap<FCell, FCellEntries>& InCells, TArrayView<const FCell> CellsToSearch, TArray<int32, TInlineAllocator<16>>& OutEntries) const;
+
+	void AddEntry(TMap<FCell, FCellEntries>& InCells, TArrayView<const FCell> CellsToAdd, int32 Entry);
+	void RemoveEntry(TMap<FCell, FCellEntries>& InCells, TArrayView<const FCell> CellsToRemove, int32 Entry);
+
+	TSparseArray<FTilePlacement> Tiles;
+	TSparseArray<FEdgePlacement> Edges;
+	TSparseArray<FPointPlacement> Points;
+	TMap<FCell, FCellEntries> TileCells;
+	TMap<FCell, FCellEntries> EdgeCells;
+	TMap<FCell, FCellEntries> PointCells;
+};
+
 /*
  * Just copy all placement data from Tiled Level Asset to this game data... let it handle all the rest...
  */
@@ -430,7 +516,11 @@ struct FTiledLevelGameData
 	TArray<FBox> Boundaries;
 
 	void Empty();
-	
+
+	void AddPlacement(const FTilePlacement& NewPlacement);
+	void AddPlacement(const FEdgePlacement& NewPlacement);
+	void AddPlacement(const FPointPlacement& NewPlacement);
+
 	bool RemovePlacement(FTransform CompareTransform, FGuid ItemID);
 	void RemovePlacements(const TArray<FTilePlacement>& ToDelete);
 	void RemovePlacements(const TArray<FEdgePlacement>& ToDelete);
@@ -445,9 +535,131 @@ struct FTiledLevelGameData
 		PillarPlacements.Append(Other.PillarPlacements);
 		PointPlacements.Append(Other.PointPlacements);
 		Boundaries.Append(Other.Boundaries);
+		Occupancy.Reset();
+		OnPlacementsChanged(false);
+	}
+
+	void operator+=(FTiledLevelGameData&& Other)
+	{
+		BlockPlacements.Append(MoveTemp(Other.BlockPlacements));
+		FloorPlacements.Append(MoveTemp(Other.FloorPlacements));
+		WallPlacements.Append(MoveTemp(Other.WallPlacements));
+		EdgePlacements.Append(MoveTemp(Other.EdgePlacements));
+		PillarPlacements.Append(MoveTemp(Other.PillarPlacements));
+		PointPlacements.Append(MoveTemp(Other.PointPlacements));
+		Boundaries.Append(MoveTemp(Other.Boundaries));
+		Occupancy.Reset();
+		OnPlacementsChanged(false);
 	}
 
 	void SetFocusFloor(int FloorPosition);
+
+	int32 GetNumOfPlacements() const;
+
+	// rebuilt here if the placements were changed without going through this struct (ex: filled from blueprint)
+	const FTiledOccupancyGrid& GetOccupancy();
+
+	// call after changing the placement arrays directly, so the occupancy is rebuilt on next access
+	void MarkPlacementsChanged() { OnPlacementsChanged(false); }
+
+private:
+	// not a property, only valid while it was built or kept up to date at the current placements version
+	FTiledOccupancyGrid Occupancy;
+
+	// increased on every placement change made through this struct or marked with MarkPlacementsChanged,
+	// the occupancy is synced while it was built or updated at the current placements version (never at first)
+	uint32 PlacementsVersion = 1;
+	uint32 OccupancyVersion = 0;
+
+	bool IsOccupancySynced() const;
+	void OnPlacementsChanged(bool bOccupancyUpdated);
+};
+
+/*
+ * Identifies the HISM instance of a mesh placement within its component.
+ * Holds the same 6 values as the custom data of the instance (see FTiledLevelUtility::ConvertPlacementToHISM_CustomData)
+ */
+struct TILEDLEVELRUNTIME_API FTiledInstanceKey
+{
+	FIntVector Position{0, 0, 0};
+	FIntVector Extent{0, 0, 0};
+
+	FTiledInstanceKey() {}
+
+	FTiledInstanceKey(const FIntVector& InPosition, const FIntVector& InExtent)
+		: Position(InPosition), Extent(InExtent)
+	{}
+
+	// from the 6 custom data floats of an instance
+	explicit FTiledInstanceKey(const float* CustomData);
+
+	explicit FTiledInstanceKey(const FTilePlacement& P);
+	explicit FTiledInstanceKey(const FEdgePlacement& P);
+	explicit FTiledInstanceKey(const FPointPlacement& P);
+
+	bool operator== (const FTiledInstanceKey& Other) const
+	{
+		return Position == Other.Position && Extent == Other.Extent;
+	}
+
+	friend uint32 GetTypeHash(const FTiledInstanceKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.Position), GetTypeHash(Key.Extent));
+	}
+};
+
+/*
+ * Reverse lookup from placement to the index of its HISM instance, so erasing does not need to scan the custom data of every instance.
+ * Several instances may share a key (ex: same mesh placed at the same position and extent with different rotations), each key holds all of them.
+ * HISM removes instances by swapping the last instance into the removed slot, RemoveInstances mirrors that to keep the indices valid.
+ * Components whose instances were not added through this index (ex: loaded from disk) are re-indexed from their custom data on demand,
+ * call MarkStale when the instances of a component are changed behind the index's back (ex: undo).
+ */
+class TILEDLEVELRUNTIME_API FTiledInstanceIndex
+{
+public:
+	// call right after the instance is added to the component
+	void AddInstance(const UHierarchicalInstancedStaticMeshComponent* Component, int32 InstanceIndex, const FTiledInstanceKey& Key);
+
+	// returns INDEX_NONE if there is no instance for that key, the lowest added one otherwise
+	int32 FindInstance(const UHierarchicalInstancedStaticMeshComponent* Component, const FTiledInstanceKey& Key);
+
+	// every instance for that key
+	TConstArrayView<int32> FindInstances(const UHierarchicalInstancedStaticMeshComponent* Component, const FTiledInstanceKey& Key);
+
+	// call with the same indices right before they are removed from the component
+	void RemoveInstances(const UHierarchicalInstancedStaticMeshComponent* Component, const TArray<int32>& InstanceIndices);
+
+	void RemoveComponent(const UHierarchicalInstancedStaticMeshComponent* Component);
+
+	// re-index the component from its custom data on next access
+	void MarkStale(const UHierarchicalInstancedStaticMeshComponent* Component);
+
+	void Reset();
+
+	// key of every instance of the component, in instance order
+	const TArray<FTiledInstanceKey>& GetInstanceKeys(const UHierarchicalInstancedStaticMeshComponent* Component);
+
+	// number of instances that can be found by key
+	int32 Num(const UHierarchicalInstancedStaticMeshComponent* Component) const;
+
+private:
+	struct FComponentInstances
+	{
+		// key of each instance, in instance order
+		TArray<FTiledInstanceKey> Keys;
+		TMap<FTiledInstanceKey, TArray<int32, TInlineAllocator<1>>> KeyToInstances;
+		int32 NumIndexed = 0;
+		// false until built from the component, and once marked stale
+		bool bSynced = false;
+	};
+
+	// the entry of the component, rebuilt first if it is stale or obviously out of sync
+	FComponentInstances& GetSyncedInstances(const UHierarchicalInstancedStaticMeshComponent* Component);
+	void RebuildComponent(const UHierarchicalInstancedStaticMeshComponent* Component, FComponentInstances& Instances, int32 NumInstances);
+	void RemoveInstanceAtSwap(FComponentInstances& Instances, int32 InstanceIndex);
+
+	TMap<const UHierarchicalInstancedStaticMeshComponent*, FComponentInstances> Components;
 };
 
 UENUM()
@@ -8,6 +8,36 @@
 enum class EImpactSize : uint8;
 class ATiledLevel;
 
+// Board for the fill tools: a flat occupancy bit grid, plus per cell flags for the edges that block the fill from crossing into a neighbour
+struct TILEDLEVELRUNTIME_API FTiledFillBoard
+{
+	enum EBlockedSide : uint8
+	{
+		Blocked_Left = 1 << 0,	// -X
+		Blocked_Right = 1 << 1,	// +X
+		Blocked_Up = 1 << 2,	// -Y
+		Blocked_Down = 1 << 3,	// +Y
+	};
+
+	void Init(const FIntPoint& InSize);
+
+	FIntPoint GetSize() const { return Size; }
+	bool IsInside(int X, int Y) const { return X >= 0 && X < Size.X && Y >= 0 && Y < Size.Y; }
+	bool IsOccupied(int X, int Y) const { return Occupied[GetIndex(X, Y)]; }
+	void SetOccupied(int X, int Y, bool bValue = true) { Occupied[GetIndex(X, Y)] = bValue; }
+	uint8 GetBlockedSides(int X, int Y) const { return BlockedSides.Num() ? BlockedSides[GetIndex(X, Y)] : 0; }
+
+	// blocks the fill across a 2D edge (Z is ignored), edges outside the board are ignored
+	void AddBlockingEdge(const FTiledLevelEdge& Edge);
+
+private:
+	int32 GetIndex(int X, int Y) const { return Y * Size.X + X; }
+
+	FIntPoint Size = FIntPoint::ZeroValue;
+	TBitArray<> Occupied;
+	TArray<uint8> BlockedSides; // stays empty until the first blocking edge
+};
+
 class TILEDLEVELRUNTIME_API FTiledLevelUtility
 {
 public:
@@ -22,7 +52,8 @@ public:
 	static bool IsPointInsideTile(FIntVector PointPosition, int PointZExtent, const FIntVector TilePosition, const FIntVector& TileExtent);
 
 	// from placement data to get instance indices
-	static void FindInstanceIndexByPlacement(TArray<int32>& FoundIndex,const TArray<float>& CustomData,const TArray<float>& SearchData);
+	static void FindInstanceIndexByPlacement(TArray<int32>& FoundIndex, FTiledInstanceIndex& InstanceIndex,
+		const UHierarchicalInstancedStaticMeshComponent* HISM, const FTiledInstanceKey& SearchKey);
 	// make HISM custom data from placement
 	static TArray<float> ConvertPlacementToHISM_CustomData(const FTilePlacement& P);
 	static TArray<float> ConvertPlacementToHISM_CustomData(const FEdgePlacement& P);
@@ -30,6 +61,10 @@ public:
 	static void SetSpawnedActorTag(const FTilePlacement& P, AActor* TargetActor);
 	static void SetSpawnedActorTag(const FEdgePlacement& P, AActor* TargetActor);
 	static void SetSpawnedActorTag(const FPointPlacement& P, AActor* TargetActor);
+	// the tags SetSpawnedActorTag adds, to find the actor spawned for a placement
+	static TArray<FName> GetSpawnedActorTags(const FTilePlacement& P);
+	static TArray<FName> GetSpawnedActorTags(const FEdgePlacement& P);
+	static TArray<FName> GetSpawnedActorTags(const FPointPlacement& P);
 
 	// use for restriction item, otherwise just check whether overlap is fine
 	static TArray<FIntVector> GetOccupiedPositions(class UTiledLevelItem* Item, FIntVector StartPosition, bool ShouldRotate);
@@ -55,9 +90,10 @@ public:
 	static FString GetFloorNameFromPosition(int FloorPositionIndex);
 
 	// Fill tool algorithms
-	static void FloodFill(TArray<TArray<int>>& InBoard, const FIntPoint& InBoardSize, int X , int Y, TArray<FIntPoint>& FilledTarget);
-	static void FloodFillByEdges(const TArray<FTiledLevelEdge>& BlockingEdges, TArray<TArray<int>>& InBoard, const FIntPoint& InBoardSize, int X, int Y, TArray<FIntPoint>& FilledTarget);
-	static void GetConsecutiveTiles(TArray<TArray<int>>& InBoard, FIntPoint InBoardSize, int X, int Y, TArray<FIntPoint>& OutTiles);
+	// fills the empty region connected to (X, Y) without crossing blocking edges, marking it occupied
+	static void FloodFill(FTiledFillBoard& InBoard, int X , int Y, TArray<FIntPoint>& FilledTarget);
+	// collects the occupied region connected to (X, Y), marking it empty
+	static void GetConsecutiveTiles(FTiledFillBoard& InBoard, int X, int Y, TArray<FIntPoint>& OutTiles);
 	static TArray<float> GetWeightedCoefficient(TArray<float>& RawCoefficientArray);
 	static bool GetFeasibleFillTile(UTiledLevelItem* InItem, int& RotationIndex, TArray<FIntPoint>& CandidatePoints, FIntPoint& OutPoint);
 	static TArray<FTiledLevelEdge> GetEdgesAroundArea(const TSet<FIntPoint>& Region, int Z = 1, bool AskForOuter = true);
@@ -76,6 +112,8 @@ public:
     static struct FMeshDescription BuildMeshDescription(class UProceduralMeshComponent* ProcMeshComp);
 	// Copy from FProceduralMeshComponentDetails::ClickedOnConvertToStaticMesh and with minor modifications...
 	static class UProceduralMeshComponent* ConvertTiledLevelAssetToProcMesh(class UTiledLevelAsset* TargetAsset, int TargetLOD = 0, UObject* Outer = nullptr, EObjectFlags Flags = RF_NoFlags);
+	// one section per mesh section, so sections sharing a material end up in the same polygon group of BuildMeshDescription
+	static class UProceduralMeshComponent* ConvertMeshesToProcMesh(const TArray<class UStaticMesh*>& TargetMeshes, const TArray<FTransform>& TransformMods, int TargetLOD, UObject* Outer, EObjectFlags Flags = RF_NoFlags);
 
 	static void GenerateCubesWithUniqueFaces(TArray<FIntVector> CubePositions, FVector CubeSize, TArray<FVector>& OutVertices, TArray<int32>& OutTriangles,
 		TArray<FVector>& OutNormals, TArray<FVector2D>& OutUVs, float PaddingSize=0.f);